@@ -13,6 +13,71 @@ use_inter_ping = true;
 -- Ping clients? This should generally remain enabled, but it's useful for using a debugger
 use_client_ping = true;
 
+-- How many threads should service network I/O?
+-- Packet encryption and decryption for each connection is spread across these threads
+-- 0 uses one thread per hardware thread on the machine
+io_threads = 0;
+
+-- How much outbound data may be queued for a client that isn't reading it?
+-- Above either soft limit, low priority packets (movement, emotes, chat from other players) are dropped for that client
+-- Above the hard limit, the client is disconnected
+-- Sizes are in bytes, 0 disables a limit
+client_send_limits = {
+	["soft_bytes"] = 262144,
+	["soft_packets"] = 2048,
+	["hard_bytes"] = 4194304,
+};
+
+-- How often (in seconds) should each server write per-opcode packet counts and handler timings to logs/opcode_stats?
+-- 0 disables the file, the counters are still kept and can be viewed in-game with !opstats
+opcode_stats_interval = 300;
+
+-- Should the ChannelServer record every decrypted client packet to captures/?
+-- Captures can be replayed offline with "ChannelServer --replay <file> [--fast]"
+-- They contain everything players send, including chat, so treat them like the database
+capture_client_packets = false;
+
+-- Should timers (map ticks, buffs, cooldowns, pings, etc.) be kept in a timing wheel instead of a priority queue?
+-- The wheel adds and cancels timers in constant time and frees cancelled timers right away
+-- It fires timers on 10ms boundaries, the priority queue fires them at the exact time but gets slower as timers pile up
+use_timer_wheel = true;
+
+-- How many map workers should the ChannelServer split its maps between?
+-- Movement and emotes are handled on the worker that owns the player's map, so busy maps can use more than one core
+-- Everything else still runs on the handler strand, which pauses the workers while it runs
+-- 0 handles everything on the handler strand, io_threads should be higher than this to see any benefit
+map_workers = 0;
+
+-- How many threads should run database queries that were moved off the handlers (fame checks, lookups, etc.)?
+-- Each thread keeps its own database connections
+db_threads = 2;
+
+-- How many queries may wait for those threads?
+-- Past this, queries are turned away and their callers fall back to running them directly or report an error
+db_queue_capacity = 1024;
+
+-- Should a ChannelServer send the whole character along when it changes channels?
+-- The next channel then builds the character from that instead of loading it from the database
+-- If something changed the character between asking to move and moving, the next channel loads it from the database after all
+-- Every channel in the world understands both, this only decides what gets sent
+transfer_full_state = false;
+
+-- How often (in seconds) should a ChannelServer save each online character in the background?
+-- Background saves go to journal/ first and reach the database every player_flush_interval seconds, a character saved several times in between is only written once
+-- A ChannelServer that goes down writes what's left in its journal when it starts again
+-- 0 disables background saves, characters are then only saved when they leave the channel or on !save
+player_save_interval = 0;
+player_flush_interval = 60;
+
+-- Where should a ChannelServer look for a data snapshot of the MCDB?
+-- Snapshots are built with "ChannelServer --compile-data <file>" and let channels start without reading all of datadb
+-- A missing snapshot or one built for another MCDB version or before datadb was imported again is ignored and the data is loaded from the database as usual
+-- Rebuild it after changing anything in datadb, an empty string always loads from the database
+data_snapshot = "data/datadb.vdat";
+-- Should a ChannelServer also compare the content of the datadb tables with the snapshot before using it?
+-- This catches edits to datadb that weren't followed by a rebuild, but it reads every one of those tables on each start (CHECKSUM TABLE)
+data_snapshot_verify = false;
+
 -- What IP and port should the server use to connect to the LoginServer?
 login_ip = "127.0.0.1";
 login_inter_port = 8485;
@@ -0,0 +1,70 @@
+-- Settings for the LoadGenerator, a headless client that logs in scripted bots and plays with them to put load on a server stack
+-- The bots speak the encrypted client protocol, so use_client_encryption needs to be enabled in connection_properties.lua
+
+-- Where is the LoginServer the bots should log in through?
+-- The channel address comes from the LoginServer like it would for a real client
+login_ip = "127.0.0.1";
+login_port = 8484;
+
+-- Bot accounts are named account_prefix followed by a number, starting at account_start
+-- The LoadGenerator doesn't create anything, every account has to exist already with its gender set and a character in the world below
+-- Bots always play the first character on their account
+-- Map changes are done with the !map command, so the accounts need a GM level to use it
+account_prefix = "bot";
+account_start = 1;
+password = "bot";
+
+-- Only used when the LoginServer has the PIN system enabled
+pin = "";
+
+-- Which world and channel should the bots play on? Both are 0-based
+world = 0;
+channel = 0;
+
+-- How many bots should be logged in, and how many should start logging in per second?
+bot_count = 1000;
+ramp_rate = 50;
+
+-- How many threads should drive the bots? 0 uses one thread per hardware thread on the machine
+threads = 0;
+
+-- How many seconds should the run last before every bot disconnects? 0 runs until interrupted
+duration = 600;
+
+-- How many seconds between status reports?
+report_interval = 10;
+
+-- How many milliseconds should a bot wait between leaving the LoginServer and connecting to the channel?
+-- The WorldServer needs a moment to tell the channel about the player, a real client takes about this long as well
+migrate_delay = 500;
+
+-- What the bots do once they're in game
+-- Every action_interval milliseconds (give or take a quarter), a bot picks one action, the numbers are the relative weights of each
+-- Attacks and looting only happen when there's something to attack or loot, the bot moves instead otherwise
+behaviour = {
+	["action_interval"] = 1000,
+	["move"] = 50,
+	["attack"] = 25,
+	["loot"] = 15,
+	["chat"] = 8,
+	["change_map"] = 2,
+	-- How far a bot walks in one movement
+	["move_range"] = 150,
+	-- Damage dealt by each hit
+	["damage"] = 1,
+	-- Maps the bots wander between
+	["maps"] = {
+		100000000,
+		101000000,
+		102000000,
+		103000000,
+		104000000,
+	},
+	-- The LoadGenerator times how long it takes for a bot's own chat to come back, which tracks how backed up the channel is
+	["chat_messages"] = {
+		"hello",
+		"anyone want to party?",
+		"selling stuff",
+		"brb",
+	},
+};
\ No newline at end of file
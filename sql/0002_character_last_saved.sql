@@ -0,0 +1,2 @@
+ALTER TABLE `%%PREFIX%%characters`
+	ADD COLUMN `last_saved` bigint(20) NOT NULL DEFAULT '0' AFTER `book_cover`;
\ No newline at end of file
@@ -19,18 +19,24 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "Common/ConfigFile.hpp"
 #include "Common/ConnectionListenerConfig.hpp"
 #include "Common/ConnectionManager.hpp"
+#include "Common/Database.hpp"
+#include "Common/DataSnapshot.hpp"
 #include "Common/ExitCodes.hpp"
+#include "Common/FileUtilities.hpp"
 #include "Common/InitializeCommon.hpp"
 #include "Common/MiscUtilities.hpp"
 #include "Common/PacketBuilder.hpp"
 #include "Common/ServerType.hpp"
+#include "Common/StringUtilities.hpp"
 #include "ChannelServer/ChatHandler.hpp"
+#include "ChannelServer/CmsgHeader.hpp"
 #include "ChannelServer/Map.hpp"
 #include "ChannelServer/Player.hpp"
 #include "ChannelServer/PlayerDataProvider.hpp"
 #include "ChannelServer/ServerPacket.hpp"
 #include "ChannelServer/SyncPacket.hpp"
 #include "ChannelServer/WorldServerPacket.hpp"
+#include <algorithm>
 
 namespace Vana {
 namespace ChannelServer {
@@ -52,14 +58,103 @@ auto ChannelServer::listen() -> void {
 			ConnectionType::EndUser,
 			MapleVersion::ChannelSubversion,
 			m_port,
-			Ip::Type::Ipv4
+			Ip::Type::Ipv4,
+			config.clientSendLimits
 		},
 		[&] { return make_ref_ptr<Player>(); }
 	);
 
+	startPacketCapture();
 	Initializing::setUsersOffline(this, getOnlineId());
 }
 
+auto ChannelServer::startReplay() -> void {
+	// Replays stand alone, there's no LoginServer to assign a world and channel or WorldServer to sync with
+	m_worldId = 0;
+	m_channelId = 0;
+	m_sessionPool.initialize(1);
+	Map::setMapUnloadTime(m_config.mapUnloadTime);
+	Initializing::setUsersOffline(this, getOnlineId());
+
+	getConnectionManager().replay(
+		m_replay,
+		[&] { return make_ref_ptr<Player>(); },
+		[&](const Ip &ip, PacketReader reader) {
+			if (reader.get<header_t>() == CMSG_PLAYER_LOAD) {
+				m_playerDataProvider.replayConnectable(reader.get<player_id_t>(), ip);
+			}
+		},
+		[&] {
+			writeOpcodeStats();
+			ExitCodes::exit(ExitCodes::Ok);
+		});
+}
+
+auto ChannelServer::setReplay(const ReplayConfig &config) -> void {
+	m_replay = config;
+}
+
+auto ChannelServer::isReplaying() const -> bool {
+	return !m_replay.file.empty();
+}
+
+auto ChannelServer::setCompileData(const string_t &file) -> void {
+	m_compileData = file;
+}
+
+auto ChannelServer::loadDataSnapshot() -> void {
+	auto &snapshot = DataSnapshot::getInstance();
+	if (!m_compileData.empty()) {
+		snapshot.record();
+		return;
+	}
+
+	const auto &config = getInterServerConfig();
+	const string_t &file = config.dataSnapshot;
+	if (file.empty()) {
+		return;
+	}
+
+	if (snapshot.load(file, Database::getDataDb(), config.verifyDataSnapshot) == Result::Failure) {
+		log(LogType::Info, "Data snapshot " + file + " is missing or doesn't match the MCDB or datadb, loading from the database");
+		return;
+	}
+
+	log(LogType::Info, [&](out_stream_t &str) {
+		str << "Loading " << snapshot.getTableCount() << " tables from data snapshot " << file;
+	});
+}
+
+auto ChannelServer::finishDataSnapshot() -> Result {
+	auto &snapshot = DataSnapshot::getInstance();
+	if (!m_compileData.empty()) {
+		if (snapshot.write(m_compileData, Database::getDataDb()) == Result::Failure) {
+			log(LogType::CriticalError, "Unable to write data snapshot " + m_compileData);
+			snapshot.release();
+			ExitCodes::exit(ExitCodes::ConfigError);
+			return Result::Failure;
+		}
+
+		log(LogType::Info, [&](out_stream_t &str) {
+			str << "Wrote " << snapshot.getTableCount() << " tables to data snapshot " << m_compileData;
+		});
+		snapshot.release();
+		// There's nothing else to do, failing here keeps the server from connecting anywhere
+		ExitCodes::exit(ExitCodes::Ok);
+		return Result::Failure;
+	}
+
+	if (snapshot.isLoaded() && snapshot.getMisses() > 0) {
+		log(LogType::Warning, [&](out_stream_t &str) {
+			str << snapshot.getMisses() << " queries weren't in the data snapshot, it was built by a different version and should be compiled again";
+		});
+	}
+
+	// Reloads always go to the database
+	snapshot.release();
+	return Result::Successful;
+}
+
 auto ChannelServer::finalizePlayer(ref_ptr_t<Player> session) -> void {
 	m_sessionPool.store(session);
 }
@@ -67,6 +162,7 @@ auto ChannelServer::finalizePlayer(ref_ptr_t<Player> session) -> void {
 auto ChannelServer::shutdown() -> void {
 	// If we don't do this and the connection disconnects, it will try to call shutdown() again
 	m_channelId = -1;
+	m_persistence.stop();
 	AbstractServer::shutdown();
 }
 
@@ -78,6 +174,7 @@ auto ChannelServer::loadData() -> Result {
 		return Result::Failure;
 	}
 
+	loadDataSnapshot();
 	m_buffDataProvider.loadData();
 	m_validCharDataProvider.loadData();
 	m_equipDataProvider.loadData();
@@ -94,11 +191,19 @@ auto ChannelServer::loadData() -> Result {
 	m_itemDataProvider.loadData(m_buffDataProvider);
 	m_mapDataProvider.loadData();
 	m_eventDataProvider.loadData();
+	if (finishDataSnapshot() == Result::Failure) {
+		return Result::Failure;
+	}
 
 	std::cout << std::setw(Initializing::OutputWidth) << std::left << "Initializing Commands... ";
 	ChatHandler::initializeCommands();
 	std::cout << "DONE" << std::endl;
 
+	if (isReplaying()) {
+		startReplay();
+		return Result::Successful;
+	}
+
 	auto &config = getInterServerConfig();
 	auto result = getConnectionManager().connect(
 		config.loginIp,
@@ -150,6 +255,12 @@ auto ChannelServer::getLogPrefix() const -> string_t {
 	return "channel";
 }
 
+auto ChannelServer::makeFileIdentifier() const -> string_t {
+	return "channel_" +
+		StringUtilities::lexical_cast<string_t>(static_cast<int32_t>(m_worldId)) + "_" +
+		StringUtilities::lexical_cast<string_t>(static_cast<int32_t>(m_channelId));
+}
+
 auto ChannelServer::connectToWorld(world_id_t worldId, port_t port, const Ip &ip) -> Result {
 	m_worldId = worldId;
 	m_worldPort = port;
@@ -205,6 +316,20 @@ auto ChannelServer::establishedWorldConnection(channel_id_t channelId, port_t po
 	m_port = port;
 	m_config = config;
 	Map::setMapUnloadTime(config.mapUnloadTime);
+
+	// Characters are only accepted once the saves a previous run left in the journal are written
+	auto &interServer = getInterServerConfig();
+	string_t journal = "journal/" + makeFileIdentifier() + ".vjnl";
+	bool writeBehind = interServer.playerSaveInterval.count() > 0;
+	if (writeBehind || FileUtilities::fileExists(journal)) {
+		Result result = m_persistence.start(journal, writeBehind ? std::max(interServer.playerFlushInterval, seconds_t{1}) : seconds_t{0});
+		if (result == Result::Failure) {
+			// Characters saved in the journal would be loaded without their last save
+			ExitCodes::exit(ExitCodes::JournalError);
+			return;
+		}
+	}
+
 	listen();
 	displayLaunchTime();
 }
@@ -293,6 +418,18 @@ auto ChannelServer::getInstances() -> Instances & {
 	return m_instances;
 }
 
+auto ChannelServer::getMapTickScheduler() -> MapTickScheduler & {
+	return m_mapTickScheduler;
+}
+
+auto ChannelServer::getSaveStats() -> PlayerSaveStats & {
+	return m_saveStats;
+}
+
+auto ChannelServer::getPersistence() -> PlayerPersistence & {
+	return m_persistence;
+}
+
 auto ChannelServer::getMap(int32_t mapId) -> Map * {
 	return m_mapDataProvider.getMap(mapId);
 }
@@ -301,6 +438,18 @@ auto ChannelServer::unloadMap(int32_t mapId) -> void {
 	return m_mapDataProvider.unloadMap(mapId);
 }
 
+auto ChannelServer::getMapWorker(map_id_t mapId) const -> int32_t {
+	int32_t workers = getInterServerConfig().mapWorkers;
+	if (workers <= 0) {
+		return -1;
+	}
+	return static_cast<int32_t>(static_cast<uint32_t>(mapId) % static_cast<uint32_t>(workers));
+}
+
+auto ChannelServer::postToHandlerStrand(function_t<void()> work) -> void {
+	getConnectionManager().postHandler(work);
+}
+
 auto ChannelServer::isConnected() const -> bool {
 	return m_channelId != -1;
 }
@@ -318,6 +467,10 @@ auto ChannelServer::getOnlineId() const -> int32_t {
 }
 
 auto ChannelServer::sendWorld(const PacketBuilder &builder) -> void {
+	if (m_worldConnection == nullptr) {
+		// There is no WorldServer while replaying
+		return;
+	}
 	m_worldConnection->send(builder);
 }
 
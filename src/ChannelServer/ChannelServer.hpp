@@ -26,6 +26,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "Common/FinalizationPool.hpp"
 #include "Common/Ip.hpp"
 #include "Common/ItemDataProvider.hpp"
+#include "Common/PacketReplay.hpp"
 #include "Common/MobDataProvider.hpp"
 #include "Common/NpcDataProvider.hpp"
 #include "Common/QuestDataProvider.hpp"
@@ -41,7 +42,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "ChannelServer/LoginServerSession.hpp"
 #include "ChannelServer/MapDataProvider.hpp"
 #include "ChannelServer/MapleTvs.hpp"
+#include "ChannelServer/MapTickScheduler.hpp"
 #include "ChannelServer/PlayerDataProvider.hpp"
+#include "ChannelServer/PlayerPersistence.hpp"
+#include "ChannelServer/PlayerSaveStats.hpp"
 #include "ChannelServer/Trades.hpp"
 #include "ChannelServer/WorldServerSession.hpp"
 #include <string>
@@ -60,6 +64,10 @@ namespace Vana {
 			auto shutdown() -> void override;
 			auto connectToWorld(world_id_t worldId, port_t port, const Ip &ip) -> Result;
 			auto establishedWorldConnection(channel_id_t channelId, port_t port, const WorldConfig &config) -> void;
+			auto setReplay(const ReplayConfig &config) -> void;
+			auto isReplaying() const -> bool;
+			// Loads every provider from the database, writes them to the file and quits
+			auto setCompileData(const string_t &file) -> void;
 
 			// TODO FIXME api
 			// Eyeball these for potential refactoring - they involve world<->channel operations and I don't want to dig into that now
@@ -90,9 +98,16 @@ namespace Vana {
 			auto getTrades() -> Trades &;
 			auto getMapleTvs() -> MapleTvs &;
 			auto getInstances() -> Instances &;
+			auto getMapTickScheduler() -> MapTickScheduler &;
+			auto getSaveStats() -> PlayerSaveStats &;
+			auto getPersistence() -> PlayerPersistence &;
 
 			auto getMap(int32_t mapId) -> Map *;
 			auto unloadMap(int32_t mapId) -> void;
+			// The worker that owns the map's packets, -1 when map workers are off
+			auto getMapWorker(map_id_t mapId) const -> int32_t;
+			// For work a map worker finds that reaches outside its map
+			auto postToHandlerStrand(function_t<void()> work) -> void;
 
 			auto isConnected() const -> bool;
 			auto getWorldId() const -> world_id_t;
@@ -108,8 +123,12 @@ namespace Vana {
 		protected:
 			auto loadData() -> Result override;
 			auto listen() -> void;
+			auto startReplay() -> void;
+			auto loadDataSnapshot() -> void;
+			auto finishDataSnapshot() -> Result;
 			auto makeLogIdentifier() const -> opt_string_t override;
 			auto getLogPrefix() const -> string_t override;
+			auto makeFileIdentifier() const -> string_t override;
 		private:
 			world_id_t m_worldId = -1;
 			channel_id_t m_channelId = -1;
@@ -117,6 +136,8 @@ namespace Vana {
 			port_t m_port = 0;
 			Ip m_worldIp;
 			WorldConfig m_config;
+			ReplayConfig m_replay;
+			string_t m_compileData;
 			ref_ptr_t<WorldServerSession> m_worldConnection;
 			ref_ptr_t<LoginServerSession> m_loginConnection;
 			FinalizationPool<Player> m_sessionPool;
@@ -136,11 +157,14 @@ namespace Vana {
 			QuestDataProvider m_questDataProvider;
 			BuffDataProvider m_buffDataProvider;
 			EventDataProvider m_eventDataProvider;
+			MapTickScheduler m_mapTickScheduler;
 			MapDataProvider m_mapDataProvider;
 			PlayerDataProvider m_playerDataProvider;
 			Trades m_trades;
 			MapleTvs m_mapleTvs;
 			Instances m_instances;
+			PlayerSaveStats m_saveStats;
+			PlayerPersistence m_persistence;
 		};
 	}
 }
\ No newline at end of file
@@ -46,7 +46,7 @@ auto ChatHandler::handleChat(ref_ptr_t<Player> player, PacketReader &reader) ->
 			return;
 		}
 
-		player->sendMap(Packets::Players::showChat(player->getId(), player->isGm(), message, bubbleOnly));
+		player->sendMap(Packets::Players::showChat(player->getId(), player->isGm(), message, bubbleOnly), false, PacketPriority::Low);
 	}
 }
 
@@ -635,6 +635,31 @@ auto ChatHandlerFunctions::initialize() -> void {
 	command.syntax = "<${view | reset | set}> <${mobexp | dropmeso | questexp | drop | globaldrop | globaldropmeso}> [#new rate]";
 	command.notes.push_back("Allows the viewing or setting of rates on the current world");
 	sCommandList["rates"] = command.addToMap();
+
+	command.command = &ManagementFunctions::opcodeStats;
+	command.syntax = "[${handled | sent | sessions | reset | write}] [#count]";
+	command.notes.push_back("Displays the opcodes on the current channel that took the most handler time (handled) or sent the most bytes (sent)");
+	command.notes.push_back("Sessions shows the traffic and send queues of the connected sessions and how many were disconnected for send limits");
+	command.notes.push_back("Reset clears the counters, write saves every opcode to the stats file immediately");
+	sCommandList["opstats"] = command.addToMap();
+
+	command.command = &ManagementFunctions::mapTickStats;
+	command.syntax = "[${reset}]";
+	command.notes.push_back("Displays how many maps on the current channel are being ticked and how long each sweep over them takes");
+	command.notes.push_back("Reset clears the timings");
+	sCommandList["mapticks"] = command.addToMap();
+
+	command.command = &ManagementFunctions::taskStats;
+	command.notes.push_back("Displays the background task queue depth and how long tasks wait and run on the current channel");
+	sCommandList["taskstats"] = command.addToMap();
+
+	command.command = &ManagementFunctions::dbStats;
+	command.syntax = "[${reset}]";
+	command.notes.push_back("Displays how many queries are waiting on the current channel and how long each kind of query takes");
+	command.notes.push_back("Also shows how many rows player saves write on average");
+	command.notes.push_back("With background saves on it shows the save queue, the journal and how long flushes take");
+	command.notes.push_back("Reset clears the timings");
+	sCommandList["dbstats"] = command.addToMap();
 	#pragma endregion
 
 	#pragma region GM Level 0
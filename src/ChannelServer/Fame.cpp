@@ -17,6 +17,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "Fame.hpp"
 #include "Common/Database.hpp"
+#include "Common/DatabaseExecutor.hpp"
 #include "Common/PacketReader.hpp"
 #include "ChannelServer/ChannelServer.hpp"
 #include "ChannelServer/FamePacket.hpp"
@@ -30,21 +31,51 @@ auto Fame::handleFame(ref_ptr_t<Player> player, PacketReader &reader) -> void {
 	player_id_t targetId = reader.get<player_id_t>();
 	uint8_t type = reader.get<uint8_t>();
 	if (targetId > 0) {
-		if (player->getId() == targetId) {
+		if (player->getId() == targetId || player->isFameCheckPending()) {
 			// Hacking
 			return;
 		}
-		int32_t checkResult = canFame(player, targetId);
-		if (checkResult != 0) {
-			player->send(Packets::Fame::sendError(checkResult));
+		if (player->getStats()->getLevel() < 15) {
+			player->send(Packets::Fame::sendError(Packets::Fame::Errors::LevelUnder15));
+			return;
+		}
+		if (ChannelServer::getInstance().getPlayerDataProvider().getPlayer(targetId) == nullptr) {
+			player->send(Packets::Fame::sendError(Packets::Fame::Errors::IncorrectUser));
+			return;
 		}
-		else {
-			auto famee = ChannelServer::getInstance().getPlayerDataProvider().getPlayer(targetId);
-			fame_t newFame = famee->getStats()->getFame() + (type == 1 ? 1 : -1);
-			famee->getStats()->setFame(newFame);
-			addFameLog(player->getId(), targetId);
-			player->send(Packets::Fame::sendFame(famee->getName(), type, newFame));
-			famee->send(Packets::Fame::receiveFame(player->getName(), type));
+
+		player_id_t from = player->getId();
+		const auto &config = ChannelServer::getInstance().getConfig();
+		int32_t fameTime = static_cast<int32_t>(config.fameTime.count());
+		int32_t fameResetTime = static_cast<int32_t>(config.fameResetTime.count());
+		auto check = [from, targetId, fameTime, fameResetTime] {
+			return checkAndLogFame(from, targetId, fameTime, fameResetTime);
+		};
+
+		// The log is written by the same query that checks it, so a second check can't get in between while this one's pending
+		view_ptr_t<Player> weakPlayer = player;
+		player->setFameCheckPending(true);
+		Result result = DatabaseExecutor::getInstance().query("fame check", check,
+			[weakPlayer, targetId, type](const pair_t<int32_t, int32_t> &checkResult) {
+				if (auto player = weakPlayer.lock()) {
+					player->setFameCheckPending(false);
+					applyFame(player, targetId, type, checkResult);
+				}
+				else if (checkResult.first == 0) {
+					// Nobody's left to give the fame
+					removeFameLog(checkResult.second);
+				}
+			},
+			[weakPlayer] {
+				if (auto player = weakPlayer.lock()) {
+					player->setFameCheckPending(false);
+				}
+			});
+
+		if (result == Result::Failure) {
+			// The database queue is full, fall back to checking here
+			player->setFameCheckPending(false);
+			applyFame(player, targetId, type, check());
 		}
 	}
 	else {
@@ -52,32 +83,63 @@ auto Fame::handleFame(ref_ptr_t<Player> player, PacketReader &reader) -> void {
 	}
 }
 
-auto Fame::canFame(ref_ptr_t<Player> player, player_id_t to) -> int32_t {
-	player_id_t from = player->getId();
-	if (player->getStats()->getLevel() < 15) {
-		return Packets::Fame::Errors::LevelUnder15;
+auto Fame::applyFame(ref_ptr_t<Player> player, player_id_t targetId, uint8_t type, const pair_t<int32_t, int32_t> &check) -> void {
+	if (check.first != 0) {
+		player->send(Packets::Fame::sendError(check.first));
+		return;
 	}
-	if (getLastFameLog(from) == SearchResult::Found) {
-		return Packets::Fame::Errors::AlreadyFamedToday;
+
+	auto famee = ChannelServer::getInstance().getPlayerDataProvider().getPlayer(targetId);
+	if (famee == nullptr) {
+		// Logged off while the check was running, the fame wasn't given so it doesn't count for the day
+		removeFameLog(check.second);
+		player->send(Packets::Fame::sendError(Packets::Fame::Errors::IncorrectUser));
+		return;
 	}
-	if (getLastFameSpLog(from, to) == SearchResult::Found) {
-		return Packets::Fame::Errors::FamedThisMonth;
+
+	fame_t newFame = famee->getStats()->getFame() + (type == 1 ? 1 : -1);
+	famee->getStats()->setFame(newFame);
+	player->send(Packets::Fame::sendFame(famee->getName(), type, newFame));
+	famee->send(Packets::Fame::receiveFame(player->getName(), type));
+}
+
+auto Fame::checkAndLogFame(player_id_t from, player_id_t to, int32_t fameTime, int32_t fameResetTime) -> pair_t<int32_t, int32_t> {
+	if (getLastFameLog(from, fameTime) == SearchResult::Found) {
+		return std::make_pair(static_cast<int32_t>(Packets::Fame::Errors::AlreadyFamedToday), 0);
+	}
+	if (getLastFameSpLog(from, to, fameResetTime) == SearchResult::Found) {
+		return std::make_pair(static_cast<int32_t>(Packets::Fame::Errors::FamedThisMonth), 0);
 	}
-	return 0;
+	return std::make_pair(0, addFameLog(from, to));
 }
 
-auto Fame::addFameLog(player_id_t from, player_id_t to) -> void {
+auto Fame::addFameLog(player_id_t from, player_id_t to) -> int32_t {
 	auto &db = Database::getCharDb();
-	auto &sql = db.getSession();
-	sql.once
-		<< "INSERT INTO " << db.makeTable("fame_log") << " (from_character_id, to_character_id, fame_time) "
-		<< "VALUES (:from, :to, NOW())",
-		soci::use(from, "from"),
-		soci::use(to, "to");
+	auto &fameLogAdd = db.prepareCommand<player_id_t, player_id_t>("fame log add", [&db](out_stream_t &query) {
+		query
+			<< "INSERT INTO " << db.makeTable("fame_log") << " (from_character_id, to_character_id, fame_time) "
+			<< "VALUES (:from, :to, NOW())";
+	});
+	fameLogAdd.execute(from, to);
+	return db.getLastId<int32_t>();
+}
+
+auto Fame::removeFameLog(int32_t fameId) -> void {
+	auto remove = [fameId] {
+		auto &db = Database::getCharDb();
+		auto &fameLogRemove = db.prepareCommand<int32_t>("fame log remove", [&db](out_stream_t &query) {
+			query << "DELETE FROM " << db.makeTable("fame_log") << " WHERE fame_id = :id";
+		});
+		fameLogRemove.execute(fameId);
+	};
+
+	if (DatabaseExecutor::getInstance().execute("fame log remove", remove) == Result::Failure) {
+		// The database queue is full, fall back to removing it here
+		remove();
+	}
 }
 
-auto Fame::getLastFameLog(player_id_t from) -> SearchResult {
-	int32_t fameTime = static_cast<int32_t>(ChannelServer::getInstance().getConfig().fameTime.count());
+auto Fame::getLastFameLog(player_id_t from, int32_t fameTime) -> SearchResult {
 	if (fameTime == 0) {
 		return SearchResult::Found;
 	}
@@ -86,25 +148,21 @@ auto Fame::getLastFameLog(player_id_t from) -> SearchResult {
 	}
 
 	auto &db = Database::getCharDb();
-	auto &sql = db.getSession();
-	optional_t<UnixTime> time;
-
-	sql.once
-		<< "SELECT fame_time "
-		<< "FROM " << db.makeTable("fame_log") << " "
-		<< "WHERE from_character_id = :from AND UNIX_TIMESTAMP(fame_time) > UNIX_TIMESTAMP() - :fameTime "
-		<< "ORDER BY fame_time DESC",
-		soci::use(from, "from"),
-		soci::use(fameTime, "fameTime"),
-		soci::into(time);
-
-	return time.is_initialized() ?
+	auto &lastFame = db.prepareQuery<player_id_t, int32_t>("fame log last", [&db](out_stream_t &query) {
+		query
+			<< "SELECT fame_time "
+			<< "FROM " << db.makeTable("fame_log") << " "
+			<< "WHERE from_character_id = :from AND UNIX_TIMESTAMP(fame_time) > UNIX_TIMESTAMP() - :fameTime "
+			<< "ORDER BY fame_time DESC "
+			<< "LIMIT 1";
+	});
+
+	return lastFame.execute(from, fameTime) ?
 		SearchResult::Found :
 		SearchResult::NotFound;
 }
 
-auto Fame::getLastFameSpLog(player_id_t from, player_id_t to) -> SearchResult {
-	int32_t fameResetTime = static_cast<int32_t>(ChannelServer::getInstance().getConfig().fameResetTime.count());
+auto Fame::getLastFameSpLog(player_id_t from, player_id_t to, int32_t fameResetTime) -> SearchResult {
 	if (fameResetTime == 0) {
 		return SearchResult::Found;
 	}
@@ -113,20 +171,16 @@ auto Fame::getLastFameSpLog(player_id_t from, player_id_t to) -> SearchResult {
 	}
 
 	auto &db = Database::getCharDb();
-	auto &sql = db.getSession();
-	optional_t<UnixTime> time;
-
-	sql.once
-		<< "SELECT fame_time "
-		<< "FROM " << db.makeTable("fame_log") << " "
-		<< "WHERE from_character_id = :from AND to_character_id = :to AND UNIX_TIMESTAMP(fame_time) > UNIX_TIMESTAMP() - :fameResetTime "
-		<< "ORDER BY fame_time DESC",
-		soci::use(from, "from"),
-		soci::use(to, "to"),
-		soci::use(fameResetTime, "fameResetTime"),
-		soci::into(time);
-
-	return time.is_initialized() ?
+	auto &lastFame = db.prepareQuery<player_id_t, player_id_t, int32_t>("fame log last to", [&db](out_stream_t &query) {
+		query
+			<< "SELECT fame_time "
+			<< "FROM " << db.makeTable("fame_log") << " "
+			<< "WHERE from_character_id = :from AND to_character_id = :to AND UNIX_TIMESTAMP(fame_time) > UNIX_TIMESTAMP() - :fameResetTime "
+			<< "ORDER BY fame_time DESC "
+			<< "LIMIT 1";
+	});
+
+	return lastFame.execute(from, to, fameResetTime) ?
 		SearchResult::Found :
 		SearchResult::NotFound;
 }
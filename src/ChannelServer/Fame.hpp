@@ -27,10 +27,14 @@ namespace Vana {
 
 		namespace Fame {
 			auto handleFame(ref_ptr_t<Player> player, PacketReader &reader) -> void;
-			auto canFame(ref_ptr_t<Player> player, player_id_t to) -> int32_t;
-			auto addFameLog(player_id_t from, player_id_t to) -> void;
-			auto getLastFameLog(player_id_t from) -> SearchResult;
-			auto getLastFameSpLog(player_id_t from, player_id_t to) -> SearchResult;
+			auto applyFame(ref_ptr_t<Player> player, player_id_t targetId, uint8_t type, const pair_t<int32_t, int32_t> &check) -> void;
+			// Database work only, safe to call off the handler strand
+			// Returns the error (0 if there's none) and the ID of the log it wrote
+			auto checkAndLogFame(player_id_t from, player_id_t to, int32_t fameTime, int32_t fameResetTime) -> pair_t<int32_t, int32_t>;
+			auto addFameLog(player_id_t from, player_id_t to) -> int32_t;
+			auto removeFameLog(int32_t fameId) -> void;
+			auto getLastFameLog(player_id_t from, int32_t fameTime) -> SearchResult;
+			auto getLastFameSpLog(player_id_t from, player_id_t to, int32_t fameResetTime) -> SearchResult;
 		}
 	}
 }
\ No newline at end of file
@@ -17,6 +17,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "InfoFunctions.hpp"
 #include "Common/Database.hpp"
+#include "Common/DatabaseExecutor.hpp"
 #include "Common/MapPosition.hpp"
 #include "ChannelServer/ChannelServer.hpp"
 #include "ChannelServer/Maps.hpp"
@@ -95,27 +96,45 @@ auto InfoFunctions::lookup(ref_ptr_t<Player> player, const chat_t &args) -> Chat
 			return ChatResult::HandledDisplay;
 		};
 
-		auto &db = Database::getDataDb();
-		auto &sql = db.getSession();
-		auto displayFunc = [&sql, &player](const soci::rowset<> &rs, function_t<void(const soci::row &row, out_stream_t &str)> formatMessage, const string_t &query) {
-			// Bug in the behavior of SOCI
-			// In the case where you use dynamic resultset binding, got_data() will not properly report that it got results
-
-			ChatHandlerFunctions::showInfo(player, "Search for '" + query + "'");
+		auto displayFunc = [&player](function_t<soci::rowset<>(Database &db, soci::session &sql)> runQuery, function_t<void(const soci::row &row, out_stream_t &str)> formatMessage, const string_t &query) {
+			// The search runs against the data database off the handler strand, the results come back once it's done
+			view_ptr_t<Player> weakPlayer = player;
+			Result result = DatabaseExecutor::getInstance().query("lookup",
+				[runQuery, formatMessage]() -> vector_t<string_t> {
+					auto &db = Database::getDataDb();
+					soci::rowset<> rs = runQuery(db, db.getSession());
+
+					// Bug in the behavior of SOCI
+					// In the case where you use dynamic resultset binding, got_data() will not properly report that it got results
+
+					vector_t<string_t> lines;
+					out_stream_t str{""};
+					for (const auto &row : rs) {
+						str.str("");
+						str.clear();
+						formatMessage(row, str);
+						lines.push_back(str.str());
+					}
+					return lines;
+				},
+				[weakPlayer, query](const vector_t<string_t> &lines) {
+					auto player = weakPlayer.lock();
+					if (player == nullptr) {
+						return;
+					}
 
-			out_stream_t str{""};
-			bool found = false;
-			for (const auto &row : rs) {
-				found = true;
+					ChatHandlerFunctions::showInfo(player, "Search for '" + query + "'");
+					for (const auto &line : lines) {
+						ChatHandlerFunctions::showInfo(player, line);
+					}
 
-				str.str("");
-				str.clear();
-				formatMessage(row, str);
-				ChatHandlerFunctions::showInfo(player, str.str());
-			}
+					if (lines.size() == 0) {
+						ChatHandlerFunctions::showError(player, "No results");
+					}
+				});
 
-			if (!found) {
-				ChatHandlerFunctions::showError(player, "No results");
+			if (result == Result::Failure) {
+				ChatHandlerFunctions::showError(player, "The database is busy, try again later");
 			}
 		};
 
@@ -131,27 +150,31 @@ auto InfoFunctions::lookup(ref_ptr_t<Player> player, const chat_t &args) -> Chat
 
 			if (type == 1 && subType != 0) {
 				q = "%" + q + "%";
-				soci::rowset<> rs = (sql.prepare
-					<< "SELECT s.objectid, s.`label` "
-					<< "FROM " << db.makeTable("strings") << " s "
-					<< "INNER JOIN " << db.makeTable("item_data") << " i ON s.objectid = i.itemid "
-					<< "WHERE s.object_type = :type AND s.label LIKE :q AND i.inventory = :subtype",
-					soci::use(q, "q"),
-					soci::use(type, "type"),
-					soci::use(subType, "subtype"));
-
-				displayFunc(rs, format, matches[2]);
+				auto runQuery = [q, type, subType](Database &db, soci::session &sql) -> soci::rowset<> {
+					return (sql.prepare
+						<< "SELECT s.objectid, s.`label` "
+						<< "FROM " << db.makeTable("strings") << " s "
+						<< "INNER JOIN " << db.makeTable("item_data") << " i ON s.objectid = i.itemid "
+						<< "WHERE s.object_type = :type AND s.label LIKE :q AND i.inventory = :subtype",
+						soci::use(q, "q"),
+						soci::use(type, "type"),
+						soci::use(subType, "subtype"));
+				};
+
+				displayFunc(runQuery, format, matches[2]);
 			}
 			else {
 				q = "%" + q + "%";
-				soci::rowset<> rs = (sql.prepare
-					<< "SELECT objectid, `label` "
-					<< "FROM " << db.makeTable("strings") << " "
-					<< "WHERE object_type = :type AND label LIKE :q",
-					soci::use(q, "q"),
-					soci::use(type, "type"));
-
-				displayFunc(rs, format, matches[2]);
+				auto runQuery = [q, type](Database &db, soci::session &sql) -> soci::rowset<> {
+					return (sql.prepare
+						<< "SELECT objectid, `label` "
+						<< "FROM " << db.makeTable("strings") << " "
+						<< "WHERE object_type = :type AND label LIKE :q",
+						soci::use(q, "q"),
+						soci::use(type, "type"));
+				};
+
+				displayFunc(runQuery, format, matches[2]);
 			}
 		}
 		else if (rawType == "id") {
@@ -167,8 +190,10 @@ auto InfoFunctions::lookup(ref_ptr_t<Player> player, const chat_t &args) -> Chat
 				str << row.get<int32_t>(0) << " (" << row.get<string_t>(2) << ") : " << row.get<string_t>(1);
 			};
 
-			soci::rowset<> rs = (sql.prepare << "SELECT objectid, `label`, object_type FROM " << db.makeTable("strings") << " WHERE objectid = :q", soci::use(q, "q"));
-			displayFunc(rs, format, matches[2]);
+			auto runQuery = [q](Database &db, soci::session &sql) -> soci::rowset<> {
+				return (sql.prepare << "SELECT objectid, `label`, object_type FROM " << db.makeTable("strings") << " WHERE objectid = :q", soci::use(q, "q"));
+			};
+			displayFunc(runQuery, format, matches[2]);
 		}
 		else if (rawType == "continent") {
 			string_t rawMap = matches[2];
@@ -202,15 +227,19 @@ auto InfoFunctions::lookup(ref_ptr_t<Player> player, const chat_t &args) -> Chat
 			}
 			if (rawType == "scriptbyname") {
 				q = "%" + q + "%";
-				soci::rowset<> rs = (sql.prepare << "SELECT script_type, objectid, script FROM " << db.makeTable("scripts") << " WHERE script LIKE :q", soci::use(q, "q"));
-				displayFunc(rs, format, matches[2]);
+				auto runQuery = [q](Database &db, soci::session &sql) -> soci::rowset<> {
+					return (sql.prepare << "SELECT script_type, objectid, script FROM " << db.makeTable("scripts") << " WHERE script LIKE :q", soci::use(q, "q"));
+				};
+				displayFunc(runQuery, format, matches[2]);
 			}
 			else if (rawType == "scriptbyid") {
 				if (!isIntegerString(q)) {
 					return shouldBeIdOnly("scriptbyid", q);
 				}
-				soci::rowset<> rs = (sql.prepare << "SELECT script_type, objectid, script FROM " << db.makeTable("scripts") << " WHERE objectid = :q", soci::use(q, "q"));
-				displayFunc(rs, format, matches[2]);
+				auto runQuery = [q](Database &db, soci::session &sql) -> soci::rowset<> {
+					return (sql.prepare << "SELECT script_type, objectid, script FROM " << db.makeTable("scripts") << " WHERE objectid = :q", soci::use(q, "q"));
+				};
+				displayFunc(runQuery, format, matches[2]);
 			}
 		}
 		else if (rawType == "whatdrops") {
@@ -226,19 +255,21 @@ auto InfoFunctions::lookup(ref_ptr_t<Player> player, const chat_t &args) -> Chat
 				return shouldBeIdOnly("whatdrops", q);
 			}
 
-			soci::rowset<> rs = (sql.prepare
-				<< "SELECT d.dropperid, s.label "
-				<< "FROM " << db.makeTable("drop_data") << " d "
-				<< "INNER JOIN " << db.makeTable("strings") << " s ON s.objectid = d.dropperid AND s.object_type = 'mob' "
-				<< "WHERE d.dropperid NOT IN (SELECT DISTINCT dropperid FROM " << db.makeTable("user_drop_data") << ") AND d.itemid = :q "
-				<< "UNION ALL "
-				<< "SELECT d.dropperid, s.label "
-				<< "FROM " << db.makeTable("user_drop_data") << " d "
-				<< "INNER JOIN " << db.makeTable("strings") << " s ON s.objectid = d.dropperid AND s.object_type = 'mob' "
-				<< "WHERE d.itemid = :q ",
-				soci::use(q, "q"));
-
-			displayFunc(rs, format, matches[2]);
+			auto runQuery = [q](Database &db, soci::session &sql) -> soci::rowset<> {
+				return (sql.prepare
+					<< "SELECT d.dropperid, s.label "
+					<< "FROM " << db.makeTable("drop_data") << " d "
+					<< "INNER JOIN " << db.makeTable("strings") << " s ON s.objectid = d.dropperid AND s.object_type = 'mob' "
+					<< "WHERE d.dropperid NOT IN (SELECT DISTINCT dropperid FROM " << db.makeTable("user_drop_data") << ") AND d.itemid = :q "
+					<< "UNION ALL "
+					<< "SELECT d.dropperid, s.label "
+					<< "FROM " << db.makeTable("user_drop_data") << " d "
+					<< "INNER JOIN " << db.makeTable("strings") << " s ON s.objectid = d.dropperid AND s.object_type = 'mob' "
+					<< "WHERE d.itemid = :q ",
+					soci::use(q, "q"));
+			};
+
+			displayFunc(runQuery, format, matches[2]);
 		}
 		else if (rawType == "whatmaps") {
 			string_t q = matches[2];
@@ -253,18 +284,20 @@ auto InfoFunctions::lookup(ref_ptr_t<Player> player, const chat_t &args) -> Chat
 				string_t option = matches[1];
 				string_t test = matches[2];
 				if (option == "portal") {
-					soci::rowset<> rs = (sql.prepare
-						<< "SELECT m.mapid, s.label "
-						<< "FROM " << db.makeTable("map_data") << " m "
-						<< "INNER JOIN " << db.makeTable("strings") << " s ON s.objectid = m.mapid AND s.object_type = 'map' "
-						<< "WHERE m.mapid IN ("
-						<< "	SELECT mp.mapid "
-						<< "	FROM " << db.makeTable("map_portals") << " mp "
-						<< "	WHERE mp.script = :query "
-						<< ")",
-						soci::use(test, "query"));
-
-					displayFunc(rs, format, matches[2]);
+					auto runQuery = [test](Database &db, soci::session &sql) -> soci::rowset<> {
+						return (sql.prepare
+							<< "SELECT m.mapid, s.label "
+							<< "FROM " << db.makeTable("map_data") << " m "
+							<< "INNER JOIN " << db.makeTable("strings") << " s ON s.objectid = m.mapid AND s.object_type = 'map' "
+							<< "WHERE m.mapid IN ("
+							<< "	SELECT mp.mapid "
+							<< "	FROM " << db.makeTable("map_portals") << " mp "
+							<< "	WHERE mp.script = :query "
+							<< ")",
+							soci::use(test, "query"));
+					};
+
+					displayFunc(runQuery, format, matches[2]);
 				}
 				else if (option == "npc" || option == "mob" || option == "reactor") {
 					if (!isIntegerString(test)) {
@@ -273,19 +306,21 @@ auto InfoFunctions::lookup(ref_ptr_t<Player> player, const chat_t &args) -> Chat
 
 					option = " AND ml.life_type = '" + option + "'";
 
-					soci::rowset<> rs = (sql.prepare
-						<< "SELECT m.mapid, s.label "
-						<< "FROM " << db.makeTable("map_data") << " m "
-						<< "INNER JOIN " << db.makeTable("strings") << " s ON s.objectid = m.mapid AND s.object_type = 'map' "
-						<< "WHERE m.mapid IN ("
-						<< "	SELECT ml.mapid "
-						<< "	FROM " << db.makeTable("map_life") << " ml "
-						<< "	WHERE ml.lifeid = :objectId "
-						<< "	" << option
-						<< ")",
-						soci::use(test, "objectId"));
-
-					displayFunc(rs, format, matches[2]);
+					auto runQuery = [test, option](Database &db, soci::session &sql) -> soci::rowset<> {
+						return (sql.prepare
+							<< "SELECT m.mapid, s.label "
+							<< "FROM " << db.makeTable("map_data") << " m "
+							<< "INNER JOIN " << db.makeTable("strings") << " s ON s.objectid = m.mapid AND s.object_type = 'map' "
+							<< "WHERE m.mapid IN ("
+							<< "	SELECT ml.mapid "
+							<< "	FROM " << db.makeTable("map_life") << " ml "
+							<< "	WHERE ml.lifeid = :objectId "
+							<< "	" << option
+							<< ")",
+							soci::use(test, "objectId"));
+					};
+
+					displayFunc(runQuery, format, matches[2]);
 				}
 				else {
 					ChatHandlerFunctions::showError(player, "Invalid life type: " + option);
@@ -307,13 +342,15 @@ auto InfoFunctions::lookup(ref_ptr_t<Player> player, const chat_t &args) -> Chat
 				return requiresSecondArgument(rawType);
 			}
 			q = "%" + q + "%";
-			soci::rowset<> rs = (sql.prepare
-				<< "SELECT DISTINCT m.default_bgm "
-				<< "FROM " << db.makeTable("map_data") << " m "
-				<< "WHERE m.default_bgm LIKE :q",
-				soci::use(q, "q"));
+			auto runQuery = [q](Database &db, soci::session &sql) -> soci::rowset<> {
+				return (sql.prepare
+					<< "SELECT DISTINCT m.default_bgm "
+					<< "FROM " << db.makeTable("map_data") << " m "
+					<< "WHERE m.default_bgm LIKE :q",
+					soci::use(q, "q"));
+			};
 
-			displayFunc(rs, format, matches[2]);
+			displayFunc(runQuery, format, matches[2]);
 		}
 		else if (rawType == "drops") {
 			auto format = [](const soci::row &row, out_stream_t &str) {
@@ -328,20 +365,22 @@ auto InfoFunctions::lookup(ref_ptr_t<Player> player, const chat_t &args) -> Chat
 				return shouldBeIdOnly("drops", q);
 			}
 
-			soci::rowset<> rs = (sql.prepare
-				<< "SELECT d.itemid, s.label, d.chance "
-				<< "FROM " << db.makeTable("drop_data") << " d "
-				<< "INNER JOIN " << db.makeTable("strings") << " s ON s.objectid = d.itemid AND s.object_type = 'item' "
-				<< "WHERE d.dropperid NOT IN (SELECT DISTINCT dropperid FROM " << db.makeTable("user_drop_data") << ") AND d.dropperid = :q "
-				<< "UNION ALL "
-				<< "SELECT d.itemid, s.label, d.chance "
-				<< "FROM " << db.makeTable("user_drop_data") << " d "
-				<< "INNER JOIN " << db.makeTable("strings") << " s ON s.objectid = d.itemid AND s.object_type = 'item' "
-				<< "WHERE d.dropperid = :q "
-				<< "ORDER BY itemid",
-				soci::use(q, "q"));
-
-			displayFunc(rs, format, matches[2]);
+			auto runQuery = [q](Database &db, soci::session &sql) -> soci::rowset<> {
+				return (sql.prepare
+					<< "SELECT d.itemid, s.label, d.chance "
+					<< "FROM " << db.makeTable("drop_data") << " d "
+					<< "INNER JOIN " << db.makeTable("strings") << " s ON s.objectid = d.itemid AND s.object_type = 'item' "
+					<< "WHERE d.dropperid NOT IN (SELECT DISTINCT dropperid FROM " << db.makeTable("user_drop_data") << ") AND d.dropperid = :q "
+					<< "UNION ALL "
+					<< "SELECT d.itemid, s.label, d.chance "
+					<< "FROM " << db.makeTable("user_drop_data") << " d "
+					<< "INNER JOIN " << db.makeTable("strings") << " s ON s.objectid = d.itemid AND s.object_type = 'item' "
+					<< "WHERE d.dropperid = :q "
+					<< "ORDER BY itemid",
+					soci::use(q, "q"));
+			};
+
+			displayFunc(runQuery, format, matches[2]);
 		}
 		else {
 			ChatHandlerFunctions::showError(player, "Invalid search type: " + rawType);
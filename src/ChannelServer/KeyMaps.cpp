@@ -72,9 +72,12 @@ auto KeyMaps::load(player_id_t charId) -> void {
 		<< "WHERE k.character_id = :char",
 		soci::use(charId, "char"));
 
+	RowTracker<int32_t, row_t>::rows_t savedKeys;
 	for (const auto &row : rs) {
-		add(row.get<int32_t>("pos"), KeyMap{static_cast<KeyMapType>(row.get<int8_t>("type")), row.get<int32_t>("action")});
+		savedKeys[row.get<int32_t>("pos")] = row_t{row.get<int8_t>("type"), row.get<int32_t>("action")};
 	}
+	load(savedKeys);
+
 	if (getMax() == -1) {
 		// No keymaps, set default map
 		defaultMap();
@@ -82,35 +85,75 @@ auto KeyMaps::load(player_id_t charId) -> void {
 	}
 }
 
+auto KeyMaps::load(const RowTracker<int32_t, row_t>::rows_t &keys) -> void {
+	for (const auto &kvp : keys) {
+		add(kvp.first, KeyMap{static_cast<KeyMapType>(kvp.second.first), kvp.second.second});
+	}
+	m_savedKeys.commit(keys);
+}
+
 auto KeyMaps::save(player_id_t charId) -> void {
-	size_t i = 0;
-	int8_t type = 0;
-	int32_t action = 0;
+	int32_t pos = 0;
 
 	auto &db = Database::getCharDb();
 	auto &sql = db.getSession();
 
-	sql.once
-		<< "DELETE FROM " << db.makeTable("keymap") << " "
-		<< "WHERE character_id = :char",
-		soci::use(charId, "char");
-
-	soci::statement st = (sql.prepare
-		<< "INSERT INTO " << db.makeTable("keymap") << " "
-		<< "VALUES (:char, :key, :type, :action)",
-		soci::use(charId, "char"),
-		soci::use(i, "key"),
-		soci::use(type, "type"),
-		soci::use(action, "action"));
-
-	for (i = 0; i < KeyMaps::KeyCount; i++) {
-		KeyMap *keymap = getKeyMap(i);
-		if (keymap != nullptr) {
-			type = static_cast<int8_t>(keymap->type);
-			action = keymap->action;
+	// Only the keys bound since the last save are written
+	auto keys = getRows();
+	if (m_savedKeys.isTracking()) {
+		auto removed = m_savedKeys.getRemoved(keys);
+		if (removed.size() > 0) {
+			soci::statement st = (sql.prepare
+				<< "DELETE FROM " << db.makeTable("keymap") << " "
+				<< "WHERE character_id = :char AND pos = :key",
+				soci::use(charId, "char"),
+				soci::use(pos, "key"));
+
+			for (int32_t removedPos : removed) {
+				pos = removedPos;
+				st.execute(true);
+			}
+		}
+	}
+	else {
+		sql.once
+			<< "DELETE FROM " << db.makeTable("keymap") << " "
+			<< "WHERE character_id = :char",
+			soci::use(charId, "char");
+	}
+
+	auto changed = m_savedKeys.getChanged(keys);
+	if (changed.size() > 0) {
+		int8_t type = 0;
+		int32_t action = 0;
+
+		soci::statement st = (sql.prepare
+			<< "REPLACE INTO " << db.makeTable("keymap") << " "
+			<< "VALUES (:char, :key, :type, :action)",
+			soci::use(charId, "char"),
+			soci::use(pos, "key"),
+			soci::use(type, "type"),
+			soci::use(action, "action"));
+
+		for (int32_t changedPos : changed) {
+			pos = changedPos;
+			type = keys[changedPos].first;
+			action = keys[changedPos].second;
 			st.execute(true);
 		}
 	}
+	m_savedKeys.commit(std::move(keys));
+}
+
+auto KeyMaps::getRows() -> RowTracker<int32_t, row_t>::rows_t {
+	RowTracker<int32_t, row_t>::rows_t rows;
+	for (size_t i = 0; i < KeyMaps::KeyCount; i++) {
+		KeyMap *keymap = getKeyMap(static_cast<int32_t>(i));
+		if (keymap != nullptr) {
+			rows[static_cast<int32_t>(i)] = row_t{static_cast<int8_t>(keymap->type), keymap->action};
+		}
+	}
+	return rows;
 }
 
 }
@@ -17,6 +17,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #pragma once
 
+#include "Common/RowTracker.hpp"
 #include "Common/Types.hpp"
 #include "ChannelServer/KeyMapAction.hpp"
 #include "ChannelServer/KeyMapKey.hpp"
@@ -29,6 +30,8 @@ namespace Vana {
 			NONCOPYABLE(KeyMaps);
 		public:
 			struct KeyMap;
+			// Type and action
+			using row_t = pair_t<int8_t, int32_t>;
 
 			KeyMaps() = default;
 
@@ -39,12 +42,16 @@ namespace Vana {
 			auto getMax() -> int32_t;
 
 			auto load(player_id_t charId) -> void;
+			// Takes keys that are already saved, e.g. ones handed over by another channel
+			auto load(const RowTracker<int32_t, row_t>::rows_t &keys) -> void;
 			auto save(player_id_t charId) -> void;
+			auto getRows() -> RowTracker<int32_t, row_t>::rows_t;
 
 			static const size_t KeyCount = 90;
 		private:
 			hash_map_t<int32_t, KeyMap> m_keyMaps;
 			int32_t m_maxValue = -1; // Cache max value
+			RowTracker<int32_t, row_t> m_savedKeys;
 		};
 
 		struct KeyMaps::KeyMap {
@@ -17,14 +17,20 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "ManagementFunctions.hpp"
 #include "Common/Database.hpp"
+#include "Common/DatabaseExecutor.hpp"
 #include "Common/ExitCodes.hpp"
 #include "Common/ItemConstants.hpp"
 #include "Common/ItemDataProvider.hpp"
+#include "Common/OpcodeStats.hpp"
 #include "Common/RatesConfig.hpp"
+#include "Common/SessionStats.hpp"
 #include "Common/StringUtilities.hpp"
+#include "Common/ThreadPool.hpp"
+#include "Common/TimeUtilities.hpp"
 #include "ChannelServer/ChannelServer.hpp"
 #include "ChannelServer/Inventory.hpp"
 #include "ChannelServer/Maps.hpp"
+#include "ChannelServer/MapTickScheduler.hpp"
 #include "ChannelServer/MysticDoor.hpp"
 #include "ChannelServer/NpcHandler.hpp"
 #include "ChannelServer/Player.hpp"
@@ -32,6 +38,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "ChannelServer/PlayerPacket.hpp"
 #include "ChannelServer/SyncPacket.hpp"
 #include "ChannelServer/WorldServerPacket.hpp"
+#include <algorithm>
+#include <iomanip>
 
 namespace Vana {
 namespace ChannelServer {
@@ -815,5 +823,212 @@ auto ManagementFunctions::rates(ref_ptr_t<Player> player, const chat_t &args) ->
 	return ChatResult::HandledDisplay;
 }
 
+auto ManagementFunctions::opcodeStats(ref_ptr_t<Player> player, const chat_t &args) -> ChatResult {
+	match_t matches;
+	string_t type = "handled";
+	size_t count = 10;
+	if (!args.empty()) {
+		if (ChatHandlerFunctions::runRegexPattern(args, R"((\w+) ?(\d+)?)", matches) == MatchResult::NoMatches) {
+			return ChatResult::ShowSyntax;
+		}
+		type = matches[1];
+		string_t rawCount = matches[2];
+		if (!rawCount.empty()) {
+			count = StringUtilities::lexical_cast<size_t>(rawCount);
+		}
+	}
+
+	auto &server = ChannelServer::getInstance();
+	auto &stats = server.getOpcodeStats();
+	if (type == "reset") {
+		stats.reset();
+		ChatHandlerFunctions::showInfo(player, "Reset the opcode stats");
+		return ChatResult::HandledDisplay;
+	}
+	if (type == "write") {
+		if (server.writeOpcodeStats()) {
+			ChatHandlerFunctions::showInfo(player, "Wrote the opcode stats");
+		}
+		else {
+			ChatHandlerFunctions::showError(player, "Unable to write the opcode stats");
+		}
+		return ChatResult::HandledDisplay;
+	}
+
+	auto formatOpcode = [](header_t opcode) -> string_t {
+		out_stream_t str;
+		str << "0x" << std::hex << std::setw(4) << std::setfill('0') << opcode;
+		return str.str();
+	};
+
+	auto elapsed = TimeUtilities::getDistance<seconds_t>(TimeUtilities::getNow(), stats.getResetTime());
+	if (type == "handled") {
+		auto handled = stats.getHandled();
+		std::sort(std::begin(handled), std::end(handled), [](const OpcodeStats::Summary &a, const OpcodeStats::Summary &b) { return a.totalTime > b.totalTime; });
+		ChatHandlerFunctions::showInfo(player, "Handler time by opcode over the last " + StringUtilities::lexical_cast<string_t>(elapsed) + " seconds");
+		for (size_t i = 0; i < handled.size() && i < count; ++i) {
+			const auto &summary = handled[i];
+			out_stream_t line;
+			line << formatOpcode(summary.opcode) << ": " << summary.calls << " calls, "
+				<< summary.bytes << " bytes, "
+				<< duration_cast<milliseconds_t>(summary.totalTime).count() << "ms total, "
+				<< summary.totalTime.count() / static_cast<int64_t>(summary.calls) << "us avg, "
+				<< summary.p99Time.count() << "us p99, "
+				<< summary.maxTime.count() << "us max";
+			ChatHandlerFunctions::showInfo(player, line.str());
+		}
+		return ChatResult::HandledDisplay;
+	}
+	if (type == "sent") {
+		auto sent = stats.getSent();
+		std::sort(std::begin(sent), std::end(sent), [](const OpcodeStats::Summary &a, const OpcodeStats::Summary &b) { return a.bytes > b.bytes; });
+		ChatHandlerFunctions::showInfo(player, "Outbound bytes by opcode over the last " + StringUtilities::lexical_cast<string_t>(elapsed) + " seconds");
+		for (size_t i = 0; i < sent.size() && i < count; ++i) {
+			const auto &summary = sent[i];
+			out_stream_t line;
+			line << formatOpcode(summary.opcode) << ": " << summary.calls << " packets, " << summary.bytes << " bytes";
+			ChatHandlerFunctions::showInfo(player, line.str());
+		}
+		return ChatResult::HandledDisplay;
+	}
+	if (type == "sessions") {
+		auto connections = server.getConnectionStats();
+		const SessionStats &totals = connections.totals;
+		ChatHandlerFunctions::showInfo(player, "Sessions: " + StringUtilities::lexical_cast<string_t>(connections.sessions) + " connected, " + StringUtilities::lexical_cast<string_t>(connections.sendLimitDisconnects) + " disconnected for send limits");
+
+		out_stream_t traffic;
+		traffic << "Traffic: "
+			<< totals.packetsSent << " packets (" << totals.bytesSent << " bytes) sent in " << totals.writes << " writes, "
+			<< totals.packetsReceived << " packets (" << totals.bytesReceived << " bytes) received in " << totals.reads << " reads";
+		ChatHandlerFunctions::showInfo(player, traffic.str());
+
+		out_stream_t queues;
+		queues << "Send queues: "
+			<< totals.queuedPackets << " packets (" << totals.queuedBytes << " bytes) queued, "
+			<< totals.peakQueuedBytes << " bytes peak, "
+			<< totals.packetsDropped << " packets dropped";
+		ChatHandlerFunctions::showInfo(player, queues.str());
+		return ChatResult::HandledDisplay;
+	}
+	return ChatResult::ShowSyntax;
+}
+auto ManagementFunctions::mapTickStats(ref_ptr_t<Player> player, const chat_t &args) -> ChatResult {
+	auto &scheduler = ChannelServer::getInstance().getMapTickScheduler();
+	if (args == "reset") {
+		scheduler.resetStats();
+		ChatHandlerFunctions::showInfo(player, "Reset the map tick stats");
+		return ChatResult::HandledDisplay;
+	}
+	if (!args.empty()) {
+		return ChatResult::ShowSyntax;
+	}
+
+	auto stats = scheduler.getStats();
+	ChatHandlerFunctions::showInfo(player, "Maps: " + StringUtilities::lexical_cast<string_t>(stats.activeMaps) + " active, " + StringUtilities::lexical_cast<string_t>(stats.parkedMaps) + " parked");
+
+	out_stream_t line;
+	line << "Ticks: " << stats.ticks << " sweeps, "
+		<< stats.mapsTicked << " map ticks, "
+		<< stats.lastTime.count() << "us last, "
+		<< (stats.ticks > 0 ? stats.totalTime.count() / static_cast<int64_t>(stats.ticks) : 0) << "us avg, "
+		<< stats.maxTime.count() << "us max";
+	ChatHandlerFunctions::showInfo(player, line.str());
+	return ChatResult::HandledDisplay;
+}
+
+auto ManagementFunctions::taskStats(ref_ptr_t<Player> player, const chat_t &args) -> ChatResult {
+	auto stats = ThreadPool::getTaskStats();
+	ChatHandlerFunctions::showInfo(player, "Tasks: " + StringUtilities::lexical_cast<string_t>(stats.workers) + " workers, " + StringUtilities::lexical_cast<string_t>(stats.queued) + " queued, " + StringUtilities::lexical_cast<string_t>(stats.peakQueued) + " peak queued");
+
+	int64_t completed = std::max<int64_t>(static_cast<int64_t>(stats.completed), 1);
+	out_stream_t counts;
+	counts << "Submitted: " << stats.submitted << ", "
+		<< stats.completed << " completed, "
+		<< stats.stolen << " stolen, "
+		<< stats.ranInline << " ran inline";
+	ChatHandlerFunctions::showInfo(player, counts.str());
+
+	out_stream_t times;
+	times << "Latency: "
+		<< stats.totalWait.count() / completed << "us avg wait, "
+		<< stats.maxWait.count() << "us max wait, "
+		<< stats.totalRun.count() / completed << "us avg run, "
+		<< stats.maxRun.count() << "us max run";
+	ChatHandlerFunctions::showInfo(player, times.str());
+	return ChatResult::HandledDisplay;
+}
+
+auto ManagementFunctions::dbStats(ref_ptr_t<Player> player, const chat_t &args) -> ChatResult {
+	auto &executor = DatabaseExecutor::getInstance();
+	auto &saveStats = ChannelServer::getInstance().getSaveStats();
+	auto &persistence = ChannelServer::getInstance().getPersistence();
+	if (args == "reset") {
+		executor.resetStats();
+		saveStats.resetStats();
+		persistence.resetStats();
+		ChatHandlerFunctions::showInfo(player, "Reset the database stats");
+		return ChatResult::HandledDisplay;
+	}
+	if (!args.empty()) {
+		return ChatResult::ShowSyntax;
+	}
+
+	auto stats = executor.getStats();
+	ChatHandlerFunctions::showInfo(player, "Database: " + StringUtilities::lexical_cast<string_t>(executor.getQueued()) + " queued");
+
+	auto saves = saveStats.getStats();
+	int64_t saveCount = std::max<int64_t>(static_cast<int64_t>(saves.saves), 1);
+	out_stream_t saveLine;
+	saveLine << "Player saves: " << saves.saves << " saves, "
+		<< saves.rowsWritten / static_cast<uint64_t>(saveCount) << " avg rows, "
+		<< saves.maxRows << " max rows, "
+		<< saves.lastRows << " last rows, "
+		<< saves.totalTime.count() / saveCount << "us avg, "
+		<< saves.maxTime.count() << "us max";
+	ChatHandlerFunctions::showInfo(player, saveLine.str());
+
+	if (persistence.isWriteBehind()) {
+		auto queued = persistence.getStats();
+		int64_t flushCount = std::max<int64_t>(static_cast<int64_t>(queued.flushes), 1);
+		out_stream_t queueLine;
+		queueLine << "Background saves: " << queued.queued << " queued, "
+			<< queued.journalBytes << " journal bytes, "
+			<< queued.queuedSaves << " saves, "
+			<< queued.coalesced << " coalesced, "
+			<< queued.flushes << " flushes, "
+			<< queued.flushedSaves << " written, "
+			<< queued.failures << " failed, "
+			<< queued.lastBatch << " last batch, "
+			<< queued.totalFlush.count() / flushCount << "us avg flush, "
+			<< queued.maxFlush.count() << "us max flush";
+		ChatHandlerFunctions::showInfo(player, queueLine.str());
+	}
+
+	auto statements = Database::getStatementStats();
+	ChatHandlerFunctions::showInfo(player, "Prepared statements: " + StringUtilities::lexical_cast<string_t>(statements.prepared) + " prepared, " + StringUtilities::lexical_cast<string_t>(statements.executed) + " executed");
+	if (stats.size() == 0) {
+		ChatHandlerFunctions::showInfo(player, "No queries have run yet");
+		return ChatResult::HandledDisplay;
+	}
+
+	std::sort(std::begin(stats), std::end(stats), [](const DatabaseExecutor::QueryStats &a, const DatabaseExecutor::QueryStats &b) {
+		return a.totalTime > b.totalTime;
+	});
+
+	for (const auto &query : stats) {
+		int64_t calls = std::max<int64_t>(static_cast<int64_t>(query.calls), 1);
+		out_stream_t line;
+		line << query.type << ": "
+			<< query.calls << " calls, "
+			<< query.failures << " failed, "
+			<< query.rejected << " rejected, "
+			<< query.totalWait.count() / calls << "us avg wait, "
+			<< query.totalTime.count() / calls << "us avg, "
+			<< query.maxTime.count() << "us max";
+		ChatHandlerFunctions::showInfo(player, line.str());
+	}
+	return ChatResult::HandledDisplay;
+}
+
 }
 }
\ No newline at end of file
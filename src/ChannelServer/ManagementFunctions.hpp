@@ -48,6 +48,10 @@ namespace Vana {
 			auto unban(ref_ptr_t<Player> player, const chat_t &args) -> ChatResult;
 			auto rehash(ref_ptr_t<Player> player, const chat_t &args) -> ChatResult;
 			auto rates(ref_ptr_t<Player> player, const chat_t &args) -> ChatResult;
+			auto opcodeStats(ref_ptr_t<Player> player, const chat_t &args) -> ChatResult;
+			auto mapTickStats(ref_ptr_t<Player> player, const chat_t &args) -> ChatResult;
+			auto taskStats(ref_ptr_t<Player> player, const chat_t &args) -> ChatResult;
+			auto dbStats(ref_ptr_t<Player> player, const chat_t &args) -> ChatResult;
 		}
 	}
 }
\ No newline at end of file
@@ -17,6 +17,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "Map.hpp"
 #include "Common/Algorithm.hpp"
+#include "Common/BroadcastPacket.hpp"
 #include "Common/GameLogicUtilities.hpp"
 #include "Common/MiscUtilities.hpp"
 #include "Common/MobConstants.hpp"
@@ -69,11 +70,8 @@ Map::Map(ref_ptr_t<MapInfo> info, map_id_t id) :
 	m_objectIds{1000},
 	m_music{info->defaultMusic}
 {
-	// Dynamic loading, start the map timer once the object is created
-	Vana::Timer::Timer::create(
-		[this](const time_point_t &now) { this->mapTick(now); },
-		Vana::Timer::Id{TimerType::MapTimer, id},
-		getTimers(), seconds_t{0}, seconds_t{1});
+	// Dynamic loading, the map starts ticking once the object is created
+	ChannelServer::getInstance().getMapTickScheduler().add(this);
 
 	Point rightBottom = info->dimensions.rightBottom();
 	double mapHeight = std::max<double>(rightBottom.y - 450, 600);
@@ -81,12 +79,17 @@ Map::Map(ref_ptr_t<MapInfo> info, map_id_t id) :
 	m_minSpawnCount = ext::constrain_range(static_cast<int32_t>((mapHeight * mapWidth * info->spawnRate) / 128000.), 1, 40);
 	m_maxSpawnCount = m_minSpawnCount * 2;
 	m_runUnloader = info->shipKind == -1;
+	m_worker = ChannelServer::getInstance().getMapWorker(id);
 	m_inferSizeFromFootholds = info->dimensions.area() == 0;
 	if (!m_inferSizeFromFootholds) {
 		m_realDimensions = info->dimensions;
 	}
 }
 
+Map::~Map() {
+	ChannelServer::getInstance().getMapTickScheduler().remove(this);
+}
+
 // Map info
 auto Map::setMusic(const string_t &musicName) -> void {
 	m_music = musicName == "default" ?
@@ -173,6 +176,8 @@ auto Map::addTimeMob(ref_ptr_t<TimeMob> info) -> void {
 // Players
 auto Map::addPlayer(ref_ptr_t<Player> player) -> void {
 	m_players.push_back(player);
+	player->setMapWorker(m_worker);
+	wakeTicks();
 	if (m_info->forceMapEquip) {
 		player->send(Packets::Map::forceMapEquip());
 	}
@@ -261,6 +266,7 @@ auto Map::removePlayer(ref_ptr_t<Player> player) -> void {
 			break;
 		}
 	}
+	player->setMapWorker(-1);
 
 	player->getActiveBuffs()->resetHomingBeaconMob();
 
@@ -359,6 +365,7 @@ auto Map::removeReactor(size_t id) -> void {
 		// We don't want to respawn -1s, leave that to some script
 		time_point_t reactorRespawn = TimeUtilities::getNowWithTimeAdded(seconds_t{info.time});
 		m_reactorRespawns.emplace_back(id, reactorRespawn);
+		wakeTicks();
 	}
 }
 
@@ -845,6 +852,7 @@ auto Map::mobDeath(ref_ptr_t<Mob> mob, bool fromExplosion) -> void {
 				seconds_t timeModifier = seconds_t{Randomizer::twofold(spawn.time)};
 				time_point_t spawnTime = TimeUtilities::getNowWithTimeAdded<seconds_t>(timeModifier);
 				m_mobRespawns.emplace_back(spawnId, spawnTime);
+				wakeTicks();
 				spawn.spawned = false;
 			}
 		}
@@ -963,6 +971,7 @@ auto Map::convertShellToNormal(ref_ptr_t<Mob> mob) -> void {
 
 auto Map::addWebbedMob(map_object_t mapMobId) -> void {
 	m_webbed[mapMobId] = view_ptr_t<Mob>(m_mobs[mapMobId]);
+	wakeTicks();
 }
 
 auto Map::removeWebbedMob(map_object_t mapMobId) -> void {
@@ -977,17 +986,16 @@ auto Map::runFunctionMobs(function_t<void(ref_ptr_t<const Mob>)> func) -> void {
 
 // Drops
 auto Map::addDrop(Drop *drop) -> void {
-	owned_lock_t<recursive_mutex_t> l{m_dropsMutex};
 	map_object_t id = m_objectIds.lease();
 	drop->setId(id);
 	Point foundPosition = drop->getPos();
 	findFloor(foundPosition, foundPosition, -100);
 	drop->setPos(foundPosition);
 	m_drops[id] = drop;
+	wakeTicks();
 }
 
 auto Map::removeDrop(map_object_t id) -> void {
-	owned_lock_t<recursive_mutex_t> l{m_dropsMutex};
 	auto drop = m_drops.find(id);
 	if (drop != std::end(m_drops)) {
 		m_drops.erase(drop);
@@ -996,13 +1004,11 @@ auto Map::removeDrop(map_object_t id) -> void {
 }
 
 auto Map::getDrop(map_object_t id) -> Drop * {
-	owned_lock_t<recursive_mutex_t> l{m_dropsMutex};
 	auto drop = m_drops.find(id);
 	return drop != std::end(m_drops) ? drop->second : nullptr;
 }
 
 auto Map::clearDrops(bool showPacket) -> void {
-	owned_lock_t<recursive_mutex_t> l{m_dropsMutex};
 	auto copy = m_drops;
 	for (const auto &drop : copy) {
 		drop.second->removeDrop(showPacket);
@@ -1034,6 +1040,7 @@ auto Map::addMist(Mist *mist) -> void {
 
 	if (mist->isPoison() && !mist->isMobMist()) {
 		m_poisonMists[mist->getId()] = mist;
+		wakeTicks();
 	}
 	else {
 		m_mists[mist->getId()] = mist;
@@ -1173,8 +1180,6 @@ auto Map::checkMists() -> void {
 
 auto Map::clearDrops(time_point_t time) -> void {
 	// Clear drops based on how long they have been in the map
-	owned_lock_t<recursive_mutex_t> l{m_dropsMutex};
-
 	time -= minutes_t{3}; // Drops disappear after 3 minutes
 
 	hash_map_t<map_object_t, Drop *> drops = m_drops;
@@ -1187,19 +1192,17 @@ auto Map::clearDrops(time_point_t time) -> void {
 	}
 }
 
-auto Map::mapTick(const time_point_t &now) -> void {
-	if (m_runUnloader) {
-		if (s_mapUnloadTime > 0 && s_mapUnloadTime > m_maxMobSpawnTime) {
-			// TODO FIXME need more robust handling of instances active when the map goes to unload
-			if (m_players.size() > 0 || getInstance() != nullptr) {
-				m_emptyMapTicks = 0;
-			}
-			else {
-				m_emptyMapTicks++;
-				if (m_emptyMapTicks > s_mapUnloadTime) {
-					Maps::unloadMap(getId());
-					return;
-				}
+auto Map::mapTick(const time_point_t &now, bool webTick) -> void {
+	if (canUnload()) {
+		// TODO FIXME need more robust handling of instances active when the map goes to unload
+		if (m_players.size() > 0 || getInstance() != nullptr) {
+			m_emptyMapTicks = 0;
+		}
+		else {
+			m_emptyMapTicks++;
+			if (m_emptyMapTicks > s_mapUnloadTime) {
+				Maps::unloadMap(getId());
+				return;
 			}
 		}
 	}
@@ -1208,7 +1211,7 @@ auto Map::mapTick(const time_point_t &now) -> void {
 	clearDrops(now);
 	checkMists();
 
-	if (TimeUtilities::getSecond() % 3 == 0) {
+	if (webTick) {
 		checkShadowWeb();
 	}
 	damage_t dps = m_info->damagePerSecond;
@@ -1223,6 +1226,46 @@ auto Map::mapTick(const time_point_t &now) -> void {
 	}
 }
 
+auto Map::needsTick() const -> bool {
+	return m_players.size() > 0 ||
+		m_mobRespawns.size() > 0 ||
+		m_reactorRespawns.size() > 0 ||
+		m_drops.size() > 0 ||
+		m_poisonMists.size() > 0 ||
+		m_webbed.size() > 0;
+}
+
+auto Map::canUnload() const -> bool {
+	return m_runUnloader && s_mapUnloadTime > 0 && s_mapUnloadTime > m_maxMobSpawnTime;
+}
+
+auto Map::onParked() -> void {
+	if (!canUnload() || getInstance() != nullptr) {
+		return;
+	}
+
+	// Parked maps aren't ticked, so the rest of the empty countdown becomes a single timer
+	Vana::Timer::Timer::create(
+		[this](const time_point_t &now) {
+			// An instance may have claimed the map since the timer was armed
+			if (getInstance() == nullptr && canUnload()) {
+				Maps::unloadMap(this->getId());
+			}
+		},
+		Vana::Timer::Id{TimerType::MapTimer, getId()},
+		getTimers(), seconds_t{s_mapUnloadTime + 1 - m_emptyMapTicks});
+}
+
+auto Map::onWoken() -> void {
+	getTimers()->removeTimer(Vana::Timer::Id{TimerType::MapTimer, getId()});
+}
+
+auto Map::wakeTicks() -> void {
+	if (m_parked) {
+		ChannelServer::getInstance().getMapTickScheduler().wake(this);
+	}
+}
+
 auto Map::timeMob(bool firstLoad) -> void {
 	int32_t cHour = TimeUtilities::getHour(false);
 	TimeMob *tm = getTimeMob();
@@ -1316,12 +1359,9 @@ auto Map::showObjects(ref_ptr_t<Player> player) -> void {
 	}
 
 	// Drops
-	{
-		owned_lock_t<recursive_mutex_t> l{m_dropsMutex};
-		for (const auto &kvp : m_drops) {
-			if (Drop *drop = kvp.second) {
-				drop->showDrop(player);
-			}
+	for (const auto &kvp : m_drops) {
+		if (Drop *drop = kvp.second) {
+			drop->showDrop(player);
 		}
 	}
 
@@ -1346,24 +1386,26 @@ auto Map::showObjects(ref_ptr_t<Player> player) -> void {
 	}
 }
 
-auto Map::send(const PacketBuilder &builder, ref_ptr_t<Player> sender) -> void {
+auto Map::send(const PacketBuilder &builder, ref_ptr_t<Player> sender, PacketPriority priority) -> void {
+	BroadcastPacket packet{builder, priority};
 	for (const auto &mapPlayer : m_players) {
 		if (mapPlayer != sender) {
-			mapPlayer->send(builder);
+			mapPlayer->send(packet);
 		}
 	}
 }
 
-auto Map::send(const SplitPacketBuilder &builder, ref_ptr_t<Player> sender) -> void {
+auto Map::send(const SplitPacketBuilder &builder, ref_ptr_t<Player> sender, PacketPriority priority) -> void {
 	if (builder.player.getSize() > 0) {
 		sender->send(builder.player);
 	}
 
 	if (builder.map.getSize() > 0) {
+		BroadcastPacket packet{builder.map, priority};
 		for (const auto &mapPlayer : m_players) {
 			if (mapPlayer != sender) {
 				if (!sender->isUsingGmHide()) {
-					mapPlayer->send(builder.map);
+					mapPlayer->send(packet);
 				}
 			}
 		}
@@ -1389,6 +1431,22 @@ auto Map::createWeather(ref_ptr_t<Player> player, bool adminWeather, int32_t tim
 }
 
 // Instance
+auto Map::setInstance(Instance *instance) -> void {
+	bool hadInstance = m_instance != nullptr;
+	m_instance = instance;
+	if (!m_parked || hadInstance == (instance != nullptr)) {
+		return;
+	}
+
+	// Instances hold off the unloader of a parked map
+	if (instance != nullptr) {
+		onWoken();
+	}
+	else {
+		onParked();
+	}
+}
+
 auto Map::endInstance(bool reset) -> void {
 	setInstance(nullptr);
 	setMusic("default");
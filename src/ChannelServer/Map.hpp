@@ -20,6 +20,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "Common/FootholdInfo.hpp"
 #include "Common/IdPool.hpp"
 #include "Common/MapConstants.hpp"
+#include "Common/PacketPriority.hpp"
 #include "Common/Point.hpp"
 #include "Common/PortalInfo.hpp"
 #include "Common/Rect.hpp"
@@ -34,7 +35,6 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include <functional>
 #include <map>
 #include <memory>
-#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -84,6 +84,7 @@ namespace Vana {
 			NO_DEFAULT_CONSTRUCTOR(Map);
 		public:
 			Map(ref_ptr_t<MapInfo> info, map_id_t id);
+			~Map();
 
 			auto boatDock(bool isDocked) -> void;
 			static auto setMapUnloadTime(seconds_t newTime) -> void;
@@ -102,6 +103,7 @@ namespace Vana {
 			auto getForcedReturn() const -> map_id_t { return m_info->forcedReturn; }
 			auto getReturnMap() const -> map_id_t { return m_info->returnMap; }
 			auto getId() const -> map_id_t { return m_id; }
+			auto getWorker() const -> int32_t { return m_worker; }
 			auto getDimensions() const -> Rect { return m_realDimensions; }
 			auto getMusic() const -> string_t { return m_music; }
 
@@ -188,11 +190,11 @@ namespace Vana {
 			auto showObjects(ref_ptr_t<Player> player) -> void;
 
 			// Packet stuff
-			auto send(const PacketBuilder &builder, ref_ptr_t<Player> sender = nullptr) -> void;
-			auto send(const SplitPacketBuilder &builder, ref_ptr_t<Player> sender) -> void;
+			auto send(const PacketBuilder &builder, ref_ptr_t<Player> sender = nullptr, PacketPriority priority = PacketPriority::Normal) -> void;
+			auto send(const SplitPacketBuilder &builder, ref_ptr_t<Player> sender, PacketPriority priority = PacketPriority::Normal) -> void;
 
 			// Instance
-			auto setInstance(Instance *instance) -> void { m_instance = instance; }
+			auto setInstance(Instance *instance) -> void;
 			auto endInstance(bool reset) -> void;
 			auto getInstance() const -> Instance * { return m_instance; }
 
@@ -206,6 +208,7 @@ namespace Vana {
 			static int32_t s_mapUnloadTime/* = 0*/;
 
 			friend class MapDataProvider;
+			friend class MapTickScheduler;
 			auto addFoothold(const FootholdInfo &foothold) -> void;
 			auto addSeat(const SeatInfo &seat) -> void;
 			auto addPortal(const PortalInfo &portal) -> void;
@@ -220,7 +223,12 @@ namespace Vana {
 			auto spawnShell(mob_id_t mobId, const Point &pos, foothold_id_t foothold) -> ref_ptr_t<Mob>;
 			auto updateMobControl(ref_ptr_t<Player> player) -> void;
 			auto updateMobControl(ref_ptr_t<Mob> mob, MobSpawnType spawn = MobSpawnType::Existing, ref_ptr_t<Player> display = nullptr) -> void;
-			auto mapTick(const time_point_t &now) -> void;
+			auto mapTick(const time_point_t &now, bool webTick) -> void;
+			auto needsTick() const -> bool;
+			auto canUnload() const -> bool;
+			auto onParked() -> void;
+			auto onWoken() -> void;
+			auto wakeTicks() -> void;
 			auto getTimeMobId() const -> map_object_t { return m_timeMob; }
 			auto getTimeMob() const -> TimeMob * { return m_timeMobInfo.get(); }
 			auto getMist(mist_id_t id) -> Mist *;
@@ -235,10 +243,13 @@ namespace Vana {
 			bool m_ship = false;
 			bool m_runUnloader = true;
 			bool m_inferSizeFromFootholds = false;
+			bool m_parked = false;
 			map_id_t m_id = 0;
 			map_object_t m_timeMob = 0;
 			mob_id_t m_spawnMobs = -1;
 			int32_t m_emptyMapTicks = 0;
+			int32_t m_worker = -1;
+			size_t m_tickSlot = 0;
 			int32_t m_minSpawnCount = 0;
 			int32_t m_maxSpawnCount = 0;
 			int32_t m_maxMobSpawnTime = -1;
@@ -250,7 +261,6 @@ namespace Vana {
 			Rect m_realDimensions;
 			IdPool<map_object_t> m_objectIds;
 			IdPool<mist_id_t> m_mistIds;
-			recursive_mutex_t m_dropsMutex;
 			ref_ptr_t<MapInfo> m_info;
 			ref_ptr_t<TimeMob> m_timeMobInfo;
 			vector_t<FootholdInfo> m_footholds;
@@ -16,6 +16,7 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "MapDataProvider.hpp"
+#include "Common/DataSnapshot.hpp"
 #include "Common/Database.hpp"
 #include "Common/GameLogicUtilities.hpp"
 #include "Common/InitializeCommon.hpp"
@@ -54,10 +55,9 @@ auto MapDataProvider::loadData() -> void {
 	int8_t continent;
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("map_continent_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("map_continent_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		mapCluster = row.get<int8_t>("map_cluster");
 		continent = row.get<int8_t>("continent");
 
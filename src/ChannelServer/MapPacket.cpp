@@ -41,8 +41,31 @@ namespace Packets {
 namespace Map {
 
 PACKET_IMPL(playerPacket, ref_ptr_t<Vana::ChannelServer::Player> player) {
-	PacketBuilder builder;
+	// The buffs and the look are built first so the whole packet can be sized before anything is written
+	PacketBuilder buffs = Helpers::addBuffMapValues(player->getActiveBuffs()->getMapBuffValues());
+	PacketBuilder display = Helpers::addPlayerDisplay(player);
+
+	size_t size =
+		packetSize<header_t, player_id_t>() + packetSize(player->getName()) +
+		packetSize<uint16_t, int16_t, int8_t, int16_t, int8_t>() + // Guild
+		buffs.getSize() +
+		packetSize<job_id_t>() + display.getSize() +
+		packetSize<int32_t, item_id_t, item_id_t, Point, int8_t, foothold_id_t, int8_t>() +
+		packetSize<bool>() +
+		packetSize<int32_t, int32_t, int32_t>() + // Mount
+		packetSize<int8_t, bool>() +
+		packetSize<int8_t, int8_t, int8_t, int8_t, int8_t, int8_t>();
+
+	for (int8_t i = 0; i < Inventories::MaxPetCount; i++) {
+		if (Pet *pet = player->getPets()->getSummoned(i)) {
+			size += packetSize<bool, item_id_t>() + packetSize(pet->getName()) + packetSize<pet_id_t, Point, int8_t, foothold_id_t, bool, bool>();
+		}
+	}
+	if (!player->getChalkboard().empty()) {
+		size += packetSize(player->getChalkboard());
+	}
 
+	PacketBuilder builder{size};
 	builder
 		.add<header_t>(SMSG_MAP_PLAYER_SPAWN)
 		.add<player_id_t>(player->getId())
@@ -53,12 +76,11 @@ PACKET_IMPL(playerPacket, ref_ptr_t<Vana::ChannelServer::Player> player) {
 		.add<int16_t>(0) // Guild icon garbage
 		.add<int8_t>(0); // Guild icon garbage
 
-	PacketBuilder ref = Helpers::addBuffMapValues(player->getActiveBuffs()->getMapBuffValues());
-	builder.addBuffer(ref);
+	builder.addBuffer(buffs);
 
 	builder
 		.add<job_id_t>(player->getStats()->getJob())
-		.addBuffer(Helpers::addPlayerDisplay(player))
+		.addBuffer(display)
 		.unk<int32_t>()
 		.add<item_id_t>(player->getItemEffect())
 		.add<item_id_t>(player->getChair())
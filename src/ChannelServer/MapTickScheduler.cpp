@@ -0,0 +1,139 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "MapTickScheduler.hpp"
+#include "Common/TimeUtilities.hpp"
+#include "Common/Timer.hpp"
+#include "Common/TimerType.hpp"
+#include "ChannelServer/Map.hpp"
+#include <algorithm>
+
+namespace Vana {
+namespace ChannelServer {
+
+auto MapTickScheduler::add(Map *map) -> void {
+	owned_lock_t<recursive_mutex_t> l{m_mutex};
+	if (!m_started) {
+		Vana::Timer::Timer::create(
+			[this](const time_point_t &now) { this->tick(now); },
+			Vana::Timer::Id{TimerType::MapTimer},
+			getTimers(), seconds_t{0}, seconds_t{1});
+		m_started = true;
+	}
+
+	m_mapCount++;
+	map->m_parked = false;
+	map->m_tickSlot = m_active.size();
+	m_active.push_back(map);
+}
+
+auto MapTickScheduler::remove(Map *map) -> void {
+	owned_lock_t<recursive_mutex_t> l{m_mutex};
+	m_mapCount--;
+	if (!map->m_parked) {
+		deactivate(map);
+	}
+}
+
+auto MapTickScheduler::wake(Map *map) -> void {
+	owned_lock_t<recursive_mutex_t> l{m_mutex};
+	if (!map->m_parked) {
+		return;
+	}
+
+	map->m_parked = false;
+	map->m_tickSlot = m_active.size();
+	m_active.push_back(map);
+	map->onWoken();
+}
+
+auto MapTickScheduler::deactivate(Map *map) -> void {
+	size_t slot = map->m_tickSlot;
+	map->m_parked = true;
+	if (m_sweeping) {
+		// The sweep is walking the slots, leave a hole and close them all afterwards
+		m_active[slot] = nullptr;
+		m_holes = true;
+		return;
+	}
+
+	Map *last = m_active.back();
+	m_active[slot] = last;
+	last->m_tickSlot = slot;
+	m_active.pop_back();
+}
+
+auto MapTickScheduler::compact() -> void {
+	if (!m_holes) {
+		return;
+	}
+
+	m_active.erase(std::remove(std::begin(m_active), std::end(m_active), nullptr), std::end(m_active));
+	for (size_t i = 0; i < m_active.size(); ++i) {
+		m_active[i]->m_tickSlot = i;
+	}
+	m_holes = false;
+}
+
+auto MapTickScheduler::tick(const time_point_t &now) -> void {
+	owned_lock_t<recursive_mutex_t> l{m_mutex};
+	time_point_t start = TimeUtilities::getNow();
+	bool webTick = TimeUtilities::getSecond() % 3 == 0;
+
+	m_sweeping = true;
+	// Maps woken up during the sweep are appended and picked up next tick
+	size_t count = m_active.size();
+	for (size_t i = 0; i < count; ++i) {
+		Map *map = m_active[i];
+		if (map == nullptr) {
+			continue;
+		}
+
+		map->mapTick(now, webTick);
+		m_stats.mapsTicked++;
+
+		// The map may have unloaded itself during its tick
+		if (m_active[i] == map && !map->needsTick()) {
+			deactivate(map);
+			map->onParked();
+		}
+	}
+	m_sweeping = false;
+	compact();
+
+	microseconds_t elapsed = duration_cast<microseconds_t>(TimeUtilities::getNow() - start);
+	m_stats.ticks++;
+	m_stats.lastTime = elapsed;
+	m_stats.totalTime += elapsed;
+	m_stats.maxTime = std::max(m_stats.maxTime, elapsed);
+}
+
+auto MapTickScheduler::getStats() const -> Stats {
+	owned_lock_t<recursive_mutex_t> l{m_mutex};
+	Stats stats = m_stats;
+	stats.activeMaps = m_active.size();
+	stats.parkedMaps = m_mapCount - m_active.size();
+	return stats;
+}
+
+auto MapTickScheduler::resetStats() -> void {
+	owned_lock_t<recursive_mutex_t> l{m_mutex};
+	m_stats = Stats{};
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/TimerContainerHolder.hpp"
+#include "Common/Types.hpp"
+#include <mutex>
+#include <vector>
+
+namespace Vana {
+	namespace ChannelServer {
+		class Map;
+
+		// Runs the once-a-second upkeep for every loaded map in a single sweep instead of one timer per map
+		// Maps with nothing to do are parked and skipped until something wakes them up
+		class MapTickScheduler : public TimerContainerHolder {
+			NONCOPYABLE(MapTickScheduler);
+		public:
+			struct Stats {
+				uint64_t ticks = 0;
+				uint64_t mapsTicked = 0;
+				size_t activeMaps = 0;
+				size_t parkedMaps = 0;
+				microseconds_t lastTime = microseconds_t{0};
+				microseconds_t totalTime = microseconds_t{0};
+				microseconds_t maxTime = microseconds_t{0};
+			};
+
+			MapTickScheduler() = default;
+
+			// New maps start out active
+			auto add(Map *map) -> void;
+			auto remove(Map *map) -> void;
+			auto wake(Map *map) -> void;
+			auto getStats() const -> Stats;
+			auto resetStats() -> void;
+		private:
+			auto tick(const time_point_t &now) -> void;
+			auto deactivate(Map *map) -> void;
+			auto compact() -> void;
+
+			bool m_started = false;
+			bool m_sweeping = false;
+			bool m_holes = false;
+			size_t m_mapCount = 0;
+			vector_t<Map *> m_active;
+			Stats m_stats;
+			mutable recursive_mutex_t m_mutex;
+		};
+	}
+}
\ No newline at end of file
@@ -162,7 +162,7 @@ auto MobHandler::monsterControl(ref_ptr_t<Player> player, PacketReader &reader)
 
 	player->send(Packets::Mobs::moveMobResponse(mobId, moveId, nextMovementCouldBeSkill, mob->getMp(), nextCastSkill, nextCastSkillLevel));
 	reader.reset(19);
-	player->sendMap(Packets::Mobs::moveMob(mobId, nextMovementCouldBeSkill, rawActivity, useSkillId, useSkillLevel, option, reader.getBuffer(), reader.getBufferLength()), true);
+	player->sendMap(Packets::Mobs::moveMob(mobId, nextMovementCouldBeSkill, rawActivity, useSkillId, useSkillLevel, option, reader.getBuffer(), reader.getBufferLength()), true, PacketPriority::Low);
 }
 
 auto MobHandler::handleMobStatus(player_id_t playerId, ref_ptr_t<Mob> mob, skill_id_t skillId, skill_level_t level, item_id_t weapon, int8_t hits, damage_t damage) -> int32_t {
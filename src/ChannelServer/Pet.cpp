@@ -46,14 +46,19 @@ Pet::Pet(Player *player, Item *item) :
 	item->setPetId(m_id);
 }
 
-Pet::Pet(Player *player, Item *item, const soci::row &row) :
+Pet::Pet(Player *player, Item *item, int8_t inventorySlot, const row_t &row) :
 	MovableLife{0, Point{}, 0},
-	m_player{player},
-	m_id{item->getPetId()},
+	m_index{std::get<0>(row)},
+	m_level{std::get<2>(row)},
+	m_fullness{std::get<4>(row)},
+	m_inventorySlot{inventorySlot},
+	m_closeness{std::get<3>(row)},
 	m_itemId{item->getId()},
-	m_item{item}
+	m_id{item->getPetId()},
+	m_item{item},
+	m_player{player},
+	m_name{std::get<1>(row)}
 {
-	initializePet(row);
 	if (isSummoned()) {
 		if (m_index.is_initialized() && m_index.get() == 1) {
 			startTimer();
@@ -136,14 +141,5 @@ auto Pet::hasQuoteItem() const -> bool {
 	return false;
 }
 
-auto Pet::initializePet(const soci::row &row) -> void {
-	m_index = row.get<opt_int8_t>("index");
-	m_name = row.get<string_t>("pet_name");
-	m_level = row.get<int8_t>("level");
-	m_closeness = row.get<int16_t>("closeness");
-	m_fullness = row.get<int8_t>("fullness");
-	m_inventorySlot = row.get<int8_t>("slot");
-}
-
 }
 }
\ No newline at end of file
@@ -20,8 +20,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "Common/Point.hpp"
 #include "Common/Types.hpp"
 #include "ChannelServer/MovableLife.hpp"
-#include <soci.h>
 #include <string>
+#include <tuple>
 
 namespace Vana {
 	class Item;
@@ -33,8 +33,11 @@ namespace Vana {
 			NONCOPYABLE(Pet);
 			NO_DEFAULT_CONSTRUCTOR(Pet);
 		public:
+			// Index, name, level, closeness and fullness as they're stored in the database
+			using row_t = tuple_t<opt_int8_t, string_t, int8_t, int16_t, int8_t>;
+
 			Pet(Player *player, Item *item);
-			Pet(Player *player, Item *item, const soci::row &row);
+			Pet(Player *player, Item *item, int8_t inventorySlot, const row_t &row);
 
 			auto summon(int8_t index) -> void { m_index = index; }
 			auto desummon() -> void { m_index.reset(); }
@@ -58,7 +61,6 @@ namespace Vana {
 
 			auto startTimer() -> void;
 		private:
-			auto initializePet(const soci::row &row) -> void;
 			auto levelUp() -> void;
 
 			opt_int8_t m_index;
@@ -46,7 +46,7 @@ auto PetHandler::handleMovement(ref_ptr_t<Player> player, PacketReader &reader)
 	reader.unk<uint32_t>(); // Not ticks at all, not sure what this is
 	MovementHandler::parseMovement(pet, reader);
 	reader.reset(10);
-	player->sendMap(Packets::Pets::showMovement(player->getId(), pet, reader.getBuffer(), reader.getBufferLength() - 9));
+	player->sendMap(Packets::Pets::showMovement(player->getId(), pet, reader.getBuffer(), reader.getBufferLength() - 9), PacketPriority::Low);
 }
 
 auto PetHandler::handleChat(ref_ptr_t<Player> player, PacketReader &reader) -> void {
@@ -58,7 +58,7 @@ auto PetHandler::handleChat(ref_ptr_t<Player> player, PacketReader &reader) -> v
 	reader.unk<uint8_t>();
 	int8_t act = reader.get<int8_t>();
 	string_t message = reader.get<string_t>();
-	player->sendMap(Packets::Pets::showChat(player->getId(), player->getPets()->getPet(petId), message, act));
+	player->sendMap(Packets::Pets::showChat(player->getId(), player->getPets()->getPet(petId), message, act), PacketPriority::Low);
 }
 
 auto PetHandler::handleSummon(ref_ptr_t<Player> player, PacketReader &reader) -> void {
@@ -198,6 +198,10 @@ PACKET_IMPL(addInfo, Pet *pet, Item *petItem) {
 	return builder;
 }
 
+auto addInfoSize() -> size_t {
+	return packetSize<int8_t, item_id_t, int8_t, pet_id_t, int64_t>() + 13 + packetSize<int8_t, int16_t, int8_t, FileTime, int32_t, int32_t>();
+}
+
 }
 }
 }
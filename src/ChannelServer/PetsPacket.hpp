@@ -45,6 +45,7 @@ namespace Vana {
 				PACKET(updateSummonedPets, ref_ptr_t<Player> player);
 				PACKET(blankUpdate);
 				PACKET(addInfo, Pet *pet, Item *petItem);
+				auto addInfoSize() -> size_t;
 			}
 		}
 	}
@@ -16,8 +16,10 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "Player.hpp"
+#include "Common/BroadcastPacket.hpp"
 #include "Common/CommonHeader.hpp"
 #include "Common/Database.hpp"
+#include "Common/DatabaseExecutor.hpp"
 #include "Common/EnumUtilities.hpp"
 #include "Common/GameConstants.hpp"
 #include "Common/GameLogicUtilities.hpp"
@@ -29,6 +31,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "Common/Session.hpp"
 #include "Common/SplitPacketBuilder.hpp"
 #include "Common/StringUtilities.hpp"
+#include "Common/Timer.hpp"
 #include "Common/TimeUtilities.hpp"
 #include "ChannelServer/BuddyListHandler.hpp"
 #include "ChannelServer/BuddyListPacket.hpp"
@@ -58,7 +61,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "ChannelServer/PetHandler.hpp"
 #include "ChannelServer/PlayerDataProvider.hpp"
 #include "ChannelServer/PlayerHandler.hpp"
+#include "ChannelServer/PlayerLoader.hpp"
 #include "ChannelServer/PlayerPacket.hpp"
+#include "ChannelServer/PlayerPersistence.hpp"
 #include "ChannelServer/Quests.hpp"
 #include "ChannelServer/ReactorHandler.hpp"
 #include "ChannelServer/ServerPacket.hpp"
@@ -69,6 +74,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "ChannelServer/SyncPacket.hpp"
 #include "ChannelServer/TradeHandler.hpp"
 #include "ChannelServer/WorldServerSession.hpp"
+#include <algorithm>
 #include <array>
 #include <stdexcept>
 
@@ -89,6 +95,9 @@ auto Player::handle(PacketReader &reader) -> Result {
 				playerConnect(reader);
 			}
 		}
+		else if (m_changingChannel) {
+			// The character was already handed to the next channel, anything done now would be lost
+		}
 		else {
 			switch (header) {
 				case CMSG_ADMIN_COMMAND: CommandHandler::handleAdminCommand(shared_from_this(), reader); break;
@@ -204,7 +213,25 @@ auto Player::handle(PacketReader &reader) -> Result {
 	return Result::Successful;
 }
 
+auto Player::getShard(header_t opcode) const -> int32_t {
+	switch (opcode) {
+		// Only handlers that never reach outside the player's map may run on the map's worker
+		case CMSG_EMOTE:
+		case CMSG_PET_MOVEMENT:
+		case CMSG_PLAYER_MOVE:
+		case CMSG_SUMMON_MOVEMENT:
+			return m_mapWorker;
+	}
+	return -1;
+}
+
 auto Player::onDisconnect() -> void {
+	if (!m_isConnect) {
+		// The character never finished loading, there's nothing to clean up
+		ChannelServer::getInstance().finalizePlayer(shared_from_this());
+		return;
+	}
+
 	m_disconnecting = true;
 
 	Map *curMap = Maps::getMap(m_map);
@@ -244,6 +271,7 @@ auto Player::onDisconnect() -> void {
 		saveAll(true);
 		setOnline(false);
 	}
+	ChannelServer::getInstance().getPersistence().release(m_id);
 
 	if (ChannelServer::getInstance().isConnected()) {
 		// Do not connect to worldserver if the worldserver has disconnected
@@ -258,6 +286,11 @@ auto Player::onDisconnect() -> void {
 }
 
 auto Player::playerConnect(PacketReader &reader) -> void {
+	if (m_loading) {
+		// The character is already being loaded
+		return;
+	}
+
 	player_id_t id = reader.get<player_id_t>();
 	bool hasTransferPacket = false;
 	auto &channel = ChannelServer::getInstance();
@@ -269,70 +302,112 @@ auto Player::playerConnect(PacketReader &reader) -> void {
 	}
 
 	m_id = id;
-	auto &db = Database::getCharDb();
-	auto &sql = db.getSession();
-	soci::row row;
-	sql.once
-		<< "SELECT c.*, u.gm_level, u.admin "
-		<< "FROM " << db.makeTable("characters") << " c "
-		<< "INNER JOIN " << db.makeTable("accounts") << " u ON c.account_id = u.account_id "
-		<< "WHERE c.character_id = :char",
-		soci::use(id, "char"),
-		soci::into(row);
+	m_loading = true;
 
-	if (!sql.got_data()) {
-		// Hacking
+	auto &config = channel.getConfig();
+	storage_slot_t defaultStorageSlots = config.defaultStorageSlots;
+	int32_t defaultChars = config.defaultChars;
+	function_t<PlayerLoadData()> load = [id, defaultStorageSlots, defaultChars] {
+		return PlayerLoader::load(id, defaultStorageSlots, defaultChars);
+	};
+
+	if (hasTransferPacket) {
+		PacketReader transfer = provider.getPacket(id);
+		if (transfer.get<bool>()) {
+			// The previous channel sent the whole character along, it's used as long as its final save didn't change anything
+			int64_t takenAt = transfer.get<int64_t>();
+			transfer.skip<uint32_t>();
+			auto state = make_ref_ptr<PlayerLoadData>(PlayerLoader::read(transfer));
+			load = [id, defaultStorageSlots, defaultChars, takenAt, state] {
+				if (PlayerPersistence::getLastSaved(id) == takenAt) {
+					return *state;
+				}
+				return PlayerLoader::load(id, defaultStorageSlots, defaultChars);
+			};
+		}
+	}
+
+	if (channel.isReplaying()) {
+		// Replays feed the next packets right away, they expect the character to be there already
+		finishConnect(load(), hasTransferPacket);
+		return;
+	}
+
+	view_ptr_t<Player> weakPlayer = shared_from_this();
+	Result result = DatabaseExecutor::getInstance().query("player load", load,
+		[weakPlayer, hasTransferPacket](const PlayerLoadData &data) {
+			if (auto player = weakPlayer.lock()) {
+				player->finishConnect(data, hasTransferPacket);
+			}
+		},
+		[weakPlayer] {
+			if (auto player = weakPlayer.lock()) {
+				player->m_loading = false;
+				player->disconnect();
+			}
+		});
+
+	if (result == Result::Failure) {
+		// The database queue is full, fall back to loading here
+		finishConnect(load(), hasTransferPacket);
+	}
+}
+
+auto Player::finishConnect(const PlayerLoadData &data, bool hasTransferPacket) -> void {
+	m_loading = false;
+	if (m_disconnected) {
+		return;
+	}
+
+	auto &channel = ChannelServer::getInstance();
+	auto &provider = channel.getPlayerDataProvider();
+	if (!data.found || !provider.isConnecting(m_id)) {
+		// Either hacking or the connection expired while the character was loading
 		disconnect();
 		return;
 	}
 
-	m_name = row.get<string_t>("name");
-	m_accountId = row.get<account_id_t>("account_id");
-	m_map = row.get<map_id_t>("map");
-	m_gmLevel = row.get<int32_t>("gm_level");
-	m_admin = row.get<bool>("admin");
-	m_face = row.get<face_id_t>("face");
-	m_hair = row.get<hair_id_t>("hair");
-	m_worldId = row.get<world_id_t>("world_id");
-	m_gender = row.get<gender_id_t>("gender");
-	m_skin = row.get<skin_id_t>("skin");
-	m_mapPos = row.get<portal_id_t>("pos");
-	m_buddylistSize = row.get<uint8_t>("buddylist_size");
+	m_name = data.name;
+	m_accountId = data.accountId;
+	m_map = data.map;
+	m_gmLevel = data.gmLevel;
+	m_admin = data.admin;
+	m_face = data.face;
+	m_hair = data.hair;
+	m_worldId = data.worldId;
+	m_gender = data.gender;
+	m_skin = data.skin;
+	m_mapPos = data.mapPos;
+	m_buddylistSize = data.buddylistSize;
 
 	// Stats
 	m_stats = make_owned_ptr<PlayerStats>(
 		this,
-		row.get<player_level_t>("level"),
-		row.get<job_id_t>("job"),
-		row.get<fame_t>("fame"),
-		row.get<stat_t>("str"),
-		row.get<stat_t>("dex"),
-		row.get<stat_t>("int"),
-		row.get<stat_t>("luk"),
-		row.get<stat_t>("ap"),
-		row.get<health_ap_t>("hpmp_ap"),
-		row.get<stat_t>("sp"),
-		row.get<health_t>("chp"),
-		row.get<health_t>("mhp"),
-		row.get<health_t>("cmp"),
-		row.get<health_t>("mmp"),
-		row.get<experience_t>("exp")
+		data.level,
+		data.job,
+		data.fame,
+		data.str,
+		data.dex,
+		data.intt,
+		data.luk,
+		data.ap,
+		data.hpMpAp,
+		data.sp,
+		data.hp,
+		data.maxHp,
+		data.mp,
+		data.maxMp,
+		data.exp
 	);
 
 	// Inventory
-	m_mounts = make_owned_ptr<PlayerMounts>(this);
+	m_mounts = make_owned_ptr<PlayerMounts>(this, data.mounts);
 	m_pets = make_owned_ptr<PlayerPets>(this);
-	array_t<inventory_slot_count_t, Inventories::InventoryCount> maxSlots;
-	maxSlots[0] = row.get<inventory_slot_count_t>("equip_slots");
-	maxSlots[1] = row.get<inventory_slot_count_t>("use_slots");
-	maxSlots[2] = row.get<inventory_slot_count_t>("setup_slots");
-	maxSlots[3] = row.get<inventory_slot_count_t>("etc_slots");
-	maxSlots[4] = row.get<inventory_slot_count_t>("cash_slots");
-	m_inventory = make_owned_ptr<PlayerInventory>(this, maxSlots, row.get<mesos_t>("mesos"));
-	m_storage = make_owned_ptr<PlayerStorage>(this);
+	m_inventory = make_owned_ptr<PlayerInventory>(this, data.maxSlots, data.mesos, data.inventory);
+	m_storage = make_owned_ptr<PlayerStorage>(this, data.storage);
 
 	// Skills
-	m_skills = make_owned_ptr<PlayerSkills>(this);
+	m_skills = make_owned_ptr<PlayerSkills>(this, data.skills);
 
 	// Buffs/summons
 	m_activeBuffs = make_owned_ptr<PlayerActiveBuffs>(this);
@@ -349,23 +424,21 @@ auto Player::playerConnect(PacketReader &reader) -> void {
 		m_gmChat = isGm() && config.defaultGmChatMode;
 	}
 
-	provider.playerEstablished(id);
+	provider.playerEstablished(m_id);
 
 	// The rest
-	m_variables = make_owned_ptr<PlayerVariables>(this);
-	m_buddyList = make_owned_ptr<PlayerBuddyList>(this);
-	m_quests = make_owned_ptr<PlayerQuests>(this);
-	m_monsterBook = make_owned_ptr<PlayerMonsterBook>(this);
+	m_variables = make_owned_ptr<PlayerVariables>(this, data.variables);
+	m_buddyList = make_owned_ptr<PlayerBuddyList>(this, data.buddyList);
+	m_quests = make_owned_ptr<PlayerQuests>(this, data.quests);
+	m_monsterBook = make_owned_ptr<PlayerMonsterBook>(this, data.monsterBook);
 
-	opt_int32_t bookCover = row.get<opt_int32_t>("book_cover");
-	getMonsterBook()->setCover(bookCover.get(0));
+	getMonsterBook()->setCover(data.bookCover.get(0));
 
 	// Key Maps and Macros
-	KeyMaps keyMaps;
-	keyMaps.load(id);
+	m_keyMaps = data.keyMaps;
+	m_skillMacros = data.skillMacros;
 
-	SkillMacros skillMacros;
-	skillMacros.load(id);
+	channel.getPersistence().track(m_id, data);
 
 	// Adjust down HP or MP if necessary
 	getStats()->checkHpMp();
@@ -402,12 +475,12 @@ auto Player::playerConnect(PacketReader &reader) -> void {
 		}
 	}
 
-	send(Packets::Player::showKeys(&keyMaps));
+	send(Packets::Player::showKeys(m_keyMaps.get()));
 
 	send(Packets::Buddy::update(shared_from_this(), Packets::Buddy::ActionTypes::Add));
 	getBuddyList()->checkForPendingBuddy();
 
-	send(Packets::Player::showSkillMacros(&skillMacros));
+	send(Packets::Player::showSkillMacros(m_skillMacros.get()));
 
 	provider.addPlayer(shared_from_this());
 	Maps::addPlayer(shared_from_this(), m_map);
@@ -419,25 +492,40 @@ auto Player::playerConnect(PacketReader &reader) -> void {
 	setOnline(true);
 	m_isConnect = true;
 
-	PlayerData data;
+	seconds_t saveInterval = channel.getInterServerConfig().playerSaveInterval;
+	if (channel.getPersistence().isWriteBehind() && saveInterval.count() > 0) {
+		Vana::Timer::Timer::create(
+			[this](const time_point_t &now) {
+				// Timers are dispatched to the handler strand (see AbstractServer::initialize), the character can't change while it's copied
+				if (m_isConnect && !m_changingChannel) {
+					ChannelServer::getInstance().getPersistence().queue(m_id, getLoadData());
+				}
+			},
+			Vana::Timer::Id{TimerType::SaveTimer},
+			getTimers(),
+			saveInterval,
+			saveInterval);
+	}
+
+	PlayerData playerData;
 	const PlayerData * const existingData = provider.getPlayerData(m_id);
 	bool firstConnectionSinceServerStarted = firstConnect && !existingData->initialized;
 
 	if (firstConnectionSinceServerStarted) {
-		data.admin = m_admin;
-		data.level = getStats()->getLevel();
-		data.job = getStats()->getJob();
-		data.gmLevel = m_gmLevel;
-		data.name = m_name;
-		data.mutualBuddies = m_buddyList->getBuddyIds();
+		playerData.admin = m_admin;
+		playerData.level = getStats()->getLevel();
+		playerData.job = getStats()->getJob();
+		playerData.gmLevel = m_gmLevel;
+		playerData.name = m_name;
+		playerData.mutualBuddies = m_buddyList->getBuddyIds();
 	}
 
-	data.channel = channel.getChannelId();
-	data.map = m_map;
-	data.id = m_id;
-	data.ip = getIp().get();
+	playerData.channel = channel.getChannelId();
+	playerData.map = m_map;
+	playerData.id = m_id;
+	playerData.ip = getIp().get();
 
-	channel.sendWorld(Packets::Interserver::Player::connect(data, firstConnectionSinceServerStarted));
+	channel.sendWorld(Packets::Interserver::Player::connect(playerData, firstConnectionSinceServerStarted));
 }
 
 auto Player::getMap() const -> Map * {
@@ -528,11 +616,84 @@ auto Player::getMedalName() -> string_t {
 }
 
 auto Player::changeChannel(channel_id_t channel) -> void {
-	ChannelServer::getInstance().sendWorld(Packets::Interserver::Player::changeChannel(shared_from_this(), channel));
+	auto &channelServer = ChannelServer::getInstance();
+	// The state that goes along is final, the player stays put until the WorldServer answers
+	m_changingChannel = channelServer.getInterServerConfig().fullStateTransfer;
+	if (m_changingChannel) {
+		PacketBuilder state;
+		PlayerLoader::write(state, getLoadData());
+		m_transferState.assign(state.getBuffer(), state.getBuffer() + state.getSize());
+		m_transferTakenAt = PlayerPersistence::getSaveTime();
+	}
+	channelServer.sendWorld(Packets::Interserver::Player::changeChannel(shared_from_this(), channel));
+}
+
+auto Player::getLoadData() const -> PlayerLoadData {
+	PlayerLoadData data;
+	data.found = true;
+	data.name = m_name;
+	data.accountId = m_accountId;
+	data.map = m_map;
+	data.gmLevel = m_gmLevel;
+	data.admin = m_admin;
+	data.face = m_face;
+	data.hair = m_hair;
+	data.worldId = m_worldId;
+	data.gender = m_gender;
+	data.skin = m_skin;
+	data.mapPos = m_mapPos;
+	data.buddylistSize = m_buddylistSize;
+	if (int32_t cover = getMonsterBook()->getCover()) {
+		data.bookCover = cover;
+	}
+
+	PlayerStats *s = getStats();
+	data.level = s->getLevel();
+	data.job = s->getJob();
+	data.fame = s->getFame();
+	data.str = s->getStr();
+	data.dex = s->getDex();
+	data.intt = s->getInt();
+	data.luk = s->getLuk();
+	data.ap = s->getAp();
+	data.hpMpAp = s->getHpMpAp();
+	data.sp = s->getSp();
+	data.hp = s->getHp();
+	data.maxHp = s->getMaxHp(true);
+	data.mp = s->getMp();
+	data.maxMp = s->getMaxMp(true);
+	data.exp = s->getExp();
+
+	PlayerInventory *i = getInventory();
+	for (inventory_t inv = Inventories::EquipInventory; inv <= Inventories::InventoryCount; ++inv) {
+		data.maxSlots[inv - 1] = i->getMaxSlots(inv);
+	}
+	data.mesos = i->getMesos();
+
+	data.inventory = i->getLoadData();
+	data.storage = getStorage()->getLoadData();
+	data.mounts = getMounts()->getLoadData();
+	data.skills = getSkills()->getLoadData();
+	data.variables = getVariables()->getLoadData();
+	data.buddyList = getBuddyList()->getLoadData();
+	data.quests = getQuests()->getLoadData();
+	data.monsterBook = getMonsterBook()->getLoadData();
+	data.keyMaps = m_keyMaps;
+	data.skillMacros = m_skillMacros;
+	return data;
 }
 
 auto Player::getTransferPacket() const -> PacketBuilder {
 	PacketBuilder builder;
+	bool fullState = ChannelServer::getInstance().getInterServerConfig().fullStateTransfer;
+	builder.add<bool>(fullState);
+	if (fullState) {
+		builder
+			.add<int64_t>(m_transferTakenAt)
+			.add<uint32_t>(static_cast<uint32_t>(m_transferState.size()))
+			.addBuffer(m_transferState.data(), m_transferState.size());
+	}
+
 	builder
 		.add<int64_t>(getConnectionTime())
 		.add<player_id_t>(m_follow != nullptr ? m_follow->getId() : 0)
@@ -544,6 +705,12 @@ auto Player::getTransferPacket() const -> PacketBuilder {
 }
 
 auto Player::parseTransferPacket(PacketReader &reader) -> void {
+	if (reader.get<bool>()) {
+		// Full state, already taken by playerConnect
+		reader.skip<int64_t>();
+		reader.skip(static_cast<int32_t>(reader.get<uint32_t>()));
+	}
+
 	setConnectionTime(reader.get<int64_t>());
 	player_id_t followId = reader.get<player_id_t>();
 	if (followId != 0) {
@@ -574,8 +741,7 @@ auto Player::changeKey(PacketReader &reader) -> void {
 			return;
 		}
 
-		KeyMaps keyMaps;
-		keyMaps.load(m_id);
+		KeyMaps &keyMaps = *m_keyMaps;
 		for (int32_t i = 0; i < howMany; i++) {
 			int32_t pos = reader.get<int32_t>();
 			KeyMapType type;
@@ -602,7 +768,7 @@ auto Player::changeSkillMacros(PacketReader &reader) -> void {
 	if (num == 0) {
 		return;
 	}
-	SkillMacros skillMacros;
+	auto skillMacros = make_ref_ptr<SkillMacros>();
 	for (uint8_t i = 0; i < num; i++) {
 		string_t name = reader.get<string_t>();
 		bool shout = reader.get<bool>();
@@ -610,9 +776,10 @@ auto Player::changeSkillMacros(PacketReader &reader) -> void {
 		skill_id_t skill2 = reader.get<skill_id_t>();
 		skill_id_t skill3 = reader.get<skill_id_t>();
 
-		skillMacros.add(i, new SkillMacros::SkillMacro(name, shout, skill1, skill2, skill3));
+		skillMacros->add(i, new SkillMacros::SkillMacro(name, shout, skill1, skill2, skill3));
 	}
-	skillMacros.save(getId());
+	skillMacros->save(getId());
+	m_skillMacros = skillMacros;
 }
 
 auto Player::setHair(hair_id_t id) -> void {
@@ -630,117 +797,20 @@ auto Player::setSkin(skin_id_t id) -> void {
 	send(Packets::Player::updateStat(Stats::Skin, id));
 }
 
-auto Player::saveStats() -> void {
-	PlayerStats *s = getStats();
-	PlayerInventory *i = getInventory();
-	// Need local bindings
-	// Stats
-	player_level_t level = s->getLevel();
-	job_id_t job = s->getJob();
-	stat_t str = s->getStr();
-	stat_t dex = s->getDex();
-	stat_t intt = s->getInt();
-	stat_t luk = s->getLuk();
-	health_t hp = s->getHp();
-	health_t maxHp = s->getMaxHp(true);
-	health_t mp = s->getMp();
-	health_t maxMp = s->getMaxMp(true);
-	health_ap_t hpMpAp = s->getHpMpAp();
-	stat_t ap = s->getAp();
-	stat_t sp = s->getSp();
-	fame_t fame = s->getFame();
-	experience_t exp = s->getExp();
-	// Inventory
-	inventory_slot_count_t equip = i->getMaxSlots(Inventories::EquipInventory);
-	inventory_slot_count_t use = i->getMaxSlots(Inventories::UseInventory);
-	inventory_slot_count_t setup = i->getMaxSlots(Inventories::SetupInventory);
-	inventory_slot_count_t etc = i->getMaxSlots(Inventories::EtcInventory);
-	inventory_slot_count_t cash = i->getMaxSlots(Inventories::CashInventory);
-	mesos_t money = i->getMesos();
-	// Other
-	int32_t rawCover = getMonsterBook()->getCover();
-	opt_int32_t cover;
-	if (rawCover != 0) {
-		cover = rawCover;
-	}
-
-	auto &db = Database::getCharDb();
-	auto &sql = db.getSession();
-	sql.once
-		<< "UPDATE " << db.makeTable("characters") << " "
-		<< "SET "
-		<< "	level = :level, "
-		<< "	job = :job, "
-		<< "	str = :str, "
-		<< "	dex = :dex, "
-		<< "	`int` = :int, "
-		<< "	luk = :luk, "
-		<< "	chp = :hp, "
-		<< "	mhp = :maxhp, "
-		<< "	cmp = :mp, "
-		<< "	mmp = :maxmp, "
-		<< "	hpmp_ap = :hpmpap, "
-		<< "	ap = :ap, "
-		<< "	sp = :sp, "
-		<< "	exp = :exp, "
-		<< "	fame = :fame, "
-		<< "	map = :map, "
-		<< "	pos = :pos, "
-		<< "	gender = :gender, "
-		<< "	skin = :skin, "
-		<< "	face = :face, "
-		<< "	hair = :hair, "
-		<< "	mesos = :money, "
-		<< "	equip_slots = :equip, "
-		<< "	use_slots = :use, "
-		<< "	setup_slots = :setup, "
-		<< "	etc_slots = :etc, "
-		<< "	cash_slots = :cash, "
-		<< "	buddylist_size = :buddylist, "
-		<< "	book_cover = :cover "
-		<< "WHERE character_id = :char",
-		soci::use(m_id, "char"),
-		soci::use(level, "level"),
-		soci::use(job, "job"),
-		soci::use(str, "str"),
-		soci::use(dex, "dex"),
-		soci::use(intt, "int"),
-		soci::use(luk, "luk"),
-		soci::use(hp, "hp"),
-		soci::use(maxHp, "maxhp"),
-		soci::use(mp, "mp"),
-		soci::use(maxMp, "maxmp"),
-		soci::use(hpMpAp, "hpmpap"),
-		soci::use(ap, "ap"),
-		soci::use(sp, "sp"),
-		soci::use(exp, "exp"),
-		soci::use(fame, "fame"),
-		soci::use(m_map, "map"),
-		soci::use(m_mapPos, "pos"),
-		soci::use(m_gender, "gender"),
-		soci::use(m_skin, "skin"),
-		soci::use(m_face, "face"),
-		soci::use(m_hair, "hair"),
-		soci::use(money, "money"),
-		soci::use(equip, "equip"),
-		soci::use(use, "use"),
-		soci::use(setup, "setup"),
-		soci::use(etc, "etc"),
-		soci::use(cash, "cash"),
-		soci::use(m_buddylistSize, "buddylist"),
-		soci::use(cover, "cover");
-}
-
 auto Player::saveAll(bool saveCooldowns) -> void {
-	saveStats();
-	getInventory()->save();
-	getStorage()->save();
-	getMonsterBook()->save();
-	getMounts()->save();
-	getPets()->save();
-	getQuests()->save();
-	getSkills()->save(saveCooldowns);
-	getVariables()->save();
+	// The components only write the rows that changed since they were loaded or last saved
+	PlayerLoadData data = getLoadData();
+	int64_t takenAt = 0;
+	if (m_changingChannel) {
+		// Something may have changed the character after the state for the next channel was taken (e.g. party EXP, fame, GM commands)
+		// It's stamped as that state only when nothing did, the next channel loads from the database otherwise
+		PacketBuilder state;
+		PlayerLoader::write(state, data);
+		if (state.getSize() == m_transferState.size() && std::equal(m_transferState.begin(), m_transferState.end(), state.getBuffer())) {
+			takenAt = m_transferTakenAt;
+		}
+	}
+	ChannelServer::getInstance().getPersistence().save(m_id, data, saveCooldowns, takenAt);
 }
 
 auto Player::setOnline(bool online) -> void {
@@ -839,18 +909,24 @@ auto Player::send(const PacketBuilder &builder) -> void {
 	PacketHandler::send(builder);
 }
 
+auto Player::send(const BroadcastPacket &packet) -> void {
+	// TODO FIXME resource
+	if (isDisconnecting()) return;
+	PacketHandler::send(packet);
+}
+
 auto Player::send(const SplitPacketBuilder &builder) -> void {
 	// TODO FIXME resource
 	if (isDisconnecting()) return;
 	send(builder.player);
 }
 
-auto Player::sendMap(const PacketBuilder &builder, bool excludeSelf) -> void {
-	getMap()->send(builder, excludeSelf ? shared_from_this() : nullptr);
+auto Player::sendMap(const PacketBuilder &builder, bool excludeSelf, PacketPriority priority) -> void {
+	getMap()->send(builder, excludeSelf ? shared_from_this() : nullptr, priority);
 }
 
-auto Player::sendMap(const SplitPacketBuilder &builder) -> void {
-	getMap()->send(builder, shared_from_this());
+auto Player::sendMap(const SplitPacketBuilder &builder, PacketPriority priority) -> void {
+	getMap()->send(builder, shared_from_this(), priority);
 }
 
 }
@@ -19,6 +19,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
 #include "Common/ChargeOrStationarySkillData.hpp"
 #include "Common/PacketHandler.hpp"
+#include "Common/PacketPriority.hpp"
 #include "Common/SkillDataProvider.hpp"
 #include "Common/TauswortheGenerator.hpp"
 #include "Common/TimerContainerHolder.hpp"
@@ -36,6 +37,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "ChannelServer/PlayerStorage.hpp"
 #include "ChannelServer/PlayerSummons.hpp"
 #include "ChannelServer/PlayerVariables.hpp"
+#include <atomic>
 #include <ctime>
 #include <memory>
 #include <string>
@@ -43,6 +45,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include <vector>
 
 namespace Vana {
+	class BroadcastPacket;
 	class PacketBuilder;
 	class PacketReader;
 	struct PortalInfo;
@@ -50,8 +53,11 @@ namespace Vana {
 
 	namespace ChannelServer {
 		class Instance;
+		class KeyMaps;
 		class Map;
 		class Party;
+		class SkillMacros;
+		struct PlayerLoadData;
 
 		class Player : public PacketHandler, public enable_shared<Player>, public TimerContainerHolder, public MovableLife {
 			NONCOPYABLE(Player);
@@ -61,10 +67,12 @@ namespace Vana {
 			auto setGmChat(bool chat) -> void { m_gmChat = chat; }
 			auto setSaveOnDc(bool save) -> void { m_saveOnDc = save; }
 			auto setTrading(bool state) -> void { m_tradeState = state; }
+			auto setFameCheckPending(bool pending) -> void { m_fameCheckPending = pending; }
 			auto setChangingChannel(bool v) -> void { m_changingChannel = v; }
 			auto setSkin(skin_id_t id) -> void;
 			auto setFallCounter(int8_t falls) -> void { m_fallCounter = falls; }
 			auto setMapChair(seat_id_t s) -> void { m_mapChair = s; }
+			auto setMapWorker(int32_t worker) -> void { m_mapWorker = worker; }
 			auto setFace(face_id_t id) -> void;
 			auto setHair(hair_id_t id) -> void;
 			auto setMap(map_id_t mapId, const PortalInfo * const portal = nullptr, bool instance = false) -> void;
@@ -89,6 +97,7 @@ namespace Vana {
 			auto isChangingChannel() const -> bool { return m_changingChannel; }
 			auto isTrading() const -> bool { return m_tradeState; }
 			auto isDisconnecting() const -> bool { return m_disconnecting; }
+			auto isFameCheckPending() const -> bool { return m_fameCheckPending; }
 			auto hasGmEquip() const -> bool;
 			auto isUsingGmHide() const -> bool;
 			auto hasGmBenefits() const -> bool;
@@ -151,26 +160,31 @@ namespace Vana {
 			auto initializeRng(PacketBuilder &builder) -> void;
 
 			auto send(const PacketBuilder &builder) -> void;
+			auto send(const BroadcastPacket &packet) -> void;
 			auto send(const SplitPacketBuilder &builder) -> void;
-			auto sendMap(const PacketBuilder &builder, bool excludeSelf = false) -> void;
-			auto sendMap(const SplitPacketBuilder &builder) -> void;
+			auto sendMap(const PacketBuilder &builder, bool excludeSelf = false, PacketPriority priority = PacketPriority::Normal) -> void;
+			auto sendMap(const SplitPacketBuilder &builder, PacketPriority priority = PacketPriority::Normal) -> void;
 		protected:
 			auto handle(PacketReader &reader) -> Result override;
+			auto getShard(header_t opcode) const -> int32_t override;
 			auto onDisconnect() -> void override;
 		private:
 			auto playerConnect(PacketReader &reader) -> void;
+			auto finishConnect(const PlayerLoadData &data, bool hasTransferPacket) -> void;
+			auto getLoadData() const -> PlayerLoadData;
 			auto changeKey(PacketReader &reader) -> void;
 			auto changeSkillMacros(PacketReader &reader) -> void;
-			auto saveStats() -> void;
 			auto internalSetMap(map_id_t mapId, portal_id_t portalId, const Point &pos, bool fromPosition) -> void;
 
 			bool m_tradeState = false;
 			bool m_saveOnDc = true;
 			bool m_isConnect = false;
+			bool m_loading = false;
 			bool m_changingChannel = false;
 			bool m_admin = false;
 			bool m_gmChat = false;
 			bool m_disconnecting = false;
+			bool m_fameCheckPending = false;
 			world_id_t m_worldId = -1;
 			portal_id_t m_mapPos = -1;
 			gender_id_t m_gender = -1;
@@ -189,8 +203,13 @@ namespace Vana {
 			item_id_t m_itemEffect = 0;
 			item_id_t m_chair = 0;
 			int32_t m_gmLevel = 0;
+			// Read off the handler strand to route packets, only written while the player enters or leaves a map
+			std::atomic<int32_t> m_mapWorker{-1};
 			trade_id_t m_tradeId = 0;
 			int64_t m_onlineTime = 0;
+			// What was handed to the next channel on a channel change and when it was taken, see saveAll
+			int64_t m_transferTakenAt = 0;
+			vector_t<unsigned char> m_transferState;
 			Instance *m_instance = nullptr;
 			Party *m_party = nullptr;
 			string_t m_chalkboard;
@@ -211,6 +230,8 @@ namespace Vana {
 			owned_ptr_t<PlayerSummons> m_summons;
 			owned_ptr_t<PlayerVariables> m_variables;
 			owned_ptr_t<TauswortheGenerator> m_randStream;
+			ref_ptr_t<KeyMaps> m_keyMaps;
+			ref_ptr_t<SkillMacros> m_skillMacros;
 			hash_set_t<portal_id_t> m_usedPortals;
 		};
 	}
@@ -30,41 +30,66 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 namespace Vana {
 namespace ChannelServer {
 
-PlayerBuddyList::PlayerBuddyList(Player *player) :
+PlayerBuddyList::PlayerBuddyList(Player *player, const LoadData &data) :
 	m_player{player}
 {
-	load();
+	load(data);
 }
 
-auto PlayerBuddyList::load() -> void {
-	auto &db = Database::getCharDb();
-	auto &sql = db.getSession();
-
-	soci::rowset<> rs = (sql.prepare
-		<< "SELECT bl.id, bl.buddy_character_id, bl.name AS name_cache, c.name, bl.group_name, CASE WHEN c.online = 1 THEN u.online ELSE 0 END AS `online` "
-		<< "FROM " << db.makeTable("buddylist") << " bl "
-		<< "LEFT JOIN " << db.makeTable("characters") << " c ON bl.buddy_character_id = c.character_id "
-		<< "LEFT JOIN " << db.makeTable("accounts") << " u ON c.account_id = u.account_id "
-		<< "WHERE bl.character_id = :char",
-		soci::use(m_player->getId(), "char"));
-
-	for (const auto &row : rs) {
-		addBuddy(db, row);
+auto PlayerBuddyList::fetch(Database &db, player_id_t charId, world_id_t worldId) -> LoadData {
+	LoadData data;
+
+	// The opposite end is joined in so the list doesn't need a lookup per buddy
+	auto &buddiesLoad = db.prepareQuery<player_id_t>("buddy list load", [&db](out_stream_t &query) {
+		query
+			<< "SELECT bl.id, bl.buddy_character_id, bl.name AS name_cache, c.name, bl.group_name, CASE WHEN c.online = 1 THEN u.online ELSE 0 END AS `online`, ob.id AS opposite_id "
+			<< "FROM " << db.makeTable("buddylist") << " bl "
+			<< "LEFT JOIN " << db.makeTable("characters") << " c ON bl.buddy_character_id = c.character_id "
+			<< "LEFT JOIN " << db.makeTable("accounts") << " u ON c.account_id = u.account_id "
+			<< "LEFT JOIN " << db.makeTable("buddylist") << " ob ON ob.character_id = bl.buddy_character_id AND ob.buddy_character_id = bl.character_id "
+			<< "WHERE bl.character_id = :char";
+	});
+
+	for (bool hasRow = buddiesLoad.execute(charId); hasRow; hasRow = buddiesLoad.fetch()) {
+		const soci::row &row = buddiesLoad.getRow();
+		data.buddies.push_back(readBuddy(db, charId, row, row.get<opt_int32_t>("opposite_id").is_initialized()));
 	}
 
-	rs = (sql.prepare
-		<< "SELECT p.* "
-		<< "FROM " << db.makeTable("buddylist_pending") << " p "
-		<< "LEFT JOIN " << db.makeTable("characters") << " c ON c.character_id = p.inviter_character_id "
-		<< "WHERE c.world_id = :world AND p.character_id = :char ",
-		soci::use(m_player->getId(), "char"),
-		soci::use(ChannelServer::getInstance().getWorldId(), "world"));
-
-	BuddyInvite invite;
-	for (const auto &row : rs) {
-		invite = BuddyInvite{};
+	auto &pendingLoad = db.prepareQuery<world_id_t, player_id_t>("buddy list pending load", [&db](out_stream_t &query) {
+		query
+			<< "SELECT p.* "
+			<< "FROM " << db.makeTable("buddylist_pending") << " p "
+			<< "LEFT JOIN " << db.makeTable("characters") << " c ON c.character_id = p.inviter_character_id "
+			<< "WHERE c.world_id = :world AND p.character_id = :char ";
+	});
+
+	for (bool hasRow = pendingLoad.execute(worldId, charId); hasRow; hasRow = pendingLoad.fetch()) {
+		const soci::row &row = pendingLoad.getRow();
+		BuddyInvite invite;
 		invite.id = row.get<player_id_t>("inviter_character_id");
 		invite.name = row.get<string_t>("inviter_name");
+		data.pending.push_back(invite);
+	}
+
+	return data;
+}
+
+auto PlayerBuddyList::getLoadData() const -> LoadData {
+	LoadData data;
+	for (const auto &kvp : m_buddies) {
+		data.buddies.push_back(*kvp.second);
+	}
+	for (const auto &invite : m_pendingBuddies) {
+		data.pending.push_back(invite);
+	}
+	return data;
+}
+
+auto PlayerBuddyList::load(const LoadData &data) -> void {
+	for (const auto &buddy : data.buddies) {
+		m_buddies[buddy.charId] = make_ref_ptr<Buddy>(buddy);
+	}
+	for (const auto &invite : data.pending) {
 		m_pendingBuddies.push_back(invite);
 	}
 }
@@ -81,27 +106,25 @@ auto PlayerBuddyList::addBuddy(const string_t &name, const string_t &group, bool
 	}
 
 	auto &db = Database::getCharDb();
-	auto &sql = db.getSession();
-	soci::row row;
-
-	sql.once
-		<< "SELECT c.character_id, c.name, u.gm_level, u.admin, c.buddylist_size AS buddylist_limit, ("
-		<< "	SELECT COUNT(b.id) "
-		<< "	FROM " << db.makeTable("buddylist") << " b "
-		<< "	WHERE b.character_id = c.character_id"
-		<< ") AS buddylist_size "
-		<< "FROM " << db.makeTable("characters") << " c "
-		<< "INNER JOIN " << db.makeTable("accounts") << " u ON c.account_id = u.account_id "
-		<< "WHERE c.name = :name AND c.world_id = :world ",
-		soci::use(name, "name"),
-		soci::use(ChannelServer::getInstance().getWorldId(), "world"),
-		soci::into(row);
-
-	if (!sql.got_data()) {
+	auto &buddyFind = db.prepareQuery<string_t, world_id_t>("buddy find", [&db](out_stream_t &query) {
+		query
+			<< "SELECT c.character_id, c.name, u.gm_level, u.admin, c.buddylist_size AS buddylist_limit, ("
+			<< "	SELECT COUNT(b.id) "
+			<< "	FROM " << db.makeTable("buddylist") << " b "
+			<< "	WHERE b.character_id = c.character_id"
+			<< ") AS buddylist_size "
+			<< "FROM " << db.makeTable("characters") << " c "
+			<< "INNER JOIN " << db.makeTable("accounts") << " u ON c.account_id = u.account_id "
+			<< "WHERE c.name = :name AND c.world_id = :world ";
+	});
+
+	if (!buddyFind.execute(name, ChannelServer::getInstance().getWorldId())) {
 		// Name does not exist
 		return Packets::Buddy::Errors::UserDoesNotExist;
 	}
 
+	const soci::row &row = buddyFind.getRow();
+
 	if (row.get<int32_t>("gm_level") > 0 && !m_player->isGm()) {
 		// GM cannot be in buddy list unless the player is a GM
 		return Packets::Buddy::Errors::NoGms;
@@ -124,48 +147,35 @@ auto PlayerBuddyList::addBuddy(const string_t &name, const string_t &group, bool
 			return Packets::Buddy::Errors::AlreadyInList;
 		}
 		else {
-			sql.once
-				<< "UPDATE " << db.makeTable("buddylist") << " "
-				<< "SET group_name = :name "
-				<< "WHERE buddy_character_id = :buddy AND character_id = :owner ",
-				soci::use(group, "name"),
-				soci::use(charId, "buddy"),
-				soci::use(m_player->getId(), "owner");
-
+			saveGroup(db, m_player->getId(), charId, group);
 			m_buddies[charId]->groupName = group;
 		}
 	}
 	else {
-		sql.once
-			<< "INSERT INTO " << db.makeTable("buddylist") << " (character_id, buddy_character_id, name, group_name) "
-			<< "VALUES (:owner, :buddy, :name, :group)",
-			soci::use(name, "name"),
-			soci::use(group, "group"),
-			soci::use(charId, "buddy"),
-			soci::use(m_player->getId(), "owner");
+		auto &buddyAdd = db.prepareCommand<player_id_t, player_id_t, string_t, string_t>("buddy add", [&db](out_stream_t &query) {
+			query
+				<< "INSERT INTO " << db.makeTable("buddylist") << " (character_id, buddy_character_id, name, group_name) "
+				<< "VALUES (:owner, :buddy, :name, :group)";
+		});
+		buddyAdd.execute(m_player->getId(), charId, name, group);
 
 		int32_t rowId = db.getLastId<int32_t>();
 
-		sql.once
-			<< "SELECT bl.id, bl.buddy_character_id, bl.name AS name_cache, c.name, bl.group_name, CASE WHEN c.online = 1 THEN u.online ELSE 0 END AS `online` "
-			<< "FROM " << db.makeTable("buddylist") << " bl "
-			<< "LEFT JOIN " << db.makeTable("characters") << " c ON bl.buddy_character_id = c.character_id "
-			<< "LEFT JOIN " << db.makeTable("accounts") << " u ON c.account_id = u.account_id "
-			<< "WHERE bl.id = :row",
-			soci::use(rowId, "row"),
-			soci::into(row);
-
-		addBuddy(db, row);
+		auto &buddyLoad = db.prepareQuery<int32_t>("buddy load", [&db](out_stream_t &query) {
+			query
+				<< "SELECT bl.id, bl.buddy_character_id, bl.name AS name_cache, c.name, bl.group_name, CASE WHEN c.online = 1 THEN u.online ELSE 0 END AS `online` "
+				<< "FROM " << db.makeTable("buddylist") << " bl "
+				<< "LEFT JOIN " << db.makeTable("characters") << " c ON bl.buddy_character_id = c.character_id "
+				<< "LEFT JOIN " << db.makeTable("accounts") << " u ON c.account_id = u.account_id "
+				<< "WHERE bl.id = :row";
+		});
 
-		sql.once
-			<< "SELECT id "
-			<< "FROM " << db.makeTable("buddylist") << " "
-			<< "WHERE character_id = :char AND buddy_character_id = :buddy",
-			soci::use(charId, "char"),
-			soci::use(m_player->getId(), "buddy"),
-			soci::into(rowId);
+		bool inOppositeList = isInOppositeList(db, charId);
+		if (buddyLoad.execute(rowId)) {
+			m_buddies[charId] = make_ref_ptr<Buddy>(readBuddy(db, m_player->getId(), buddyLoad.getRow(), inOppositeList));
+		}
 
-		if (!sql.got_data()) {
+		if (!inOppositeList) {
 			if (invite) {
 				ChannelServer::getInstance().sendWorld(Packets::Interserver::Buddy::buddyInvite(m_player->getId(), charId));
 			}
@@ -197,70 +207,76 @@ auto PlayerBuddyList::removeBuddy(player_id_t charId) -> void {
 	m_buddies.erase(charId);
 
 	auto &db = Database::getCharDb();
-	auto &sql = db.getSession();
-	sql.once
-		<< "DELETE FROM " << db.makeTable("buddylist") << " "
-		<< "WHERE character_id = :char AND buddy_character_id = :buddy",
-		soci::use(m_player->getId(), "char"),
-		soci::use(charId, "buddy");
+	auto &buddyRemove = db.prepareCommand<player_id_t, player_id_t>("buddy remove", [&db](out_stream_t &query) {
+		query
+			<< "DELETE FROM " << db.makeTable("buddylist") << " "
+			<< "WHERE character_id = :char AND buddy_character_id = :buddy";
+	});
+	buddyRemove.execute(m_player->getId(), charId);
 
 	m_player->send(Packets::Buddy::update(ref_ptr_t<Player>{m_player}, Packets::Buddy::ActionTypes::Remove));
 }
 
-auto PlayerBuddyList::addBuddy(Database &db, const soci::row &row) -> void {
+auto PlayerBuddyList::readBuddy(Database &db, player_id_t ownerId, const soci::row &row, bool inOppositeList) -> Buddy {
 	player_id_t charId = row.get<player_id_t>("buddy_character_id");
 	int32_t rowId = row.get<int32_t>("id");
 	opt_string_t name = row.get<opt_string_t>("name");
 	opt_string_t group = row.get<opt_string_t>("group_name");
 	string_t cache = row.get<string_t>("name_cache");
 
-	auto &sql = db.getSession();
 	if (name.is_initialized() && name.get() != cache) {
 		// Outdated name cache, i.e. character renamed
-		sql.once
-			<< "UPDATE " << db.makeTable("buddylist") << " "
-			<< "SET name = :name "
-			<< "WHERE id = :id ",
-			soci::use(name.get(), "name"),
-			soci::use(rowId, "id");
+		auto &nameUpdate = db.prepareCommand<string_t, int32_t>("buddy name update", [&db](out_stream_t &query) {
+			query
+				<< "UPDATE " << db.makeTable("buddylist") << " "
+				<< "SET name = :name "
+				<< "WHERE id = :id ";
+		});
+		nameUpdate.execute(name.get(), rowId);
 	}
 
-	ref_ptr_t<Buddy> buddy = make_ref_ptr<Buddy>();
-	buddy->charId = charId;
+	Buddy buddy;
+	buddy.charId = charId;
 
 	// Note that the cache is for displaying the character name when the character in question is deleted
-	buddy->name = name.get(cache);
+	buddy.name = name.get(cache);
 
 	if (!group.is_initialized()) {
-		buddy->groupName = "Default Group";
-		sql.once
-			<< "UPDATE " << db.makeTable("buddylist") << " "
-			<< "SET group_name = :name "
-			<< "WHERE buddy_character_id = :buddy AND character_id = :owner ",
-			soci::use(buddy->groupName, "name"),
-			soci::use(charId, "buddy"),
-			soci::use(m_player->getId(), "owner");
+		buddy.groupName = "Default Group";
+		saveGroup(db, ownerId, charId, buddy.groupName);
 	}
 	else {
-		buddy->groupName = group.get();
+		buddy.groupName = group.get();
 	}
 
-	sql.once
-		<< "SELECT id "
-		<< "FROM " << db.makeTable("buddylist") << " "
-		<< "WHERE character_id = :char AND buddy_character_id = :buddy ",
-		soci::use(charId, "char"),
-		soci::use(m_player->getId(), "buddy"),
-		soci::into(rowId);
-
-	if (sql.got_data()) {
-		buddy->oppositeStatus = Packets::Buddy::OppositeStatus::Registered;
+	if (inOppositeList) {
+		buddy.oppositeStatus = Packets::Buddy::OppositeStatus::Registered;
 	}
 	else {
-		buddy->oppositeStatus = Packets::Buddy::OppositeStatus::Unregistered;
+		buddy.oppositeStatus = Packets::Buddy::OppositeStatus::Unregistered;
 	}
 
-	m_buddies[charId] = buddy;
+	return buddy;
+}
+
+auto PlayerBuddyList::saveGroup(Database &db, player_id_t ownerId, player_id_t charId, const string_t &group) -> void {
+	auto &groupUpdate = db.prepareCommand<string_t, player_id_t, player_id_t>("buddy group update", [&db](out_stream_t &query) {
+		query
+			<< "UPDATE " << db.makeTable("buddylist") << " "
+			<< "SET group_name = :name "
+			<< "WHERE buddy_character_id = :buddy AND character_id = :owner ";
+	});
+	groupUpdate.execute(group, charId, ownerId);
+}
+
+auto PlayerBuddyList::isInOppositeList(Database &db, player_id_t charId) -> bool {
+	auto &oppositeFind = db.prepareQuery<player_id_t, player_id_t>("buddy opposite find", [&db](out_stream_t &query) {
+		query
+			<< "SELECT id "
+			<< "FROM " << db.makeTable("buddylist") << " "
+			<< "WHERE character_id = :char AND buddy_character_id = :buddy ";
+	});
+	return oppositeFind.execute(charId, m_player->getId());
 }
 
 auto PlayerBuddyList::addBuddies(PacketBuilder &builder) -> void {
@@ -332,12 +348,12 @@ auto PlayerBuddyList::removePendingBuddy(player_id_t id, bool accepted) -> void
 		}
 
 		auto &db = Database::getCharDb();
-		auto &sql = db.getSession();
-		sql.once
-			<< "DELETE FROM " << db.makeTable("buddylist_pending") << " "
-			<< "WHERE character_id = :char AND inviter_character_id = :buddy",
-			soci::use(m_player->getId(), "char"),
-			soci::use(id, "buddy");
+		auto &pendingRemove = db.prepareCommand<player_id_t, player_id_t>("buddy list pending remove", [&db](out_stream_t &query) {
+			query
+				<< "DELETE FROM " << db.makeTable("buddylist_pending") << " "
+				<< "WHERE character_id = :char AND inviter_character_id = :buddy";
+		});
+		pendingRemove.execute(m_player->getId(), id);
 
 		ChannelServer::getInstance().sendWorld(Packets::Interserver::Buddy::acceptBuddyInvite(m_player->getId(), id));
 	}
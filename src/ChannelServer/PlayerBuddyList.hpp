@@ -49,7 +49,16 @@ namespace Vana {
 			NONCOPYABLE(PlayerBuddyList);
 			NO_DEFAULT_CONSTRUCTOR(PlayerBuddyList);
 		public:
-			PlayerBuddyList(Player *player);
+			struct LoadData {
+				vector_t<Buddy> buddies;
+				vector_t<BuddyInvite> pending;
+			};
+
+			PlayerBuddyList(Player *player, const LoadData &data);
+
+			// Only touches the database so it may run on any thread
+			static auto fetch(Database &db, player_id_t charId, world_id_t worldId) -> LoadData;
+			auto getLoadData() const -> LoadData;
 
 			auto addBuddy(const string_t &name, const string_t &group, bool invite = true) -> uint8_t;
 			auto removeBuddy(player_id_t charId) -> void;
@@ -64,8 +73,10 @@ namespace Vana {
 			auto buddyAccepted(player_id_t buddyId) -> void;
 			auto removePendingBuddy(player_id_t id, bool accepted) -> void;
 		private:
-			auto addBuddy(Database &db, const soci::row &row) -> void;
-			auto load() -> void;
+			static auto readBuddy(Database &db, player_id_t ownerId, const soci::row &row, bool inOppositeList) -> Buddy;
+			static auto saveGroup(Database &db, player_id_t ownerId, player_id_t charId, const string_t &group) -> void;
+			auto isInOppositeList(Database &db, player_id_t charId) -> bool;
+			auto load(const LoadData &data) -> void;
 
 			bool m_sentRequest = false;
 			Player *m_player = nullptr;
@@ -17,6 +17,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "PlayerDataProvider.hpp"
 #include "Common/Algorithm.hpp"
+#include "Common/BroadcastPacket.hpp"
 #include "Common/Database.hpp"
 #include "Common/InterHeader.hpp"
 #include "Common/InterHelper.hpp"
@@ -201,18 +202,20 @@ auto PlayerDataProvider::send(player_id_t playerId, const PacketBuilder &builder
 }
 
 auto PlayerDataProvider::send(const vector_t<player_id_t> &playerIds, const PacketBuilder &builder) -> void {
+	BroadcastPacket packet{builder};
 	for (const auto &playerId : playerIds) {
 		auto kvp = m_players.find(playerId);
 		if (kvp != std::end(m_players)) {
-			kvp->second->send(builder);
+			kvp->second->send(packet);
 		}
 	}
 }
 
 auto PlayerDataProvider::send(const PacketBuilder &builder) -> void {
+	BroadcastPacket packet{builder};
 	for (const auto &kvp : m_players) {
 		auto player = kvp.second;
-		player->send(builder);
+		player->send(packet);
 	}
 }
 
@@ -330,6 +333,22 @@ auto PlayerDataProvider::playerEstablished(player_id_t id) -> void {
 	m_connections.erase(id);
 }
 
+auto PlayerDataProvider::isConnecting(player_id_t id) const -> bool {
+	return m_connections.find(id) != std::end(m_connections);
+}
+
+auto PlayerDataProvider::replayConnectable(player_id_t id, const Ip &ip) -> void {
+	// Stands in for the WorldServer, which announces every character and every incoming connection ahead of time
+	auto &data = m_playerData[id];
+	data.id = id;
+
+	ConnectingPlayer player;
+	player.connectIp = ip;
+	player.connectTime = TimeUtilities::getNow();
+	player.packetSize = 0;
+	m_connections[id] = player;
+}
+
 auto PlayerDataProvider::handlePlayerSync(PacketReader &reader) -> void {
 	switch (reader.get<sync_t>()) {
 		case Sync::Player::NewConnectable: handleNewConnectable(reader); break;
@@ -377,6 +396,7 @@ auto PlayerDataProvider::handleChangeChannel(PacketReader &reader) -> void {
 
 	if (auto player = getPlayer(playerId)) {
 		if (!ip.isInitialized()) {
+			player->setChangingChannel(false);
 			player->send(Packets::Player::sendBlockedMessage(Packets::Player::BlockMessages::CannotGo));
 		}
 		else {
@@ -390,10 +410,11 @@ auto PlayerDataProvider::handleChangeChannel(PacketReader &reader) -> void {
 				m_followers.erase(kvp);
 			}
 
-			player->setOnline(false); // Set online to false BEFORE CC packet is sent to player
-			player->send(Packets::Player::changeChannel(ip, port));
+			// The save is written before the player is told to go, the next channel's saves can't be overwritten by it
 			player->saveAll(true);
 			player->setSaveOnDc(false);
+			player->setOnline(false); // Set online to false BEFORE CC packet is sent to player
+			player->send(Packets::Player::changeChannel(ip, port));
 		}
 	}
 }
@@ -81,6 +81,8 @@ namespace Vana {
 			auto checkPlayer(player_id_t id, const Ip &ip, bool &hasPacket) const -> Result;
 			auto getPacket(player_id_t id) const -> PacketReader;
 			auto playerEstablished(player_id_t id) -> void;
+			auto isConnecting(player_id_t id) const -> bool;
+			auto replayConnectable(player_id_t id, const Ip &ip) -> void;
 		private:
 			auto parseChannelConnectPacket(PacketReader &reader) -> void;
 
@@ -293,7 +293,7 @@ auto PlayerHandler::handleDamage(ref_ptr_t<Player> player, PacketReader &reader)
 
 auto PlayerHandler::handleFacialExpression(ref_ptr_t<Player> player, PacketReader &reader) -> void {
 	int32_t face = reader.get<int32_t>();
-	player->sendMap(Packets::Players::faceExpression(player->getId(), face));
+	player->sendMap(Packets::Players::faceExpression(player->getId(), face), PacketPriority::Low);
 }
 
 auto PlayerHandler::handleGetInfo(ref_ptr_t<Player> player, PacketReader &reader) -> void {
@@ -324,7 +324,7 @@ auto PlayerHandler::handleMoving(ref_ptr_t<Player> player, PacketReader &reader)
 	reader.reset(11);
 	MovementHandler::parseMovement(player.get(), reader);
 	reader.reset(11);
-	player->sendMap(Packets::Players::showMoving(player->getId(), reader.getBuffer(), reader.getBufferLength()));
+	player->sendMap(Packets::Players::showMoving(player->getId(), reader.getBuffer(), reader.getBufferLength()), PacketPriority::Low);
 
 	if (player->getFoothold() == 0 && !player->isUsingGmHide()) {
 		// Player is floating in the air
@@ -339,7 +339,15 @@ auto PlayerHandler::handleMoving(ref_ptr_t<Player> player, PacketReader &reader)
 			// There are no footholds below the player
 			int8_t count = player->getFallCounter();
 			if (count > 3) {
-				player->setMap(mapId);
+				// Moving the player through the map list may reach other maps, so it can't happen on the map's worker
+				player->setFallCounter(0);
+				view_ptr_t<Player> weakPlayer = player;
+				ChannelServer::getInstance().postToHandlerStrand([weakPlayer, mapId] {
+					auto player = weakPlayer.lock();
+					if (player != nullptr && player->getMapId() == mapId) {
+						player->setMap(mapId);
+					}
+				});
 			}
 			else {
 				player->setFallCounter(++count);
@@ -38,7 +38,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 namespace Vana {
 namespace ChannelServer {
 
-PlayerInventory::PlayerInventory(Player *player, const array_t<inventory_slot_count_t, Inventories::InventoryCount> &maxSlots, mesos_t mesos) :
+PlayerInventory::PlayerInventory(Player *player, const array_t<inventory_slot_count_t, Inventories::InventoryCount> &maxSlots, mesos_t mesos, const LoadData &data) :
 	m_maxSlots{maxSlots},
 	m_mesos{mesos},
 	m_player{player}
@@ -49,7 +49,7 @@ PlayerInventory::PlayerInventory(Player *player, const array_t<inventory_slot_co
 		m_equipped[i] = init;
 	}
 
-	load();
+	load(data);
 }
 
 PlayerInventory::~PlayerInventory() {
@@ -59,94 +59,256 @@ PlayerInventory::~PlayerInventory() {
 	}
 }
 
-auto PlayerInventory::load() -> void {
-	using namespace soci;
-	auto &db = Database::getCharDb();
-	auto &sql = db.getSession();
-	player_id_t charId = m_player->getId();
-	string_t location = "inventory";
+auto PlayerInventory::fetch(Database &db, player_id_t charId) -> LoadData {
+	LoadData data;
 
-	soci::rowset<> rs = (sql.prepare
-		<< "SELECT i.*, p.index, p.name AS pet_name, p.level, p.closeness, p.fullness "
-		<< "FROM " << db.makeTable("items") << " i "
-		<< "LEFT OUTER JOIN " << db.makeTable("pets") << " p ON i.pet_id = p.pet_id "
-		<< "WHERE i.location = :location AND i.character_id = :char",
-		soci::use(m_player->getId(), "char"),
-		soci::use(location, "location"));
+	auto &itemsLoad = db.prepareQuery<string_t, player_id_t>("inventory items load", [&db](out_stream_t &query) {
+		query
+			<< "SELECT i.*, p.index, p.name AS pet_name, p.level, p.closeness, p.fullness "
+			<< "FROM " << db.makeTable("items") << " i "
+			<< "LEFT OUTER JOIN " << db.makeTable("pets") << " p ON i.pet_id = p.pet_id "
+			<< "WHERE i.location = :location AND i.character_id = :char";
+	});
 
-	for (const auto &row : rs) {
-		Item *item = new Item(row);
-		addItem(row.get<inventory_t>("inv"), row.get<inventory_slot_t>("slot"), item, true);
-
-		if (item->getPetId() != 0) {
-			Pet *pet = new Pet{m_player, item, row};
-			m_player->getPets()->addPet(pet);
+	for (bool hasRow = itemsLoad.execute("inventory", charId); hasRow; hasRow = itemsLoad.fetch()) {
+		const soci::row &row = itemsLoad.getRow();
+		item_key_t key{row.get<inventory_t>("inv"), row.get<inventory_slot_t>("slot")};
+		Item item{row};
+		if (item.getPetId() != 0) {
+			data.pets[key] = Pet::row_t{
+				row.get<opt_int8_t>("index"),
+				row.get<string_t>("pet_name"),
+				row.get<int8_t>("level"),
+				row.get<int16_t>("closeness"),
+				row.get<int8_t>("fullness")};
 		}
+		data.items[key] = item;
 	}
 
-	rs = (sql.prepare << "SELECT t.map_index, t.map_id FROM " << db.makeTable("teleport_rock_locations") << " t WHERE t.character_id = :char", soci::use(m_player->getId(), "char"));
+	auto &rocksLoad = db.prepareQuery<player_id_t>("teleport rocks load", [&db](out_stream_t &query) {
+		query << "SELECT t.map_index, t.map_id FROM " << db.makeTable("teleport_rock_locations") << " t WHERE t.character_id = :char";
+	});
 
-	for (const auto &row : rs) {
-		int8_t index = row.get<int8_t>("map_index");
-		map_id_t mapId = row.get<map_id_t>("map_id");
+	for (bool hasRow = rocksLoad.execute(charId); hasRow; hasRow = rocksLoad.fetch()) {
+		const soci::row &row = rocksLoad.getRow();
+		data.rocks[row.get<int8_t>("map_index")] = row.get<map_id_t>("map_id");
+	}
 
-		if (index >= Inventories::TeleportRockMax) {
-			m_vipLocations.push_back(mapId);
+	return data;
+}
+
+auto PlayerInventory::load(const LoadData &data) -> void {
+	for (const auto &kvp : data.items) {
+		Item *item = new Item{kvp.second};
+		addItem(kvp.first.first, kvp.first.second, item, true);
+
+		auto pet = data.pets.find(kvp.first);
+		if (pet != std::end(data.pets)) {
+			m_player->getPets()->addPet(new Pet{m_player, item, static_cast<int8_t>(kvp.first.second), pet->second});
+		}
+	}
+
+	for (const auto &kvp : data.rocks) {
+		if (kvp.first >= Inventories::TeleportRockMax) {
+			m_vipLocations.push_back(kvp.second);
 		}
 		else {
-			m_rockLocations.push_back(mapId);
+			m_rockLocations.push_back(kvp.second);
 		}
-
 	}
 }
 
-auto PlayerInventory::save() -> void {
+auto PlayerInventory::track(const LoadData &data, SaveState &state) -> void {
+	state.items.commit(data.items);
+	state.rocks.commit(data.rocks);
+	state.pets.commit(getPetRows(data));
+}
+
+auto PlayerInventory::save(Database &db, player_id_t charId, account_id_t accountId, world_id_t worldId, const LoadData &data, SaveState &state) -> size_t {
 	using namespace soci;
-	auto &db = Database::getCharDb();
 	auto &sql = db.getSession();
-	player_id_t charId = m_player->getId();
+	size_t rowsWritten = 0;
+
+	auto rocks = data.rocks;
+	vector_t<int8_t> changedRocks = state.rocks.getChanged(rocks);
+	if (state.rocks.isTracking()) {
+		auto removedRocks = state.rocks.getRemoved(rocks);
+		if (removedRocks.size() > 0) {
+			int8_t rockIndex = 0;
+			statement st = (sql.prepare
+				<< "DELETE FROM " << db.makeTable("teleport_rock_locations") << " "
+				<< "WHERE character_id = :char AND map_index = :i",
+				use(charId, "char"),
+				use(rockIndex, "i"));
+
+			for (int8_t index : removedRocks) {
+				rockIndex = index;
+				st.execute(true);
+				rowsWritten++;
+			}
+		}
+	}
+	else {
+		sql.once << "DELETE FROM " << db.makeTable("teleport_rock_locations") << " WHERE character_id = :char", use(charId, "char");
+		rowsWritten++;
+	}
 
-	sql.once << "DELETE FROM " << db.makeTable("teleport_rock_locations") << " WHERE character_id = :char", use(charId, "char");
-	if (m_rockLocations.size() > 0 || m_vipLocations.size() > 0) {
+	if (changedRocks.size() > 0) {
 		map_id_t mapId = 0;
-		size_t rockIndex = 0;
+		int8_t rockIndex = 0;
 
 		statement st = (sql.prepare
-			<< "INSERT INTO " << db.makeTable("teleport_rock_locations") << " "
+			<< "REPLACE INTO " << db.makeTable("teleport_rock_locations") << " "
 			<< "VALUES (:char, :i, :map)",
 			use(charId, "char"),
 			use(mapId, "map"),
 			use(rockIndex, "i"));
 
-		for (rockIndex = 0; rockIndex < m_rockLocations.size(); ++rockIndex) {
-			mapId = m_rockLocations[rockIndex];
+		for (int8_t index : changedRocks) {
+			rockIndex = index;
+			mapId = rocks[index];
 			st.execute(true);
+			rowsWritten++;
+		}
+	}
+	state.rocks.commit(std::move(rocks));
+
+	auto items = data.items;
+	vector_t<item_key_t> changedItems = state.items.getChanged(items);
+	if (state.items.isTracking()) {
+		// Changed rows are replaced, deleting one that was never written does nothing
+		vector_t<item_key_t> staleItems = state.items.getRemoved(items);
+		staleItems.insert(std::end(staleItems), std::begin(changedItems), std::end(changedItems));
+		if (staleItems.size() > 0) {
+			inventory_t inv = 0;
+			inventory_slot_t slot = 0;
+			statement st = (sql.prepare
+				<< "DELETE FROM " << db.makeTable("items") << " "
+				<< "WHERE location = :inv AND character_id = :char AND inv = :invId AND slot = :slot",
+				use(charId, "char"),
+				use(Item::Inventory, "inv"),
+				use(inv, "invId"),
+				use(slot, "slot"));
+
+			for (const auto &key : staleItems) {
+				inv = key.first;
+				slot = key.second;
+				st.execute(true);
+				rowsWritten++;
+			}
 		}
+	}
+	else {
+		sql.once
+			<< "DELETE FROM " << db.makeTable("items") << " "
+			<< "WHERE location = :inv AND character_id = :char",
+			use(charId, "char"),
+			use(Item::Inventory, "inv");
+		rowsWritten++;
+	}
 
-		rockIndex = Inventories::TeleportRockMax;
-		for (size_t i = 0; i < m_vipLocations.size(); ++i) {
-			mapId = m_vipLocations[i];
+	if (changedItems.size() > 0) {
+		vector_t<ItemDbRecord> v;
+		for (const auto &key : changedItems) {
+			ItemDbRecord rec(key.second, charId, accountId, worldId, Item::Inventory, &items[key]);
+			v.push_back(rec);
+		}
+
+		Item::databaseInsert(db, v);
+		rowsWritten += v.size();
+	}
+	state.items.commit(std::move(items));
+
+	auto pets = getPetRows(data);
+	// Pets aren't deleted from here, their items are
+	auto changedPets = state.pets.getChanged(pets);
+	if (changedPets.size() > 0) {
+		opt_int8_t index = 0;
+		string_t name = "";
+		int8_t level = 0;
+		int16_t closeness = 0;
+		int8_t fullness = 0;
+		pet_id_t petId = 0;
+
+		statement st = (sql.prepare
+			<< "UPDATE " << db.makeTable("pets") << " "
+			<< "SET "
+			<< "	`index` = :index, "
+			<< "	name = :name, "
+			<< "	level = :level, "
+			<< "	closeness = :closeness, "
+			<< "	fullness = :fullness "
+			<< "WHERE pet_id = :pet",
+			use(petId, "pet"),
+			use(index, "index"),
+			use(name, "name"),
+			use(level, "level"),
+			use(closeness, "closeness"),
+			use(fullness, "fullness"));
+
+		for (pet_id_t changedId : changedPets) {
+			const auto &row = pets[changedId];
+			petId = changedId;
+			index = std::get<0>(row);
+			name = std::get<1>(row);
+			level = std::get<2>(row);
+			closeness = std::get<3>(row);
+			fullness = std::get<4>(row);
 			st.execute(true);
-			++rockIndex;
+			rowsWritten++;
 		}
 	}
+	state.pets.commit(std::move(pets));
 
-	sql.once
-		<< "DELETE FROM " << db.makeTable("items") << " "
-		<< "WHERE location = :inv AND character_id = :char",
-		use(charId, "char"),
-		use(Item::Inventory, "inv");
+	return rowsWritten;
+}
 
-	vector_t<ItemDbRecord> v;
+auto PlayerInventory::getItemRows() const -> RowTracker<item_key_t, Item>::rows_t {
+	RowTracker<item_key_t, Item>::rows_t rows;
 	for (inventory_t i = Inventories::EquipInventory; i <= Inventories::InventoryCount; ++i) {
-		const auto &itemsInv = m_items[i - 1];
-		for (const auto &kvp : itemsInv) {
-			ItemDbRecord rec(kvp.first, charId, m_player->getAccountId(), m_player->getWorldId(), Item::Inventory, kvp.second);
-			v.push_back(rec);
+		for (const auto &kvp : m_items[i - 1]) {
+			rows[item_key_t{i, kvp.first}] = *kvp.second;
 		}
 	}
+	return rows;
+}
 
-	Item::databaseInsert(db, v);
+auto PlayerInventory::getPetRows(const LoadData &data) -> RowTracker<pet_id_t, Pet::row_t>::rows_t {
+	RowTracker<pet_id_t, Pet::row_t>::rows_t rows;
+	for (const auto &kvp : data.pets) {
+		auto item = data.items.find(kvp.first);
+		if (item != std::end(data.items)) {
+			rows[item->second.getPetId()] = kvp.second;
+		}
+	}
+	return rows;
+}
+
+auto PlayerInventory::getRockRows() const -> RowTracker<int8_t, map_id_t>::rows_t {
+	RowTracker<int8_t, map_id_t>::rows_t rows;
+	for (size_t i = 0; i < m_rockLocations.size(); ++i) {
+		rows[static_cast<int8_t>(i)] = m_rockLocations[i];
+	}
+	for (size_t i = 0; i < m_vipLocations.size(); ++i) {
+		rows[static_cast<int8_t>(Inventories::TeleportRockMax + i)] = m_vipLocations[i];
+	}
+	return rows;
+}
+
+auto PlayerInventory::getLoadData() const -> LoadData {
+	LoadData data;
+	data.items = getItemRows();
+	for (const auto &kvp : data.items) {
+		pet_id_t petId = kvp.second.getPetId();
+		if (petId == 0) {
+			continue;
+		}
+		if (Pet *pet = m_player->getPets()->getPet(petId)) {
+			data.pets[kvp.first] = Pet::row_t{pet->getIndex(), pet->getName(), pet->getLevel(), pet->getCloseness(), pet->getFullness()};
+		}
+	}
+	data.rocks = getRockRows();
+	return data;
 }
 
 auto PlayerInventory::addMaxSlots(inventory_t inventory, inventory_slot_count_t rows) -> void {
@@ -661,6 +823,21 @@ auto PlayerInventory::connectPacket(PacketBuilder &builder) -> void {
 	}
 }
 
+auto PlayerInventory::connectPacketSize() const -> size_t {
+	// Every item is counted at its full size, the packet only skips a few odd equip slots
+	size_t size = packetSize<int32_t>() + packetSize<inventory_slot_count_t>() * Inventories::InventoryCount;
+	size += packetSize<int8_t>() * (Inventories::InventoryCount + 2);
+	for (const auto &inventory : m_items) {
+		for (const auto &kvp : inventory) {
+			Item *item = kvp.second;
+			size += item->getPetId() == 0 ?
+				Packets::Helpers::addItemInfoSize(kvp.first, item) :
+				packetSize<int8_t>() + Packets::Pets::addInfoSize();
+		}
+	}
+	return size;
+}
+
 auto PlayerInventory::rockPacket(PacketBuilder &builder) -> void {
 	builder.addBuffer(Packets::Helpers::fillRockPacket(m_rockLocations, Inventories::TeleportRockMax));
 	builder.addBuffer(Packets::Helpers::fillRockPacket(m_vipLocations, Inventories::VipRockMax));
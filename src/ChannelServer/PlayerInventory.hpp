@@ -19,13 +19,16 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
 #include "Common/Item.hpp"
 #include "Common/ItemConstants.hpp"
+#include "Common/RowTracker.hpp"
 #include "Common/Types.hpp"
+#include "ChannelServer/Pet.hpp"
 #include <array>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 namespace Vana {
+	class Database;
 	class Item;
 	class PacketBuilder;
 
@@ -36,13 +39,32 @@ namespace Vana {
 			NONCOPYABLE(PlayerInventory);
 			NO_DEFAULT_CONSTRUCTOR(PlayerInventory);
 		public:
-			PlayerInventory(Player *player, const array_t<inventory_slot_count_t, Inventories::InventoryCount> &maxSlots, mesos_t mesos);
+			using item_key_t = pair_t<inventory_t, inventory_slot_t>;
+
+			struct LoadData {
+				RowTracker<item_key_t, Item>::rows_t items;
+				// Keyed by the slot of the pet's item
+				ord_map_t<item_key_t, Pet::row_t> pets;
+				RowTracker<int8_t, map_id_t>::rows_t rocks;
+			};
+			struct SaveState {
+				RowTracker<item_key_t, Item> items;
+				RowTracker<int8_t, map_id_t> rocks;
+				RowTracker<pet_id_t, Pet::row_t> pets;
+			};
+
+			PlayerInventory(Player *player, const array_t<inventory_slot_count_t, Inventories::InventoryCount> &maxSlots, mesos_t mesos, const LoadData &data);
 			~PlayerInventory();
 
-			auto load() -> void;
-			auto save() -> void;
+			// Only reads from the database so it may run on any thread
+			static auto fetch(Database &db, player_id_t charId) -> LoadData;
+			auto getLoadData() const -> LoadData;
+			static auto track(const LoadData &data, SaveState &state) -> void;
+			// Returns the number of rows written, the pets of the items are written here as well
+			static auto save(Database &db, player_id_t charId, account_id_t accountId, world_id_t worldId, const LoadData &data, SaveState &state) -> size_t;
 
 			auto connectPacket(PacketBuilder &builder) -> void;
+			auto connectPacketSize() const -> size_t;
 			auto addEquippedPacket(PacketBuilder &builder) -> void;
 			auto rockPacket(PacketBuilder &builder) -> void;
 			auto wishlistInfoPacket(PacketBuilder &builder) -> void;
@@ -85,7 +107,11 @@ namespace Vana {
 			auto addWishListItem(item_id_t itemId) -> void;
 			auto checkExpiredItems() -> void;
 		private:
+			auto load(const LoadData &data) -> void;
 			auto addEquipped(inventory_slot_t slot, item_id_t itemId) -> void;
+			auto getItemRows() const -> RowTracker<item_key_t, Item>::rows_t;
+			auto getRockRows() const -> RowTracker<int8_t, map_id_t>::rows_t;
+			static auto getPetRows(const LoadData &data) -> RowTracker<pet_id_t, Pet::row_t>::rows_t;
 
 			inventory_slot_t m_hammer = -1;
 			mesos_t m_mesos = 0;
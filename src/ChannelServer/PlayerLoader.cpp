@@ -0,0 +1,374 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "PlayerLoader.hpp"
+#include "Common/ContainerSerialize.hpp"
+#include "Common/Database.hpp"
+#include "Common/Item.hpp"
+#include "Common/PacketBuilder.hpp"
+#include "Common/PacketReader.hpp"
+#include "ChannelServer/KeyMaps.hpp"
+#include "ChannelServer/SkillMacros.hpp"
+
+namespace Vana {
+
+template <>
+struct PacketSerialize<ChannelServer::MountData> {
+	auto read(PacketReader &reader) -> ChannelServer::MountData {
+		ChannelServer::MountData ret;
+		ret.exp = reader.get<int16_t>();
+		ret.tiredness = reader.get<int8_t>();
+		ret.level = reader.get<int8_t>();
+		return ret;
+	}
+	auto write(PacketBuilder &builder, const ChannelServer::MountData &obj) -> void {
+		builder.add<int16_t>(obj.exp);
+		builder.add<int8_t>(obj.tiredness);
+		builder.add<int8_t>(obj.level);
+	}
+};
+
+template <>
+struct PacketSerialize<ChannelServer::PlayerSkillInfo> {
+	auto read(PacketReader &reader) -> ChannelServer::PlayerSkillInfo {
+		ChannelServer::PlayerSkillInfo ret;
+		ret.level = reader.get<skill_level_t>();
+		ret.playerMaxSkillLevel = reader.get<skill_level_t>();
+		return ret;
+	}
+	auto write(PacketBuilder &builder, const ChannelServer::PlayerSkillInfo &obj) -> void {
+		// The skill's own max level comes from the data provider on the other end
+		builder.add<skill_level_t>(obj.level);
+		builder.add<skill_level_t>(obj.playerMaxSkillLevel);
+	}
+};
+
+template <>
+struct PacketSerialize<ChannelServer::ActiveQuest> {
+	auto read(PacketReader &reader) -> ChannelServer::ActiveQuest {
+		ChannelServer::ActiveQuest ret;
+		ret.id = reader.get<quest_id_t>();
+		ret.done = reader.get<bool>();
+		ret.data = reader.get<string_t>();
+		ret.kills = reader.get<ord_map_t<mob_id_t, uint16_t>>();
+		return ret;
+	}
+	auto write(PacketBuilder &builder, const ChannelServer::ActiveQuest &obj) -> void {
+		builder.add<quest_id_t>(obj.id);
+		builder.add<bool>(obj.done);
+		builder.add<string_t>(obj.data);
+		builder.add<ord_map_t<mob_id_t, uint16_t>>(obj.kills);
+	}
+};
+
+template <>
+struct PacketSerialize<ChannelServer::Buddy> {
+	auto read(PacketReader &reader) -> ChannelServer::Buddy {
+		ChannelServer::Buddy ret;
+		ret.oppositeStatus = reader.get<uint8_t>();
+		ret.charId = reader.get<player_id_t>();
+		ret.name = reader.get<string_t>();
+		ret.groupName = reader.get<string_t>();
+		return ret;
+	}
+	auto write(PacketBuilder &builder, const ChannelServer::Buddy &obj) -> void {
+		builder.add<uint8_t>(obj.oppositeStatus);
+		builder.add<player_id_t>(obj.charId);
+		builder.add<string_t>(obj.name);
+		builder.add<string_t>(obj.groupName);
+	}
+};
+
+template <>
+struct PacketSerialize<ChannelServer::BuddyInvite> {
+	auto read(PacketReader &reader) -> ChannelServer::BuddyInvite {
+		ChannelServer::BuddyInvite ret;
+		ret.send = reader.get<bool>();
+		ret.id = reader.get<player_id_t>();
+		ret.name = reader.get<string_t>();
+		return ret;
+	}
+	auto write(PacketBuilder &builder, const ChannelServer::BuddyInvite &obj) -> void {
+		builder.add<bool>(obj.send);
+		builder.add<player_id_t>(obj.id);
+		builder.add<string_t>(obj.name);
+	}
+};
+
+namespace ChannelServer {
+
+auto PlayerLoader::load(player_id_t charId, storage_slot_t defaultStorageSlots, int32_t defaultChars) -> PlayerLoadData {
+	PlayerLoadData data;
+
+	auto &db = Database::getCharDb();
+	auto &characterLoad = db.prepareQuery<player_id_t>("character load", [&db](out_stream_t &query) {
+		query
+			<< "SELECT c.*, u.gm_level, u.admin "
+			<< "FROM " << db.makeTable("characters") << " c "
+			<< "INNER JOIN " << db.makeTable("accounts") << " u ON c.account_id = u.account_id "
+			<< "WHERE c.character_id = :char";
+	});
+
+	if (!characterLoad.execute(charId)) {
+		return data;
+	}
+
+	const soci::row &row = characterLoad.getRow();
+	data.found = true;
+	data.name = row.get<string_t>("name");
+	data.accountId = row.get<account_id_t>("account_id");
+	data.map = row.get<map_id_t>("map");
+	data.gmLevel = row.get<int32_t>("gm_level");
+	data.admin = row.get<bool>("admin");
+	data.face = row.get<face_id_t>("face");
+	data.hair = row.get<hair_id_t>("hair");
+	data.worldId = row.get<world_id_t>("world_id");
+	data.gender = row.get<gender_id_t>("gender");
+	data.skin = row.get<skin_id_t>("skin");
+	data.mapPos = row.get<portal_id_t>("pos");
+	data.buddylistSize = row.get<uint8_t>("buddylist_size");
+	data.bookCover = row.get<opt_int32_t>("book_cover");
+
+	data.level = row.get<player_level_t>("level");
+	data.job = row.get<job_id_t>("job");
+	data.fame = row.get<fame_t>("fame");
+	data.str = row.get<stat_t>("str");
+	data.dex = row.get<stat_t>("dex");
+	data.intt = row.get<stat_t>("int");
+	data.luk = row.get<stat_t>("luk");
+	data.ap = row.get<stat_t>("ap");
+	data.hpMpAp = row.get<health_ap_t>("hpmp_ap");
+	data.sp = row.get<stat_t>("sp");
+	data.hp = row.get<health_t>("chp");
+	data.maxHp = row.get<health_t>("mhp");
+	data.mp = row.get<health_t>("cmp");
+	data.maxMp = row.get<health_t>("mmp");
+	data.exp = row.get<experience_t>("exp");
+
+	data.maxSlots[0] = row.get<inventory_slot_count_t>("equip_slots");
+	data.maxSlots[1] = row.get<inventory_slot_count_t>("use_slots");
+	data.maxSlots[2] = row.get<inventory_slot_count_t>("setup_slots");
+	data.maxSlots[3] = row.get<inventory_slot_count_t>("etc_slots");
+	data.maxSlots[4] = row.get<inventory_slot_count_t>("cash_slots");
+	data.mesos = row.get<mesos_t>("mesos");
+
+	data.inventory = PlayerInventory::fetch(db, charId);
+	data.storage = PlayerStorage::fetch(db, data.accountId, data.worldId, defaultStorageSlots, defaultChars);
+	data.mounts = PlayerMounts::fetch(db, charId);
+	data.skills = PlayerSkills::fetch(db, charId, data.accountId, data.worldId);
+	data.variables = PlayerVariables::fetch(db, charId);
+	data.buddyList = PlayerBuddyList::fetch(db, charId, data.worldId);
+	data.quests = PlayerQuests::fetch(db, charId);
+	data.monsterBook = PlayerMonsterBook::fetch(db, charId);
+
+	data.keyMaps = make_ref_ptr<KeyMaps>();
+	data.keyMaps->load(charId);
+	data.skillMacros = make_ref_ptr<SkillMacros>();
+	data.skillMacros->load(charId);
+
+	return data;
+}
+
+auto PlayerLoader::write(PacketBuilder &builder, const PlayerLoadData &data) -> void {
+	builder
+		.add<string_t>(data.name)
+		.add<account_id_t>(data.accountId)
+		.add<map_id_t>(data.map)
+		.add<int32_t>(data.gmLevel)
+		.add<bool>(data.admin)
+		.add<face_id_t>(data.face)
+		.add<hair_id_t>(data.hair)
+		.add<world_id_t>(data.worldId)
+		.add<gender_id_t>(data.gender)
+		.add<skin_id_t>(data.skin)
+		.add<portal_id_t>(data.mapPos)
+		.add<uint8_t>(data.buddylistSize)
+		.add<opt_int32_t>(data.bookCover)
+		.add<player_level_t>(data.level)
+		.add<job_id_t>(data.job)
+		.add<fame_t>(data.fame)
+		.add<stat_t>(data.str)
+		.add<stat_t>(data.dex)
+		.add<stat_t>(data.intt)
+		.add<stat_t>(data.luk)
+		.add<stat_t>(data.ap)
+		.add<health_ap_t>(data.hpMpAp)
+		.add<stat_t>(data.sp)
+		.add<health_t>(data.hp)
+		.add<health_t>(data.maxHp)
+		.add<health_t>(data.mp)
+		.add<health_t>(data.maxMp)
+		.add<experience_t>(data.exp)
+		.add<mesos_t>(data.mesos);
+
+	for (inventory_slot_count_t slots : data.maxSlots) {
+		builder.add<inventory_slot_count_t>(slots);
+	}
+
+	builder
+		.add<ord_map_t<PlayerInventory::item_key_t, Item>>(data.inventory.items)
+		.add<ord_map_t<int8_t, map_id_t>>(data.inventory.rocks)
+		.add<uint32_t>(static_cast<uint32_t>(data.inventory.pets.size()));
+
+	for (const auto &kvp : data.inventory.pets) {
+		builder
+			.add<PlayerInventory::item_key_t>(kvp.first)
+			.add<opt_int8_t>(std::get<0>(kvp.second))
+			.add<string_t>(std::get<1>(kvp.second))
+			.add<int8_t>(std::get<2>(kvp.second))
+			.add<int16_t>(std::get<3>(kvp.second))
+			.add<int8_t>(std::get<4>(kvp.second));
+	}
+
+	builder
+		.add<storage_slot_t>(data.storage.slots)
+		.add<mesos_t>(data.storage.mesos)
+		.add<int32_t>(data.storage.charSlots)
+		.add<ord_map_t<storage_slot_t, Item>>(data.storage.items)
+		.add<hash_map_t<item_id_t, MountData>>(data.mounts.mounts)
+		.add<hash_map_t<skill_id_t, PlayerSkillInfo>>(data.skills.skills)
+		.add<hash_map_t<skill_id_t, seconds_t>>(data.skills.cooldowns)
+		.add<opt_string_t>(data.skills.blessingPlayer)
+		.add<player_level_t>(data.skills.blessingLevel)
+		.add<hash_map_t<string_t, string_t>>(data.variables.variables)
+		.add<vector_t<Buddy>>(data.buddyList.buddies)
+		.add<vector_t<BuddyInvite>>(data.buddyList.pending)
+		.add<ord_map_t<quest_id_t, ActiveQuest>>(data.quests.quests)
+		.add<ord_map_t<quest_id_t, FileTime>>(data.quests.completed)
+		.add<ord_map_t<item_id_t, uint8_t>>(data.monsterBook.cards);
+
+	// Queued saves leave these out, they're written as soon as they change
+	builder.add<bool>(data.keyMaps != nullptr);
+	if (data.keyMaps != nullptr) {
+		builder.add<ord_map_t<int32_t, KeyMaps::row_t>>(data.keyMaps->getRows());
+	}
+
+	builder.add<bool>(data.skillMacros != nullptr);
+	if (data.skillMacros == nullptr) {
+		return;
+	}
+
+	SkillMacros &macros = *data.skillMacros;
+	builder.add<int8_t>(macros.getMax());
+	for (int8_t i = 0; i <= macros.getMax(); i++) {
+		SkillMacros::SkillMacro *macro = macros.getSkillMacro(i);
+		builder.add<bool>(macro != nullptr);
+		if (macro != nullptr) {
+			builder
+				.add<string_t>(macro->name)
+				.add<bool>(macro->shout)
+				.add<skill_id_t>(macro->skill1)
+				.add<skill_id_t>(macro->skill2)
+				.add<skill_id_t>(macro->skill3);
+		}
+	}
+}
+
+auto PlayerLoader::read(PacketReader &reader) -> PlayerLoadData {
+	PlayerLoadData data;
+	data.found = true;
+	data.name = reader.get<string_t>();
+	data.accountId = reader.get<account_id_t>();
+	data.map = reader.get<map_id_t>();
+	data.gmLevel = reader.get<int32_t>();
+	data.admin = reader.get<bool>();
+	data.face = reader.get<face_id_t>();
+	data.hair = reader.get<hair_id_t>();
+	data.worldId = reader.get<world_id_t>();
+	data.gender = reader.get<gender_id_t>();
+	data.skin = reader.get<skin_id_t>();
+	data.mapPos = reader.get<portal_id_t>();
+	data.buddylistSize = reader.get<uint8_t>();
+	data.bookCover = reader.get<opt_int32_t>();
+	data.level = reader.get<player_level_t>();
+	data.job = reader.get<job_id_t>();
+	data.fame = reader.get<fame_t>();
+	data.str = reader.get<stat_t>();
+	data.dex = reader.get<stat_t>();
+	data.intt = reader.get<stat_t>();
+	data.luk = reader.get<stat_t>();
+	data.ap = reader.get<stat_t>();
+	data.hpMpAp = reader.get<health_ap_t>();
+	data.sp = reader.get<stat_t>();
+	data.hp = reader.get<health_t>();
+	data.maxHp = reader.get<health_t>();
+	data.mp = reader.get<health_t>();
+	data.maxMp = reader.get<health_t>();
+	data.exp = reader.get<experience_t>();
+	data.mesos = reader.get<mesos_t>();
+
+	for (auto &slots : data.maxSlots) {
+		slots = reader.get<inventory_slot_count_t>();
+	}
+
+	data.inventory.items = reader.get<ord_map_t<PlayerInventory::item_key_t, Item>>();
+	data.inventory.rocks = reader.get<ord_map_t<int8_t, map_id_t>>();
+	uint32_t pets = reader.get<uint32_t>();
+	for (uint32_t i = 0; i < pets; i++) {
+		auto key = reader.get<PlayerInventory::item_key_t>();
+		opt_int8_t index = reader.get<opt_int8_t>();
+		string_t name = reader.get<string_t>();
+		int8_t level = reader.get<int8_t>();
+		int16_t closeness = reader.get<int16_t>();
+		int8_t fullness = reader.get<int8_t>();
+		data.inventory.pets[key] = Pet::row_t{index, name, level, closeness, fullness};
+	}
+
+	data.storage.slots = reader.get<storage_slot_t>();
+	data.storage.mesos = reader.get<mesos_t>();
+	data.storage.charSlots = reader.get<int32_t>();
+	data.storage.items = reader.get<ord_map_t<storage_slot_t, Item>>();
+	data.mounts.mounts = reader.get<hash_map_t<item_id_t, MountData>>();
+	data.skills.skills = reader.get<hash_map_t<skill_id_t, PlayerSkillInfo>>();
+	data.skills.cooldowns = reader.get<hash_map_t<skill_id_t, seconds_t>>();
+	data.skills.blessingPlayer = reader.get<opt_string_t>();
+	data.skills.blessingLevel = reader.get<player_level_t>();
+	data.variables.variables = reader.get<hash_map_t<string_t, string_t>>();
+	data.buddyList.buddies = reader.get<vector_t<Buddy>>();
+	data.buddyList.pending = reader.get<vector_t<BuddyInvite>>();
+	data.quests.quests = reader.get<ord_map_t<quest_id_t, ActiveQuest>>();
+	data.quests.completed = reader.get<ord_map_t<quest_id_t, FileTime>>();
+	data.monsterBook.cards = reader.get<ord_map_t<item_id_t, uint8_t>>();
+
+	if (reader.get<bool>()) {
+		data.keyMaps = make_ref_ptr<KeyMaps>();
+		data.keyMaps->load(reader.get<ord_map_t<int32_t, KeyMaps::row_t>>());
+	}
+
+	if (!reader.get<bool>()) {
+		return data;
+	}
+
+	data.skillMacros = make_ref_ptr<SkillMacros>();
+	int8_t maxMacro = reader.get<int8_t>();
+	for (int8_t i = 0; i <= maxMacro; i++) {
+		if (!reader.get<bool>()) {
+			continue;
+		}
+		string_t name = reader.get<string_t>();
+		bool shout = reader.get<bool>();
+		skill_id_t skill1 = reader.get<skill_id_t>();
+		skill_id_t skill2 = reader.get<skill_id_t>();
+		skill_id_t skill3 = reader.get<skill_id_t>();
+		data.skillMacros->add(i, new SkillMacros::SkillMacro(name, shout, skill1, skill2, skill3));
+	}
+
+	return data;
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Types.hpp"
+#include "ChannelServer/PlayerBuddyList.hpp"
+#include "ChannelServer/PlayerInventory.hpp"
+#include "ChannelServer/PlayerMonsterBook.hpp"
+#include "ChannelServer/PlayerMounts.hpp"
+#include "ChannelServer/PlayerQuests.hpp"
+#include "ChannelServer/PlayerSkills.hpp"
+#include "ChannelServer/PlayerStorage.hpp"
+#include "ChannelServer/PlayerVariables.hpp"
+#include <array>
+#include <memory>
+#include <string>
+
+namespace Vana {
+	class PacketBuilder;
+	class PacketReader;
+
+	namespace ChannelServer {
+		class KeyMaps;
+		class SkillMacros;
+
+		// Everything a character needs from the database before it can enter the channel
+		struct PlayerLoadData {
+			bool found = false;
+			string_t name;
+			account_id_t accountId = 0;
+			map_id_t map = 0;
+			int32_t gmLevel = 0;
+			bool admin = false;
+			face_id_t face = 0;
+			hair_id_t hair = 0;
+			world_id_t worldId = 0;
+			gender_id_t gender = 0;
+			skin_id_t skin = 0;
+			portal_id_t mapPos = 0;
+			uint8_t buddylistSize = 0;
+			opt_int32_t bookCover;
+
+			player_level_t level = 0;
+			job_id_t job = 0;
+			fame_t fame = 0;
+			stat_t str = 0;
+			stat_t dex = 0;
+			stat_t intt = 0;
+			stat_t luk = 0;
+			stat_t ap = 0;
+			health_ap_t hpMpAp = 0;
+			stat_t sp = 0;
+			health_t hp = 0;
+			health_t maxHp = 0;
+			health_t mp = 0;
+			health_t maxMp = 0;
+			experience_t exp = 0;
+
+			array_t<inventory_slot_count_t, Inventories::InventoryCount> maxSlots;
+			mesos_t mesos = 0;
+
+			PlayerInventory::LoadData inventory;
+			PlayerStorage::LoadData storage;
+			PlayerMounts::LoadData mounts;
+			PlayerSkills::LoadData skills;
+			PlayerVariables::LoadData variables;
+			PlayerBuddyList::LoadData buddyList;
+			PlayerQuests::LoadData quests;
+			PlayerMonsterBook::LoadData monsterBook;
+			ref_ptr_t<KeyMaps> keyMaps;
+			ref_ptr_t<SkillMacros> skillMacros;
+		};
+
+		namespace PlayerLoader {
+			// Reads the character and every component back to back on the calling thread's connection
+			// Nothing here touches channel state, so it's meant to run on the database executor
+			auto load(player_id_t charId, storage_slot_t defaultStorageSlots, int32_t defaultChars) -> PlayerLoadData;
+			// The same data in a form another channel can take instead of loading it, see Player::getTransferPacket
+			// Key maps and skill macros may be left out (null), they come back null too
+			auto write(PacketBuilder &builder, const PlayerLoadData &data) -> void;
+			auto read(PacketReader &reader) -> PlayerLoadData;
+		}
+	}
+}
\ No newline at end of file
@@ -27,56 +27,103 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 namespace Vana {
 namespace ChannelServer {
 
-PlayerMonsterBook::PlayerMonsterBook(Player *player) :
+PlayerMonsterBook::PlayerMonsterBook(Player *player, const LoadData &data) :
 	m_player{player}
 {
-	load();
+	load(data);
 }
 
-auto PlayerMonsterBook::load() -> void {
-	auto &db = Database::getCharDb();
-	auto &sql = db.getSession();
-	player_id_t charId = m_player->getId();
-
-	soci::rowset<> rs = (sql.prepare
-		<< "SELECT b.card_id, b.level "
-		<< "FROM " << db.makeTable("monster_book") << " b "
-		<< "WHERE b.character_id = :char "
-		<< "ORDER BY b.card_id ASC",
-		soci::use(charId, "char"));
+auto PlayerMonsterBook::fetch(Database &db, player_id_t charId) -> LoadData {
+	auto &cardsLoad = db.prepareQuery<player_id_t>("monster book load", [&db](out_stream_t &query) {
+		query
+			<< "SELECT b.card_id, b.level "
+			<< "FROM " << db.makeTable("monster_book") << " b "
+			<< "WHERE b.character_id = :char "
+			<< "ORDER BY b.card_id ASC";
+	});
+
+	LoadData data;
+	for (bool hasRow = cardsLoad.execute(charId); hasRow; hasRow = cardsLoad.fetch()) {
+		const soci::row &row = cardsLoad.getRow();
+		data.cards[row.get<item_id_t>("card_id")] = row.get<uint8_t>("level");
+	}
+	return data;
+}
 
-	for (const auto &row : rs) {
-		addCard(row.get<item_id_t>("card_id"), row.get<uint8_t>("level"), true);
+auto PlayerMonsterBook::load(const LoadData &data) -> void {
+	for (const auto &kvp : data.cards) {
+		addCard(kvp.first, kvp.second, true);
 	}
 
 	calculateLevel();
 }
 
-auto PlayerMonsterBook::save() -> void {
-	auto &db = Database::getCharDb();
-	auto &sql = db.getSession();
-	player_id_t charId = m_player->getId();
+auto PlayerMonsterBook::track(const LoadData &data, SaveState &state) -> void {
+	state.cards.commit(data.cards);
+}
 
-	sql.once << "DELETE FROM " << db.makeTable("monster_book") << " WHERE character_id = :char", soci::use(charId, "char");
+auto PlayerMonsterBook::save(Database &db, player_id_t charId, const LoadData &data, SaveState &state) -> size_t {
+	auto &sql = db.getSession();
+	item_id_t cardId = 0;
+	size_t rowsWritten = 0;
+
+	auto cards = data.cards;
+	if (state.cards.isTracking()) {
+		auto removed = state.cards.getRemoved(cards);
+		if (removed.size() > 0) {
+			soci::statement st = (sql.prepare
+				<< "DELETE FROM " << db.makeTable("monster_book") << " "
+				<< "WHERE character_id = :char AND card_id = :card",
+				soci::use(charId, "char"),
+				soci::use(cardId, "card"));
+
+			for (item_id_t removedId : removed) {
+				cardId = removedId;
+				st.execute(true);
+				rowsWritten++;
+			}
+		}
+	}
+	else {
+		sql.once << "DELETE FROM " << db.makeTable("monster_book") << " WHERE character_id = :char", soci::use(charId, "char");
+		rowsWritten++;
+	}
 
-	if (m_cards.size() > 0) {
-		item_id_t cardId = 0;
+	auto changed = state.cards.getChanged(cards);
+	if (changed.size() > 0) {
 		uint8_t level = 0;
 
 		soci::statement st = (sql.prepare
-			<< "INSERT INTO " << db.makeTable("monster_book") << " "
+			<< "REPLACE INTO " << db.makeTable("monster_book") << " "
 			<< "VALUES (:char, :card, :level) ",
 			soci::use(charId, "char"),
 			soci::use(cardId, "card"),
 			soci::use(level, "level"));
 
-		for (const auto &kvp : m_cards) {
-			const MonsterCard &c = kvp.second;
-			cardId = c.id;
-			level = c.level;
+		for (item_id_t changedId : changed) {
+			cardId = changedId;
+			level = cards[changedId];
 			st.execute(true);
+			rowsWritten++;
 		}
 	}
+	state.cards.commit(std::move(cards));
+
+	return rowsWritten;
+}
+
+auto PlayerMonsterBook::getRows() const -> RowTracker<item_id_t, uint8_t>::rows_t {
+	RowTracker<item_id_t, uint8_t>::rows_t rows;
+	for (const auto &kvp : m_cards) {
+		rows[kvp.second.id] = kvp.second.level;
+	}
+	return rows;
+}
+
+auto PlayerMonsterBook::getLoadData() const -> LoadData {
+	LoadData data;
+	data.cards = getRows();
+	return data;
 }
 
 auto PlayerMonsterBook::getCardLevel(int32_t cardId) -> uint8_t {
@@ -137,6 +184,10 @@ auto PlayerMonsterBook::connectPacket(PacketBuilder &builder) -> void {
 	}
 }
 
+auto PlayerMonsterBook::connectPacketSize() const -> size_t {
+	return packetSize<int32_t, int8_t, uint16_t>() + packetSize<int16_t, int8_t>() * m_cards.size();
+}
+
 auto PlayerMonsterBook::calculateLevel() -> void {
 	int32_t size = getSize();
 	m_level = MonsterCards::MaxPlayerLevel;
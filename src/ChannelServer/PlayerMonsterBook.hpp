@@ -18,10 +18,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
 #pragma once
 
+#include "Common/RowTracker.hpp"
 #include "Common/Types.hpp"
 #include <unordered_map>
 
 namespace Vana {
+	class Database;
 	class PacketBuilder;
 
 	namespace ChannelServer {
@@ -39,11 +41,24 @@ namespace Vana {
 			NONCOPYABLE(PlayerMonsterBook);
 			NO_DEFAULT_CONSTRUCTOR(PlayerMonsterBook);
 		public:
-			PlayerMonsterBook(Player *player);
+			struct LoadData {
+				// Card ID to level
+				RowTracker<item_id_t, uint8_t>::rows_t cards;
+			};
+			struct SaveState {
+				RowTracker<item_id_t, uint8_t> cards;
+			};
 
-			auto load() -> void;
-			auto save() -> void;
+			PlayerMonsterBook(Player *player, const LoadData &data);
+
+			// Only reads from the database so it may run on any thread
+			static auto fetch(Database &db, player_id_t charId) -> LoadData;
+			auto getLoadData() const -> LoadData;
+			static auto track(const LoadData &data, SaveState &state) -> void;
+			// Returns the number of rows written
+			static auto save(Database &db, player_id_t charId, const LoadData &data, SaveState &state) -> size_t;
 			auto connectPacket(PacketBuilder &builder) -> void;
+			auto connectPacketSize() const -> size_t;
 			auto infoPacket(PacketBuilder &builder) -> void;
 
 			auto addCard(item_id_t itemId, uint8_t level = 1, bool initialLoad = false) -> bool;
@@ -59,6 +74,9 @@ namespace Vana {
 			auto getCover() const -> int32_t { return m_cover; }
 			auto isFull(item_id_t cardId) -> bool;
 		private:
+			auto load(const LoadData &data) -> void;
+			auto getRows() const -> RowTracker<item_id_t, uint8_t>::rows_t;
+
 			int32_t m_specialCount = 0;
 			int32_t m_normalCount = 0;
 			int32_t m_level = 1;
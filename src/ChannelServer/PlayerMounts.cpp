@@ -23,26 +23,50 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 namespace Vana {
 namespace ChannelServer {
 
-PlayerMounts::PlayerMounts(Player *player) :
+PlayerMounts::PlayerMounts(Player *player, const LoadData &data) :
 	m_player{player}
 {
-	load();
+	load(data);
 }
 
-auto PlayerMounts::save() -> void {
-	auto &db = Database::getCharDb();
+auto PlayerMounts::track(const LoadData &data, SaveState &state) -> void {
+	state.mounts.commit(getRows(data));
+}
+
+auto PlayerMounts::save(Database &db, player_id_t charId, const LoadData &data, SaveState &state) -> size_t {
 	auto &sql = db.getSession();
-	player_id_t charId = m_player->getId();
 	item_id_t itemId = 0;
 	int16_t exp = 0;
 	uint8_t tiredness = 0;
 	uint8_t level = 0;
+	size_t rowsWritten = 0;
+
+	auto mounts = getRows(data);
+	if (state.mounts.isTracking()) {
+		auto removed = state.mounts.getRemoved(mounts);
+		if (removed.size() > 0) {
+			soci::statement st = (sql.prepare
+				<< "DELETE FROM " << db.makeTable("mounts") << " "
+				<< "WHERE character_id = :char AND mount_id = :item",
+				soci::use(charId, "char"),
+				soci::use(itemId, "item"));
+
+			for (item_id_t removedId : removed) {
+				itemId = removedId;
+				st.execute(true);
+				rowsWritten++;
+			}
+		}
+	}
+	else {
+		sql.once << "DELETE FROM " << db.makeTable("mounts") << " WHERE character_id = :char", soci::use(charId, "char");
+		rowsWritten++;
+	}
 
-	sql.once << "DELETE FROM " << db.makeTable("mounts") << " WHERE character_id = :char", soci::use(charId, "char");
-
-	if (m_mounts.size() > 0) {
+	auto changed = state.mounts.getChanged(mounts);
+	if (changed.size() > 0) {
 		soci::statement st = (sql.prepare
-			<< "INSERT INTO " << db.makeTable("mounts") << " "
+			<< "REPLACE INTO " << db.makeTable("mounts") << " "
 			<< "VALUES (:char, :item, :exp, :level, :tiredness) ",
 			soci::use(charId, "char"),
 			soci::use(itemId, "item"),
@@ -50,31 +74,54 @@ auto PlayerMounts::save() -> void {
 			soci::use(level, "level"),
 			soci::use(tiredness, "tiredness"));
 
-		for (const auto &kvp : m_mounts) {
-			const MountData &c = kvp.second;
-			itemId = kvp.first;
-			exp = c.exp;
-			level = c.level;
-			tiredness = c.tiredness;
+		for (item_id_t changedId : changed) {
+			const row_t &row = mounts[changedId];
+			itemId = changedId;
+			exp = std::get<0>(row);
+			tiredness = std::get<1>(row);
+			level = std::get<2>(row);
 			st.execute(true);
+			rowsWritten++;
 		}
 	}
+	state.mounts.commit(std::move(mounts));
+
+	return rowsWritten;
 }
 
-auto PlayerMounts::load() -> void {
-	auto &db = Database::getCharDb();
-	auto &sql = db.getSession();
-	player_id_t charId = m_player->getId();
+auto PlayerMounts::getRows(const LoadData &data) -> RowTracker<item_id_t, row_t>::rows_t {
+	RowTracker<item_id_t, row_t>::rows_t rows;
+	for (const auto &kvp : data.mounts) {
+		rows[kvp.first] = row_t{kvp.second.exp, kvp.second.tiredness, kvp.second.level};
+	}
+	return rows;
+}
 
-	soci::rowset<> rs = (sql.prepare << "SELECT m.* FROM " << db.makeTable("mounts") << " m WHERE m.character_id = :char ", soci::use(charId, "char"));
+auto PlayerMounts::getLoadData() const -> LoadData {
+	LoadData data;
+	data.mounts = m_mounts;
+	return data;
+}
 
-	for (const auto &row : rs) {
+auto PlayerMounts::fetch(Database &db, player_id_t charId) -> LoadData {
+	auto &mountsLoad = db.prepareQuery<player_id_t>("mounts load", [&db](out_stream_t &query) {
+		query << "SELECT m.* FROM " << db.makeTable("mounts") << " m WHERE m.character_id = :char ";
+	});
+
+	LoadData data;
+	for (bool hasRow = mountsLoad.execute(charId); hasRow; hasRow = mountsLoad.fetch()) {
+		const soci::row &row = mountsLoad.getRow();
 		MountData c;
 		c.exp = row.get<int16_t>("exp");
 		c.level = row.get<int8_t>("level");
 		c.tiredness = row.get<int8_t>("tiredness");
-		m_mounts[row.get<item_id_t>("mount_id")] = c;
+		data.mounts[row.get<item_id_t>("mount_id")] = c;
 	}
+	return data;
+}
+
+auto PlayerMounts::load(const LoadData &data) -> void {
+	m_mounts = data.mounts;
 }
 
 auto PlayerMounts::getCurrentExp() -> int16_t {
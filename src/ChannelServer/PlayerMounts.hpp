@@ -17,10 +17,13 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #pragma once
 
+#include "Common/RowTracker.hpp"
 #include "Common/Types.hpp"
+#include <tuple>
 #include <unordered_map>
 
 namespace Vana {
+	class Database;
 	class PacketBuilder;
 
 	namespace ChannelServer {
@@ -36,10 +39,23 @@ namespace Vana {
 			NONCOPYABLE(PlayerMounts);
 			NO_DEFAULT_CONSTRUCTOR(PlayerMounts);
 		public:
-			PlayerMounts(Player *player);
+			using row_t = tuple_t<int16_t, int8_t, int8_t>;
 
-			auto save() -> void;
-			auto load() -> void;
+			struct LoadData {
+				hash_map_t<item_id_t, MountData> mounts;
+			};
+			struct SaveState {
+				RowTracker<item_id_t, row_t> mounts;
+			};
+
+			PlayerMounts(Player *player, const LoadData &data);
+
+			// Only reads from the database so it may run on any thread
+			static auto fetch(Database &db, player_id_t charId) -> LoadData;
+			auto getLoadData() const -> LoadData;
+			static auto track(const LoadData &data, SaveState &state) -> void;
+			// Returns the number of rows written
+			static auto save(Database &db, player_id_t charId, const LoadData &data, SaveState &state) -> size_t;
 
 			auto mountInfoPacket(PacketBuilder &builder) -> void;
 			auto mountInfoMapSpawnPacket(PacketBuilder &builder) -> void;
@@ -59,6 +75,9 @@ namespace Vana {
 			auto getMountLevel(item_id_t id) -> int8_t;
 			auto getMountTiredness(item_id_t id) -> int8_t;
 		private:
+			auto load(const LoadData &data) -> void;
+			static auto getRows(const LoadData &data) -> RowTracker<item_id_t, row_t>::rows_t;
+
 			item_id_t m_currentMount = 0;
 			Player *m_player = nullptr;
 			hash_map_t<item_id_t, MountData> m_mounts;
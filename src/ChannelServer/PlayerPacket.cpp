@@ -19,6 +19,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "Common/ClientIp.hpp"
 #include "Common/FileTime.hpp"
 #include "Common/InterHeader.hpp"
+#include "Common/ItemConstants.hpp"
 #include "Common/Session.hpp"
 #include "Common/TimeUtilities.hpp"
 #include "ChannelServer/ChannelServer.hpp"
@@ -38,7 +39,23 @@ namespace Packets {
 namespace Player {
 
 PACKET_IMPL(connectData, ref_ptr_t<Vana::ChannelServer::Player> player) {
-	PacketBuilder builder;
+	// This is the largest packet the server sends, so size it up front rather than growing it section by section
+	size_t size =
+		packetSize<header_t, int32_t, uint8_t, bool, int16_t>() +
+		packetSize<uint32_t, uint32_t, uint32_t>() + // RNG seeds
+		packetSize<int64_t, player_id_t>() + 13 + packetSize<gender_id_t, skin_id_t, face_id_t, hair_id_t>() +
+		player->getPets()->connectPacketSize() +
+		player->getStats()->connectPacketSize() +
+		packetSize<int32_t, map_id_t, portal_id_t, int32_t, uint8_t>() +
+		player->getInventory()->connectPacketSize() +
+		player->getSkills()->connectPacketSize() +
+		player->getQuests()->connectPacketSize() +
+		packetSize<int16_t, int16_t, int16_t, int16_t>() +
+		packetSize<map_id_t>() * (Inventories::TeleportRockMax + Inventories::VipRockMax) +
+		player->getMonsterBook()->connectPacketSize() +
+		packetSize<int16_t, int16_t, int16_t, FileTime>();
+
+	PacketBuilder builder{size};
 	builder
 		.add<header_t>(SMSG_CHANGE_MAP)
 		.add<int32_t>(ChannelServer::getInstance().getChannelId())
@@ -111,6 +111,28 @@ PACKET_IMPL(addItemInfo, inventory_slot_t slot, Item *item, bool shortSlot) {
 	return builder;
 }
 
+auto addItemInfoSize(inventory_slot_t slot, Item *item, bool shortSlot) -> size_t {
+	size_t size = 0;
+	if (slot != 0) {
+		size += shortSlot ? packetSize<inventory_slot_t>() : packetSize<int8_t>();
+	}
+	size += packetSize<int8_t, item_id_t, int8_t, FileTime>();
+	if (GameLogicUtilities::isEquip(item->getId())) {
+		size += packetSize<int8_t, int8_t>();
+		size += packetSize<stat_t>() * 4 + packetSize<health_t>() * 2 + packetSize<stat_t>() * 9;
+		size += packetSize(item->getName()) + packetSize<int16_t>();
+		size += packetSize<int8_t, int8_t, int16_t, int16_t, int32_t, int64_t>();
+		size += 8 + packetSize<int32_t>(); // The constant bytes and the trailing -1
+	}
+	else {
+		size += packetSize<slot_qty_t>() + packetSize(item->getName()) + packetSize<int16_t>();
+		if (GameLogicUtilities::isRechargeable(item->getId())) {
+			size += packetSize<int64_t>();
+		}
+	}
+	return size;
+}
+
 PACKET_IMPL(addPlayerDisplay, ref_ptr_t<Vana::ChannelServer::Player> player) {
 	PacketBuilder builder;
 	builder
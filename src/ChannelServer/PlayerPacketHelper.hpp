@@ -29,6 +29,7 @@ namespace Vana {
 		namespace Packets {
 			namespace Helpers {
 				PACKET(addItemInfo, inventory_slot_t slot, Item *item, bool shortSlot = false);
+				auto addItemInfoSize(inventory_slot_t slot, Item *item, bool shortSlot = false) -> size_t;
 				PACKET(addPlayerDisplay, ref_ptr_t<Vana::ChannelServer::Player> player);
 			}
 		}
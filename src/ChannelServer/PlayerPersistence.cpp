@@ -0,0 +1,447 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "PlayerPersistence.hpp"
+#include "Common/Database.hpp"
+#include "Common/DatabaseExecutor.hpp"
+#include "Common/Journal.hpp"
+#include "Common/PacketBuilder.hpp"
+#include "Common/PacketReader.hpp"
+#include "Common/Timer.hpp"
+#include "Common/TimerContainer.hpp"
+#include "Common/TimerThread.hpp"
+#include "Common/TimerType.hpp"
+#include "Common/TimeUtilities.hpp"
+#include "ChannelServer/ChannelServer.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace Vana {
+namespace ChannelServer {
+
+PlayerPersistence::PlayerPersistence()
+{
+}
+
+PlayerPersistence::~PlayerPersistence() = default;
+
+auto PlayerPersistence::start(const string_t &journalFile, seconds_t flushInterval) -> Result {
+	if (m_journal != nullptr) {
+		return Result::Successful;
+	}
+
+	m_journal = make_owned_ptr<Journal>(journalFile);
+	if (recover() == Result::Failure) {
+		// The journal is left as it is so the next start can try again
+		m_journal.reset();
+		return Result::Failure;
+	}
+	if (m_journal->clear() == Result::Failure) {
+		ChannelServer::getInstance().log(LogType::CriticalError, "Unable to open the player journal " + journalFile);
+		m_journal.reset();
+		return Result::Failure;
+	}
+	if (flushInterval.count() <= 0) {
+		// Only opened for what a previous run left behind
+		m_journal.reset();
+		return Result::Successful;
+	}
+
+	Vana::Timer::Timer::create(
+		[this](const time_point_t &now) {
+			if (m_flushPosted.exchange(true)) {
+				// The last flush hasn't started yet
+				return;
+			}
+			Result posted = DatabaseExecutor::getInstance().execute("player flush", [this] {
+				m_flushPosted = false;
+				this->flush();
+			});
+			if (posted == Result::Failure) {
+				// The executor is full, the next tick tries again
+				m_flushPosted = false;
+			}
+		},
+		Vana::Timer::Id{TimerType::FlushTimer},
+		Vana::Timer::TimerThread::getInstance().getTimerContainer(),
+		flushInterval,
+		flushInterval);
+
+	return Result::Successful;
+}
+
+auto PlayerPersistence::stop() -> void {
+	if (m_journal == nullptr) {
+		return;
+	}
+
+	Vana::Timer::TimerThread::getInstance().getTimerContainer()->removeTimer(Vana::Timer::Id{TimerType::FlushTimer});
+	flush();
+}
+
+auto PlayerPersistence::isWriteBehind() const -> bool {
+	return m_journal != nullptr;
+}
+
+auto PlayerPersistence::track(player_id_t charId, const PlayerLoadData &data) -> void {
+	owned_lock_t<mutex_t> l{m_writeMutex};
+	PlayerSaveState &state = m_states[charId];
+	state = PlayerSaveState{};
+	PlayerInventory::track(data.inventory, state.inventory);
+	PlayerStorage::track(data.storage, state.storage);
+	PlayerMonsterBook::track(data.monsterBook, state.monsterBook);
+	PlayerMounts::track(data.mounts, state.mounts);
+	PlayerQuests::track(data.quests, state.quests);
+	PlayerSkills::track(data.skills, state.skills);
+	PlayerVariables::track(data.variables, state.variables);
+}
+
+auto PlayerPersistence::save(player_id_t charId, const PlayerLoadData &data, bool saveCooldowns, int64_t takenAt) -> void {
+	owned_lock_t<mutex_t> l{m_writeMutex};
+	{
+		owned_lock_t<mutex_t> pending{m_mutex};
+		m_pending.erase(charId);
+	}
+
+	write(Database::getCharDb(), charId, data, takenAt != 0 ? takenAt : getSaveTime(), saveCooldowns);
+
+	owned_lock_t<mutex_t> pending{m_mutex};
+	if (m_journal != nullptr && m_journal->getSize() > 0) {
+		// Whatever the journal holds for the character is older than this, it mustn't be written again after a crash
+		// A save cut short by a crash is rolled back, the journal's older save is what gets written then
+		appendJournal(charId, nullptr);
+	}
+}
+
+auto PlayerPersistence::queue(player_id_t charId, PlayerLoadData data) -> void {
+	if (!isWriteBehind()) {
+		save(charId, data, false);
+		return;
+	}
+
+	// Key maps and macros are written as soon as they change, the queue doesn't need the character's copies
+	data.keyMaps.reset();
+	data.skillMacros.reset();
+
+	PendingSave save;
+	save.data = std::move(data);
+	save.takenAt = getSaveTime();
+
+	owned_lock_t<mutex_t> l{m_mutex};
+	appendJournal(charId, &save);
+	m_stats.queuedSaves++;
+	auto kvp = m_pending.find(charId);
+	if (kvp != std::end(m_pending)) {
+		kvp->second = std::move(save);
+		m_stats.coalesced++;
+	}
+	else {
+		m_pending.emplace(charId, std::move(save));
+	}
+}
+
+auto PlayerPersistence::release(player_id_t charId) -> void {
+	owned_lock_t<mutex_t> l{m_writeMutex};
+	m_states.erase(charId);
+}
+
+auto PlayerPersistence::recover() -> Result {
+	ord_map_t<player_id_t, PendingSave> saves;
+	size_t records = m_journal->replay([&saves](PacketReader &reader) {
+		player_id_t charId = reader.get<player_id_t>();
+		if (reader.get<bool>()) {
+			PendingSave &save = saves[charId];
+			save.takenAt = reader.get<int64_t>();
+			save.data = PlayerLoader::read(reader);
+		}
+		else {
+			saves.erase(charId);
+		}
+	});
+
+	if (saves.size() == 0) {
+		return Result::Successful;
+	}
+
+	auto &channel = ChannelServer::getInstance();
+	size_t stale = 0;
+	try {
+		owned_lock_t<mutex_t> l{m_writeMutex};
+		auto &db = Database::getCharDb();
+		for (const auto &kvp : saves) {
+			if (!write(db, kvp.first, kvp.second.data, kvp.second.takenAt, false, true)) {
+				// Written before the crash, or the character was saved again since (e.g. on another channel)
+				stale++;
+			}
+		}
+	}
+	catch (std::exception &e) {
+		channel.log(LogType::CriticalError, "Unable to write the saves left in the player journal: " + string_t{e.what()});
+		return Result::Failure;
+	}
+
+	channel.log(LogType::Info, [&](out_stream_t &log) {
+		log << "Wrote " << saves.size() - stale << " character save(s) left in the player journal from " << records << " record(s), "
+			<< stale << " were older than what the database holds";
+	});
+	return Result::Successful;
+}
+
+auto PlayerPersistence::flush() -> void {
+	owned_lock_t<mutex_t> flushLock{m_flushMutex};
+	vector_t<player_id_t> batch;
+	{
+		owned_lock_t<mutex_t> l{m_mutex};
+		for (const auto &kvp : m_pending) {
+			batch.push_back(kvp.first);
+		}
+	}
+	if (batch.size() == 0) {
+		return;
+	}
+
+	time_point_t start = TimeUtilities::getNow();
+	auto &db = Database::getCharDb();
+	size_t written = 0;
+	for (player_id_t charId : batch) {
+		owned_lock_t<mutex_t> writeLock{m_writeMutex};
+		PendingSave save;
+		{
+			owned_lock_t<mutex_t> l{m_mutex};
+			auto kvp = m_pending.find(charId);
+			if (kvp == std::end(m_pending)) {
+				// The character left and was saved in the meantime
+				continue;
+			}
+			save = std::move(kvp->second);
+			m_pending.erase(kvp);
+		}
+
+		try {
+			write(db, charId, save.data, save.takenAt, false);
+			written++;
+		}
+		catch (std::exception &e) {
+			ChannelServer::getInstance().log(LogType::Error, [&](out_stream_t &log) {
+				log << "Unable to write the queued save of character " << charId << ": " << e.what();
+			});
+
+			owned_lock_t<mutex_t> l{m_mutex};
+			// Queued again unless a newer save came in, the rest of the batch waits for the next flush
+			m_pending.emplace(charId, std::move(save));
+			m_stats.failures++;
+			break;
+		}
+	}
+
+	microseconds_t elapsed = duration_cast<microseconds_t>(TimeUtilities::getNow() - start);
+	owned_lock_t<mutex_t> l{m_mutex};
+	if (m_pending.size() == 0 && m_journal != nullptr && m_journal->getSize() > 0) {
+		if (m_journal->clear() == Result::Failure) {
+			ChannelServer::getInstance().log(LogType::Error, "Unable to empty the player journal");
+		}
+	}
+
+	m_stats.flushes++;
+	m_stats.flushedSaves += written;
+	m_stats.lastBatch = written;
+	m_stats.lastFlush = elapsed;
+	m_stats.totalFlush += elapsed;
+	m_stats.maxFlush = std::max(m_stats.maxFlush, elapsed);
+}
+
+auto PlayerPersistence::write(Database &db, player_id_t charId, const PlayerLoadData &data, int64_t takenAt, bool saveCooldowns, bool onlyIfNewer) -> bool {
+	time_point_t start = TimeUtilities::getNow();
+	// A character that isn't on the channel has nothing to compare against, all of it is written again
+	// A tracked character's state is taken out until the save commits, a failed save leaves it untracked so the next one is written whole
+	PlayerSaveState state;
+	auto kvp = m_states.find(charId);
+	bool tracked = kvp != std::end(m_states);
+	if (tracked) {
+		state = std::move(kvp->second);
+		m_states.erase(kvp);
+	}
+
+	// The components start by deleting rows, a save is written entirely or not at all
+	soci::transaction transaction{db.getSession()};
+	if (onlyIfNewer && !claimSave(db, charId, takenAt)) {
+		if (tracked) {
+			m_states[charId] = std::move(state);
+		}
+		return false;
+	}
+
+	saveCharacter(db, charId, data, takenAt);
+	size_t rowsWritten = 1;
+	rowsWritten += PlayerInventory::save(db, charId, data.accountId, data.worldId, data.inventory, state.inventory);
+	rowsWritten += PlayerStorage::save(db, charId, data.accountId, data.worldId, data.storage, state.storage);
+	rowsWritten += PlayerMonsterBook::save(db, charId, data.monsterBook, state.monsterBook);
+	rowsWritten += PlayerMounts::save(db, charId, data.mounts, state.mounts);
+	rowsWritten += PlayerQuests::save(db, charId, data.quests, state.quests);
+	rowsWritten += PlayerSkills::save(db, charId, data.skills, state.skills, saveCooldowns);
+	rowsWritten += PlayerVariables::save(db, charId, data.variables, state.variables);
+	transaction.commit();
+
+	if (tracked) {
+		m_states[charId] = std::move(state);
+	}
+	ChannelServer::getInstance().getSaveStats().record(rowsWritten, duration_cast<microseconds_t>(TimeUtilities::getNow() - start));
+	return true;
+}
+
+auto PlayerPersistence::appendJournal(player_id_t charId, const PendingSave *save) -> void {
+	PacketBuilder record;
+	record
+		.add<player_id_t>(charId)
+		.add<bool>(save != nullptr);
+
+	if (save != nullptr) {
+		record.add<int64_t>(save->takenAt);
+		PlayerLoader::write(record, save->data);
+	}
+
+	if (m_journal->append(record) == Result::Failure) {
+		ChannelServer::getInstance().log(LogType::Error, [&](out_stream_t &log) {
+			log << "Unable to journal the save of character " << charId << ", it's only kept in memory until the next flush";
+		});
+	}
+}
+
+auto PlayerPersistence::claimSave(Database &db, player_id_t charId, int64_t takenAt) -> bool {
+	// Compared and stamped in one statement, the row stays locked until the save's transaction ends
+	auto &sql = db.getSession();
+	soci::statement st = (sql.prepare
+		<< "UPDATE " << db.makeTable("characters") << " "
+		<< "SET last_saved = :saved "
+		<< "WHERE character_id = :char AND last_saved < :saved",
+		soci::use(charId, "char"),
+		soci::use(takenAt, "saved"));
+
+	st.execute();
+	return st.get_affected_rows() > 0;
+}
+
+auto PlayerPersistence::saveCharacter(Database &db, player_id_t charId, const PlayerLoadData &data, int64_t takenAt) -> void {
+	auto &statsSave = db.prepareCommand<
+		player_level_t, job_id_t, stat_t, stat_t, stat_t, stat_t,
+		health_t, health_t, health_t, health_t, health_ap_t, stat_t, stat_t,
+		experience_t, fame_t, map_id_t, portal_id_t, gender_id_t, skin_id_t, face_id_t, hair_id_t, mesos_t,
+		inventory_slot_count_t, inventory_slot_count_t, inventory_slot_count_t, inventory_slot_count_t, inventory_slot_count_t,
+		uint8_t, opt_int32_t, int64_t, player_id_t>("character save", [&db](out_stream_t &query) {
+		query
+			<< "UPDATE " << db.makeTable("characters") << " "
+			<< "SET "
+			<< "	level = :level, "
+			<< "	job = :job, "
+			<< "	str = :str, "
+			<< "	dex = :dex, "
+			<< "	`int` = :int, "
+			<< "	luk = :luk, "
+			<< "	chp = :hp, "
+			<< "	mhp = :maxhp, "
+			<< "	cmp = :mp, "
+			<< "	mmp = :maxmp, "
+			<< "	hpmp_ap = :hpmpap, "
+			<< "	ap = :ap, "
+			<< "	sp = :sp, "
+			<< "	exp = :exp, "
+			<< "	fame = :fame, "
+			<< "	map = :map, "
+			<< "	pos = :pos, "
+			<< "	gender = :gender, "
+			<< "	skin = :skin, "
+			<< "	face = :face, "
+			<< "	hair = :hair, "
+			<< "	mesos = :money, "
+			<< "	equip_slots = :equip, "
+			<< "	use_slots = :use, "
+			<< "	setup_slots = :setup, "
+			<< "	etc_slots = :etc, "
+			<< "	cash_slots = :cash, "
+			<< "	buddylist_size = :buddylist, "
+			<< "	book_cover = :cover, "
+			<< "	last_saved = :saved "
+			<< "WHERE character_id = :char";
+	});
+
+	statsSave.execute(
+		data.level,
+		data.job,
+		data.str,
+		data.dex,
+		data.intt,
+		data.luk,
+		data.hp,
+		data.maxHp,
+		data.mp,
+		data.maxMp,
+		data.hpMpAp,
+		data.ap,
+		data.sp,
+		data.exp,
+		data.fame,
+		data.map,
+		data.mapPos,
+		data.gender,
+		data.skin,
+		data.face,
+		data.hair,
+		data.mesos,
+		data.maxSlots[Inventories::EquipInventory - 1],
+		data.maxSlots[Inventories::UseInventory - 1],
+		data.maxSlots[Inventories::SetupInventory - 1],
+		data.maxSlots[Inventories::EtcInventory - 1],
+		data.maxSlots[Inventories::CashInventory - 1],
+		data.buddylistSize,
+		data.bookCover,
+		takenAt,
+		charId);
+}
+
+auto PlayerPersistence::getLastSaved(player_id_t charId) -> int64_t {
+	auto &db = Database::getCharDb();
+	auto &sql = db.getSession();
+	int64_t lastSaved = 0;
+	sql.once
+		<< "SELECT last_saved "
+		<< "FROM " << db.makeTable("characters") << " "
+		<< "WHERE character_id = :char",
+		soci::use(charId, "char"),
+		soci::into(lastSaved);
+	return lastSaved;
+}
+
+auto PlayerPersistence::getSaveTime() -> int64_t {
+	// Wall clock time, the stamps are compared across channels
+	return duration_cast<milliseconds_t>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+auto PlayerPersistence::getStats() const -> Stats {
+	owned_lock_t<mutex_t> l{m_mutex};
+	Stats stats = m_stats;
+	stats.queued = m_pending.size();
+	stats.journalBytes = m_journal != nullptr ? m_journal->getSize() : 0;
+	return stats;
+}
+
+auto PlayerPersistence::resetStats() -> void {
+	owned_lock_t<mutex_t> l{m_mutex};
+	m_stats = Stats{};
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Types.hpp"
+#include "ChannelServer/PlayerLoader.hpp"
+#include <atomic>
+#include <mutex>
+
+namespace Vana {
+	class Database;
+	class Journal;
+
+	namespace ChannelServer {
+		// What the database holds for a character as far as this channel knows, saves only write what differs from it
+		struct PlayerSaveState {
+			PlayerInventory::SaveState inventory;
+			PlayerStorage::SaveState storage;
+			PlayerMonsterBook::SaveState monsterBook;
+			PlayerMounts::SaveState mounts;
+			PlayerQuests::SaveState quests;
+			PlayerSkills::SaveState skills;
+			PlayerVariables::SaveState variables;
+		};
+
+		// Every character save goes through here, either written right away or queued for the background writer
+		// Queued saves are appended to a journal before anything else, the writer keeps only the latest save of each character and writes them in batches
+		// Once the queue is written the journal is emptied, whatever is left in it after a crash is written when the channel starts again
+		// Saves are stamped with when they were taken, a save left in the journal is dropped when the database already has a newer one
+		class PlayerPersistence {
+			NONCOPYABLE(PlayerPersistence);
+		public:
+			struct Stats {
+				size_t queued = 0;
+				uint64_t journalBytes = 0;
+				uint64_t queuedSaves = 0;
+				// Queued saves that replaced one that hadn't been written yet
+				uint64_t coalesced = 0;
+				uint64_t flushes = 0;
+				uint64_t flushedSaves = 0;
+				uint64_t failures = 0;
+				size_t lastBatch = 0;
+				microseconds_t lastFlush = microseconds_t{0};
+				microseconds_t totalFlush = microseconds_t{0};
+				microseconds_t maxFlush = microseconds_t{0};
+			};
+
+			PlayerPersistence();
+			~PlayerPersistence();
+
+			// Writes whatever the journal still holds, then flushes the queue every flushInterval, an interval of 0 stops after the former
+			// Fails when the journal can't be written or what it holds can't be, characters mustn't be accepted then
+			auto start(const string_t &journalFile, seconds_t flushInterval) -> Result;
+			// Writes everything that's queued
+			auto stop() -> void;
+			auto isWriteBehind() const -> bool;
+
+			// The character was built from data, which is what the database holds
+			auto track(player_id_t charId, const PlayerLoadData &data) -> void;
+			// Writes data now, anything queued for the character is older and dropped
+			// takenAt is what's stored as characters.last_saved, 0 for now
+			auto save(player_id_t charId, const PlayerLoadData &data, bool saveCooldowns, int64_t takenAt = 0) -> void;
+			// Falls back to save when there's no background writer
+			auto queue(player_id_t charId, PlayerLoadData data) -> void;
+			// The character left after its last save
+			auto release(player_id_t charId) -> void;
+
+			auto getStats() const -> Stats;
+			auto resetStats() -> void;
+
+			// Milliseconds since the epoch, comparable across channels
+			static auto getSaveTime() -> int64_t;
+			// Database work only, safe to call off the handler strand
+			static auto getLastSaved(player_id_t charId) -> int64_t;
+		private:
+			struct PendingSave {
+				PlayerLoadData data;
+				// Milliseconds since the epoch, stored as characters.last_saved when written
+				int64_t takenAt = 0;
+			};
+
+			auto recover() -> Result;
+			auto flush() -> void;
+			// Returns false when onlyIfNewer is set and the database already has a save at least as new
+			auto write(Database &db, player_id_t charId, const PlayerLoadData &data, int64_t takenAt, bool saveCooldowns, bool onlyIfNewer = false) -> bool;
+			auto appendJournal(player_id_t charId, const PendingSave *save) -> void;
+			static auto claimSave(Database &db, player_id_t charId, int64_t takenAt) -> bool;
+			static auto saveCharacter(Database &db, player_id_t charId, const PlayerLoadData &data, int64_t takenAt) -> void;
+
+			std::atomic<bool> m_flushPosted{false};
+			owned_ptr_t<Journal> m_journal;
+			ord_map_t<player_id_t, PendingSave> m_pending;
+			// Only touched with m_writeMutex held
+			hash_map_t<player_id_t, PlayerSaveState> m_states;
+			Stats m_stats;
+			// Guards the queue, the journal and the stats
+			mutable mutex_t m_mutex;
+			// One character is written at a time so a late batch can't write over a newer save
+			mutex_t m_writeMutex;
+			mutex_t m_flushMutex;
+		};
+	}
+}
\ No newline at end of file
@@ -16,7 +16,6 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "PlayerPets.hpp"
-#include "Common/Database.hpp"
 #include "ChannelServer/Pet.hpp"
 #include "ChannelServer/Player.hpp"
 
@@ -48,46 +47,6 @@ auto PlayerPets::getSummoned(int8_t index) -> Pet * {
 	return m_summoned[index] > 0 ? m_pets[m_summoned[index]] : nullptr;
 }
 
-auto PlayerPets::save() -> void {
-	if (m_pets.size() > 0) {
-		auto &db = Database::getCharDb();
-		auto &sql = db.getSession();
-		opt_int8_t index = 0;
-		string_t name = "";
-		int8_t level = 0;
-		int16_t closeness = 0;
-		int8_t fullness = 0;
-		pet_id_t petId = 0;
-
-		soci::statement st = (sql.prepare
-			<< "UPDATE " << db.makeTable("pets") << " "
-			<< "SET "
-			<< "	`index` = :index, "
-			<< "	name = :name, "
-			<< "	level = :level, "
-			<< "	closeness = :closeness, "
-			<< "	fullness = :fullness "
-			<< "WHERE pet_id = :pet",
-			soci::use(petId, "pet"),
-			soci::use(index, "index"),
-			soci::use(name, "name"),
-			soci::use(level, "level"),
-			soci::use(closeness, "closeness"),
-			soci::use(fullness, "fullness"));
-
-		for (const auto &kvp : m_pets) {
-			Pet *p = kvp.second;
-			index = p->getIndex();
-			name = p->getName();
-			level = p->getLevel();
-			closeness = p->getCloseness();
-			fullness = p->getFullness();
-			petId = p->getId();
-			st.execute(true);
-		}
-	}
-}
-
 auto PlayerPets::petInfoPacket(PacketBuilder &builder) -> void {
 	Item *it;
 	for (int8_t i = 0; i < Inventories::MaxPetCount; i++) {
@@ -124,5 +83,9 @@ auto PlayerPets::connectPacket(PacketBuilder &builder) -> void {
 	}
 }
 
+auto PlayerPets::connectPacketSize() const -> size_t {
+	return packetSize<int64_t>() * Inventories::MaxPetCount;
+}
+
 }
 }
\ No newline at end of file
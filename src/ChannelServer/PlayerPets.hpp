@@ -33,9 +33,9 @@ namespace Vana {
 		public:
 			PlayerPets(Player *player);
 
-			auto save() -> void;
 			auto petInfoPacket(PacketBuilder &builder) -> void;
 			auto connectPacket(PacketBuilder &builder) -> void;
+			auto connectPacketSize() const -> size_t;
 
 			auto getPet(pet_id_t petId) -> Pet *;
 			auto getSummoned(int8_t index) -> Pet *;
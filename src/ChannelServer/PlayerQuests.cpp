@@ -31,22 +31,47 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 namespace Vana {
 namespace ChannelServer {
 
-PlayerQuests::PlayerQuests(Player *player) :
+PlayerQuests::PlayerQuests(Player *player, const LoadData &data) :
 	m_player{player}
 {
-	load();
+	load(data);
 }
 
-auto PlayerQuests::save() -> void {
-	auto &db = Database::getCharDb();
+auto PlayerQuests::track(const LoadData &data, SaveState &state) -> void {
+	state.active.commit(getActiveRows(data));
+	state.completed.commit(getCompletedRows(data));
+}
+
+auto PlayerQuests::save(Database &db, player_id_t charId, const LoadData &data, SaveState &state) -> size_t {
 	auto &sql = db.getSession();
-	player_id_t charId = m_player->getId();
 	quest_id_t questId = 0;
+	size_t rowsWritten = 0;
+
+	auto active = getActiveRows(data);
+	auto changedActive = state.active.getChanged(active);
+	if (state.active.isTracking()) {
+		vector_t<quest_id_t> staleActive = state.active.getRemoved(active);
+		staleActive.insert(std::end(staleActive), std::begin(changedActive), std::end(changedActive));
+		if (staleActive.size() > 0) {
+			soci::statement st = (sql.prepare
+				<< "DELETE FROM " << db.makeTable("active_quests") << " "
+				<< "WHERE character_id = :char AND quest_id = :quest",
+				soci::use(charId, "char"),
+				soci::use(questId, "quest"));
+
+			for (quest_id_t staleId : staleActive) {
+				questId = staleId;
+				st.execute(true);
+				rowsWritten++;
+			}
+		}
+	}
+	else {
+		sql.once << "DELETE FROM " << db.makeTable("active_quests") << " WHERE character_id = :char", soci::use(charId, "char");
+		rowsWritten++;
+	}
 
-	sql.once << "DELETE FROM " << db.makeTable("active_quests") << " WHERE character_id = :char", soci::use(charId, "char");
-	sql.once << "DELETE FROM " << db.makeTable("completed_quests") << " WHERE character_id = :char", soci::use(charId, "char");
-
-	if (m_quests.size() > 0) {
+	if (changedActive.size() > 0) {
 		mob_id_t mobId = 0;
 		uint16_t killed = 0;
 		int64_t id = 0;
@@ -68,9 +93,10 @@ auto PlayerQuests::save() -> void {
 			soci::use(mobId, "mob"),
 			soci::use(killed, "killed"));
 
-		for (const auto &kvp : m_quests) {
-			const string_t &d = kvp.second.data;
-			questId = kvp.first;
+		for (quest_id_t changedId : changedActive) {
+			const auto &row = active[changedId];
+			const string_t &d = row.first;
+			questId = changedId;
 			if (d.empty()) {
 				data.reset();
 			}
@@ -78,83 +104,149 @@ auto PlayerQuests::save() -> void {
 				data = d;
 			}
 			st.execute(true);
+			rowsWritten++;
 
-			if (kvp.second.kills.size() > 0) {
+			if (row.second.size() > 0) {
 				id = db.getLastId<int64_t>();
-				for (const auto &killPair : kvp.second.kills) {
+				for (const auto &killPair : row.second) {
 					mobId = killPair.first;
 					killed = killPair.second;
 					stMobs.execute(true);
+					rowsWritten++;
 				}
 			}
 		}
 	}
+	state.active.commit(std::move(active));
+
+	auto completed = getCompletedRows(data);
+	if (state.completed.isTracking()) {
+		auto removed = state.completed.getRemoved(completed);
+		if (removed.size() > 0) {
+			soci::statement st = (sql.prepare
+				<< "DELETE FROM " << db.makeTable("completed_quests") << " "
+				<< "WHERE character_id = :char AND quest_id = :quest",
+				soci::use(charId, "char"),
+				soci::use(questId, "quest"));
+
+			for (quest_id_t removedId : removed) {
+				questId = removedId;
+				st.execute(true);
+				rowsWritten++;
+			}
+		}
+	}
+	else {
+		sql.once << "DELETE FROM " << db.makeTable("completed_quests") << " WHERE character_id = :char", soci::use(charId, "char");
+		rowsWritten++;
+	}
 
-	if (m_completed.size() > 0) {
+	auto changedCompleted = state.completed.getChanged(completed);
+	if (changedCompleted.size() > 0) {
 		int64_t time = 0;
 
 		soci::statement st = (sql.prepare
-			<< "INSERT INTO " << db.makeTable("completed_quests") << " "
+			<< "REPLACE INTO " << db.makeTable("completed_quests") << " "
 			<< "VALUES (:char, :quest, :time)",
 			soci::use(charId, "char"),
 			soci::use(questId, "quest"),
 			soci::use(time, "time"));
 
-		for (const auto &kvp : m_completed) {
-			questId = kvp.first;
-			time = kvp.second.getValue();
+		for (quest_id_t changedId : changedCompleted) {
+			questId = changedId;
+			time = completed[changedId];
 			st.execute(true);
+			rowsWritten++;
 		}
 	}
+	state.completed.commit(std::move(completed));
+
+	return rowsWritten;
+}
+
+auto PlayerQuests::getActiveRows(const LoadData &data) -> RowTracker<quest_id_t, active_row_t>::rows_t {
+	RowTracker<quest_id_t, active_row_t>::rows_t rows;
+	for (const auto &kvp : data.quests) {
+		rows[kvp.first] = active_row_t{kvp.second.data, kvp.second.kills};
+	}
+	return rows;
 }
 
-auto PlayerQuests::load() -> void {
-	auto &db = Database::getCharDb();
-	auto &sql = db.getSession();
-	player_id_t charId = m_player->getId();
+auto PlayerQuests::getCompletedRows(const LoadData &data) -> RowTracker<quest_id_t, int64_t>::rows_t {
+	RowTracker<quest_id_t, int64_t>::rows_t rows;
+	for (const auto &kvp : data.completed) {
+		rows[kvp.first] = kvp.second.getValue();
+	}
+	return rows;
+}
+
+auto PlayerQuests::getLoadData() const -> LoadData {
+	LoadData data;
+	data.quests = m_quests;
+	data.completed = m_completed;
+	return data;
+}
+
+auto PlayerQuests::fetch(Database &db, player_id_t charId) -> LoadData {
+	LoadData data;
 	quest_id_t previous = 0;
 	quest_id_t current = 0;
 	bool init = true;
 	ActiveQuest curQuest;
 
-	soci::rowset<> rs = (sql.prepare
-		<< "SELECT a.quest_id, am.mob_id, am.quantity_killed, a.data "
-		<< "FROM " << db.makeTable("active_quests") << " a "
-		<< "LEFT OUTER JOIN " << db.makeTable("active_quests_mobs") << " am ON am.active_quest_id = a.id "
-		<< "WHERE a.character_id = :char ORDER BY a.quest_id ASC",
-		soci::use(charId, "char"));
+	auto &activeLoad = db.prepareQuery<player_id_t>("active quests load", [&db](out_stream_t &query) {
+		query
+			<< "SELECT a.quest_id, am.mob_id, am.quantity_killed, a.data "
+			<< "FROM " << db.makeTable("active_quests") << " a "
+			<< "LEFT OUTER JOIN " << db.makeTable("active_quests_mobs") << " am ON am.active_quest_id = a.id "
+			<< "WHERE a.character_id = :char ORDER BY a.quest_id ASC";
+	});
 
-	for (const auto &row : rs) {
+	for (bool hasRow = activeLoad.execute(charId); hasRow; hasRow = activeLoad.fetch()) {
+		const soci::row &row = activeLoad.getRow();
 		current = row.get<quest_id_t>("quest_id");
 		mob_id_t mob = row.get<mob_id_t>("mob_id");
-		string_t data = row.get<string_t>("data");
+		string_t questData = row.get<string_t>("data");
 
 		if (init) {
 			curQuest.id = current;
-			curQuest.data = data;
+			curQuest.data = questData;
 			init = false;
 		}
 		else if (previous != -1 && current != previous) {
-			m_quests[previous] = curQuest;
+			data.quests[previous] = curQuest;
 			curQuest = ActiveQuest{};
 			curQuest.id = current;
-			curQuest.data = data;
+			curQuest.data = questData;
 		}
 		if (mob != 0) {
-			uint16_t kills = row.get<uint16_t>("quantity_killed");
-			curQuest.kills[mob] = kills;
-			m_mobToQuestMapping[mob].push_back(current);
+			curQuest.kills[mob] = row.get<uint16_t>("quantity_killed");
 		}
 		previous = current;
 	}
 	if (!init) {
-		m_quests[previous] = curQuest;
+		data.quests[previous] = curQuest;
+	}
+
+	auto &completedLoad = db.prepareQuery<player_id_t>("completed quests load", [&db](out_stream_t &query) {
+		query << "SELECT c.quest_id, c.end_time FROM " << db.makeTable("completed_quests") << " c WHERE c.character_id = :char";
+	});
+
+	for (bool hasRow = completedLoad.execute(charId); hasRow; hasRow = completedLoad.fetch()) {
+		const soci::row &row = completedLoad.getRow();
+		data.completed[row.get<quest_id_t>("quest_id")] = FileTime{row.get<int64_t>("end_time")};
 	}
 
-	rs = (sql.prepare << "SELECT c.quest_id, c.end_time FROM " << db.makeTable("completed_quests") << " c WHERE c.character_id = :char", soci::use(charId, "char"));
+	return data;
+}
 
-	for (const auto &row : rs) {
-		m_completed[row.get<quest_id_t>("quest_id")] = FileTime{row.get<int64_t>("end_time")};
+auto PlayerQuests::load(const LoadData &data) -> void {
+	m_quests = data.quests;
+	m_completed = data.completed;
+	for (const auto &quest : m_quests) {
+		for (const auto &kvp : quest.second.kills) {
+			m_mobToQuestMapping[kvp.first].push_back(quest.first);
+		}
 	}
 }
 
@@ -426,6 +518,18 @@ auto PlayerQuests::connectPacket(PacketBuilder &builder) -> void {
 	}
 }
 
+auto PlayerQuests::connectPacketSize() const -> size_t {
+	size_t size = packetSize<uint16_t>();
+	for (const auto &kvp : m_quests) {
+		// Kill counts go out as 3 digits each in place of the stored data, see ActiveQuest::getQuestData
+		const auto &quest = kvp.second;
+		size += packetSize<quest_id_t, uint16_t>() + (quest.kills.size() == 0 ? quest.data.size() : quest.kills.size() * 3);
+	}
+	size += packetSize<uint16_t>();
+	size += packetSize<quest_id_t, FileTime>() * m_completed.size();
+	return size;
+}
+
 auto PlayerQuests::setQuestData(quest_id_t id, const string_t &data) -> void {
 	// TODO FIXME figure out how this works
 	// e.g. Battleship quest
@@ -20,6 +20,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "Common/FileTime.hpp"
 #include "Common/Quest.hpp"
 #include "Common/QuestDataProvider.hpp"
+#include "Common/RowTracker.hpp"
 #include "Common/Types.hpp"
 #include "ChannelServer/Quests.hpp"
 #include <iomanip>
@@ -30,6 +31,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include <vector>
 
 namespace Vana {
+	class Database;
 	class PacketBuilder;
 
 	namespace ChannelServer {
@@ -65,11 +67,28 @@ namespace Vana {
 			NONCOPYABLE(PlayerQuests);
 			NO_DEFAULT_CONSTRUCTOR(PlayerQuests);
 		public:
-			PlayerQuests(Player *player);
+			using active_row_t = pair_t<string_t, ord_map_t<mob_id_t, uint16_t>>;
 
-			auto load() -> void;
-			auto save() -> void;
+			struct LoadData {
+				ord_map_t<quest_id_t, ActiveQuest> quests;
+				ord_map_t<quest_id_t, FileTime> completed;
+			};
+			struct SaveState {
+				// An active quest's mob rows go with it, they're deleted by the foreign key and written again whenever the quest changes
+				RowTracker<quest_id_t, active_row_t> active;
+				RowTracker<quest_id_t, int64_t> completed;
+			};
+
+			PlayerQuests(Player *player, const LoadData &data);
+
+			// Only reads from the database so it may run on any thread
+			static auto fetch(Database &db, player_id_t charId) -> LoadData;
+			auto getLoadData() const -> LoadData;
+			static auto track(const LoadData &data, SaveState &state) -> void;
+			// Returns the number of rows written
+			static auto save(Database &db, player_id_t charId, const LoadData &data, SaveState &state) -> size_t;
 			auto connectPacket(PacketBuilder &builder) -> void;
+			auto connectPacketSize() const -> size_t;
 
 			auto itemDropAllowed(item_id_t itemId, quest_id_t questId) -> AllowQuestItemResult;
 			auto addQuest(quest_id_t questId, npc_id_t npcId) -> void;
@@ -82,7 +101,10 @@ namespace Vana {
 			auto setQuestData(quest_id_t id, const string_t &data) -> void;
 			auto getQuestData(quest_id_t id) -> string_t;
 		private:
+			auto load(const LoadData &data) -> void;
 			auto giveRewards(quest_id_t questId, bool start) -> Result;
+			static auto getActiveRows(const LoadData &data) -> RowTracker<quest_id_t, active_row_t>::rows_t;
+			static auto getCompletedRows(const LoadData &data) -> RowTracker<quest_id_t, int64_t>::rows_t;
 
 			Player *m_player = nullptr;
 			hash_map_t<mob_id_t, vector_t<quest_id_t>> m_mobToQuestMapping;
@@ -0,0 +1,45 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "PlayerSaveStats.hpp"
+#include <algorithm>
+
+namespace Vana {
+namespace ChannelServer {
+
+auto PlayerSaveStats::record(size_t rowsWritten, microseconds_t elapsed) -> void {
+	owned_lock_t<mutex_t> l{m_mutex};
+	m_stats.saves++;
+	m_stats.rowsWritten += rowsWritten;
+	m_stats.lastRows = rowsWritten;
+	m_stats.maxRows = std::max(m_stats.maxRows, rowsWritten);
+	m_stats.totalTime += elapsed;
+	m_stats.maxTime = std::max(m_stats.maxTime, elapsed);
+}
+
+auto PlayerSaveStats::getStats() const -> Stats {
+	owned_lock_t<mutex_t> l{m_mutex};
+	return m_stats;
+}
+
+auto PlayerSaveStats::resetStats() -> void {
+	owned_lock_t<mutex_t> l{m_mutex};
+	m_stats = Stats{};
+}
+
+}
+}
\ No newline at end of file
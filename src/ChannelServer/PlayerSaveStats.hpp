@@ -0,0 +1,48 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Types.hpp"
+#include <mutex>
+
+namespace Vana {
+	namespace ChannelServer {
+		// Tracks how much each Player::saveAll writes, unchanged rows aren't written so this shows what the saves actually cost
+		class PlayerSaveStats {
+			NONCOPYABLE(PlayerSaveStats);
+		public:
+			struct Stats {
+				uint64_t saves = 0;
+				uint64_t rowsWritten = 0;
+				size_t lastRows = 0;
+				size_t maxRows = 0;
+				microseconds_t totalTime = microseconds_t{0};
+				microseconds_t maxTime = microseconds_t{0};
+			};
+
+			PlayerSaveStats() = default;
+
+			auto record(size_t rowsWritten, microseconds_t elapsed) -> void;
+			auto getStats() const -> Stats;
+			auto resetStats() -> void;
+		private:
+			Stats m_stats;
+			mutable mutex_t m_mutex;
+		};
+	}
+}
\ No newline at end of file
@@ -37,129 +37,180 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 namespace Vana {
 namespace ChannelServer {
 
-PlayerSkills::PlayerSkills(Player *player) :
+PlayerSkills::PlayerSkills(Player *player, const LoadData &data) :
 	m_player{player}
 {
-	load();
+	load(data);
 }
 
-auto PlayerSkills::load() -> void {
-	auto &db = Database::getCharDb();
-	auto &sql = db.getSession();
-	PlayerSkillInfo skill;
-	player_id_t playerId = m_player->getId();
-	skill_id_t skillId = 0;
+auto PlayerSkills::fetch(Database &db, player_id_t charId, account_id_t accountId, world_id_t worldId) -> LoadData {
+	LoadData data;
 
-	soci::rowset<> rs = (sql.prepare
-		<< "SELECT s.skill_id, s.points, s.max_level "
-		<< "FROM " << db.makeTable("skills") << " s "
-		<< "WHERE s.character_id = :char",
-		soci::use(playerId, "char"));
+	auto &skillsLoad = db.prepareQuery<player_id_t>("skills load", [&db](out_stream_t &query) {
+		query
+			<< "SELECT s.skill_id, s.points, s.max_level "
+			<< "FROM " << db.makeTable("skills") << " s "
+			<< "WHERE s.character_id = :char";
+	});
 
-	for (const auto &row : rs) {
-		skillId = row.get<skill_id_t>("skill_id");
+	for (bool hasRow = skillsLoad.execute(charId); hasRow; hasRow = skillsLoad.fetch()) {
+		const soci::row &row = skillsLoad.getRow();
+		skill_id_t skillId = row.get<skill_id_t>("skill_id");
 		if (GameLogicUtilities::isBlessingOfTheFairy(skillId)) {
 			continue;
 		}
 
-		skill = PlayerSkillInfo{};
+		PlayerSkillInfo skill;
 		skill.level = row.get<skill_level_t>("points");
-		skill.maxSkillLevel = ChannelServer::getInstance().getSkillDataProvider().getMaxLevel(skillId);
 		skill.playerMaxSkillLevel = row.get<skill_level_t>("max_level");
-		m_skills[skillId] = skill;
+		data.skills[skillId] = skill;
 	}
 
-	rs = (sql.prepare
-		<< "SELECT c.* "
-		<< "FROM " << db.makeTable("cooldowns") << " c "
-		<< "WHERE c.character_id = :char",
-		soci::use(playerId, "char"));
+	auto &cooldownsLoad = db.prepareQuery<player_id_t>("cooldowns load", [&db](out_stream_t &query) {
+		query
+			<< "SELECT c.* "
+			<< "FROM " << db.makeTable("cooldowns") << " c "
+			<< "WHERE c.character_id = :char";
+	});
 
-	for (const auto &row : rs) {
-		skill_id_t skillId = row.get<skill_id_t>("skill_id");
-		seconds_t timeLeft = seconds_t{row.get<int16_t>("remaining_time")};
-		Skills::startCooldown(ref_ptr_t<Player>{m_player}, skillId, timeLeft, true);
-		m_cooldowns[skillId] = timeLeft;
+	for (bool hasRow = cooldownsLoad.execute(charId); hasRow; hasRow = cooldownsLoad.fetch()) {
+		const soci::row &row = cooldownsLoad.getRow();
+		data.cooldowns[row.get<skill_id_t>("skill_id")] = seconds_t{row.get<int16_t>("remaining_time")};
 	}
 
-	skillId = getBlessingOfTheFairy();
-
-	opt_string_t blessingPlayerName;
-	optional_t<player_level_t> blessingPlayerLevel;
-
-	account_id_t accountId = m_player->getAccountId();
-	world_id_t worldId = m_player->getWorldId();
-
 	// TODO FIXME skill
 	// Allow Cygnus <-> Adventurer selection here or allow it to be ignored
 	// That is, some versions only allowed Adv. Blessing to be populated by Cygnus levels and vice versa
 	// Some later versions lifted this restriction entirely
-	sql.once
-		<< "SELECT c.name, c.level "
-		<< "FROM " << db.makeTable("characters") << " c "
-		<< "WHERE c.world_id = :world AND c.account_id = :account AND c.character_id <> :char "
-		<< "ORDER BY c.level DESC "
-		<< "LIMIT 1 ",
-		soci::use(accountId, "account"),
-		soci::use(worldId, "world"),
-		soci::use(playerId, "char"),
-		soci::into(blessingPlayerName),
-		soci::into(blessingPlayerLevel);
-
-	if (blessingPlayerLevel.is_initialized()) {
-		skill = PlayerSkillInfo{};
-		skill.maxSkillLevel = ChannelServer::getInstance().getSkillDataProvider().getMaxLevel(skillId);
-		skill.level = std::min<skill_level_t>(blessingPlayerLevel.get() / 10, skill.maxSkillLevel);
-		m_blessingPlayer = blessingPlayerName.get();
+	auto &blessingFind = db.prepareQuery<world_id_t, account_id_t, player_id_t>("blessing of the fairy find", [&db](out_stream_t &query) {
+		query
+			<< "SELECT c.name, c.level "
+			<< "FROM " << db.makeTable("characters") << " c "
+			<< "WHERE c.world_id = :world AND c.account_id = :account AND c.character_id <> :char "
+			<< "ORDER BY c.level DESC "
+			<< "LIMIT 1 ";
+	});
+
+	if (blessingFind.execute(worldId, accountId, charId)) {
+		const soci::row &row = blessingFind.getRow();
+		data.blessingPlayer = row.get<string_t>("name");
+		data.blessingLevel = row.get<player_level_t>("level");
+	}
+
+	return data;
+}
+
+auto PlayerSkills::load(const LoadData &data) -> void {
+	auto &skillProvider = ChannelServer::getInstance().getSkillDataProvider();
+	for (const auto &kvp : data.skills) {
+		PlayerSkillInfo skill = kvp.second;
+		skill.maxSkillLevel = skillProvider.getMaxLevel(kvp.first);
+		m_skills[kvp.first] = skill;
+	}
+
+	for (const auto &kvp : data.cooldowns) {
+		Skills::startCooldown(ref_ptr_t<Player>{m_player}, kvp.first, kvp.second, true);
+		m_cooldowns[kvp.first] = kvp.second;
+	}
+
+	if (data.blessingPlayer.is_initialized()) {
+		skill_id_t skillId = getBlessingOfTheFairy();
+		PlayerSkillInfo skill;
+		skill.maxSkillLevel = skillProvider.getMaxLevel(skillId);
+		skill.level = std::min<skill_level_t>(data.blessingLevel / 10, skill.maxSkillLevel);
+		m_blessingPlayer = data.blessingPlayer.get();
+		m_blessingLevel = data.blessingLevel;
 		m_skills[skillId] = skill;
 	}
 }
 
-auto PlayerSkills::save(bool saveCooldowns) -> void {
+auto PlayerSkills::track(const LoadData &data, SaveState &state) -> void {
+	state.skills.commit(getRows(data));
+}
+
+auto PlayerSkills::save(Database &db, player_id_t charId, const LoadData &data, SaveState &state, bool saveCooldowns) -> size_t {
 	using namespace soci;
-	player_id_t playerId = m_player->getId();
-	auto &db = Database::getCharDb();
 	auto &sql = db.getSession();
+	size_t rowsWritten = 0;
 
+	// Skills are never taken away so there's nothing to delete
+	auto skills = getRows(data);
+	auto changed = state.skills.getChanged(skills);
 	skill_id_t skillId = 0;
-	skill_level_t level = 0;
-	skill_level_t maxLevel = 0;
-	statement st = (sql.prepare
-		<< "REPLACE INTO " << db.makeTable("skills") << " VALUES (:player, :skill, :level, :maxLevel)",
-		use(playerId, "player"),
-		use(skillId, "skill"),
-		use(level, "level"),
-		use(maxLevel, "maxLevel"));
-
-	for (const auto &kvp : m_skills) {
-		if (GameLogicUtilities::isBlessingOfTheFairy(kvp.first)) {
-			continue;
+	if (changed.size() > 0) {
+		skill_level_t level = 0;
+		skill_level_t maxLevel = 0;
+		statement st = (sql.prepare
+			<< "REPLACE INTO " << db.makeTable("skills") << " VALUES (:player, :skill, :level, :maxLevel)",
+			use(charId, "player"),
+			use(skillId, "skill"),
+			use(level, "level"),
+			use(maxLevel, "maxLevel"));
+
+		for (skill_id_t changedId : changed) {
+			skillId = changedId;
+			level = skills[changedId].first;
+			maxLevel = skills[changedId].second;
+			st.execute(true);
+			rowsWritten++;
 		}
-		skillId = kvp.first;
-		level = kvp.second.level;
-		maxLevel = kvp.second.playerMaxSkillLevel;
-		st.execute(true);
 	}
+	state.skills.commit(std::move(skills));
 
 	if (saveCooldowns) {
-		sql.once << "DELETE FROM " << db.makeTable("cooldowns") << " WHERE character_id = :char", soci::use(playerId, "char");
+		sql.once << "DELETE FROM " << db.makeTable("cooldowns") << " WHERE character_id = :char", soci::use(charId, "char");
+		rowsWritten++;
 
-		if (m_cooldowns.size() > 0) {
+		if (data.cooldowns.size() > 0) {
 			int16_t remainingTime = 0;
-			st = (sql.prepare
+			statement st = (sql.prepare
 				<< "INSERT INTO " << db.makeTable("cooldowns") << " (character_id, skill_id, remaining_time) "
 				<< "VALUES (:char, :skill, :time)",
-				use(playerId, "char"),
+				use(charId, "char"),
 				use(skillId, "skill"),
 				use(remainingTime, "time"));
 
-			for (const auto &kvp : m_cooldowns) {
+			// Only the cooldowns with time left are in the data
+			for (const auto &kvp : data.cooldowns) {
 				skillId = kvp.first;
-				remainingTime = Skills::getCooldownTimeLeft(ref_ptr_t<Player>{m_player}, kvp.first);
+				remainingTime = static_cast<int16_t>(kvp.second.count());
 				st.execute(true);
+				rowsWritten++;
 			}
 		}
 	}
+
+	return rowsWritten;
+}
+
+auto PlayerSkills::getLoadData() const -> LoadData {
+	LoadData data;
+	for (const auto &kvp : m_skills) {
+		if (GameLogicUtilities::isBlessingOfTheFairy(kvp.first)) {
+			continue;
+		}
+		data.skills[kvp.first] = kvp.second;
+	}
+	for (const auto &kvp : m_cooldowns) {
+		int16_t timeLeft = Skills::getCooldownTimeLeft(ref_ptr_t<Player>{m_player}, kvp.first);
+		if (timeLeft > 0) {
+			data.cooldowns[kvp.first] = seconds_t{timeLeft};
+		}
+	}
+	if (!m_blessingPlayer.empty()) {
+		data.blessingPlayer = m_blessingPlayer;
+		data.blessingLevel = m_blessingLevel;
+	}
+	return data;
+}
+
+auto PlayerSkills::getRows(const LoadData &data) -> RowTracker<skill_id_t, row_t>::rows_t {
+	// The data never holds Blessing of the Fairy, it comes from another character
+	RowTracker<skill_id_t, row_t>::rows_t rows;
+	for (const auto &kvp : data.skills) {
+		rows[kvp.first] = row_t{kvp.second.level, kvp.second.playerMaxSkillLevel};
+	}
+	return rows;
 }
 
 auto PlayerSkills::addSkillLevel(skill_id_t skillId, skill_level_t amount, bool sendPacket) -> bool {
@@ -778,6 +829,19 @@ auto PlayerSkills::connectPacket(PacketBuilder &builder) const -> void {
 	}
 }
 
+auto PlayerSkills::connectPacketSize() const -> size_t {
+	size_t size = packetSize<uint16_t>();
+	for (const auto &kvp : m_skills) {
+		size += packetSize<skill_id_t, int32_t>();
+		if (GameLogicUtilities::isFourthJobSkill(kvp.first)) {
+			size += packetSize<int32_t>();
+		}
+	}
+	size += packetSize<uint16_t>();
+	size += packetSize<skill_id_t, int16_t>() * m_cooldowns.size();
+	return size;
+}
+
 auto PlayerSkills::connectPacketForBlessing(PacketBuilder &builder) const -> void {
 	// Orange text wasn't added until sometime after .75 and before .82
 	//if (!m_blessingPlayer.empty()) {
@@ -17,10 +17,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #pragma once
 
+#include "Common/RowTracker.hpp"
 #include "Common/Types.hpp"
 #include <unordered_map>
 
 namespace Vana {
+	class Database;
 	class PacketBuilder;
 	enum class MysticDoorResult;
 	struct SkillLevelInfo;
@@ -40,11 +42,28 @@ namespace Vana {
 			NONCOPYABLE(PlayerSkills);
 			NO_DEFAULT_CONSTRUCTOR(PlayerSkills);
 		public:
-			PlayerSkills(Player *player);
+			struct LoadData {
+				hash_map_t<skill_id_t, PlayerSkillInfo> skills;
+				hash_map_t<skill_id_t, seconds_t> cooldowns;
+				// The highest level character on the same account, the source of Blessing of the Fairy
+				opt_string_t blessingPlayer;
+				player_level_t blessingLevel = 0;
+			};
+			using row_t = pair_t<skill_level_t, skill_level_t>;
+			struct SaveState {
+				RowTracker<skill_id_t, row_t> skills;
+			};
 
-			auto load() -> void;
-			auto save(bool saveCooldowns = false) -> void;
+			PlayerSkills(Player *player, const LoadData &data);
+
+			// Only reads from the database so it may run on any thread
+			static auto fetch(Database &db, player_id_t charId, account_id_t accountId, world_id_t worldId) -> LoadData;
+			auto getLoadData() const -> LoadData;
+			static auto track(const LoadData &data, SaveState &state) -> void;
+			// Returns the number of rows written
+			static auto save(Database &db, player_id_t charId, const LoadData &data, SaveState &state, bool saveCooldowns) -> size_t;
 			auto connectPacket(PacketBuilder &builder) const -> void;
+			auto connectPacketSize() const -> size_t;
 			auto connectPacketForBlessing(PacketBuilder &builder) const -> void;
 
 			auto addSkillLevel(skill_id_t skillId, skill_level_t amount, bool sendPacket = true) -> bool;
@@ -96,12 +115,15 @@ namespace Vana {
 			auto onMapChange() const -> void;
 			auto onDisconnect() -> void;
 		private:
+			auto load(const LoadData &data) -> void;
 			auto hasSkill(skill_id_t skillId) const -> bool;
+			static auto getRows(const LoadData &data) -> RowTracker<skill_id_t, row_t>::rows_t;
 
 			Player *m_player = nullptr;
 			hash_map_t<skill_id_t, PlayerSkillInfo> m_skills;
 			hash_map_t<skill_id_t, seconds_t> m_cooldowns;
 			ref_ptr_t<MysticDoor> m_mysticDoor;
+			player_level_t m_blessingLevel = 0;
 			string_t m_blessingPlayer;
 		};
 	}
@@ -146,6 +146,10 @@ auto PlayerStats::connectPacket(PacketBuilder &builder) -> void {
 	builder.add<fame_t>(getFame());
 }
 
+auto PlayerStats::connectPacketSize() const -> size_t {
+	return packetSize<player_level_t, job_id_t, stat_t, stat_t, stat_t, stat_t, health_t, health_t, health_t, health_t, stat_t, stat_t, experience_t, fame_t>();
+}
+
 auto PlayerStats::getMaxHp(bool withoutBonus) -> health_t {
 	if (!withoutBonus) {
 		return static_cast<health_t>(std::min<int32_t>(m_maxHp + m_equipBonuses.hp + m_buffBonuses.hp, Stats::MaxMaxHp));
@@ -106,6 +106,7 @@ namespace Vana {
 
 			// Data acquisition
 			auto connectPacket(PacketBuilder &builder) -> void;
+			auto connectPacketSize() const -> size_t;
 			auto getLevel() const -> player_level_t { return m_level; }
 			auto getJob() const -> job_id_t { return m_job; }
 			auto getExp() const -> experience_t { return m_exp; }
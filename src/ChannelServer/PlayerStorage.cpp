@@ -30,10 +30,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 namespace Vana {
 namespace ChannelServer {
 
-PlayerStorage::PlayerStorage(Player *player) :
+PlayerStorage::PlayerStorage(Player *player, const LoadData &data) :
 	m_player{player}
 {
-	load();
+	load(data);
 }
 
 PlayerStorage::~PlayerStorage() {
@@ -77,96 +77,150 @@ auto PlayerStorage::changeMesos(mesos_t mesos) -> void {
 	m_player->send(Packets::Storage::changeMesos(getSlots(), m_mesos));
 }
 
-auto PlayerStorage::load() -> void {
-	auto &db = Database::getCharDb();
-	auto &sql = db.getSession();
-	soci::row row;
-	account_id_t accountId = m_player->getAccountId();
-	world_id_t worldId = m_player->getWorldId();
-
-	sql.once
-		<< "SELECT s.slots, s.mesos, s.char_slots "
-		<< "FROM " << db.makeTable("storage") << " s "
-		<< "WHERE s.account_id = :account AND s.world_id = :world "
-		<< "LIMIT 1",
-		soci::use(accountId, "account"),
-		soci::use(worldId, "world"),
-		soci::into(row);
-
-	if (sql.got_data()) {
-		m_slots = row.get<storage_slot_t>("slots");
-		m_mesos = row.get<mesos_t>("mesos");
-		m_charSlots = row.get<int32_t>("char_slots");
+auto PlayerStorage::fetch(Database &db, account_id_t accountId, world_id_t worldId, storage_slot_t defaultSlots, int32_t defaultChars) -> LoadData {
+	LoadData data;
+
+	auto &settingsLoad = db.prepareQuery<account_id_t, world_id_t>("storage load", [&db](out_stream_t &query) {
+		query
+			<< "SELECT s.slots, s.mesos, s.char_slots "
+			<< "FROM " << db.makeTable("storage") << " s "
+			<< "WHERE s.account_id = :account AND s.world_id = :world "
+			<< "LIMIT 1";
+	});
+
+	if (settingsLoad.execute(accountId, worldId)) {
+		const soci::row &row = settingsLoad.getRow();
+		data.slots = row.get<storage_slot_t>("slots");
+		data.mesos = row.get<mesos_t>("mesos");
+		data.charSlots = row.get<int32_t>("char_slots");
 	}
 	else {
-		auto &config = ChannelServer::getInstance().getConfig();
-		m_slots = config.defaultStorageSlots;
-		m_mesos = 0;
-		m_charSlots = config.defaultChars;
-		sql.once
-			<< "INSERT INTO " << db.makeTable("storage") << " (account_id, world_id, slots, mesos, char_slots) "
-			<< "VALUES (:account, :world, :slots, :mesos, :chars)",
-			soci::use(accountId, "account"),
-			soci::use(worldId, "world"),
-			soci::use(m_slots, "slots"),
-			soci::use(m_mesos, "mesos"),
-			soci::use(m_charSlots, "chars");
+		data.slots = defaultSlots;
+		data.mesos = 0;
+		data.charSlots = defaultChars;
+
+		auto &settingsAdd = db.prepareCommand<account_id_t, world_id_t, storage_slot_t, mesos_t, int32_t>("storage add", [&db](out_stream_t &query) {
+			query
+				<< "INSERT INTO " << db.makeTable("storage") << " (account_id, world_id, slots, mesos, char_slots) "
+				<< "VALUES (:account, :world, :slots, :mesos, :chars)";
+		});
+		settingsAdd.execute(accountId, worldId, data.slots, data.mesos, data.charSlots);
 	}
 
-	m_items.reserve(m_slots);
+	auto &itemsLoad = db.prepareQuery<string_t, account_id_t, world_id_t>("storage items load", [&db](out_stream_t &query) {
+		query
+			<< "SELECT i.* "
+			<< "FROM " << db.makeTable("items") << " i "
+			<< "WHERE i.location = :location AND i.account_id = :account AND i.world_id = :world "
+			<< "ORDER BY i.slot ASC";
+	});
+
+	for (bool hasRow = itemsLoad.execute("storage", accountId, worldId); hasRow; hasRow = itemsLoad.fetch()) {
+		const soci::row &row = itemsLoad.getRow();
+		data.items[row.get<storage_slot_t>("slot")] = Item{row};
+	}
 
-	string_t location = "storage";
+	return data;
+}
 
-	soci::rowset<> rs = (sql.prepare
-		<< "SELECT i.* "
-		<< "FROM " << db.makeTable("items") << " i "
-		<< "WHERE i.location = :location AND i.account_id = :account AND i.world_id = :world "
-		<< "ORDER BY i.slot ASC",
-		soci::use(location, "location"),
-		soci::use(accountId, "account"),
-		soci::use(worldId, "world"));
+auto PlayerStorage::load(const LoadData &data) -> void {
+	m_slots = data.slots;
+	m_mesos = data.mesos;
+	m_charSlots = data.charSlots;
+	m_items.reserve(m_slots);
 
-	for (const auto &row : rs) {
-		Item *item = new Item{row};
-		addItem(item);
+	for (const auto &kvp : data.items) {
+		addItem(new Item{kvp.second});
 	}
 }
 
-auto PlayerStorage::save() -> void {
+auto PlayerStorage::track(const LoadData &data, SaveState &state) -> void {
+	state.settings = settings_t{data.slots, data.mesos, data.charSlots};
+	state.items.commit(data.items);
+}
+
+auto PlayerStorage::save(Database &db, player_id_t charId, account_id_t accountId, world_id_t worldId, const LoadData &data, SaveState &state) -> size_t {
 	using namespace soci;
-	world_id_t worldId = m_player->getWorldId();
-	account_id_t accountId = m_player->getAccountId();
-	player_id_t playerId = m_player->getId();
+	size_t rowsWritten = 0;
 
-	auto &db = Database::getCharDb();
 	auto &sql = db.getSession();
-	sql.once
-		<< "UPDATE " << db.makeTable("storage") << " "
-		<< "SET slots = :slots, mesos = :mesos, char_slots = :chars "
-		<< "WHERE account_id = :account AND world_id = :world",
-		use(accountId, "account"),
-		use(worldId, "world"),
-		use(m_slots, "slots"),
-		use(m_mesos, "mesos"),
-		use(m_charSlots, "chars");
-
-	sql.once
-		<< "DELETE FROM " << db.makeTable("items") << " "
-		<< "WHERE location = :location AND account_id = :account AND world_id = :world",
-		use(Item::Storage, "location"),
-		use(accountId, "account"),
-		use(worldId, "world");
-
-	storage_slot_t max = getNumItems();
-
-	if (max > 0) {
+	settings_t settings{data.slots, data.mesos, data.charSlots};
+	if (!state.items.isTracking() || settings != state.settings) {
+		sql.once
+			<< "UPDATE " << db.makeTable("storage") << " "
+			<< "SET slots = :slots, mesos = :mesos, char_slots = :chars "
+			<< "WHERE account_id = :account AND world_id = :world",
+			use(accountId, "account"),
+			use(worldId, "world"),
+			use(data.slots, "slots"),
+			use(data.mesos, "mesos"),
+			use(data.charSlots, "chars");
+		state.settings = settings;
+		rowsWritten++;
+	}
+
+	auto items = data.items;
+	vector_t<storage_slot_t> changedItems = state.items.getChanged(items);
+	if (state.items.isTracking()) {
+		// Changed rows are replaced, deleting one that was never written does nothing
+		vector_t<storage_slot_t> staleItems = state.items.getRemoved(items);
+		staleItems.insert(std::end(staleItems), std::begin(changedItems), std::end(changedItems));
+		if (staleItems.size() > 0) {
+			storage_slot_t slot = 0;
+			statement st = (sql.prepare
+				<< "DELETE FROM " << db.makeTable("items") << " "
+				<< "WHERE location = :location AND account_id = :account AND world_id = :world AND slot = :slot",
+				use(Item::Storage, "location"),
+				use(accountId, "account"),
+				use(worldId, "world"),
+				use(slot, "slot"));
+
+			for (storage_slot_t stale : staleItems) {
+				slot = stale;
+				st.execute(true);
+				rowsWritten++;
+			}
+		}
+	}
+	else {
+		sql.once
+			<< "DELETE FROM " << db.makeTable("items") << " "
+			<< "WHERE location = :location AND account_id = :account AND world_id = :world",
+			use(Item::Storage, "location"),
+			use(accountId, "account"),
+			use(worldId, "world");
+		rowsWritten++;
+	}
+
+	if (changedItems.size() > 0) {
 		vector_t<ItemDbRecord> v;
-		for (storage_slot_t i = 0; i < max; ++i) {
-			ItemDbRecord rec{i, playerId, accountId, worldId, Item::Storage, getItem(i)};
+		for (storage_slot_t slot : changedItems) {
+			ItemDbRecord rec{slot, charId, accountId, worldId, Item::Storage, &items[slot]};
 			v.push_back(rec);
 		}
 		Item::databaseInsert(db, v);
+		rowsWritten += v.size();
 	}
+	state.items.commit(std::move(items));
+
+	return rowsWritten;
+}
+
+auto PlayerStorage::getItemRows() const -> RowTracker<storage_slot_t, Item>::rows_t {
+	RowTracker<storage_slot_t, Item>::rows_t rows;
+	for (storage_slot_t i = 0; i < getNumItems(); ++i) {
+		rows[i] = *m_items[i];
+	}
+	return rows;
+}
+
+auto PlayerStorage::getLoadData() const -> LoadData {
+	LoadData data;
+	data.slots = m_slots;
+	data.mesos = m_mesos;
+	data.charSlots = m_charSlots;
+	data.items = getItemRows();
+	return data;
 }
 
 }
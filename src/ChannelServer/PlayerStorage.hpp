@@ -17,10 +17,14 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #pragma once
 
+#include "Common/Item.hpp"
+#include "Common/RowTracker.hpp"
 #include "Common/Types.hpp"
+#include <tuple>
 #include <vector>
 
 namespace Vana {
+	class Database;
 	class Item;
 
 	namespace ChannelServer {
@@ -30,9 +34,28 @@ namespace Vana {
 			NONCOPYABLE(PlayerStorage);
 			NO_DEFAULT_CONSTRUCTOR(PlayerStorage);
 		public:
-			PlayerStorage(Player *player);
+			struct LoadData {
+				storage_slot_t slots = 0;
+				mesos_t mesos = 0;
+				int32_t charSlots = 0;
+				RowTracker<storage_slot_t, Item>::rows_t items;
+			};
+			using settings_t = tuple_t<storage_slot_t, mesos_t, int32_t>;
+			struct SaveState {
+				settings_t settings;
+				RowTracker<storage_slot_t, Item> items;
+			};
+
+			PlayerStorage(Player *player, const LoadData &data);
 			~PlayerStorage();
 
+			// Only touches the database so it may run on any thread, an account without storage gets the defaults written
+			static auto fetch(Database &db, account_id_t accountId, world_id_t worldId, storage_slot_t defaultSlots, int32_t defaultChars) -> LoadData;
+			auto getLoadData() const -> LoadData;
+			static auto track(const LoadData &data, SaveState &state) -> void;
+			// Returns the number of rows written
+			static auto save(Database &db, player_id_t charId, account_id_t accountId, world_id_t worldId, const LoadData &data, SaveState &state) -> size_t;
+
 			auto setSlots(storage_slot_t slots) -> void;
 			auto addItem(Item *item) -> void;
 			auto takeItem(storage_slot_t slot) -> void;
@@ -50,10 +73,11 @@ namespace Vana {
 				}
 				return nullptr;
 			}
-
-			auto load() -> void;
-			auto save() -> void;
 		private:
+			auto load(const LoadData &data) -> void;
+
+			auto getItemRows() const -> RowTracker<storage_slot_t, Item>::rows_t;
+
 			storage_slot_t m_slots = 0;
 			mesos_t m_mesos = 0;
 			int32_t m_charSlots = 0;
@@ -22,46 +22,91 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 namespace Vana {
 namespace ChannelServer {
 
-PlayerVariables::PlayerVariables(Player *player) :
+PlayerVariables::PlayerVariables(Player *player, const LoadData &data) :
 	m_player{player}
 {
-	load();
+	load(data);
 }
 
-auto PlayerVariables::save() -> void {
-	auto &db = Database::getCharDb();
+auto PlayerVariables::track(const LoadData &data, SaveState &state) -> void {
+	state.variables.commit(getRows(data));
+}
+
+auto PlayerVariables::save(Database &db, player_id_t charId, const LoadData &data, SaveState &state) -> size_t {
 	auto &sql = db.getSession();
-	player_id_t charId = m_player->getId();
+	string_t key = "";
+	size_t rowsWritten = 0;
 
-	sql.once << "DELETE FROM " << db.makeTable("character_variables") << " WHERE character_id = :char", soci::use(charId, "char");
+	auto variables = getRows(data);
+	if (state.variables.isTracking()) {
+		auto removed = state.variables.getRemoved(variables);
+		if (removed.size() > 0) {
+			soci::statement st = (sql.prepare
+				<< "DELETE FROM " << db.makeTable("character_variables") << " "
+				<< "WHERE character_id = :char AND `key` = :key",
+				soci::use(charId, "char"),
+				soci::use(key, "key"));
 
-	if (m_variables.size() > 0) {
-		string_t key = "";
+			for (const auto &removedKey : removed) {
+				key = removedKey;
+				st.execute(true);
+				rowsWritten++;
+			}
+		}
+	}
+	else {
+		sql.once << "DELETE FROM " << db.makeTable("character_variables") << " WHERE character_id = :char", soci::use(charId, "char");
+		rowsWritten++;
+	}
+
+	auto changed = state.variables.getChanged(variables);
+	if (changed.size() > 0) {
 		string_t value = "";
 
 		soci::statement st = (sql.prepare
-			<< "INSERT INTO " << db.makeTable("character_variables") << " "
+			<< "REPLACE INTO " << db.makeTable("character_variables") << " "
 			<< "VALUES (:char, :key, :value)",
 			soci::use(charId, "char"),
 			soci::use(key, "key"),
 			soci::use(value, "value"));
 
-		for (const auto &kvp : m_variables) {
-			key = kvp.first;
-			value = kvp.second;
+		for (const auto &changedKey : changed) {
+			key = changedKey;
+			value = variables[changedKey];
 			st.execute(true);
+			rowsWritten++;
 		}
 	}
+	state.variables.commit(std::move(variables));
+
+	return rowsWritten;
 }
 
-auto PlayerVariables::load() -> void {
-	auto &db = Database::getCharDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("character_variables") << " WHERE character_id = :char", soci::use(m_player->getId(), "char"));
+auto PlayerVariables::getRows(const LoadData &data) -> RowTracker<string_t, string_t>::rows_t {
+	return RowTracker<string_t, string_t>::rows_t{std::begin(data.variables), std::end(data.variables)};
+}
+
+auto PlayerVariables::getLoadData() const -> LoadData {
+	LoadData data;
+	data.variables = m_variables;
+	return data;
+}
 
-	for (const auto &row : rs) {
-		m_variables[row.get<string_t>("key")] = row.get<string_t>("value");
+auto PlayerVariables::fetch(Database &db, player_id_t charId) -> LoadData {
+	auto &variablesLoad = db.prepareQuery<player_id_t>("variables load", [&db](out_stream_t &query) {
+		query << "SELECT * FROM " << db.makeTable("character_variables") << " WHERE character_id = :char";
+	});
+
+	LoadData data;
+	for (bool hasRow = variablesLoad.execute(charId); hasRow; hasRow = variablesLoad.fetch()) {
+		const soci::row &row = variablesLoad.getRow();
+		data.variables[row.get<string_t>("key")] = row.get<string_t>("value");
 	}
+	return data;
+}
+
+auto PlayerVariables::load(const LoadData &data) -> void {
+	m_variables = data.variables;
 }
 
 }
@@ -17,9 +17,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #pragma once
 
+#include "Common/RowTracker.hpp"
 #include "Common/Variables.hpp"
 
 namespace Vana {
+	class Database;
+
 	namespace ChannelServer {
 		class Player;
 
@@ -27,10 +30,24 @@ namespace Vana {
 			NONCOPYABLE(PlayerVariables);
 			NO_DEFAULT_CONSTRUCTOR(PlayerVariables);
 		public:
-			PlayerVariables(Player *player);
-			auto save() -> void;
-			auto load() -> void;
+			struct LoadData {
+				hash_map_t<string_t, string_t> variables;
+			};
+			struct SaveState {
+				RowTracker<string_t, string_t> variables;
+			};
+
+			PlayerVariables(Player *player, const LoadData &data);
+			// Only reads from the database so it may run on any thread
+			static auto fetch(Database &db, player_id_t charId) -> LoadData;
+			auto getLoadData() const -> LoadData;
+			static auto track(const LoadData &data, SaveState &state) -> void;
+			// Returns the number of rows written
+			static auto save(Database &db, player_id_t charId, const LoadData &data, SaveState &state) -> size_t;
 		private:
+			auto load(const LoadData &data) -> void;
+			static auto getRows(const LoadData &data) -> RowTracker<string_t, string_t>::rows_t;
+
 			Player *m_player = nullptr;
 		};
 	}
@@ -160,7 +160,7 @@ auto SummonHandler::moveSummon(ref_ptr_t<Player> player, PacketReader &reader) -
 
 	MovementHandler::parseMovement(summon, reader);
 	reader.reset(10);
-	player->sendMap(Packets::moveSummon(player->getId(), summon, summon->getPos(), reader.getBuffer(), (reader.getBufferLength() - 9)));
+	player->sendMap(Packets::moveSummon(player->getId(), summon, summon->getPos(), reader.getBuffer(), (reader.getBufferLength() - 9)), PacketPriority::Low);
 }
 
 auto SummonHandler::damageSummon(ref_ptr_t<Player> player, PacketReader &reader) -> void {
@@ -17,7 +17,36 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "Common/VanaMain.hpp"
 #include "ChannelServer/ChannelServer.hpp"
+#include <cstring>
+#include <iostream>
+
+auto main(int argc, char *argv[]) -> Vana::exit_code_t {
+	// ChannelServer --replay <capture> [--fast] runs the channel standalone against a packet capture instead of real clients
+	// ChannelServer --compile-data <file> writes a data snapshot for data_snapshot and quits
+	Vana::ReplayConfig replay;
+	Vana::string_t compileData;
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+			replay.file = argv[++i];
+		}
+		else if (strcmp(argv[i], "--fast") == 0) {
+			replay.fast = true;
+		}
+		else if (strcmp(argv[i], "--compile-data") == 0 && i + 1 < argc) {
+			compileData = argv[++i];
+		}
+		else {
+			std::cerr << "Usage: " << argv[0] << " [--replay <capture file> [--fast]] [--compile-data <snapshot file>]" << std::endl;
+			return Vana::ExitCodes::ConfigError;
+		}
+	}
+
+	if (!replay.file.empty()) {
+		Vana::ChannelServer::ChannelServer::getInstance().setReplay(replay);
+	}
+	if (!compileData.empty()) {
+		Vana::ChannelServer::ChannelServer::getInstance().setCompileData(compileData);
+	}
 
-auto main() -> Vana::exit_code_t {
 	return Vana::main<Vana::ChannelServer::ChannelServer>();
 }
\ No newline at end of file
@@ -0,0 +1,167 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "Common/CustomCipher.hpp"
+#include "Common/ExitCodes.hpp"
+#include "Common/Types.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Times the custom cipher layer's batch kernels against the scalar loop on the same packets
+// CipherBenchmark [iterations]
+
+namespace Vana {
+namespace CipherBenchmark {
+
+struct Workload {
+	string_t name;
+	vector_t<int32_t> lengths;
+};
+
+struct KernelInfo {
+	CustomCipher::Kernel kernel;
+	string_t name;
+};
+
+auto makeWorkloads() -> vector_t<Workload> {
+	std::mt19937 engine{1};
+	vector_t<Workload> workloads;
+
+	// Movement, emotes and the like, a broadcast-heavy map produces a lot of these
+	workloads.push_back(Workload{"256 x 64 bytes", vector_t<int32_t>(256, 64)});
+	workloads.push_back(Workload{"64 x 1024 bytes", vector_t<int32_t>(64, 1024)});
+
+	// What a busy session's write queue tends to look like, a few common sizes with stragglers
+	Workload mixed{"256 x mixed 2-512 bytes", {}};
+	std::uniform_int_distribution<int32_t> common{0, 7};
+	std::uniform_int_distribution<int32_t> other{2, 512};
+	const int32_t CommonLengths[] = {6, 10, 14, 22, 30, 46, 64, 128};
+	for (int32_t i = 0; i < 256; ++i) {
+		mixed.lengths.push_back(i % 4 == 3 ? other(engine) : CommonLengths[common(engine)]);
+	}
+	workloads.push_back(mixed);
+
+	return workloads;
+}
+
+auto makeBatch(vector_t<vector_t<unsigned char>> &buffers) -> vector_t<CustomCipher::Packet> {
+	vector_t<CustomCipher::Packet> packets;
+	for (auto &buffer : buffers) {
+		packets.push_back(CustomCipher::Packet{buffer.data(), static_cast<int32_t>(buffer.size())});
+	}
+	return packets;
+}
+
+auto run(const Workload &workload, const KernelInfo &kernel, int32_t iterations, double scalarSeconds) -> double {
+	std::mt19937 engine{2};
+	std::uniform_int_distribution<int32_t> byte{0, 255};
+	vector_t<vector_t<unsigned char>> original;
+	size_t bytes = 0;
+	for (int32_t length : workload.lengths) {
+		vector_t<unsigned char> buffer(length);
+		for (auto &value : buffer) {
+			value = static_cast<unsigned char>(byte(engine));
+		}
+		bytes += buffer.size();
+		original.push_back(buffer);
+	}
+
+	// Every kernel has to match the scalar code exactly before its time means anything
+	vector_t<vector_t<unsigned char>> expected = original;
+	for (auto &buffer : expected) {
+		CustomCipher::encrypt(buffer.data(), static_cast<int32_t>(buffer.size()));
+	}
+	vector_t<vector_t<unsigned char>> buffers = original;
+	auto packets = makeBatch(buffers);
+	CustomCipher::encryptBatch(packets, kernel.kernel);
+	bool matches = buffers == expected;
+	packets = makeBatch(buffers);
+	CustomCipher::decryptBatch(packets, kernel.kernel);
+	matches = matches && buffers == original;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int32_t i = 0; i < iterations; ++i) {
+		packets = makeBatch(buffers);
+		CustomCipher::encryptBatch(packets, kernel.kernel);
+		packets = makeBatch(buffers);
+		CustomCipher::decryptBatch(packets, kernel.kernel);
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	double megabytes = static_cast<double>(bytes) * iterations * 2 / (1024 * 1024);
+
+	std::cout
+		<< "  " << std::setw(8) << std::left << kernel.name
+		<< std::setw(10) << std::right << std::fixed << std::setprecision(1) << megabytes / seconds << " MB/s";
+	if (scalarSeconds > 0) {
+		std::cout << "  " << std::setprecision(2) << scalarSeconds / seconds << "x scalar";
+	}
+	if (!matches) {
+		std::cout << "  MISMATCH";
+	}
+	std::cout << std::endl;
+
+	return matches ? seconds : -1;
+}
+
+}
+}
+
+auto main(int argc, char *argv[]) -> Vana::exit_code_t {
+	using namespace Vana::CipherBenchmark;
+	using Vana::CustomCipher::Kernel;
+
+	int32_t iterations = 2000;
+	if (argc > 1) {
+		iterations = std::max(std::atoi(argv[1]), 1);
+	}
+
+	const KernelInfo Kernels[] = {
+		{Kernel::Scalar, "scalar"},
+		{Kernel::Sse2, "SSE2"},
+		{Kernel::Avx2, "AVX2"},
+	};
+
+	bool failed = false;
+	for (const auto &workload : makeWorkloads()) {
+		std::cout << workload.name << ", " << iterations << " encrypt/decrypt round trips" << std::endl;
+		double scalarSeconds = 0;
+		for (const auto &kernel : Kernels) {
+			if (!Vana::CustomCipher::hasKernel(kernel.kernel)) {
+				std::cout << "  " << std::setw(8) << std::left << kernel.name << "not available here" << std::endl;
+				continue;
+			}
+
+			double seconds = run(workload, kernel, iterations, scalarSeconds);
+			if (seconds < 0) {
+				failed = true;
+			}
+			if (kernel.kernel == Kernel::Scalar) {
+				scalarSeconds = seconds;
+			}
+		}
+		std::cout << std::endl;
+	}
+
+	return failed ? Vana::ExitCodes::ProgramException : Vana::ExitCodes::Ok;
+}
\ No newline at end of file
@@ -21,18 +21,24 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "Common/ConfigFile.hpp"
 #include "Common/ConnectionManager.hpp"
 #include "Common/ConsoleLogger.hpp"
+#include "Common/DatabaseExecutor.hpp"
 #include "Common/ExitCodes.hpp"
 #include "Common/FileLogger.hpp"
 #include "Common/HashUtilities.hpp"
 #include "Common/LogConfig.hpp"
 #include "Common/Logger.hpp"
 #include "Common/MiscUtilities.hpp"
+#include "Common/OpcodeStats.hpp"
 #include "Common/SaltingConfig.hpp"
 #include "Common/Session.hpp"
 #include "Common/SqlLogger.hpp"
+#include "Common/StringUtilities.hpp"
 #include "Common/ThreadPool.hpp"
+#include "Common/Timer.hpp"
+#include "Common/TimerType.hpp"
 #include "Common/TimerThread.hpp"
 #include "Common/TimeUtilities.hpp"
+#include <algorithm>
 #include <chrono>
 #include <ctime>
 #include <iomanip>
@@ -84,6 +90,20 @@ auto AbstractServer::initialize() -> Result {
 	}
 
 	m_interServerConfig = config->get<InterServerConfig>("");
+	Timer::TimerThread::getInstance().useTimerWheel(m_interServerConfig.useTimerWheel);
+	m_connectionManager.setShardCount(std::max(m_interServerConfig.mapWorkers, 0));
+	// Timers run alongside the packet handlers instead of racing them, map state (drops, mobs, mists, etc.) has no locks of its own
+	// Shards rely on this too, timers touch state across every shard
+	Timer::TimerThread::getInstance().setDispatcher([this](function_t<void()> work) {
+		m_connectionManager.postHandler(work);
+	});
+
+	DatabaseExecutor::getInstance().start(
+		m_interServerConfig.dbThreads,
+		static_cast<size_t>(std::max(m_interServerConfig.dbQueueCapacity, 1)),
+		[this](function_t<void()> completion) {
+			m_connectionManager.postHandler(completion);
+		});
 
 	auto salting = ConfigFile::getSaltingConfig();
 	salting->run();
@@ -100,7 +120,20 @@ auto AbstractServer::initialize() -> Result {
 	}
 	initComplete();
 
-	m_connectionManager.run();
+	if (m_interServerConfig.opcodeStatsInterval.count() > 0) {
+		Timer::Timer::create(
+			[this](const time_point_t &) {
+				if (!this->writeOpcodeStats()) {
+					this->log(LogType::Warning, "Unable to write opcode stats to " + this->getOpcodeStatsFile());
+				}
+			},
+			Timer::Id{TimerType::StatsTimer},
+			Timer::TimerThread::getInstance().getTimerContainer(),
+			m_interServerConfig.opcodeStatsInterval,
+			m_interServerConfig.opcodeStatsInterval);
+	}
+
+	m_connectionManager.run(m_interServerConfig.ioThreadCount);
 
 	return Result::Successful;
 }
@@ -118,6 +151,8 @@ auto AbstractServer::loadLogConfig() -> void {
 }
 
 auto AbstractServer::shutdown() -> void {
+	Timer::TimerThread::getInstance().setDispatcher(nullptr);
+	DatabaseExecutor::getInstance().stop();
 	m_connectionManager.stop();
 	ThreadPool::wait();
 }
@@ -134,6 +169,40 @@ auto AbstractServer::getInterserverSaltingPolicy() const -> const SaltConfig & {
 	return m_saltingPolicy;
 }
 
+auto AbstractServer::getOpcodeStats() -> OpcodeStats & {
+	return m_connectionManager.getOpcodeStats();
+}
+
+auto AbstractServer::getConnectionStats() -> ConnectionManager::Stats {
+	return m_connectionManager.getStats();
+}
+
+auto AbstractServer::writeOpcodeStats() -> bool {
+	return m_connectionManager.getOpcodeStats().write(getOpcodeStatsFile(), makeLogIdentifier());
+}
+
+auto AbstractServer::getOpcodeStatsFile() const -> string_t {
+	return "logs/opcode_stats/" + makeFileIdentifier() + ".txt";
+}
+
+auto AbstractServer::makeFileIdentifier() const -> string_t {
+	return getLogPrefix();
+}
+
+auto AbstractServer::startPacketCapture() -> void {
+	if (!m_interServerConfig.captureClientPackets) {
+		return;
+	}
+
+	string_t file = "captures/" + makeFileIdentifier() + "_" + StringUtilities::lexical_cast<string_t>(time(nullptr)) + ".vcap";
+	if (m_connectionManager.startCapture(file) == Result::Failure) {
+		log(LogType::Error, "Unable to open " + file + " for packet capture");
+		return;
+	}
+
+	log(LogType::Info, "Capturing client packets to " + file);
+}
+
 auto AbstractServer::getInterServerConfig() const -> const InterServerConfig & {
 	return m_interServerConfig;
 }
@@ -174,6 +243,8 @@ auto AbstractServer::createLogger(const LogConfig &conf) -> void {
 }
 
 auto AbstractServer::log(LogType type, const string_t &message) -> void {
+	// Handler shards may log at the same time
+	owned_lock_t<mutex_t> l{m_logMutex};
 	if (Logger *logger = m_logger.get()) {
 		logger->log(type, makeLogIdentifier(), message);
 	}
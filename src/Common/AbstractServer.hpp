@@ -46,6 +46,11 @@ namespace Vana {
 		auto getServerType() const -> ServerType;
 		auto getInterPassword() const -> string_t;
 		auto getInterserverSaltingPolicy() const -> const SaltConfig &;
+		auto getOpcodeStats() -> OpcodeStats &;
+		auto getConnectionStats() -> ConnectionManager::Stats;
+		auto writeOpcodeStats() -> bool;
+		auto getOpcodeStatsFile() const -> string_t;
+		auto getInterServerConfig() const -> const InterServerConfig &;
 	protected:
 		AbstractServer(ServerType type);
 		virtual auto loadConfig() -> Result;
@@ -53,11 +58,13 @@ namespace Vana {
 		virtual auto loadData() -> Result = 0;
 		virtual auto makeLogIdentifier() const -> opt_string_t = 0;
 		virtual auto getLogPrefix() const -> string_t = 0;
+		// Distinguishes this server's files (opcode stats, captures) from those of other servers sharing the directory
+		virtual auto makeFileIdentifier() const -> string_t;
 
-		auto getInterServerConfig() const -> const InterServerConfig &;
 		auto sendAuth(ref_ptr_t<Session> session) const -> void;
 		auto displayLaunchTime() const -> void;
 		auto buildLogIdentifier(function_t<void(out_stream_t &)> produceId) const -> opt_string_t;
+		auto startPacketCapture() -> void;
 		auto getConnectionManager() -> ConnectionManager & { return m_connectionManager; }
 	private:
 		auto loadLogConfig() -> void;
@@ -68,6 +75,7 @@ namespace Vana {
 		string_t m_interPassword;
 		string_t m_salt;
 		owned_ptr_t<Logger> m_logger;
+		mutex_t m_logMutex;
 		InterServerConfig m_interServerConfig;
 		SaltConfig m_saltingPolicy;
 		IpMatrix m_externalIps;
@@ -0,0 +1,112 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "AesKeystream.hpp"
+#include <botan/lookup.h>
+#include <cstring>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VANA_KEYSTREAM_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Vana {
+
+const uint8_t AesKeySize = 32;
+const uint8_t AesKey[AesKeySize] = {
+	0x13, 0x00, 0x00, 0x00,
+	0x08, 0x00, 0x00, 0x00,
+	0x06, 0x00, 0x00, 0x00,
+	0xB4, 0x00, 0x00, 0x00,
+	0x1B, 0x00, 0x00, 0x00,
+	0x0F, 0x00, 0x00, 0x00,
+	0x33, 0x00, 0x00, 0x00,
+	0x52, 0x00, 0x00, 0x00,
+};
+
+thread_local owned_ptr_t<AesKeystream> AesKeystream::s_instance{nullptr};
+
+static
+auto xorKeystream(unsigned char *data, const unsigned char *keystream, int32_t length) -> void {
+	int32_t i = 0;
+#ifdef VANA_KEYSTREAM_SSE2
+	for (; i + 16 <= length; i += 16) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+		__m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keystream + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(data + i), _mm_xor_si128(block, key));
+	}
+#endif
+	for (; i < length; ++i) {
+		data[i] ^= keystream[i];
+	}
+}
+
+auto AesKeystream::getInstance() -> AesKeystream & {
+	if (s_instance == nullptr) {
+		s_instance.reset(new AesKeystream{});
+	}
+	return *s_instance;
+}
+
+AesKeystream::AesKeystream() :
+	// Botan picks the fastest provider it was built with, which includes AES-NI where the CPU supports it
+	m_cipher{Botan::get_block_cipher("AES-256")},
+	m_cache{new Entry[CacheSize]}
+{
+	m_cipher->set_key(AesKey, AesKeySize);
+}
+
+auto AesKeystream::apply(const BlockCipherIv &iv, unsigned char *data, int32_t length, uint16_t headerSize) -> void {
+	// The first block is shortened by the header, every block after it restarts the same keystream
+	int32_t firstBlock = BlockSize - headerSize;
+	const unsigned char *keystream = getKeystream(iv, length > firstBlock ? BlockSize : length);
+
+	int32_t pos = 0;
+	int32_t blockSize = firstBlock;
+	while (length > pos) {
+		int32_t amount = length > (pos + blockSize) ?
+			blockSize :
+			(length - pos);
+
+		xorKeystream(data + pos, keystream, amount);
+
+		pos += blockSize;
+		blockSize = BlockSize;
+	}
+}
+
+auto AesKeystream::getKeystream(const BlockCipherIv &iv, int32_t length) -> const unsigned char * {
+	iv_t key = iv.getIv();
+	Entry &entry = m_cache[(key ^ (key >> 16)) % CacheSize];
+	if (entry.iv != key) {
+		entry.iv = key;
+		entry.length = 0;
+	}
+
+	// OFB feeds each output block back in as the next input, so a partial entry can be extended in place
+	while (entry.length < length) {
+		const unsigned char *input = entry.length == 0 ?
+			iv.getBytes() :
+			entry.keystream + entry.length - CipherBlockSize;
+
+		m_cipher->encrypt(input, entry.keystream + entry.length);
+		entry.length += CipherBlockSize;
+	}
+
+	return entry.keystream;
+}
+
+}
\ No newline at end of file
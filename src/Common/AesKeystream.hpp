@@ -0,0 +1,56 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/BlockCipherIv.hpp"
+#include "Common/Types.hpp"
+#include <botan/block_cipher.h>
+
+namespace Vana {
+	// The client runs AES-256 in OFB mode and restarts the stream from the packet IV every BlockSize bytes
+	// Since the key is fixed, the keystream is a pure function of the 4 byte IV, so it's generated lazily and cached
+	// One instance exists per thread, which keeps both the cipher and the cache lock-free
+	class AesKeystream {
+		NONCOPYABLE(AesKeystream);
+	public:
+		static const int32_t BlockSize = 1460;
+
+		static auto getInstance() -> AesKeystream &;
+
+		// Encryption and decryption are the same operation in OFB mode
+		auto apply(const BlockCipherIv &iv, unsigned char *data, int32_t length, uint16_t headerSize) -> void;
+	private:
+		AesKeystream();
+
+		static const int32_t CipherBlockSize = 16;
+		static const int32_t KeystreamSize = ((BlockSize + CipherBlockSize - 1) / CipherBlockSize) * CipherBlockSize;
+		static const size_t CacheSize = 256;
+
+		struct Entry {
+			iv_t iv = 0;
+			int32_t length = 0;
+			unsigned char keystream[KeystreamSize];
+		};
+
+		auto getKeystream(const BlockCipherIv &iv, int32_t length) -> const unsigned char *;
+
+		owned_ptr_t<Botan::BlockCipher> m_cipher;
+		owned_ptr_t<Entry[]> m_cache;
+		static thread_local owned_ptr_t<AesKeystream> s_instance;
+	};
+}
\ No newline at end of file
@@ -17,6 +17,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "BeautyDataProvider.hpp"
 #include "Algorithm.hpp"
+#include "DataSnapshot.hpp"
 #include "Database.hpp"
 #include "GameConstants.hpp"
 #include "GameLogicUtilities.hpp"
@@ -43,10 +44,9 @@ auto BeautyDataProvider::loadSkins() -> void {
 	m_skins.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("character_skin_data") << " ORDER BY skinid ASC");
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("character_skin_data") + " ORDER BY skinid ASC");
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		m_skins.push_back(row.get<skin_id_t>("skinid"));
 	}
 
@@ -57,10 +57,9 @@ auto BeautyDataProvider::loadHair() -> void {
 	std::cout << std::setw(Initializing::OutputWidth) << std::left << "Initializing Hair... ";
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("character_hair_data") << " ORDER BY hairid ASC");
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("character_hair_data") + " ORDER BY hairid ASC");
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		gender_id_t genderId = GameLogicUtilities::getGenderId(row.get<string_t>("gender"));
 		hair_id_t hair = row.get<hair_id_t>("hairid");
 		auto &gender = genderId == Gender::Female ? m_female : m_male;
@@ -74,10 +73,9 @@ auto BeautyDataProvider::loadFaces() -> void {
 	std::cout << std::setw(Initializing::OutputWidth) << std::left << "Initializing Faces... ";
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("character_face_data") << " ORDER BY faceid ASC");
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("character_face_data") + " ORDER BY faceid ASC");
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		gender_id_t genderId = GameLogicUtilities::getGenderId(row.get<string_t>("gender"));
 		face_id_t face = row.get<face_id_t>("faceid");
 		auto &gender = genderId == Gender::Female ? m_female : m_male;
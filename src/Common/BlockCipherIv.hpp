@@ -26,7 +26,7 @@ namespace Vana {
 		BlockCipherIv();
 		explicit BlockCipherIv(iv_t iv);
 
-		auto getBytes() -> unsigned char const * const { return m_iv; }
+		auto getBytes() const -> const unsigned char * { return m_iv; }
 		auto getIv() const -> iv_t { return *reinterpret_cast<const iv_t *>(m_iv); }
 		auto shuffle() -> void;
 	private:
@@ -0,0 +1,50 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "BroadcastPacket.hpp"
+#include "Common/CustomCipher.hpp"
+#include "Common/PacketBuilder.hpp"
+
+namespace Vana {
+
+BroadcastPacket::BroadcastPacket(const PacketBuilder &builder, PacketPriority priority) :
+	m_priority{priority},
+	m_builder{builder}
+{
+}
+
+auto BroadcastPacket::getBuffer() const -> const unsigned char * {
+	return m_builder.getBuffer();
+}
+
+auto BroadcastPacket::getPreparedBuffer() const -> const unsigned char * {
+	if (m_prepared.empty()) {
+		m_prepared.assign(m_builder.getBuffer(), m_builder.getBuffer() + m_builder.getSize());
+		CustomCipher::encrypt(m_prepared.data(), getSize());
+	}
+	return m_prepared.data();
+}
+
+auto BroadcastPacket::getSize() const -> int32_t {
+	return static_cast<int32_t>(m_builder.getSize());
+}
+
+auto BroadcastPacket::getPriority() const -> PacketPriority {
+	return m_priority;
+}
+
+}
\ No newline at end of file
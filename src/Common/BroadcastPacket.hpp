@@ -0,0 +1,44 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/PacketPriority.hpp"
+#include "Common/Types.hpp"
+
+namespace Vana {
+	class PacketBuilder;
+
+	// Wraps a packet that's about to be sent to many sessions
+	// The IV independent custom encryption layer is applied once, on first use, and shared by every recipient
+	// Instances are meant to live on the stack for the duration of a single fan-out
+	class BroadcastPacket {
+		NONCOPYABLE(BroadcastPacket);
+		NO_DEFAULT_CONSTRUCTOR(BroadcastPacket);
+	public:
+		explicit BroadcastPacket(const PacketBuilder &builder, PacketPriority priority = PacketPriority::Normal);
+
+		auto getBuffer() const -> const unsigned char *;
+		auto getPreparedBuffer() const -> const unsigned char *;
+		auto getSize() const -> int32_t;
+		auto getPriority() const -> PacketPriority;
+	private:
+		PacketPriority m_priority;
+		const PacketBuilder &m_builder;
+		mutable vector_t<unsigned char> m_prepared;
+	};
+}
\ No newline at end of file
@@ -37,4 +37,9 @@ namespace Vana {
 			builder.add<int8_t>(static_cast<int8_t>(obj));
 		}
 	};
+
+	template <>
+	struct PacketSize<BuffSourceType> {
+		static constexpr size_t value = packetSize<int8_t>();
+	};
 }
\ No newline at end of file
@@ -0,0 +1,56 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "BufferPool.hpp"
+
+namespace Vana {
+
+BufferPool::BufferPool(size_t bufferSize, size_t maxRetained) :
+	m_bufferSize{bufferSize},
+	m_maxRetained{maxRetained}
+{
+}
+
+auto BufferPool::acquire() -> owned_ptr_t<unsigned char[]> {
+	{
+		owned_lock_t<mutex_t> l{m_mutex};
+		if (m_free.size() > 0) {
+			auto buffer = std::move(m_free.back());
+			m_free.pop_back();
+			return buffer;
+		}
+	}
+
+	return owned_ptr_t<unsigned char[]>{new unsigned char[m_bufferSize]};
+}
+
+auto BufferPool::release(owned_ptr_t<unsigned char[]> buffer) -> void {
+	if (buffer == nullptr) {
+		return;
+	}
+
+	owned_lock_t<mutex_t> l{m_mutex};
+	if (m_free.size() < m_maxRetained) {
+		m_free.push_back(std::move(buffer));
+	}
+}
+
+auto BufferPool::getBufferSize() const -> size_t {
+	return m_bufferSize;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Types.hpp"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Vana {
+	// Hands out fixed-size byte buffers and keeps returned ones around for reuse
+	// At most maxRetained idle buffers are kept, anything returned beyond that is freed
+	class BufferPool {
+		NONCOPYABLE(BufferPool);
+		NO_DEFAULT_CONSTRUCTOR(BufferPool);
+	public:
+		BufferPool(size_t bufferSize, size_t maxRetained);
+
+		auto acquire() -> owned_ptr_t<unsigned char[]>;
+		auto release(owned_ptr_t<unsigned char[]> buffer) -> void;
+		auto getBufferSize() const -> size_t;
+	private:
+		size_t m_bufferSize;
+		size_t m_maxRetained;
+		mutex_t m_mutex;
+		vector_t<owned_ptr_t<unsigned char[]>> m_free;
+	};
+}
\ No newline at end of file
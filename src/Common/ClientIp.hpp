@@ -48,4 +48,9 @@ namespace Vana {
 			}
 		}
 	};
+
+	template <>
+	struct PacketSize<ClientIp> {
+		static constexpr size_t value = packetSize<uint32_t>();
+	};
 }
\ No newline at end of file
@@ -107,6 +107,11 @@ auto ConfigFile::getLoginServerConfig() -> owned_ptr_t<ConfigFile> {
 	return env;
 }
 
+auto ConfigFile::getLoadGeneratorConfig() -> owned_ptr_t<ConfigFile> {
+	auto env = make_owned_ptr<ConfigFile>("conf/load_generator.lua");
+	return env;
+}
+
 auto ConfigFile::getLoggerConfig() -> owned_ptr_t<ConfigFile> {
 	auto env = make_owned_ptr<ConfigFile>("conf/logger.lua");
 
@@ -34,6 +34,7 @@ namespace Vana {
 		auto static getSaltingConfig() -> owned_ptr_t<ConfigFile>;
 		auto static getWorldsConfig() -> owned_ptr_t<ConfigFile>;
 		auto static getLoginServerConfig() -> owned_ptr_t<ConfigFile>;
+		auto static getLoadGeneratorConfig() -> owned_ptr_t<ConfigFile>;
 		auto static getLoggerConfig() -> owned_ptr_t<ConfigFile>;
 		auto static getDatabaseConfig() -> owned_ptr_t<ConfigFile>;
 		auto static getConnectionPropertiesConfig() -> owned_ptr_t<ConfigFile>;
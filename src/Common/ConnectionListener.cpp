@@ -52,15 +52,12 @@ void ConnectionListener::beginAccept() {
 
 			iv_t recvIv = 0;
 			iv_t sendIv = 0;
-			if (!m_config.encrypt) {
-				newSession->start(m_config.ping, make_ref_ptr<PacketTransformer>());
-			}
-			else {
+			if (m_config.encrypt) {
 				recvIv = Randomizer::rand<iv_t>();
 				sendIv = Randomizer::rand<iv_t>();
-				newSession->start(m_config.ping, make_ref_ptr<EncryptedPacketTransformer>(recvIv, sendIv));
 			}
 
+			// The connect packet is queued before starting so it can't be preceded by anything the handler sends
 			newSession->send(
 				Packets::connect(
 					m_config.subversion,
@@ -68,6 +65,13 @@ void ConnectionListener::beginAccept() {
 					sendIv),
 				false);
 
+			if (!m_config.encrypt) {
+				newSession->start(m_config.ping, m_config.sendLimits, make_ref_ptr<PacketTransformer>());
+			}
+			else {
+				newSession->start(m_config.ping, m_config.sendLimits, make_ref_ptr<EncryptedPacketTransformer>(recvIv, sendIv));
+			}
+
 			this->beginAccept();
 		}
 		else if (error.value() == asio::error::operation_aborted) {
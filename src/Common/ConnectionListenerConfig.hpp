@@ -20,6 +20,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "Common/ConnectionType.hpp"
 #include "Common/Ip.hpp"
 #include "Common/PingConfig.hpp"
+#include "Common/SendLimitConfig.hpp"
 #include "Common/Types.hpp"
 #include <string>
 
@@ -31,6 +32,7 @@ namespace Vana {
 		string_t subversion;
 		port_t port;
 		Ip::Type ipType;
+		SendLimitConfig sendLimits;
 
 		ConnectionListenerConfig(
 			const PingConfig &ping,
@@ -38,13 +40,15 @@ namespace Vana {
 			ConnectionType type,
 			string_t subversion,
 			port_t port,
-			Ip::Type ipType) :
+			Ip::Type ipType,
+			const SendLimitConfig &sendLimits = SendLimitConfig{}) :
 			ping{ping},
 			encrypt{encrypt},
 			type{type},
 			subversion{subversion},
 			port{port},
-			ipType{ipType}
+			ipType{ipType},
+			sendLimits{sendLimits}
 		{
 		}
 	};
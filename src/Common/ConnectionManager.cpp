@@ -24,10 +24,15 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "Common/MiscUtilities.hpp"
 #include "Common/Session.hpp"
 #include "Common/ThreadPool.hpp"
+#include <algorithm>
 
 namespace Vana {
 
+const size_t ReceiveBuffersRetained = 256;
+
 ConnectionManager::ConnectionManager(AbstractServer *server) :
+	m_receiveBufferPool{Session::ReceiveBufferLen, ReceiveBuffersRetained},
+	m_handlerStrand{m_ioService},
 	m_server{server}
 {
 	m_work = make_owned_ptr<asio::io_service::work>(m_ioService);
@@ -37,7 +42,7 @@ ConnectionManager::~ConnectionManager() {
 	// m_work.reset() needs to be a pre-wait hook and in the destructor for the cases where the thread is never leased (e.g. DB unavailable)
 	// Doing this a second time doesn't harm an already-reset m_work pointer, so we're in the clear
 	m_work.reset();
-	m_thread.reset();
+	m_threads.clear();
 }
 
 auto ConnectionManager::listen(const ConnectionListenerConfig &config, HandlerCreator handlerCreator) -> void {
@@ -100,9 +105,10 @@ auto ConnectionManager::connect(const Ip &destination, port_t port, const PingCo
 				}
 				else {
 					newSession->setType(MiscUtilities::getConnectionType(sourceType));
-					newSession->start(ping, make_ref_ptr<EncryptedPacketTransformer>(recvIv, sendIv));
+					// Server links are never throttled, dropping inter-server traffic would desynchronize the servers
+					newSession->start(ping, SendLimitConfig{}, make_ref_ptr<EncryptedPacketTransformer>(recvIv, sendIv));
 
-					m_sessions.insert(newSession);
+					start(newSession);
 
 					return std::make_pair(Result::Successful, newSession);
 				}
@@ -123,22 +129,33 @@ auto ConnectionManager::connect(const Ip &destination, port_t port, const PingCo
 }
 
 auto ConnectionManager::stop() -> void {
+	if (m_replay != nullptr) {
+		m_replay->stop();
+	}
+
 	for (auto &server : m_servers) {
 		server->stop();
 	}
 	m_servers.clear();
 
-	auto sessions = m_sessions;
+	hash_set_t<ref_ptr_t<Session>> sessions;
+	{
+		owned_lock_t<mutex_t> l{m_sessionsMutex};
+		sessions = m_sessions;
+	}
+
 	for (auto &session : sessions) {
 		session->disconnect();
 	}
 }
 
 auto ConnectionManager::stop(ref_ptr_t<Session> session) -> void {
+	owned_lock_t<mutex_t> l{m_sessionsMutex};
 	m_sessions.erase(session);
 }
 
 auto ConnectionManager::start(ref_ptr_t<Session> session) -> void {
+	owned_lock_t<mutex_t> l{m_sessionsMutex};
 	m_sessions.insert(session);
 }
 
@@ -146,10 +163,114 @@ auto ConnectionManager::getServer() -> AbstractServer * {
 	return m_server;
 }
 
-auto ConnectionManager::run() -> void {
-	m_thread = ThreadPool::lease(
-		[this] { m_ioService.run(); },
-		[this] { m_work.reset(); });
+auto ConnectionManager::postHandler(function_t<void()> work) -> void {
+	m_handlerStrand.post(makeExclusive(work));
+}
+
+auto ConnectionManager::dispatchHandler(function_t<void()> work) -> void {
+	m_handlerStrand.dispatch(makeExclusive(work));
+}
+
+auto ConnectionManager::makeExclusive(function_t<void()> work) -> function_t<void()> {
+	if (m_shardStrands.empty()) {
+		return work;
+	}
+
+	return [this, work] {
+		m_gate.runExclusive(work);
+	};
+}
+
+auto ConnectionManager::setShardCount(int32_t count) -> void {
+	m_shardStrands.clear();
+	vector_t<HandlerGate::post_t> shardPosts;
+	for (int32_t i = 0; i < count; ++i) {
+		m_shardStrands.push_back(make_owned_ptr<asio::io_service::strand>(m_ioService));
+		asio::io_service::strand *strand = m_shardStrands.back().get();
+		shardPosts.push_back([strand](HandlerGate::work_t work) { strand->post(work); });
+	}
+
+	// Parked work is already past the gate's checks, it goes straight to the strands
+	m_gate.setLanes([this](HandlerGate::work_t work) { m_handlerStrand.post(work); }, shardPosts);
+}
+
+auto ConnectionManager::getShardCount() const -> int32_t {
+	return static_cast<int32_t>(m_shardStrands.size());
+}
+
+auto ConnectionManager::postShard(int32_t shard, function_t<void()> work) -> void {
+	m_shardStrands[shard]->post([this, shard, work] {
+		m_gate.runShared(static_cast<size_t>(shard), work);
+	});
+}
+
+auto ConnectionManager::getReceiveBufferPool() -> BufferPool & {
+	return m_receiveBufferPool;
+}
+
+auto ConnectionManager::recordSendLimitDisconnect() -> void {
+	m_sendLimitDisconnects.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto ConnectionManager::getStats() -> Stats {
+	Stats ret;
+	ret.sendLimitDisconnects = m_sendLimitDisconnects.load(std::memory_order_relaxed);
+
+	owned_lock_t<mutex_t> l{m_sessionsMutex};
+	ret.sessions = m_sessions.size();
+	for (const auto &session : m_sessions) {
+		SessionStats stats = session->getStats();
+		SessionStats &totals = ret.totals;
+		totals.packetsSent += stats.packetsSent;
+		totals.bytesSent += stats.bytesSent;
+		totals.writes += stats.writes;
+		totals.packetsReceived += stats.packetsReceived;
+		totals.bytesReceived += stats.bytesReceived;
+		totals.reads += stats.reads;
+		totals.packetsDropped += stats.packetsDropped;
+		totals.queuedBytes += stats.queuedBytes;
+		totals.queuedPackets += stats.queuedPackets;
+		totals.peakQueuedBytes = std::max(totals.peakQueuedBytes, stats.peakQueuedBytes);
+	}
+	return ret;
+}
+
+auto ConnectionManager::getOpcodeStats() -> OpcodeStats & {
+	return m_opcodeStats;
+}
+
+auto ConnectionManager::startCapture(const string_t &filename) -> Result {
+	auto capture = make_owned_ptr<PacketCaptureWriter>(filename);
+	if (!capture->isOpen()) {
+		return Result::Failure;
+	}
+	m_capture = std::move(capture);
+	return Result::Successful;
+}
+
+auto ConnectionManager::getCapture() -> PacketCaptureWriter * {
+	return m_capture.get();
+}
+
+auto ConnectionManager::nextSessionId() -> uint32_t {
+	return m_nextSessionId.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto ConnectionManager::replay(const ReplayConfig &config, HandlerCreator handlerCreator, PacketReplay::packet_hook_t beforeHandle, PacketReplay::complete_func_t onComplete) -> void {
+	m_replay = make_owned_ptr<PacketReplay>(m_ioService, *this, config, handlerCreator, beforeHandle, onComplete);
+	m_replay->start();
+}
+
+auto ConnectionManager::run(int32_t threadCount) -> void {
+	if (threadCount <= 0) {
+		threadCount = std::max(1, static_cast<int32_t>(thread_t::hardware_concurrency()));
+	}
+
+	for (int32_t i = 0; i < threadCount; ++i) {
+		m_threads.push_back(ThreadPool::lease(
+			[this] { m_ioService.run(); },
+			[this] { m_work.reset(); }));
+	}
 }
 
 }
\ No newline at end of file
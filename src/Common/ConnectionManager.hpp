@@ -17,7 +17,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #pragma once
 
+#include "Common/BufferPool.hpp"
+#include "Common/HandlerGate.hpp"
 #include "Common/Ip.hpp"
+#include "Common/OpcodeStats.hpp"
+#include "Common/PacketCapture.hpp"
+#include "Common/PacketReplay.hpp"
 #include "Common/ServerType.hpp"
 #include "Common/Session.hpp"
 #include "Common/Types.hpp"
@@ -36,23 +41,61 @@ namespace Vana {
 	struct ConnectionListenerConfig;
 	struct PingConfig;
 
+	// Sessions own their sockets and codecs and do all I/O, encryption, and decryption on their own strand
+	// Everything else the server owns (players, maps, worlds, etc.) belongs to the handler strand, which is where packet handlers run
+	// With handler shards, packets that a handler can confine to one shard (e.g. a map) run on that shard's strand instead
+	// Shards run side by side, but never while the handler strand is running something
 	class ConnectionManager {
 	public:
+		struct Stats {
+			size_t sessions = 0;
+			// Sums over the sessions that are connected right now, the peak is the highest of them
+			SessionStats totals;
+			uint64_t sendLimitDisconnects = 0;
+		};
+
 		ConnectionManager(AbstractServer *server);
 		~ConnectionManager();
 		auto listen(const ConnectionListenerConfig &listener, HandlerCreator handlerCreator) -> void;
 		auto connect(const Ip &destination, port_t port, const PingConfig &ping, ServerType sourceType, HandlerCreator handlerCreator) -> pair_t<Result, ref_ptr_t<Session>>;
-		auto run() -> void;
+		auto run(int32_t threadCount) -> void;
 		auto stop() -> void;
 		auto stop(ref_ptr_t<Session> session) -> void;
 		auto start(ref_ptr_t<Session> session) -> void;
 		auto getServer() -> AbstractServer *;
+		auto postHandler(function_t<void()> work) -> void;
+		auto dispatchHandler(function_t<void()> work) -> void;
+		// Must be called before run, 0 keeps everything on the handler strand
+		auto setShardCount(int32_t count) -> void;
+		auto getShardCount() const -> int32_t;
+		auto postShard(int32_t shard, function_t<void()> work) -> void;
+		auto getReceiveBufferPool() -> BufferPool &;
+		auto recordSendLimitDisconnect() -> void;
+		auto getStats() -> Stats;
+		auto getOpcodeStats() -> OpcodeStats &;
+		auto startCapture(const string_t &filename) -> Result;
+		auto getCapture() -> PacketCaptureWriter *;
+		auto nextSessionId() -> uint32_t;
+		auto replay(const ReplayConfig &config, HandlerCreator handlerCreator, PacketReplay::packet_hook_t beforeHandle, PacketReplay::complete_func_t onComplete) -> void;
 	private:
+		auto makeExclusive(function_t<void()> work) -> function_t<void()>;
+
+		// Sessions hand their buffers back when they're destroyed, so the pool has to outlive them and the io_service
+		BufferPool m_receiveBufferPool;
 		vector_t<ref_ptr_t<ConnectionListener>> m_servers;
 		hash_set_t<ref_ptr_t<Session>> m_sessions;
-		ref_ptr_t<thread_t> m_thread;
+		mutex_t m_sessionsMutex;
+		vector_t<ref_ptr_t<thread_t>> m_threads;
 		owned_ptr_t<asio::io_service::work> m_work;
 		asio::io_service m_ioService;
+		asio::io_service::strand m_handlerStrand;
+		vector_t<owned_ptr_t<asio::io_service::strand>> m_shardStrands;
+		HandlerGate m_gate;
 		AbstractServer *m_server;
+		OpcodeStats m_opcodeStats;
+		owned_ptr_t<PacketCaptureWriter> m_capture;
+		std::atomic<uint32_t> m_nextSessionId{0};
+		owned_ptr_t<PacketReplay> m_replay;
+		std::atomic<uint64_t> m_sendLimitDisconnects{0};
 	};
 }
\ No newline at end of file
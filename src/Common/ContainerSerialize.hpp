@@ -0,0 +1,82 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/IPacket.hpp"
+#include "Common/PacketBuilder.hpp"
+#include "Common/PacketReader.hpp"
+#include "Common/Types.hpp"
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+namespace Vana {
+	template <typename TFirst, typename TSecond>
+	struct PacketSerialize<pair_t<TFirst, TSecond>> {
+		auto read(PacketReader &reader) -> pair_t<TFirst, TSecond> {
+			TFirst first = reader.get<TFirst>();
+			TSecond second = reader.get<TSecond>();
+			return pair_t<TFirst, TSecond>{first, second};
+		}
+		auto write(PacketBuilder &builder, const pair_t<TFirst, TSecond> &obj) -> void {
+			builder.add<TFirst>(obj.first);
+			builder.add<TSecond>(obj.second);
+		}
+	};
+
+	// Maps are written as a count followed by each key and value
+	template <typename TKey, typename TValue>
+	struct PacketSerialize<ord_map_t<TKey, TValue>> {
+		auto read(PacketReader &reader) -> ord_map_t<TKey, TValue> {
+			ord_map_t<TKey, TValue> ret;
+			uint32_t size = reader.get<uint32_t>();
+			for (uint32_t i = 0; i < size; i++) {
+				TKey key = reader.get<TKey>();
+				ret[key] = reader.get<TValue>();
+			}
+			return ret;
+		}
+		auto write(PacketBuilder &builder, const ord_map_t<TKey, TValue> &obj) -> void {
+			builder.add<uint32_t>(static_cast<uint32_t>(obj.size()));
+			for (const auto &kvp : obj) {
+				builder.add<TKey>(kvp.first);
+				builder.add<TValue>(kvp.second);
+			}
+		}
+	};
+
+	template <typename TKey, typename TValue>
+	struct PacketSerialize<hash_map_t<TKey, TValue>> {
+		auto read(PacketReader &reader) -> hash_map_t<TKey, TValue> {
+			hash_map_t<TKey, TValue> ret;
+			uint32_t size = reader.get<uint32_t>();
+			for (uint32_t i = 0; i < size; i++) {
+				TKey key = reader.get<TKey>();
+				ret[key] = reader.get<TValue>();
+			}
+			return ret;
+		}
+		auto write(PacketBuilder &builder, const hash_map_t<TKey, TValue> &obj) -> void {
+			builder.add<uint32_t>(static_cast<uint32_t>(obj.size()));
+			for (const auto &kvp : obj) {
+				builder.add<TKey>(kvp.first);
+				builder.add<TValue>(kvp.second);
+			}
+		}
+	};
+}
\ No newline at end of file
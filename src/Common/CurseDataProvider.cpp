@@ -17,6 +17,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "CurseDataProvider.hpp"
 #include "Algorithm.hpp"
+#include "DataSnapshot.hpp"
 #include "Database.hpp"
 #include "InitializeCommon.hpp"
 #include "StringUtilities.hpp"
@@ -31,10 +32,9 @@ auto CurseDataProvider::loadData() -> void {
 
 	m_curseWords.clear();
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("curse_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("curse_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		m_curseWords.push_back(row.get<string_t>("word"));
 	}
 
@@ -0,0 +1,279 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "CustomCipher.hpp"
+#include "Common/BitUtilities.hpp"
+#include "Common/CustomCipherLanes.hpp"
+#include <algorithm>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VANA_CUSTOM_CIPHER_SIMD
+#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace Vana {
+namespace CustomCipher {
+
+auto encrypt(unsigned char *data, int32_t length) -> void {
+	int32_t j;
+	uint8_t a, c;
+	for (uint8_t i = 0; i < 3; ++i) {
+		a = 0;
+		for (j = length; j > 0; --j) {
+			c = data[length - j];
+			c = BitUtilities::rotateLeft(c, 3);
+			c = static_cast<uint8_t>(c + j); // Guess this is supposed to be right?
+			c = c ^ a;
+			a = c;
+			c = BitUtilities::rotateRight(a, j);
+			c = c ^ 0xFF;
+			c = c + 0x48;
+			data[length - j] = c;
+		}
+		a = 0;
+		for (j = length; j > 0; --j) {
+			c = data[j - 1];
+			c = BitUtilities::rotateLeft(c, 4);
+			c = static_cast<uint8_t>(c + j); // Guess this is supposed to be right?
+			c = c ^ a;
+			a = c;
+			c = c ^ 0x13;
+			c = BitUtilities::rotateRight(c, 3);
+			data[j - 1] = c;
+		}
+	}
+}
+
+auto decrypt(unsigned char *data, int32_t length) -> void {
+	int32_t j;
+	uint8_t a, b, c;
+	for (uint8_t i = 0; i < 3; i++) {
+		a = 0;
+		b = 0;
+		for (j = length; j > 0; j--) {
+			c = data[j - 1];
+			c = BitUtilities::rotateLeft(c, 3);
+			c = c ^ 0x13;
+			a = c;
+			c = c ^ b;
+			c = static_cast<uint8_t>(c - j); // Guess this is supposed to be right?
+			c = BitUtilities::rotateRight(c, 4);
+			b = a;
+			data[j - 1] = c;
+		}
+		a = 0;
+		b = 0;
+		for (j = length; j > 0; j--) {
+			c = data[length - j];
+			c = c - 0x48;
+			c = c ^ 0xFF;
+			c = BitUtilities::rotateLeft(c, j);
+			a = c;
+			c = c ^ b;
+			c = static_cast<uint8_t>(c - j); // Guess this is supposed to be right?
+			c = BitUtilities::rotateRight(c, 3);
+			b = a;
+			data[length - j] = c;
+		}
+	}
+}
+
+#ifdef VANA_CUSTOM_CIPHER_SIMD
+struct Sse2 {
+	using simd_t = __m128i;
+	static const size_t Lanes = 16;
+
+	static auto load(const unsigned char *src) -> simd_t { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(src)); }
+	static auto store(unsigned char *dest, simd_t v) -> void { _mm_storeu_si128(reinterpret_cast<__m128i *>(dest), v); }
+	static auto zero() -> simd_t { return _mm_setzero_si128(); }
+	static auto set(uint8_t value) -> simd_t { return _mm_set1_epi8(static_cast<char>(value)); }
+	static auto add(simd_t a, simd_t b) -> simd_t { return _mm_add_epi8(a, b); }
+	static auto sub(simd_t a, simd_t b) -> simd_t { return _mm_sub_epi8(a, b); }
+	static auto xor_(simd_t a, simd_t b) -> simd_t { return _mm_xor_si128(a, b); }
+	static auto and_(simd_t a, simd_t b) -> simd_t { return _mm_and_si128(a, b); }
+	static auto or_(simd_t a, simd_t b) -> simd_t { return _mm_or_si128(a, b); }
+	static auto shiftLeft16(simd_t v, int32_t shifts) -> simd_t { return _mm_sll_epi16(v, _mm_cvtsi32_si128(shifts)); }
+	static auto shiftRight16(simd_t v, int32_t shifts) -> simd_t { return _mm_srl_epi16(v, _mm_cvtsi32_si128(shifts)); }
+};
+#endif
+
+#if defined(VANA_CUSTOM_CIPHER_SIMD) || defined(VANA_CUSTOM_CIPHER_AVX2)
+// The scratch buffer lives on the stack
+const size_t ScratchSize = 32768;
+const size_t MinimumLanes = 4;
+
+template <size_t Lanes, typename TLanes>
+auto runGroup(Packet *packets, size_t count, int32_t length, TLanes lanes) -> void {
+	alignas(32) unsigned char rows[ScratchSize];
+
+	for (int32_t r = 0; r < length; ++r) {
+		unsigned char *row = rows + r * Lanes;
+		for (size_t lane = 0; lane < Lanes; ++lane) {
+			row[lane] = lane < count ? packets[lane].data[r] : 0;
+		}
+	}
+
+	lanes(rows, length);
+
+	for (int32_t r = 0; r < length; ++r) {
+		const unsigned char *row = rows + r * Lanes;
+		for (size_t lane = 0; lane < count; ++lane) {
+			packets[lane].data[r] = row[lane];
+		}
+	}
+}
+
+template <size_t Lanes, typename TScalar, typename TLanes>
+auto runBatch(vector_t<Packet> &packets, TScalar scalar, TLanes lanes) -> void {
+	const int32_t MaxLaneLength = static_cast<int32_t>(ScratchSize / Lanes);
+
+	std::sort(std::begin(packets), std::end(packets), [](const Packet &a, const Packet &b) {
+		return a.length < b.length;
+	});
+
+	size_t i = 0;
+	while (i < packets.size()) {
+		int32_t length = packets[i].length;
+		size_t end = i;
+		while (end < packets.size() && packets[end].length == length) {
+			++end;
+		}
+
+		if (length <= MaxLaneLength) {
+			while (end - i >= MinimumLanes) {
+				size_t count = std::min(end - i, Lanes);
+				runGroup<Lanes>(&packets[i], count, length, lanes);
+				i += count;
+			}
+		}
+
+		for (; i < end; ++i) {
+			scalar(packets[i].data, packets[i].length);
+		}
+	}
+}
+#endif
+
+#ifdef VANA_CUSTOM_CIPHER_AVX2
+auto cpuHasAvx2() -> bool {
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) {
+		return false;
+	}
+	// The OS has to save the YMM registers too
+	__cpuid(info, 1);
+	if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 6) != 6) {
+		return false;
+	}
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+auto hasAvx2() -> bool {
+	static const bool supported = cpuHasAvx2();
+	return supported;
+}
+#endif
+
+template <typename TScalar>
+auto runScalar(vector_t<Packet> &packets, TScalar scalar) -> void {
+	for (auto &packet : packets) {
+		scalar(packet.data, packet.length);
+	}
+}
+
+auto bestKernel() -> Kernel {
+#ifdef VANA_CUSTOM_CIPHER_AVX2
+	if (hasAvx2()) {
+		return Kernel::Avx2;
+	}
+#endif
+#ifdef VANA_CUSTOM_CIPHER_SIMD
+	return Kernel::Sse2;
+#else
+	return Kernel::Scalar;
+#endif
+}
+
+auto hasKernel(Kernel kernel) -> bool {
+	switch (kernel) {
+		case Kernel::Scalar: return true;
+#ifdef VANA_CUSTOM_CIPHER_SIMD
+		case Kernel::Sse2: return true;
+#endif
+#ifdef VANA_CUSTOM_CIPHER_AVX2
+		case Kernel::Avx2: return hasAvx2();
+#endif
+		default: return false;
+	}
+}
+
+auto encryptBatch(vector_t<Packet> &packets) -> void {
+	encryptBatch(packets, bestKernel());
+}
+
+auto decryptBatch(vector_t<Packet> &packets) -> void {
+	decryptBatch(packets, bestKernel());
+}
+
+auto encryptBatch(vector_t<Packet> &packets, Kernel kernel) -> void {
+	switch (kernel) {
+#ifdef VANA_CUSTOM_CIPHER_SIMD
+		case Kernel::Sse2: runBatch<Sse2::Lanes>(packets, &encrypt, &encryptLanes<Sse2>); return;
+#endif
+#ifdef VANA_CUSTOM_CIPHER_AVX2
+		case Kernel::Avx2:
+			if (hasAvx2()) {
+				runBatch<Avx2Lanes>(packets, &encrypt, &encryptLanesAvx2);
+				return;
+			}
+			break;
+#endif
+		default: break;
+	}
+	runScalar(packets, &encrypt);
+}
+
+auto decryptBatch(vector_t<Packet> &packets, Kernel kernel) -> void {
+	switch (kernel) {
+#ifdef VANA_CUSTOM_CIPHER_SIMD
+		case Kernel::Sse2: runBatch<Sse2::Lanes>(packets, &decrypt, &decryptLanes<Sse2>); return;
+#endif
+#ifdef VANA_CUSTOM_CIPHER_AVX2
+		case Kernel::Avx2:
+			if (hasAvx2()) {
+				runBatch<Avx2Lanes>(packets, &decrypt, &decryptLanesAvx2);
+				return;
+			}
+			break;
+#endif
+		default: break;
+	}
+	runScalar(packets, &decrypt);
+}
+
+}
+}
\ No newline at end of file
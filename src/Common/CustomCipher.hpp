@@ -0,0 +1,49 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Types.hpp"
+
+namespace Vana {
+	// The byte shuffling layer the client applies underneath AES
+	// It doesn't depend on the IV, but each byte depends on the ones processed before it, so a single packet can't be vectorized
+	// The batch functions run independent packets side by side in SIMD lanes instead and are bit-exact with the scalar ones
+	namespace CustomCipher {
+		struct Packet {
+			unsigned char *data;
+			int32_t length;
+		};
+
+		enum class Kernel {
+			Scalar,
+			Sse2,
+			Avx2,
+		};
+
+		auto encrypt(unsigned char *data, int32_t length) -> void;
+		auto decrypt(unsigned char *data, int32_t length) -> void;
+		// Both of these may reorder packets
+		auto encryptBatch(vector_t<Packet> &packets) -> void;
+		auto decryptBatch(vector_t<Packet> &packets) -> void;
+
+		// The batch functions above use the widest kernel this build and CPU have, these run a specific one for comparing them
+		auto hasKernel(Kernel kernel) -> bool;
+		auto encryptBatch(vector_t<Packet> &packets, Kernel kernel) -> void;
+		auto decryptBatch(vector_t<Packet> &packets, Kernel kernel) -> void;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "CustomCipherLanes.hpp"
+
+#ifdef VANA_CUSTOM_CIPHER_AVX2
+#if !defined(__AVX2__) && !defined(_MSC_VER)
+#error "CustomCipherAvx2.cpp has to be compiled with AVX2 enabled (-mavx2)"
+#endif
+#include <immintrin.h>
+
+namespace Vana {
+namespace CustomCipher {
+
+struct Avx2 {
+	using simd_t = __m256i;
+	static const size_t Lanes = Avx2Lanes;
+
+	static auto load(const unsigned char *src) -> simd_t { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src)); }
+	static auto store(unsigned char *dest, simd_t v) -> void { _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest), v); }
+	static auto zero() -> simd_t { return _mm256_setzero_si256(); }
+	static auto set(uint8_t value) -> simd_t { return _mm256_set1_epi8(static_cast<char>(value)); }
+	static auto add(simd_t a, simd_t b) -> simd_t { return _mm256_add_epi8(a, b); }
+	static auto sub(simd_t a, simd_t b) -> simd_t { return _mm256_sub_epi8(a, b); }
+	static auto xor_(simd_t a, simd_t b) -> simd_t { return _mm256_xor_si256(a, b); }
+	static auto and_(simd_t a, simd_t b) -> simd_t { return _mm256_and_si256(a, b); }
+	static auto or_(simd_t a, simd_t b) -> simd_t { return _mm256_or_si256(a, b); }
+	static auto shiftLeft16(simd_t v, int32_t shifts) -> simd_t { return _mm256_sll_epi16(v, _mm_cvtsi32_si128(shifts)); }
+	static auto shiftRight16(simd_t v, int32_t shifts) -> simd_t { return _mm256_srl_epi16(v, _mm_cvtsi32_si128(shifts)); }
+};
+
+auto encryptLanesAvx2(unsigned char *rows, int32_t length) -> void {
+	encryptLanes<Avx2>(rows, length);
+}
+
+auto decryptLanesAvx2(unsigned char *rows, int32_t length) -> void {
+	decryptLanes<Avx2>(rows, length);
+}
+
+}
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,116 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Types.hpp"
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+#define VANA_CUSTOM_CIPHER_AVX2
+#endif
+
+namespace Vana {
+	// The vector kernels behind the CustomCipher batch functions, only CustomCipher.cpp and CustomCipherAvx2.cpp include this
+	// The AVX2 kernel lives in its own file because it's the only one compiled with AVX2 enabled, it's only called once the CPU says it has AVX2
+	// Each file instantiates the templates here with its own register type, so nothing compiled with AVX2 is shared with the rest of the binary
+	namespace CustomCipher {
+		// Each lane carries one packet, the lanes of a group all have the same length so the position dependent terms are uniform
+		// The packets are transposed into a scratch buffer where row r holds byte r of every lane
+		const size_t Avx2Lanes = 32;
+
+		auto encryptLanesAvx2(unsigned char *rows, int32_t length) -> void;
+		auto decryptLanesAvx2(unsigned char *rows, int32_t length) -> void;
+
+		template <typename TSimd>
+		inline
+		auto rotateLeft(typename TSimd::simd_t v, int32_t shifts) -> typename TSimd::simd_t {
+			// There are no byte shifts, so shift 16 bit words and mask off what crossed over from the neighboring byte
+			shifts &= 7;
+			auto left = TSimd::and_(TSimd::shiftLeft16(v, shifts), TSimd::set(static_cast<uint8_t>(0xFF << shifts)));
+			auto right = TSimd::and_(TSimd::shiftRight16(v, 8 - shifts), TSimd::set(static_cast<uint8_t>(0xFF >> (8 - shifts))));
+			return TSimd::or_(left, right);
+		}
+
+		template <typename TSimd>
+		inline
+		auto rotateRight(typename TSimd::simd_t v, int32_t shifts) -> typename TSimd::simd_t {
+			return rotateLeft<TSimd>(v, 8 - (shifts & 7));
+		}
+
+		template <typename TSimd>
+		auto encryptLanes(unsigned char *rows, int32_t length) -> void {
+			const size_t Lanes = TSimd::Lanes;
+			for (uint8_t i = 0; i < 3; ++i) {
+				auto a = TSimd::zero();
+				for (int32_t j = length; j > 0; --j) {
+					unsigned char *row = rows + (length - j) * Lanes;
+					auto c = rotateLeft<TSimd>(TSimd::load(row), 3);
+					c = TSimd::add(c, TSimd::set(static_cast<uint8_t>(j)));
+					c = TSimd::xor_(c, a);
+					a = c;
+					c = rotateRight<TSimd>(a, j);
+					c = TSimd::xor_(c, TSimd::set(0xFF));
+					c = TSimd::add(c, TSimd::set(0x48));
+					TSimd::store(row, c);
+				}
+				a = TSimd::zero();
+				for (int32_t j = length; j > 0; --j) {
+					unsigned char *row = rows + (j - 1) * Lanes;
+					auto c = rotateLeft<TSimd>(TSimd::load(row), 4);
+					c = TSimd::add(c, TSimd::set(static_cast<uint8_t>(j)));
+					c = TSimd::xor_(c, a);
+					a = c;
+					c = TSimd::xor_(c, TSimd::set(0x13));
+					c = rotateRight<TSimd>(c, 3);
+					TSimd::store(row, c);
+				}
+			}
+		}
+
+		template <typename TSimd>
+		auto decryptLanes(unsigned char *rows, int32_t length) -> void {
+			const size_t Lanes = TSimd::Lanes;
+			for (uint8_t i = 0; i < 3; i++) {
+				auto b = TSimd::zero();
+				for (int32_t j = length; j > 0; j--) {
+					unsigned char *row = rows + (j - 1) * Lanes;
+					auto c = rotateLeft<TSimd>(TSimd::load(row), 3);
+					c = TSimd::xor_(c, TSimd::set(0x13));
+					auto a = c;
+					c = TSimd::xor_(c, b);
+					c = TSimd::sub(c, TSimd::set(static_cast<uint8_t>(j)));
+					c = rotateRight<TSimd>(c, 4);
+					b = a;
+					TSimd::store(row, c);
+				}
+				b = TSimd::zero();
+				for (int32_t j = length; j > 0; j--) {
+					unsigned char *row = rows + (length - j) * Lanes;
+					auto c = TSimd::sub(TSimd::load(row), TSimd::set(0x48));
+					c = TSimd::xor_(c, TSimd::set(0xFF));
+					c = rotateLeft<TSimd>(c, j);
+					auto a = c;
+					c = TSimd::xor_(c, b);
+					c = TSimd::sub(c, TSimd::set(static_cast<uint8_t>(j)));
+					c = rotateRight<TSimd>(c, 3);
+					b = a;
+					TSimd::store(row, c);
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,416 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "DataSnapshot.hpp"
+#include "Common/Database.hpp"
+#include "Common/FileUtilities.hpp"
+#include "Common/HashUtilities.hpp"
+#include "Common/McdbVersion.hpp"
+#include <cctype>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+
+namespace Vana {
+
+static_assert(sizeof(DataCell) == 16, "DataCell is written to snapshots as is, it can't have padding");
+
+auto DataTable::getCell(size_t row, const string_t &column) const -> const DataCell & {
+	auto kvp = m_columnIndex.find(column);
+	if (kvp == std::end(m_columnIndex)) {
+		throw soci::soci_error{"Column '" + column + "' not found"};
+	}
+	return m_cells[row * m_columns.size() + kvp->second];
+}
+
+auto DataTable::indexColumns() -> void {
+	m_columnIndex.clear();
+	for (size_t i = 0; i < m_columns.size(); ++i) {
+		m_columnIndex[m_columns[i]] = i;
+	}
+}
+
+DataSnapshot::DataSnapshot()
+{
+}
+
+auto DataSnapshot::load(const string_t &filename, Database &db, bool verifyContent) -> Result {
+	release();
+
+	// There's nothing to map files with here, a single read of the whole file is the next best thing
+	std::ifstream file{filename, std::ios_base::in | std::ios_base::binary | std::ios_base::ate};
+	if (!file) {
+		return Result::Failure;
+	}
+
+	vector_t<unsigned char> buf(static_cast<size_t>(file.tellg()));
+	file.seekg(0);
+	if (!file.read(reinterpret_cast<char *>(buf.data()), buf.size())) {
+		return Result::Failure;
+	}
+
+	size_t pos = 0;
+	char magic[sizeof(SnapshotMagic)];
+	uint16_t version = 0;
+	int32_t mcdbVersion = 0;
+	int32_t mcdbSubVersion = 0;
+	bool testServer = false;
+	string_t locale;
+	checksum_t tablesKey = 0;
+	checksum_t contentFingerprint = 0;
+	uint64_t length = 0;
+	checksum_t sum = 0;
+	if (!read(buf, pos, magic, sizeof(magic)) || memcmp(magic, SnapshotMagic, sizeof(magic)) != 0) {
+		return Result::Failure;
+	}
+	if (!read(buf, pos, version) || version != SnapshotVersion) {
+		return Result::Failure;
+	}
+	if (!read(buf, pos, mcdbVersion) || !read(buf, pos, mcdbSubVersion) || !read(buf, pos, testServer) || !readString<uint16_t>(buf, pos, locale)) {
+		return Result::Failure;
+	}
+	if (mcdbVersion != Mcdb::MajorVersion || mcdbSubVersion != Mcdb::SubVersion || testServer != Mcdb::IsTestServer || locale != Mcdb::Locale) {
+		return Result::Failure;
+	}
+	if (!read(buf, pos, tablesKey) || !read(buf, pos, contentFingerprint)) {
+		return Result::Failure;
+	}
+	if (!read(buf, pos, length) || !read(buf, pos, sum) || length != buf.size() - pos) {
+		return Result::Failure;
+	}
+	if (HashUtilities::checksum(buf.data() + pos, buf.size() - pos) != sum) {
+		return Result::Failure;
+	}
+
+	uint32_t tableCount = 0;
+	if (!read(buf, pos, tableCount)) {
+		return Result::Failure;
+	}
+
+	hash_map_t<string_t, ref_ptr_t<const DataTable>> tables;
+	for (uint32_t i = 0; i < tableCount; ++i) {
+		auto table = make_ref_ptr<DataTable>();
+		string_t query;
+		uint16_t columnCount = 0;
+		uint32_t rowCount = 0;
+		if (!readString<uint32_t>(buf, pos, query) || !read(buf, pos, columnCount)) {
+			return Result::Failure;
+		}
+
+		table->m_columns.resize(columnCount);
+		for (auto &column : table->m_columns) {
+			if (!readString<uint16_t>(buf, pos, column)) {
+				return Result::Failure;
+			}
+		}
+
+		if (!read(buf, pos, rowCount) || !readString<uint32_t>(buf, pos, table->m_text)) {
+			return Result::Failure;
+		}
+
+		table->m_rows = rowCount;
+		table->m_cells.resize(static_cast<size_t>(rowCount) * columnCount);
+		if (!read(buf, pos, table->m_cells.data(), table->m_cells.size() * sizeof(DataCell))) {
+			return Result::Failure;
+		}
+
+		table->indexColumns();
+		tables[query] = table;
+	}
+
+	// datadb was changed since the snapshot was built
+	auto readTables = findTables(db, tables);
+	if (makeTablesKey(readTables) != tablesKey) {
+		return Result::Failure;
+	}
+	if (verifyContent && makeContentFingerprint(db, readTables) != contentFingerprint) {
+		return Result::Failure;
+	}
+
+	m_tables = std::move(tables);
+	m_mode = Mode::Loaded;
+	return Result::Successful;
+}
+
+auto DataSnapshot::record() -> void {
+	release();
+	m_mode = Mode::Recording;
+}
+
+auto DataSnapshot::write(const string_t &filename, Database &db) const -> Result {
+	vector_t<unsigned char> body;
+	write(body, static_cast<uint32_t>(m_tables.size()));
+	for (const auto &kvp : m_tables) {
+		const DataTable &table = *kvp.second;
+		writeString<uint32_t>(body, kvp.first);
+		write(body, static_cast<uint16_t>(table.m_columns.size()));
+		for (const auto &column : table.m_columns) {
+			writeString<uint16_t>(body, column);
+		}
+		write(body, static_cast<uint32_t>(table.m_rows));
+		writeString<uint32_t>(body, table.m_text);
+		write(body, table.m_cells.data(), table.m_cells.size() * sizeof(DataCell));
+	}
+
+	vector_t<unsigned char> header;
+	write(header, SnapshotMagic, sizeof(SnapshotMagic));
+	write(header, SnapshotVersion);
+	write(header, Mcdb::MajorVersion);
+	write(header, Mcdb::SubVersion);
+	write(header, Mcdb::IsTestServer);
+	writeString<uint16_t>(header, Mcdb::Locale);
+	auto readTables = findTables(db, m_tables);
+	write(header, makeTablesKey(readTables));
+	write(header, makeContentFingerprint(db, readTables));
+	write(header, static_cast<uint64_t>(body.size()));
+	write(header, HashUtilities::checksum(body.data(), body.size()));
+
+	// Written next to the old snapshot and moved over it, a channel starting meanwhile never sees half a file
+	string_t temporary = filename + ".tmp";
+	FileUtilities::createParentDirectories(filename);
+	{
+		std::ofstream file{temporary, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc};
+		file.write(reinterpret_cast<const char *>(header.data()), header.size());
+		file.write(reinterpret_cast<const char *>(body.data()), body.size());
+		file.flush();
+		if (!file) {
+			return Result::Failure;
+		}
+	}
+
+	std::remove(filename.c_str());
+	if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+		return Result::Failure;
+	}
+	return Result::Successful;
+}
+
+auto DataSnapshot::release() -> void {
+	m_tables.clear();
+	m_misses = 0;
+	m_mode = Mode::Off;
+}
+
+auto DataSnapshot::isLoaded() const -> bool {
+	return m_mode == Mode::Loaded;
+}
+
+auto DataSnapshot::getTableCount() const -> size_t {
+	return m_tables.size();
+}
+
+auto DataSnapshot::getMisses() const -> size_t {
+	return m_misses;
+}
+
+auto DataSnapshot::select(Database &db, const string_t &query) -> ref_ptr_t<const DataTable> {
+	switch (m_mode) {
+		case Mode::Loaded: {
+			auto kvp = m_tables.find(query);
+			if (kvp != std::end(m_tables)) {
+				return kvp->second;
+			}
+			m_misses++;
+			break;
+		}
+		case Mode::Recording: {
+			ref_ptr_t<const DataTable> table = DataSnapshot::query(db, query);
+			m_tables[query] = table;
+			return table;
+		}
+		case Mode::Off:
+			break;
+	}
+
+	return DataSnapshot::query(db, query);
+}
+
+auto DataSnapshot::query(Database &db, const string_t &query) -> ref_ptr_t<DataTable> {
+	auto table = make_ref_ptr<DataTable>();
+	soci::rowset<> rs = (db.getSession().prepare << query);
+
+	for (const auto &row : rs) {
+		if (table->m_rows == 0) {
+			for (size_t i = 0; i < row.size(); ++i) {
+				table->m_columns.push_back(row.get_properties(i).get_name());
+			}
+		}
+
+		for (size_t i = 0; i < row.size(); ++i) {
+			table->m_cells.push_back(makeCell(row, i, table->m_text));
+		}
+		table->m_rows++;
+	}
+
+	table->indexColumns();
+	return table;
+}
+
+auto DataSnapshot::findTables(Database &db, const hash_map_t<string_t, ref_ptr_t<const DataTable>> &tables) -> vector_t<pair_t<string_t, string_t>> {
+	// Only the tables the snapshot reads count, datadb may share its schema with tables that change all the time
+	auto &sql = db.getSession();
+	string_t schema = db.getSchema();
+	string_t prefix = db.getTablePrefix();
+	soci::rowset<> rs = (sql.prepare
+		<< "SELECT TABLE_NAME, COALESCE(CAST(CREATE_TIME AS CHAR), '') "
+		<< "FROM INFORMATION_SCHEMA.TABLES "
+		<< "WHERE TABLE_SCHEMA = :schema "
+		<< "ORDER BY TABLE_NAME",
+		soci::use(schema, "schema"));
+
+	vector_t<pair_t<string_t, string_t>> ret;
+	for (const auto &row : rs) {
+		string_t table = row.get<string_t>(0);
+		if (table.compare(0, prefix.size(), prefix) != 0) {
+			continue;
+		}
+
+		for (const auto &kvp : tables) {
+			if (readsTable(kvp.first, table)) {
+				ret.emplace_back(table, row.get<string_t>(1));
+				break;
+			}
+		}
+	}
+	return ret;
+}
+
+auto DataSnapshot::makeTablesKey(const vector_t<pair_t<string_t, string_t>> &tables) -> checksum_t {
+	// Importing MCDB again drops and creates the tables, which changes their creation time
+	string_t text;
+	for (const auto &table : tables) {
+		text += table.first + "@" + table.second + ";";
+	}
+	return HashUtilities::checksum(reinterpret_cast<const unsigned char *>(text.data()), text.size());
+}
+
+auto DataSnapshot::makeContentFingerprint(Database &db, const vector_t<pair_t<string_t, string_t>> &tables) -> checksum_t {
+	// CHECKSUM TABLE reads every row, this is the expensive one
+	string_t text;
+	if (!tables.empty()) {
+		out_stream_t list;
+		for (size_t i = 0; i < tables.size(); ++i) {
+			list << (i == 0 ? "" : ", ") << "`" << tables[i].first << "`";
+		}
+
+		ref_ptr_t<DataTable> sums = query(db, "CHECKSUM TABLE " + list.str());
+		for (const auto &row : *sums) {
+			text += row.get<string_t>("Table") + "=" + row.get<string_t>("Checksum") + ";";
+		}
+	}
+	return HashUtilities::checksum(reinterpret_cast<const unsigned char *>(text.data()), text.size());
+}
+
+auto DataSnapshot::readsTable(const string_t &query, const string_t &table) -> bool {
+	auto isNamePart = [](char c) { return isalnum(static_cast<unsigned char>(c)) != 0 || c == '_'; };
+	for (size_t pos = query.find(table); pos != string_t::npos; pos = query.find(table, pos + 1)) {
+		size_t end = pos + table.size();
+		if ((pos == 0 || !isNamePart(query[pos - 1])) && (end == query.size() || !isNamePart(query[end]))) {
+			return true;
+		}
+	}
+	return false;
+}
+
+auto DataSnapshot::makeCell(const soci::row &row, size_t column, string_t &text) -> DataCell {
+	DataCell cell;
+	if (row.get_indicator(column) == soci::i_null) {
+		return cell;
+	}
+
+	switch (row.get_properties(column).get_data_type()) {
+		case soci::dt_string: {
+			std::string value = row.get<std::string>(column);
+			cell.type = DataType::String;
+			cell.value = text.size();
+			cell.length = static_cast<uint32_t>(value.size());
+			text += value;
+			break;
+		}
+		case soci::dt_double: {
+			double value = row.get<double>(column);
+			cell.type = DataType::Double;
+			memcpy(&cell.value, &value, sizeof(value));
+			break;
+		}
+		case soci::dt_integer:
+			cell.type = DataType::Integer;
+			cell.value = static_cast<uint64_t>(static_cast<int64_t>(row.get<int>(column)));
+			break;
+		case soci::dt_long_long:
+			cell.type = DataType::Integer;
+			cell.value = static_cast<uint64_t>(row.get<long long>(column));
+			break;
+		case soci::dt_unsigned_long_long:
+			cell.type = DataType::Unsigned;
+			cell.value = row.get<unsigned long long>(column);
+			break;
+		case soci::dt_date: {
+			// Same as reading it as a UnixTime
+			std::tm value = row.get<std::tm>(column);
+			cell.type = DataType::Integer;
+			cell.value = static_cast<uint64_t>(static_cast<int64_t>(mktime(&value)));
+			break;
+		}
+	}
+	return cell;
+}
+
+template <typename TValue>
+auto DataSnapshot::read(const vector_t<unsigned char> &buf, size_t &pos, TValue &value) -> bool {
+	return read(buf, pos, &value, sizeof(TValue));
+}
+
+auto DataSnapshot::read(const vector_t<unsigned char> &buf, size_t &pos, void *dest, size_t length) -> bool {
+	if (length > buf.size() - pos) {
+		return false;
+	}
+	if (length > 0) {
+		memcpy(dest, buf.data() + pos, length);
+	}
+	pos += length;
+	return true;
+}
+
+template <typename TLength>
+auto DataSnapshot::readString(const vector_t<unsigned char> &buf, size_t &pos, string_t &value) -> bool {
+	TLength length = 0;
+	if (!read(buf, pos, length) || length > buf.size() - pos) {
+		return false;
+	}
+	value.assign(reinterpret_cast<const char *>(buf.data() + pos), length);
+	pos += length;
+	return true;
+}
+
+template <typename TValue>
+auto DataSnapshot::write(vector_t<unsigned char> &buf, TValue value) -> void {
+	write(buf, &value, sizeof(TValue));
+}
+
+auto DataSnapshot::write(vector_t<unsigned char> &buf, const void *src, size_t length) -> void {
+	const unsigned char *bytes = static_cast<const unsigned char *>(src);
+	buf.insert(std::end(buf), bytes, bytes + length);
+}
+
+template <typename TLength>
+auto DataSnapshot::writeString(vector_t<unsigned char> &buf, const string_t &value) -> void {
+	write(buf, static_cast<TLength>(value.size()));
+	write(buf, value.data(), value.size());
+}
+
+}
\ No newline at end of file
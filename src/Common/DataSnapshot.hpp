@@ -0,0 +1,211 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/SociExtensions.hpp"
+#include "Common/StringUtilities.hpp"
+#include "Common/Types.hpp"
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Vana {
+	class Database;
+	class DataTable;
+
+	enum class DataType : uint8_t {
+		Null,
+		Integer,
+		Unsigned,
+		Double,
+		String,
+	};
+
+	// Laid out with no padding so a table's cells can be written and read as one block
+	struct DataCell {
+		// Integers as they are, doubles bit for bit, strings as an offset into the table's text
+		uint64_t value = 0;
+		uint32_t length = 0;
+		DataType type = DataType::Null;
+		uint8_t reserved[3] = {0, 0, 0};
+	};
+
+	// Reads like a soci::row, values go through the same type conversions so NULL and range handling don't change
+	class DataRow {
+	public:
+		DataRow(const DataTable &table, size_t row);
+
+		template <typename TValue>
+		auto get(const string_t &column) const -> TValue;
+	private:
+		template <typename TBase>
+		auto convert(const DataCell &cell, TBase &out) const -> void;
+		auto convert(const DataCell &cell, string_t &out) const -> void;
+		auto getText(const DataCell &cell) const -> string_t;
+		auto getDouble(const DataCell &cell) const -> double;
+
+		const DataTable &m_table;
+		size_t m_row = 0;
+	};
+
+	class DataTable {
+		NONCOPYABLE(DataTable);
+	public:
+		class Iterator {
+		public:
+			Iterator(const DataTable &table, size_t row) : m_table{table}, m_row{row} { }
+			auto operator*() const -> DataRow { return DataRow{m_table, m_row}; }
+			auto operator++() -> Iterator & { ++m_row; return *this; }
+			auto operator!=(const Iterator &other) const -> bool { return m_row != other.m_row; }
+		private:
+			const DataTable &m_table;
+			size_t m_row = 0;
+		};
+
+		DataTable() = default;
+
+		auto begin() const -> Iterator { return Iterator{*this, 0}; }
+		auto end() const -> Iterator { return Iterator{*this, m_rows}; }
+		auto size() const -> size_t { return m_rows; }
+		// Throws the same soci_error soci::row does for a column that isn't in the result
+		auto getCell(size_t row, const string_t &column) const -> const DataCell &;
+	private:
+		friend class DataRow;
+		friend class DataSnapshot;
+
+		auto indexColumns() -> void;
+
+		size_t m_rows = 0;
+		vector_t<string_t> m_columns;
+		hash_map_t<string_t, size_t> m_columnIndex;
+		vector_t<DataCell> m_cells;
+		string_t m_text;
+	};
+
+	// Keeps the results of the queries the data providers run against datadb so a channel can start without running them again
+	// Snapshots are a header ("VDAT", a uint16_t version, the MCDB version it was built from, a key and a fingerprint of datadb's tables, the body's length and checksum)
+	// followed by every table in host byte order, a snapshot built for another MCDB version or from other datadb tables or that fails its checksum isn't used
+	// The key covers the names and creation times of the tables the snapshot's queries read and is cheap to check, it catches MCDB being imported again
+	// The fingerprint covers their content (CHECKSUM TABLE) and reads all of them, so it's only checked when asked for, edits to datadb otherwise need a rebuild
+	// Only meant for loading, queries go straight to the database again once it's released
+	class DataSnapshot {
+		SINGLETON(DataSnapshot);
+	public:
+		// Serves the queries that are in the file until release(), anything else still goes to the database
+		auto load(const string_t &filename, Database &db, bool verifyContent) -> Result;
+		// Sends every query to the database and keeps the results for write()
+		auto record() -> void;
+		auto write(const string_t &filename, Database &db) const -> Result;
+		auto release() -> void;
+		auto isLoaded() const -> bool;
+		auto getTableCount() const -> size_t;
+		// Queries that weren't in the loaded snapshot
+		auto getMisses() const -> size_t;
+		auto select(Database &db, const string_t &query) -> ref_ptr_t<const DataTable>;
+	private:
+		enum class Mode {
+			Off,
+			Loaded,
+			Recording,
+		};
+
+		static auto query(Database &db, const string_t &query) -> ref_ptr_t<DataTable>;
+		// Names and creation times of the datadb tables the queries read
+		static auto findTables(Database &db, const hash_map_t<string_t, ref_ptr_t<const DataTable>> &tables) -> vector_t<pair_t<string_t, string_t>>;
+		static auto makeTablesKey(const vector_t<pair_t<string_t, string_t>> &tables) -> checksum_t;
+		static auto makeContentFingerprint(Database &db, const vector_t<pair_t<string_t, string_t>> &tables) -> checksum_t;
+		static auto readsTable(const string_t &query, const string_t &table) -> bool;
+		static auto makeCell(const soci::row &row, size_t column, string_t &text) -> DataCell;
+		template <typename TValue>
+		static auto read(const vector_t<unsigned char> &buf, size_t &pos, TValue &value) -> bool;
+		static auto read(const vector_t<unsigned char> &buf, size_t &pos, void *dest, size_t length) -> bool;
+		template <typename TLength>
+		static auto readString(const vector_t<unsigned char> &buf, size_t &pos, string_t &value) -> bool;
+		template <typename TValue>
+		static auto write(vector_t<unsigned char> &buf, TValue value) -> void;
+		static auto write(vector_t<unsigned char> &buf, const void *src, size_t length) -> void;
+		template <typename TLength>
+		static auto writeString(vector_t<unsigned char> &buf, const string_t &value) -> void;
+
+		Mode m_mode = Mode::Off;
+		size_t m_misses = 0;
+		hash_map_t<string_t, ref_ptr_t<const DataTable>> m_tables;
+	};
+
+	static const char SnapshotMagic[4] = {'V', 'D', 'A', 'T'};
+	static const uint16_t SnapshotVersion = 3;
+
+	inline
+	DataRow::DataRow(const DataTable &table, size_t row) :
+		m_table{table},
+		m_row{row}
+	{
+	}
+
+	template <typename TValue>
+	auto DataRow::get(const string_t &column) const -> TValue {
+		using base_type = typename soci::type_conversion<TValue>::base_type;
+
+		const DataCell &cell = m_table.getCell(m_row, column);
+		soci::indicator ind = soci::i_null;
+		base_type base{};
+		if (cell.type != DataType::Null) {
+			ind = soci::i_ok;
+			convert(cell, base);
+		}
+
+		TValue value;
+		soci::type_conversion<TValue>::from_base(base, ind, value);
+		return value;
+	}
+
+	template <typename TBase>
+	auto DataRow::convert(const DataCell &cell, TBase &out) const -> void {
+		switch (cell.type) {
+			case DataType::Integer: out = static_cast<TBase>(static_cast<int64_t>(cell.value)); break;
+			case DataType::Unsigned: out = static_cast<TBase>(cell.value); break;
+			case DataType::Double: out = static_cast<TBase>(getDouble(cell)); break;
+			case DataType::String: out = StringUtilities::lexical_cast<TBase>(getText(cell)); break;
+			case DataType::Null: break;
+		}
+	}
+
+	inline
+	auto DataRow::convert(const DataCell &cell, string_t &out) const -> void {
+		switch (cell.type) {
+			case DataType::Integer: out = StringUtilities::lexical_cast<string_t>(static_cast<int64_t>(cell.value)); break;
+			case DataType::Unsigned: out = StringUtilities::lexical_cast<string_t>(cell.value); break;
+			case DataType::Double: out = StringUtilities::lexical_cast<string_t>(getDouble(cell)); break;
+			case DataType::String: out = getText(cell); break;
+			case DataType::Null: break;
+		}
+	}
+
+	inline
+	auto DataRow::getText(const DataCell &cell) const -> string_t {
+		return string_t{m_table.m_text.data() + cell.value, cell.length};
+	}
+
+	inline
+	auto DataRow::getDouble(const DataCell &cell) const -> double {
+		double value;
+		memcpy(&value, &cell.value, sizeof(value));
+		return value;
+	}
+}
\ No newline at end of file
@@ -24,6 +24,8 @@ namespace Vana {
 
 thread_local owned_ptr_t<Database> Database::m_chardb{nullptr};
 thread_local owned_ptr_t<Database> Database::m_datadb{nullptr};
+std::atomic<uint64_t> Database::m_statementsPrepared{0};
+std::atomic<uint64_t> Database::m_statementsExecuted{0};
 
 auto Database::initCharDb() -> Database & {
 	if (m_chardb != nullptr) throw std::logic_error{"Must not call initCharDb after the database is already initialized"};
@@ -69,6 +71,13 @@ auto Database::tableExists(const string_t &table) -> bool {
 	return tableExists(getSession(), m_schema, makeTable(table));
 }
 
+auto Database::getStatementStats() -> StatementStats {
+	StatementStats stats;
+	stats.prepared = m_statementsPrepared;
+	stats.executed = m_statementsExecuted;
+	return stats;
+}
+
 auto Database::schemaExists(soci::session &sql, const string_t &schema) -> bool {
 	opt_string_t database;
 	sql.once
@@ -19,8 +19,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
 #include "Common/SociExtensions.hpp"
 #include "Common/Types.hpp"
+#include <atomic>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 namespace Vana {
 	namespace soci = ::soci;
@@ -28,6 +30,11 @@ namespace Vana {
 
 	class Database {
 	public:
+		struct StatementStats {
+			uint64_t prepared = 0;
+			uint64_t executed = 0;
+		};
+
 		Database(const DbConfig &conf, bool includeDatabase);
 
 		static auto getCharDb() -> Database &;
@@ -41,13 +48,27 @@ namespace Vana {
 		template <typename TIdentifier>
 		auto getLastId() -> TIdentifier;
 		auto tableExists(const string_t &table) -> bool;
+		// Statements are prepared the first time their id is used on this connection and reused after that
+		// An id must always be used with the same parameter types, produceQuery only runs when the statement is prepared
+		template <typename ... TParams>
+		auto prepareQuery(const string_t &id, function_t<void(out_stream_t &)> produceQuery) -> PreparedStatement<TParams...> &;
+		// Same as prepareQuery, for statements that don't return rows
+		template <typename ... TParams>
+		auto prepareCommand(const string_t &id, function_t<void(out_stream_t &)> produceQuery) -> PreparedStatement<TParams...> &;
 
+		// Counted across every connection
+		static auto getStatementStats() -> StatementStats;
 		static auto schemaExists(soci::session &sql, const string_t &schema) -> bool;
 		static auto tableExists(soci::session &sql, const string_t &schema, const string_t &table) -> bool;
 	private:
+		template <typename ... TParams>
+		auto prepare(const string_t &id, bool returnsRows, function_t<void(out_stream_t &)> produceQuery) -> PreparedStatement<TParams...> &;
+
 		owned_ptr_t<soci::session> m_session;
 		string_t m_schema;
 		string_t m_tablePrefix;
+		// Has to be destroyed before the session
+		hash_map_t<string_t, owned_ptr_t<CachedStatement>> m_statements;
 
 		static auto connectCharDb() -> void;
 		static auto connectDataDb() -> void;
@@ -55,6 +76,8 @@ namespace Vana {
 
 		static thread_local owned_ptr_t<Database> m_chardb;
 		static thread_local owned_ptr_t<Database> m_datadb;
+		static std::atomic<uint64_t> m_statementsPrepared;
+		static std::atomic<uint64_t> m_statementsExecuted;
 	};
 
 	inline
@@ -79,4 +102,30 @@ namespace Vana {
 		getSession().once << "SELECT LAST_INSERT_ID()", soci::into(val);
 		return val;
 	}
+
+	template <typename ... TParams>
+	auto Database::prepareQuery(const string_t &id, function_t<void(out_stream_t &)> produceQuery) -> PreparedStatement<TParams...> & {
+		return prepare<TParams...>(id, true, produceQuery);
+	}
+
+	template <typename ... TParams>
+	auto Database::prepareCommand(const string_t &id, function_t<void(out_stream_t &)> produceQuery) -> PreparedStatement<TParams...> & {
+		return prepare<TParams...>(id, false, produceQuery);
+	}
+
+	template <typename ... TParams>
+	auto Database::prepare(const string_t &id, bool returnsRows, function_t<void(out_stream_t &)> produceQuery) -> PreparedStatement<TParams...> & {
+		auto kvp = m_statements.find(id);
+		if (kvp != std::end(m_statements)) {
+			return static_cast<PreparedStatement<TParams...> &>(*kvp->second);
+		}
+
+		out_stream_t query;
+		produceQuery(query);
+		auto statement = make_owned_ptr<PreparedStatement<TParams...>>(*m_session, query.str(), returnsRows, m_statementsExecuted);
+		auto &ret = *statement;
+		m_statements[id] = std::move(statement);
+		m_statementsPrepared++;
+		return ret;
+	}
 }
\ No newline at end of file
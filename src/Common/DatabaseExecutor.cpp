@@ -0,0 +1,120 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "DatabaseExecutor.hpp"
+#include "Common/TimeUtilities.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace Vana {
+
+DatabaseExecutor::DatabaseExecutor()
+{
+}
+
+auto DatabaseExecutor::start(int32_t threadCount, size_t capacity, poster_t poster) -> void {
+	m_poster = poster;
+	m_executor = make_owned_ptr<TaskExecutor>(capacity, static_cast<size_t>(std::max(threadCount, 1)));
+}
+
+auto DatabaseExecutor::stop() -> void {
+	if (m_executor != nullptr) {
+		m_executor->drain();
+	}
+}
+
+auto DatabaseExecutor::execute(const string_t &type, function_t<void()> query) -> Result {
+	return enqueue(type, query);
+}
+
+auto DatabaseExecutor::enqueue(const string_t &type, function_t<void()> work) -> Result {
+	if (m_executor == nullptr) {
+		return Result::Failure;
+	}
+
+	time_point_t queuedAt = TimeUtilities::getNow();
+	m_queued++;
+	bool accepted = m_executor->trySubmit([this, type, work, queuedAt] {
+		m_queued--;
+		time_point_t start = TimeUtilities::getNow();
+		bool failed = false;
+		try {
+			work();
+		}
+		catch (std::exception &e) {
+			failed = true;
+			std::cerr << "DATABASE ERROR (" << type << "): " << e.what() << std::endl;
+		}
+		microseconds_t elapsed = duration_cast<microseconds_t>(TimeUtilities::getNow() - start);
+		record(type, duration_cast<microseconds_t>(start - queuedAt), elapsed, failed);
+	}, TaskPriority::Normal);
+
+	if (!accepted) {
+		m_queued--;
+		owned_lock_t<mutex_t> l{m_mutex};
+		m_stats[type].rejected++;
+		return Result::Failure;
+	}
+	return Result::Successful;
+}
+
+auto DatabaseExecutor::post(function_t<void()> completion) -> void {
+	if (m_poster != nullptr) {
+		m_poster(completion);
+	}
+}
+
+auto DatabaseExecutor::record(const string_t &type, microseconds_t wait, microseconds_t elapsed, bool failed) -> void {
+	owned_lock_t<mutex_t> l{m_mutex};
+	Entry &entry = m_stats[type];
+	entry.calls++;
+	if (failed) {
+		entry.failures++;
+	}
+	entry.totalWait += static_cast<uint64_t>(std::max<int64_t>(wait.count(), 0));
+	uint64_t time = static_cast<uint64_t>(std::max<int64_t>(elapsed.count(), 0));
+	entry.totalTime += time;
+	entry.maxTime = std::max(entry.maxTime, time);
+}
+
+auto DatabaseExecutor::getStats() const -> vector_t<QueryStats> {
+	owned_lock_t<mutex_t> l{m_mutex};
+	vector_t<QueryStats> stats;
+	for (const auto &kvp : m_stats) {
+		QueryStats query;
+		query.type = kvp.first;
+		query.calls = kvp.second.calls;
+		query.failures = kvp.second.failures;
+		query.rejected = kvp.second.rejected;
+		query.totalWait = microseconds_t{kvp.second.totalWait};
+		query.totalTime = microseconds_t{kvp.second.totalTime};
+		query.maxTime = microseconds_t{kvp.second.maxTime};
+		stats.push_back(query);
+	}
+	return stats;
+}
+
+auto DatabaseExecutor::getQueued() const -> size_t {
+	return m_queued.load();
+}
+
+auto DatabaseExecutor::resetStats() -> void {
+	owned_lock_t<mutex_t> l{m_mutex};
+	m_stats.clear();
+}
+
+}
\ No newline at end of file
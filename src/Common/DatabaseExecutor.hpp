@@ -0,0 +1,98 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/TaskExecutor.hpp"
+#include "Common/Types.hpp"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Vana {
+	// Runs queries on a small set of threads so a slow query doesn't hold up the handlers
+	// Each thread opens its own connections the first time it uses Database::getCharDb or Database::getDataDb
+	// Completions are handed to the poster given to start, which puts them back on the handler strand
+	class DatabaseExecutor {
+		SINGLETON(DatabaseExecutor);
+	public:
+		using poster_t = function_t<void(function_t<void()>)>;
+
+		struct QueryStats {
+			string_t type;
+			uint64_t calls = 0;
+			uint64_t failures = 0;
+			// Turned away because the queue was full
+			uint64_t rejected = 0;
+			microseconds_t totalWait = microseconds_t{0};
+			microseconds_t totalTime = microseconds_t{0};
+			microseconds_t maxTime = microseconds_t{0};
+		};
+
+		auto start(int32_t threadCount, size_t capacity, poster_t poster) -> void;
+		// Finishes everything that's queued, completions that can't be posted anymore are dropped
+		auto stop() -> void;
+
+		// A full queue returns Result::Failure without running anything, the caller decides whether to run it inline or give up
+		auto execute(const string_t &type, function_t<void()> query) -> Result;
+		// The completion receives the query's result on the handler strand, if the query throws the failure callback is posted instead
+		template <typename TQuery, typename TCompletion>
+		auto query(const string_t &type, TQuery query, TCompletion completion, function_t<void()> failure = nullptr) -> Result;
+
+		auto getStats() const -> vector_t<QueryStats>;
+		auto getQueued() const -> size_t;
+		auto resetStats() -> void;
+	private:
+		struct Entry {
+			uint64_t calls = 0;
+			uint64_t failures = 0;
+			uint64_t rejected = 0;
+			uint64_t totalWait = 0;
+			uint64_t totalTime = 0;
+			uint64_t maxTime = 0;
+		};
+
+		auto enqueue(const string_t &type, function_t<void()> work) -> Result;
+		auto record(const string_t &type, microseconds_t wait, microseconds_t elapsed, bool failed) -> void;
+		auto post(function_t<void()> completion) -> void;
+
+		poster_t m_poster;
+		owned_ptr_t<TaskExecutor> m_executor;
+		std::atomic<size_t> m_queued{0};
+		hash_map_t<string_t, Entry> m_stats;
+		mutable mutex_t m_mutex;
+	};
+
+	template <typename TQuery, typename TCompletion>
+	auto DatabaseExecutor::query(const string_t &type, TQuery query, TCompletion completion, function_t<void()> failure) -> Result {
+		using result_t = decltype(query());
+		return enqueue(type, [this, query, completion, failure] {
+			ref_ptr_t<result_t> result;
+			try {
+				result = make_ref_ptr<result_t>(query());
+			}
+			catch (...) {
+				if (failure != nullptr) {
+					post(failure);
+				}
+				throw;
+			}
+			post([completion, result] { completion(*result); });
+		});
+	}
+}
\ No newline at end of file
@@ -20,9 +20,6 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "Common/BlockCipherIv.hpp"
 #include "Common/MapleVersion.hpp"
 #include "Common/Types.hpp"
-#include <botan/filters.h>
-#include <botan/lookup.h>
-#include <botan/pipe.h>
 #include <string>
 
 namespace Vana {
@@ -48,7 +45,6 @@ namespace Vana {
 		BlockCipherIv m_recv;
 		BlockCipherIv m_send;
 		bool m_encrypted = true;
-		Botan::OctetString m_botanKey;
 	};
 
 	inline
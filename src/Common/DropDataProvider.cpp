@@ -17,6 +17,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "DropDataProvider.hpp"
 #include "Algorithm.hpp"
+#include "DataSnapshot.hpp"
 #include "Database.hpp"
 #include "InitializeCommon.hpp"
 #include "StringUtilities.hpp"
@@ -46,10 +47,9 @@ auto DropDataProvider::loadDrops() -> void {
 	};
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("drop_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("drop_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		drop = DropInfo{};
 
 		int32_t dropper = row.get<int32_t>("dropperid");
@@ -63,11 +63,11 @@ auto DropDataProvider::loadDrops() -> void {
 		m_dropInfo[dropper].push_back(drop);
 	}
 
-	rs = (sql.prepare << "SELECT * FROM " << db.makeTable("user_drop_data") << " ORDER BY dropperid");
+	rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("user_drop_data") + " ORDER BY dropperid");
 	int32_t lastDropperId = -1;
 	bool dropped = false;
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		drop = DropInfo{};
 
 		int32_t dropper = row.get<int32_t>("dropperid");
@@ -94,10 +94,9 @@ auto DropDataProvider::loadGlobalDrops() -> void {
 	m_globalDrops.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("drop_global_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("drop_global_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		GlobalDropInfo drop;
 
 		drop.continent = row.get<int8_t>("continent");
@@ -21,7 +21,6 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "Common/BlockCipherIv.hpp"
 #include "Common/PacketTransformer.hpp"
 #include "Common/Types.hpp"
-#include <botan/lookup.h>
 
 namespace Vana {
 	class EncryptedPacketTransformer final : public PacketTransformer {
@@ -32,11 +31,13 @@ namespace Vana {
 		auto setPacketHeader(unsigned char *header, uint16_t realPacketSize) -> void override;
 		auto encryptPacket(unsigned char *packetData, int32_t realPacketSize, uint16_t headerSize) -> void override;
 		auto decryptPacket(unsigned char *packetData, int32_t realPacketSize, uint16_t headerSize) -> void override;
+		auto usesCustomEncryption() const -> bool override;
+		auto encryptPreparedPacket(unsigned char *packetData, int32_t realPacketSize, uint16_t headerSize) -> void override;
+		auto decryptPreparedPacket(unsigned char *packetData, int32_t realPacketSize, uint16_t headerSize) -> void override;
 	private:
 		auto getVersionAndSize(unsigned char *header, uint16_t &version, uint16_t &size) -> void;
 
 		BlockCipherIv m_recv;
 		BlockCipherIv m_send;
-		Botan::OctetString m_botanKey;
 	};
 }
\ No newline at end of file
@@ -16,6 +16,7 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "EquipDataProvider.hpp"
+#include "DataSnapshot.hpp"
 #include "Database.hpp"
 #include "GameConstants.hpp"
 #include "GameLogicUtilities.hpp"
@@ -41,16 +42,15 @@ auto EquipDataProvider::loadEquips() -> void {
 	m_equipInfo.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
 	// Ugly hack to get the integers instead of scientific notation
 	// Note: This is MySQL's crappy behavior
 	// It displays scientific notation for only very large values, meaning it's wildly inconsistent and hard to parse
 	// We just use the string and send it to a translation function
-	soci::rowset<> rs = (sql.prepare
-		<< "SELECT *, REPLACE(FORMAT(equip_slots + 0, 0), \",\", \"\") AS equip_slot_flags "
-		<< "FROM " << db.makeTable("item_equip_data"));
+	auto rs = DataSnapshot::getInstance().select(db,
+		"SELECT *, REPLACE(FORMAT(equip_slots + 0, 0), \",\", \"\") AS equip_slot_flags "
+		"FROM " + db.makeTable("item_equip_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		EquipInfo equip;
 
 		item_id_t itemId = row.get<item_id_t>("itemid");
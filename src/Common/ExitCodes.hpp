@@ -38,6 +38,7 @@ namespace Vana {
 			ProgramException = 12,
 			QueryError = 13,
 			ForcedByGm = 14,
+			JournalError = 15,
 		};
 		// Comments for easy searching
 		// exit(0) exit(0x0) exit(0x00) exit(0x00000000)
@@ -55,6 +56,7 @@ namespace Vana {
 		// exit(12) exit(0xC) exit(0x0C) exit(0x0000000C)
 		// exit(13) exit(0xD) exit(0x0D) exit(0x0000000D)
 		// exit(14) exit(0xE) exit(0x0E) exit(0x0000000E)
+		// exit(15) exit(0xF) exit(0x0F) exit(0x0000000F)
 
 		auto exit(exit_code_t code) -> void;
 	}
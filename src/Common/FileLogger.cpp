@@ -16,15 +16,18 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "FileLogger.hpp"
+#include "Common/ThreadPool.hpp"
 #include "Common/TimeUtilities.hpp"
 #ifdef WIN32
 #include <filesystem>
 #else
 #include <boost/filesystem.hpp>
 #endif
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 
 namespace Vana {
@@ -45,6 +48,9 @@ FileLogger::FileLogger(const string_t &filename, const string_t &format, const s
 
 FileLogger::~FileLogger() {
 	flush();
+	if (m_writer.valid()) {
+		m_writer.wait();
+	}
 }
 
 auto FileLogger::log(LogType type, const opt_string_t &identifier, const string_t &message) -> void {
@@ -58,7 +64,50 @@ auto FileLogger::log(LogType type, const opt_string_t &identifier, const string_
 }
 
 auto FileLogger::flush() -> void {
-	for (const auto &bufferedMessage : m_buffer) {
+	if (m_buffer.empty()) {
+		return;
+	}
+
+	{
+		owned_lock_t<mutex_t> l{m_pendingMutex};
+		std::move(std::begin(m_buffer), std::end(m_buffer), std::back_inserter(m_pending));
+		m_buffer.clear();
+		if (m_writing) {
+			// The running task picks these up before it finishes
+			return;
+		}
+		m_writing = true;
+	}
+
+	m_writer = ThreadPool::submit([this] { writePending(); }, TaskPriority::Low);
+}
+
+auto FileLogger::writePending() -> void {
+	while (true) {
+		vector_t<FileLog> logs;
+		{
+			owned_lock_t<mutex_t> l{m_pendingMutex};
+			if (m_pending.empty()) {
+				m_writing = false;
+				return;
+			}
+			logs.swap(m_pending);
+		}
+
+		try {
+			write(logs);
+		}
+		catch (...) {
+			// The next flush starts a new task for whatever is still pending
+			owned_lock_t<mutex_t> l{m_pendingMutex};
+			m_writing = false;
+			throw;
+		}
+	}
+}
+
+auto FileLogger::write(const vector_t<FileLog> &logs) -> void {
+	for (const auto &bufferedMessage : logs) {
 		const string_t &file = bufferedMessage.file;
 		fs::path fullPath = fs::system_complete(fs::path{file.substr(0, file.find_last_of("/"))});
 		if (!fs::exists(fullPath)) {
@@ -68,7 +117,6 @@ auto FileLogger::flush() -> void {
 		f << bufferedMessage.message;
 		f.close();
 	}
-	m_buffer.clear();
 }
 
 }
\ No newline at end of file
@@ -18,6 +18,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #pragma once
 
 #include "Common/Logger.hpp"
+#include <future>
 #include <string>
 #include <vector>
 
@@ -33,11 +34,19 @@ namespace Vana {
 		~FileLogger();
 
 		auto log(LogType type, const opt_string_t &identifier, const string_t &message) -> void override;
+		// Hands the buffer to a background task, batches are still written one after another
 		auto flush() -> void;
 		auto getFilenameFormat() const -> const string_t & { return m_filenameFormat; }
 	private:
+		auto writePending() -> void;
+		auto write(const vector_t<FileLog> &logs) -> void;
+
+		bool m_writing = false;
 		string_t m_filenameFormat;
 		size_t m_bufferSize;
 		vector_t<FileLog> m_buffer;
+		vector_t<FileLog> m_pending;
+		mutex_t m_pendingMutex;
+		std::future<void> m_writer;
 	};
 }
\ No newline at end of file
@@ -90,6 +90,11 @@ namespace Vana {
 			builder.add<int64_t>(obj.getValue());
 		}
 	};
+
+	template <>
+	struct PacketSize<FileTime> {
+		static constexpr size_t value = packetSize<int64_t>();
+	};
 }
 
 namespace std {
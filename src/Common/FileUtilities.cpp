@@ -16,10 +16,21 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "FileUtilities.hpp"
+#ifdef WIN32
+#include <filesystem>
+#else
+#include <boost/filesystem.hpp>
+#endif
 #include <sys/stat.h>
 
 namespace Vana {
 
+#ifdef WIN32
+namespace fs = std::tr2::sys;
+#else
+namespace fs = boost::filesystem;
+#endif
+
 auto FileUtilities::fileExists(const string_t &file) -> bool {
 	struct stat fileInfo;
 	return (!stat(file.c_str(), &fileInfo)) != 0;
@@ -31,4 +42,16 @@ auto FileUtilities::removeExtension(const string_t &file) -> string_t {
 	return ret;
 }
 
+auto FileUtilities::createParentDirectories(const string_t &file) -> void {
+	size_t separator = file.find_last_of("/");
+	if (separator == string_t::npos) {
+		return;
+	}
+
+	fs::path fullPath = fs::system_complete(fs::path{file.substr(0, separator)});
+	if (!fs::exists(fullPath)) {
+		fs::create_directories(fullPath);
+	}
+}
+
 }
\ No newline at end of file
@@ -24,5 +24,6 @@ namespace Vana {
 	namespace FileUtilities {
 		auto fileExists(const string_t &file) -> bool;
 		auto removeExtension(const string_t &file) -> string_t;
+		auto createParentDirectories(const string_t &file) -> void;
 	}
 }
\ No newline at end of file
@@ -0,0 +1,127 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "HandlerGate.hpp"
+
+namespace Vana {
+
+thread_local int32_t HandlerGate::s_exclusiveDepth = 0;
+
+auto HandlerGate::setLanes(post_t exclusive, vector_t<post_t> shared) -> void {
+	m_exclusiveLane.post = exclusive;
+	m_sharedLanes.clear();
+	m_sharedLanes.resize(shared.size());
+	for (size_t i = 0; i < shared.size(); ++i) {
+		m_sharedLanes[i].post = shared[i];
+	}
+}
+
+auto HandlerGate::runShared(size_t lane, work_t work) -> void {
+	{
+		owned_lock_t<mutex_t> l{m_mutex};
+		if (m_exclusive || !m_exclusiveLane.parked.empty() || !m_sharedLanes[lane].parked.empty()) {
+			// Posted again by leaveExclusive
+			m_sharedLanes[lane].parked.push_back(work);
+			return;
+		}
+		m_sharedCount++;
+	}
+
+	work();
+	leaveShared();
+}
+
+auto HandlerGate::runExclusive(work_t work) -> void {
+	if (s_exclusiveDepth > 0) {
+		work();
+		return;
+	}
+
+	{
+		owned_lock_t<mutex_t> l{m_mutex};
+		if (m_exclusive || m_sharedCount > 0 || !m_exclusiveLane.parked.empty()) {
+			// Handed over by whichever of them finishes last
+			m_exclusiveLane.parked.push_back(work);
+			return;
+		}
+		m_exclusive = true;
+	}
+
+	std::deque<work_t> batch;
+	batch.push_back(work);
+	runExclusiveBatch(batch);
+}
+
+auto HandlerGate::runExclusiveBatch(std::deque<work_t> &batch) -> void {
+	s_exclusiveDepth++;
+	for (auto &work : batch) {
+		work();
+	}
+	s_exclusiveDepth--;
+	leaveExclusive();
+}
+
+auto HandlerGate::runSharedParked(size_t lane) -> void {
+	std::deque<work_t> batch;
+	{
+		owned_lock_t<mutex_t> l{m_mutex};
+		if (m_exclusive || !m_exclusiveLane.parked.empty() || m_sharedLanes[lane].parked.empty()) {
+			// Already run, or the handler strand got in first and this is posted again after it
+			return;
+		}
+		batch.swap(m_sharedLanes[lane].parked);
+		m_sharedCount++;
+	}
+
+	for (auto &work : batch) {
+		work();
+	}
+	leaveShared();
+}
+
+auto HandlerGate::leaveShared() -> void {
+	owned_lock_t<mutex_t> l{m_mutex};
+	m_sharedCount--;
+	if (m_sharedCount == 0 && !m_exclusiveLane.parked.empty()) {
+		handOverExclusive();
+	}
+}
+
+auto HandlerGate::leaveExclusive() -> void {
+	owned_lock_t<mutex_t> l{m_mutex};
+	if (!m_exclusiveLane.parked.empty()) {
+		// Handler work that came in meanwhile still goes before the shards
+		handOverExclusive();
+		return;
+	}
+
+	m_exclusive = false;
+	for (size_t i = 0; i < m_sharedLanes.size(); ++i) {
+		if (!m_sharedLanes[i].parked.empty()) {
+			m_sharedLanes[i].post([this, i] { runSharedParked(i); });
+		}
+	}
+}
+
+auto HandlerGate::handOverExclusive() -> void {
+	m_exclusive = true;
+	auto batch = make_ref_ptr<std::deque<work_t>>();
+	batch->swap(m_exclusiveLane.parked);
+	m_exclusiveLane.post([this, batch] { runExclusiveBatch(*batch); });
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Types.hpp"
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace Vana {
+	// Lets the handler shards run side by side while anything on the handler strand runs alone
+	// Nothing waits in here, work that can't run yet is parked and posted to its strand again once it can, so I/O threads never block
+	// Each lane keeps its order, once a lane has parked work everything after it is parked behind it
+	// Parked handler work goes first so busy shards can't starve the handler strand
+	class HandlerGate {
+		NONCOPYABLE(HandlerGate);
+	public:
+		using work_t = function_t<void()>;
+		using post_t = function_t<void(work_t)>;
+
+		HandlerGate() = default;
+
+		// How parked work gets back to the handler strand and to each shard strand, must be set before anything runs
+		auto setLanes(post_t exclusive, vector_t<post_t> shared) -> void;
+		// Called on the lane's own strand
+		auto runShared(size_t lane, work_t work) -> void;
+		// Runs right away on the thread that already holds it, e.g. when the handler strand dispatches to itself
+		auto runExclusive(work_t work) -> void;
+	private:
+		struct Lane {
+			post_t post;
+			std::deque<work_t> parked;
+		};
+
+		auto leaveShared() -> void;
+		auto leaveExclusive() -> void;
+		auto runExclusiveBatch(std::deque<work_t> &batch) -> void;
+		auto runSharedParked(size_t lane) -> void;
+		// m_mutex must be held
+		auto handOverExclusive() -> void;
+
+		mutex_t m_mutex;
+		Lane m_exclusiveLane;
+		vector_t<Lane> m_sharedLanes;
+		int32_t m_sharedCount = 0;
+		bool m_exclusive = false;
+
+		static thread_local int32_t s_exclusiveDepth;
+	};
+}
\ No newline at end of file
@@ -66,5 +66,14 @@ auto generateSalt(const SaltSizeConfig &conf) -> string_t {
 	return salt;
 }
 
+auto checksum(const unsigned char *buf, size_t length) -> checksum_t {
+	checksum_t hash = 2166136261u;
+	for (size_t i = 0; i < length; ++i) {
+		hash ^= buf[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
 }
 }
\ No newline at end of file
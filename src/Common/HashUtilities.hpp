@@ -31,5 +31,7 @@ namespace Vana {
 		auto hashPassword(const string_t &password, const string_t &rawSalt, const SaltConfig &conf) -> string_t;
 		auto saltPassword(const string_t &password, const string_t &rawSalt, const SaltConfig &conf) -> string_t;
 		auto generateSalt(const SaltSizeConfig &conf) -> string_t;
+		// FNV-1a, fast and only meant to catch damaged files, not tampering
+		auto checksum(const unsigned char *buf, size_t length) -> checksum_t;
 	}
 }
\ No newline at end of file
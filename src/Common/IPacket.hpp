@@ -18,6 +18,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #pragma once
 
 #include "Common/Types.hpp"
+#include <type_traits>
 
 namespace Vana {
 	class PacketBuilder;
@@ -34,4 +35,37 @@ namespace Vana {
 			throw std::logic_error{"T is not appropriately specialized for that type"};
 		};
 	};
+
+	// Number of bytes T always takes up in a packet, specialized next to PacketSerialize for fixed-layout types
+	// Anything whose size depends on the value (strings, vectors, optionals, etc.) stays at 0
+	template <typename T, typename = void>
+	struct PacketSize {
+		static constexpr size_t value = 0;
+	};
+
+	template <typename T>
+	struct PacketSize<T, typename std::enable_if<std::is_arithmetic<T>::value>::type> {
+		static constexpr size_t value = std::is_same<T, bool>::value ? sizeof(int8_t) : sizeof(T);
+	};
+
+	template <typename TRep, typename TPeriod>
+	struct PacketSize<std::chrono::duration<TRep, TPeriod>> {
+		static constexpr size_t value = sizeof(int32_t);
+	};
+
+	template <typename TValue>
+	constexpr auto packetSize() -> size_t {
+		return PacketSize<TValue>::value;
+	}
+
+	template <typename TValue1, typename TValue2, typename ... TValues>
+	constexpr auto packetSize() -> size_t {
+		return PacketSize<TValue1>::value + packetSize<TValue2, TValues...>();
+	}
+
+	// Strings are written with their length in front of them
+	inline
+	auto packetSize(const string_t &value) -> size_t {
+		return sizeof(uint16_t) + value.size();
+	}
 }
\ No newline at end of file
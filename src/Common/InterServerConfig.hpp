@@ -20,6 +20,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "Common/ConfigFile.hpp"
 #include "Common/Ip.hpp"
 #include "Common/PingConfig.hpp"
+#include "Common/SendLimitConfig.hpp"
 #include "Common/Types.hpp"
 #include <string>
 
@@ -31,8 +32,21 @@ namespace Vana {
 		}
 
 		bool clientEncryption = true;
+		bool captureClientPackets = false;
+		bool useTimerWheel = false;
+		bool fullStateTransfer = false;
+		bool verifyDataSnapshot = false;
+		int32_t ioThreadCount = 1;
+		int32_t mapWorkers = 0;
+		int32_t dbThreads = 2;
+		int32_t dbQueueCapacity = 1024;
+		seconds_t opcodeStatsInterval = seconds_t{0};
+		seconds_t playerSaveInterval = seconds_t{0};
+		seconds_t playerFlushInterval = seconds_t{60};
+		string_t dataSnapshot;
 		PingConfig clientPing;
 		PingConfig serverPing;
+		SendLimitConfig clientSendLimits;
 		port_t loginPort = 0;
 		Ip loginIp;
 	};
@@ -46,6 +60,21 @@ namespace Vana {
 			ret.serverPing = config.get<PingConfig>("inter_ping");
 			ret.loginIp = Ip{Ip::stringToIpv4(config.get<string_t>("login_ip"))};
 			ret.loginPort = config.get<port_t>("login_inter_port");
+			ret.ioThreadCount = config.get<int32_t>("io_threads", 1);
+			ret.captureClientPackets = config.get<bool>("capture_client_packets", false);
+			ret.useTimerWheel = config.get<bool>("use_timer_wheel", false);
+			ret.fullStateTransfer = config.get<bool>("transfer_full_state", false);
+			ret.mapWorkers = config.get<int32_t>("map_workers", 0);
+			ret.dbThreads = config.get<int32_t>("db_threads", 2);
+			ret.dbQueueCapacity = config.get<int32_t>("db_queue_capacity", 1024);
+			ret.opcodeStatsInterval = seconds_t{config.get<int32_t>("opcode_stats_interval", 0)};
+			ret.playerSaveInterval = seconds_t{config.get<int32_t>("player_save_interval", 0)};
+			ret.playerFlushInterval = seconds_t{config.get<int32_t>("player_flush_interval", 60)};
+			ret.dataSnapshot = config.get<string_t>("data_snapshot", "");
+			ret.verifyDataSnapshot = config.get<bool>("data_snapshot_verify", false);
+			if (config.exists("client_send_limits")) {
+				ret.clientSendLimits = config.get<SendLimitConfig>("client_send_limits");
+			}
 			return ret;
 		}
 	};
@@ -85,6 +85,11 @@ namespace Vana {
 		}
 	};
 
+	template <>
+	struct PacketSize<Ip::Type> {
+		static constexpr size_t value = packetSize<int8_t>();
+	};
+
 	template <>
 	struct PacketSerialize<Ip> {
 		auto read(PacketReader &reader) -> Ip {
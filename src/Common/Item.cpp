@@ -75,6 +75,34 @@ Item::Item(Item *item)
 	m_expiration = item->getExpirationTime();
 }
 
+auto Item::operator==(const Item &other) const -> bool {
+	return
+		m_id == other.m_id &&
+		m_amount == other.m_amount &&
+		m_hammers == other.m_hammers &&
+		m_slots == other.m_slots &&
+		m_scrolls == other.m_scrolls &&
+		m_str == other.m_str &&
+		m_dex == other.m_dex &&
+		m_int == other.m_int &&
+		m_luk == other.m_luk &&
+		m_hp == other.m_hp &&
+		m_mp == other.m_mp &&
+		m_wAtk == other.m_wAtk &&
+		m_mAtk == other.m_mAtk &&
+		m_wDef == other.m_wDef &&
+		m_mDef == other.m_mDef &&
+		m_accuracy == other.m_accuracy &&
+		m_avoid == other.m_avoid &&
+		m_hands == other.m_hands &&
+		m_jump == other.m_jump &&
+		m_speed == other.m_speed &&
+		m_petId == other.m_petId &&
+		m_name == other.m_name &&
+		m_flags == other.m_flags &&
+		m_expiration == other.m_expiration;
+}
+
 auto Item::hasSlipPrevention() const -> bool {
 	return testFlags(Items::Flags::Spikes);
 }
@@ -332,11 +360,13 @@ auto Item::databaseInsert(Database &db, const ItemDbInformation &info) -> void {
 }
 
 auto Item::databaseInsert(Database &db, const vector_t<ItemDbRecord> &items) -> void {
-	using namespace soci;
-	auto &sql = db.getSession();
 	using MiscUtilities::getOptional;
 	using MiscUtilities::NullableMode;
 
+	if (items.size() == 0) {
+		return;
+	}
+
 	static init_list_t<int8_t> nullsInt8 = {0};
 	static init_list_t<int16_t> nullsInt16 = {0};
 	static init_list_t<int32_t> nullsInt32 = {0};
@@ -347,83 +377,19 @@ auto Item::databaseInsert(Database &db, const vector_t<ItemDbRecord> &items) ->
 	using opt_stat_t = optional_t<stat_t>;
 	using opt_health_t = optional_t<health_t>;
 
-	uint8_t inventory = 0;
-	slot_qty_t amount = 0;
-	item_id_t itemId = 0;
-	inventory_slot_t slot = 0;
-	world_id_t worldId = 0;
-	account_id_t accountId = 0;
-	player_id_t playerId = 0;
-	string_t location = "";
-
-	opt_int8_t slots;
-	opt_int8_t scrolls;
-	opt_stat_t iStr;
-	opt_stat_t iDex;
-	opt_stat_t iInt;
-	opt_stat_t iLuk;
-	opt_health_t iHp;
-	opt_health_t iMp;
-	opt_stat_t iWatk;
-	opt_stat_t iMatk;
-	opt_stat_t iWdef;
-	opt_stat_t iMdef;
-	opt_stat_t iAcc;
-	opt_stat_t iAvo;
-	opt_stat_t iHands;
-	opt_stat_t iSpeed;
-	opt_stat_t iJump;
-	opt_int16_t flags;
-	opt_int32_t hammers;
-	optional_t<pet_id_t> petId;
-	opt_int64_t expiration;
-	opt_string_t name;
-
-	statement st = (sql.prepare
-		<< "INSERT INTO " << db.makeTable("items") << " (character_id, inv, slot, location, account_id, world_id, item_id, amount, slots, scrolls, istr, idex, iint, iluk, ihp, imp, iwatk, imatk, iwdef, imdef, iacc, iavo, ihand, ispeed, ijump, flags, hammers, pet_id, name, expiration) "
-		<< "VALUES (:char, :inv, :slot, :location, :account, :world, :itemid, :amount, :slots, :scrolls, :str, :dex, :int, :luk, :hp, :mp, :watk, :matk, :wdef, :mdef, :acc, :avo, :hands, :speed, :jump, :flags, :hammers, :pet, :name, :expiration)",
-		use(playerId, "char"),
-		use(inventory, "inv"),
-		use(slot, "slot"),
-		use(location, "location"),
-		use(accountId, "account"),
-		use(worldId, "world"),
-		use(itemId, "itemid"),
-		use(amount, "amount"),
-		use(slots, "slots"),
-		use(scrolls, "scrolls"),
-		use(iStr, "str"),
-		use(iDex, "dex"),
-		use(iInt, "int"),
-		use(iLuk, "luk"),
-		use(iHp, "hp"),
-		use(iMp, "mp"),
-		use(iWatk, "watk"),
-		use(iMatk, "matk"),
-		use(iWdef, "wdef"),
-		use(iMdef, "mdef"),
-		use(iAcc, "acc"),
-		use(iAvo, "avo"),
-		use(iHands, "hands"),
-		use(iSpeed, "speed"),
-		use(iJump, "jump"),
-		use(flags, "flags"),
-		use(hammers, "hammers"),
-		use(petId, "pet"),
-		use(name, "name"),
-		use(expiration, "expiration"));
+	BulkInsert<
+		player_id_t, uint8_t, inventory_slot_t, string_t, account_id_t, world_id_t, item_id_t, slot_qty_t,
+		opt_int8_t, opt_int8_t,
+		opt_stat_t, opt_stat_t, opt_stat_t, opt_stat_t, opt_health_t, opt_health_t,
+		opt_stat_t, opt_stat_t, opt_stat_t, opt_stat_t, opt_stat_t, opt_stat_t, opt_stat_t, opt_stat_t, opt_stat_t,
+		opt_int16_t, opt_int32_t, optional_t<pet_id_t>, opt_string_t, opt_int64_t> bulk{
+		db.getSession(),
+		"INSERT INTO " + db.makeTable("items") + " (character_id, inv, slot, location, account_id, world_id, item_id, amount, slots, scrolls, istr, idex, iint, iluk, ihp, imp, iwatk, imatk, iwdef, imdef, iacc, iavo, ihand, ispeed, ijump, flags, hammers, pet_id, name, expiration)"};
 
 	for (const auto &rec : items) {
 		Item *item = rec.item;
 
-		location = rec.location;
-		accountId = rec.userId;
-		playerId = rec.charId;
-		worldId = rec.worldId;
-		slot = rec.slot;
-		amount = item->m_amount;
-		itemId = item->m_id;
-		inventory = GameLogicUtilities::getInventory(itemId);
+		uint8_t inventory = GameLogicUtilities::getInventory(item->m_id);
 		bool equip = (inventory == Inventories::EquipInventory);
 		NullableMode nulls = (equip ?
 			NullableMode::NullIfFound :
@@ -432,31 +398,40 @@ auto Item::databaseInsert(Database &db, const vector_t<ItemDbRecord> &items) ->
 			NullableMode::ForceNotNull :
 			NullableMode::ForceNull);
 
-		slots = getOptional(item->m_slots, required, nullsInt8);
-		scrolls = getOptional(item->m_scrolls, required, nullsInt8);
-		iStr = getOptional(item->m_str, nulls, nullsInt16);
-		iDex = getOptional(item->m_dex, nulls, nullsInt16);
-		iInt = getOptional(item->m_int, nulls, nullsInt16);
-		iLuk = getOptional(item->m_luk, nulls, nullsInt16);
-		iHp = getOptional(item->m_hp, nulls, nullsInt16);
-		iMp = getOptional(item->m_mp, nulls, nullsInt16);
-		iWatk = getOptional(item->m_wAtk, nulls, nullsInt16);
-		iMatk = getOptional(item->m_mAtk, nulls, nullsInt16);
-		iWdef = getOptional(item->m_wDef, nulls, nullsInt16);
-		iMdef = getOptional(item->m_mDef, nulls, nullsInt16);
-		iAcc = getOptional(item->m_accuracy, nulls, nullsInt16);
-		iAvo = getOptional(item->m_avoid, nulls, nullsInt16);
-		iHands = getOptional(item->m_hands, nulls, nullsInt16);
-		iSpeed = getOptional(item->m_speed, nulls, nullsInt16);
-		iJump = getOptional(item->m_jump, nulls, nullsInt16);
-		flags = getOptional(item->m_flags, nulls, nullsInt16);
-		hammers = getOptional(item->m_hammers, nulls, nullsInt32);
-		petId = getOptional(item->m_petId, nulls, nullsInt64);
-		name = getOptional(item->m_name, nulls, nullsString);
-		expiration = getOptional(item->m_expiration.getValue(), nulls, nullsExpiration);
-
-		st.execute(true);
+		bulk.add(
+			rec.charId,
+			inventory,
+			rec.slot,
+			rec.location,
+			rec.userId,
+			rec.worldId,
+			item->m_id,
+			item->m_amount,
+			getOptional(item->m_slots, required, nullsInt8),
+			getOptional(item->m_scrolls, required, nullsInt8),
+			getOptional(item->m_str, nulls, nullsInt16),
+			getOptional(item->m_dex, nulls, nullsInt16),
+			getOptional(item->m_int, nulls, nullsInt16),
+			getOptional(item->m_luk, nulls, nullsInt16),
+			getOptional(item->m_hp, nulls, nullsInt16),
+			getOptional(item->m_mp, nulls, nullsInt16),
+			getOptional(item->m_wAtk, nulls, nullsInt16),
+			getOptional(item->m_mAtk, nulls, nullsInt16),
+			getOptional(item->m_wDef, nulls, nullsInt16),
+			getOptional(item->m_mDef, nulls, nullsInt16),
+			getOptional(item->m_accuracy, nulls, nullsInt16),
+			getOptional(item->m_avoid, nulls, nullsInt16),
+			getOptional(item->m_hands, nulls, nullsInt16),
+			getOptional(item->m_speed, nulls, nullsInt16),
+			getOptional(item->m_jump, nulls, nullsInt16),
+			getOptional(item->m_flags, nulls, nullsInt16),
+			getOptional(item->m_hammers, nulls, nullsInt32),
+			getOptional(item->m_petId, nulls, nullsInt64),
+			getOptional(item->m_name, nulls, nullsString),
+			getOptional(item->m_expiration.getValue(), nulls, nullsExpiration));
 	}
+
+	bulk.flush();
 }
 
 }
\ No newline at end of file
@@ -18,6 +18,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #pragma once
 
 #include "Common/FileTime.hpp"
+#include "Common/IPacket.hpp"
 #include "Common/ItemConstants.hpp"
 #include "Common/ItemDbInformation.hpp"
 #include "Common/ItemDbRecord.hpp"
@@ -38,6 +39,9 @@ namespace Vana {
 		Item(const EquipDataProvider &provider, item_id_t equipId, Items::StatVariance variancePolicy, bool isGm);
 		Item(Item *item);
 
+		// Compares everything that's stored in the database
+		auto operator==(const Item &other) const -> bool;
+
 		auto hasWarmSupport() const -> bool;
 		auto hasSlipPrevention() const -> bool;
 		auto hasLock() const -> bool;
@@ -122,6 +126,8 @@ namespace Vana {
 		const static string_t Inventory;
 		const static string_t Storage;
 	private:
+		friend struct PacketSerialize<Item>;
+
 		auto testStat(int16_t stat, int16_t max) -> int16_t;
 		auto modifyFlags(bool add, int16_t flags) -> void;
 		auto testFlags(int16_t flags) const -> bool;
@@ -152,4 +158,63 @@ namespace Vana {
 		FileTime m_expiration = Items::NoExpiration;
 		string_t m_name;
 	};
+
+	// Carries everything the database would, for handing items between servers
+	template <>
+	struct PacketSerialize<Item> {
+		auto read(PacketReader &reader) -> Item {
+			Item ret;
+			ret.m_slots = reader.get<int8_t>();
+			ret.m_scrolls = reader.get<int8_t>();
+			ret.m_str = reader.get<stat_t>();
+			ret.m_dex = reader.get<stat_t>();
+			ret.m_int = reader.get<stat_t>();
+			ret.m_luk = reader.get<stat_t>();
+			ret.m_hp = reader.get<health_t>();
+			ret.m_mp = reader.get<health_t>();
+			ret.m_wAtk = reader.get<stat_t>();
+			ret.m_mAtk = reader.get<stat_t>();
+			ret.m_wDef = reader.get<stat_t>();
+			ret.m_mDef = reader.get<stat_t>();
+			ret.m_accuracy = reader.get<stat_t>();
+			ret.m_avoid = reader.get<stat_t>();
+			ret.m_hands = reader.get<stat_t>();
+			ret.m_jump = reader.get<stat_t>();
+			ret.m_speed = reader.get<stat_t>();
+			ret.m_flags = reader.get<int16_t>();
+			ret.m_amount = reader.get<slot_qty_t>();
+			ret.m_id = reader.get<item_id_t>();
+			ret.m_hammers = reader.get<int32_t>();
+			ret.m_petId = reader.get<pet_id_t>();
+			ret.m_expiration = reader.get<FileTime>();
+			ret.m_name = reader.get<string_t>();
+			return ret;
+		}
+		auto write(PacketBuilder &builder, const Item &obj) -> void {
+			builder.add<int8_t>(obj.m_slots);
+			builder.add<int8_t>(obj.m_scrolls);
+			builder.add<stat_t>(obj.m_str);
+			builder.add<stat_t>(obj.m_dex);
+			builder.add<stat_t>(obj.m_int);
+			builder.add<stat_t>(obj.m_luk);
+			builder.add<health_t>(obj.m_hp);
+			builder.add<health_t>(obj.m_mp);
+			builder.add<stat_t>(obj.m_wAtk);
+			builder.add<stat_t>(obj.m_mAtk);
+			builder.add<stat_t>(obj.m_wDef);
+			builder.add<stat_t>(obj.m_mDef);
+			builder.add<stat_t>(obj.m_accuracy);
+			builder.add<stat_t>(obj.m_avoid);
+			builder.add<stat_t>(obj.m_hands);
+			builder.add<stat_t>(obj.m_jump);
+			builder.add<stat_t>(obj.m_speed);
+			builder.add<int16_t>(obj.m_flags);
+			builder.add<slot_qty_t>(obj.m_amount);
+			builder.add<item_id_t>(obj.m_id);
+			builder.add<int32_t>(obj.m_hammers);
+			builder.add<pet_id_t>(obj.m_petId);
+			builder.add<FileTime>(obj.m_expiration);
+			builder.add<string_t>(obj.m_name);
+		}
+	};
 }
\ No newline at end of file
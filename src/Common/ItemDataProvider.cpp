@@ -18,6 +18,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "ItemDataProvider.hpp"
 #include "Algorithm.hpp"
 #include "BuffDataProvider.hpp"
+#include "DataSnapshot.hpp"
 #include "Database.hpp"
 #include "EquipDataProvider.hpp"
 #include "GameConstants.hpp"
@@ -54,14 +55,12 @@ auto ItemDataProvider::loadItems() -> void {
 	m_itemInfo.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare
-		<< "SELECT id.*, s.label "
-		<< "FROM " << db.makeTable("item_data") << " id "
-		<< "LEFT JOIN " << db.makeTable("strings") << " s ON id.itemId = s.objectid AND s.object_type = :item",
-		soci::use(string_t{"item"}, "item"));
-
-	for (const auto &row : rs) {
+	auto rs = DataSnapshot::getInstance().select(db,
+		"SELECT id.*, s.label "
+		"FROM " + db.makeTable("item_data") + " id "
+		"LEFT JOIN " + db.makeTable("strings") + " s ON id.itemId = s.objectid AND s.object_type = 'item'");
+
+	for (const auto &row : *rs) {
 		ItemInfo item;
 		StringUtilities::runFlags(row.get<opt_string_t>("flags"), [&item](const string_t &cmp) {
 			if (cmp == "time_limited") item.timeLimited = true;
@@ -94,10 +93,9 @@ auto ItemDataProvider::loadScrolls() -> void {
 	m_scrollInfo.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("item_scroll_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("item_scroll_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		ScrollInfo item;
 		item_id_t itemId = row.get<item_id_t>("itemid");
 		item.success = row.get<uint16_t>("success");
@@ -132,11 +130,10 @@ auto ItemDataProvider::loadConsumes(BuffDataProvider &provider) -> void {
 	m_consumeInfo.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("item_random_morphs"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("item_random_morphs"));
 
 	hash_map_t<item_id_t, vector_t<MorphChanceInfo>> morphData;
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		MorphChanceInfo morph;
 		item_id_t itemId = row.get<item_id_t>("itemid");
 		morph.morph = row.get<morph_id_t>("morphid");
@@ -145,9 +142,9 @@ auto ItemDataProvider::loadConsumes(BuffDataProvider &provider) -> void {
 		morphData[itemId].push_back(morph);
 	}
 
-	rs = (sql.prepare << "SELECT * FROM " << db.makeTable("item_consume_data"));
+	rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("item_consume_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		ConsumeInfo item;
 		item_id_t itemId = row.get<item_id_t>("itemid");
 		item.effect = row.get<uint8_t>("effect");
@@ -235,10 +232,9 @@ auto ItemDataProvider::loadConsumes(BuffDataProvider &provider) -> void {
 
 auto ItemDataProvider::loadMapRanges() -> void {
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("item_monster_card_map_ranges"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("item_monster_card_map_ranges"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		CardMapRangeInfo range;
 		item_id_t itemId = row.get<item_id_t>("itemid");
 		range.startMap = row.get<map_id_t>("start_map");
@@ -253,10 +249,9 @@ auto ItemDataProvider::loadMonsterCardData() -> void {
 	m_mobsToCards.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("monster_card_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("monster_card_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		item_id_t cardId = row.get<item_id_t>("cardid");
 		mob_id_t mobId = row.get<mob_id_t>("mobid");
 
@@ -269,10 +264,9 @@ auto ItemDataProvider::loadItemSkills() -> void {
 	m_skillbooks.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("item_skills"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("item_skills"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		SkillbookInfo book;
 		item_id_t itemId = row.get<item_id_t>("itemid");
 		book.skillId = row.get<skill_id_t>("skillid");
@@ -288,10 +282,9 @@ auto ItemDataProvider::loadSummonBags() -> void {
 	m_summonBags.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("item_summons"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("item_summons"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		SummonBagInfo summon;
 		item_id_t itemId = row.get<item_id_t>("itemid");
 		summon.mobId = row.get<mob_id_t>("mobid");
@@ -305,10 +298,9 @@ auto ItemDataProvider::loadItemRewards() -> void {
 	m_itemRewards.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("item_reward_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("item_reward_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		ItemRewardInfo reward;
 		item_id_t itemId = row.get<item_id_t>("itemid");
 		reward.rewardId = row.get<item_id_t>("rewardid");
@@ -324,10 +316,9 @@ auto ItemDataProvider::loadPets() -> void {
 	m_petInfo.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("item_pet_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("item_pet_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		PetInfo pet;
 		item_id_t itemId = row.get<item_id_t>("itemid");
 		pet.name = row.get<string_t>("default_name");
@@ -350,10 +341,9 @@ auto ItemDataProvider::loadPetInteractions() -> void {
 	m_petInteractInfo.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("item_pet_interactions"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("item_pet_interactions"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		PetInteractInfo interaction;
 		item_id_t itemId = row.get<item_id_t>("itemid");
 		int32_t commandId = row.get<int32_t>("command");
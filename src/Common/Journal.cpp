@@ -0,0 +1,106 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "Journal.hpp"
+#include "Common/FileUtilities.hpp"
+#include "Common/HashUtilities.hpp"
+#include "Common/PacketBuilder.hpp"
+#include "Common/PacketReader.hpp"
+#include <cstring>
+
+namespace Vana {
+
+Journal::Journal(const string_t &filename) :
+	m_filename{filename}
+{
+	FileUtilities::createParentDirectories(filename);
+}
+
+Journal::~Journal() {
+	m_file.flush();
+}
+
+auto Journal::replay(function_t<void(PacketReader &)> handler) -> size_t {
+	std::ifstream file{m_filename, std::ios_base::in | std::ios_base::binary};
+	char magic[sizeof(JournalMagic)];
+	uint16_t version = 0;
+	if (!file.read(magic, sizeof(magic)) || !file.read(reinterpret_cast<char *>(&version), sizeof(version))) {
+		return 0;
+	}
+	if (memcmp(magic, JournalMagic, sizeof(magic)) != 0 || version != JournalVersion) {
+		return 0;
+	}
+
+	size_t records = 0;
+	vector_t<unsigned char> payload;
+	uint32_t length = 0;
+	checksum_t sum = 0;
+	while (file.read(reinterpret_cast<char *>(&length), sizeof(length)) && file.read(reinterpret_cast<char *>(&sum), sizeof(sum))) {
+		payload.resize(length);
+		if (!file.read(reinterpret_cast<char *>(payload.data()), length) || HashUtilities::checksum(payload.data(), length) != sum) {
+			break;
+		}
+
+		PacketReader reader{payload.data(), length};
+		handler(reader);
+		records++;
+	}
+	return records;
+}
+
+auto Journal::clear() -> Result {
+	m_file.close();
+	m_file.clear();
+	m_file.open(m_filename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+	if (!m_file) {
+		return Result::Failure;
+	}
+
+	m_file.write(JournalMagic, sizeof(JournalMagic));
+	write(JournalVersion);
+	m_file.flush();
+	m_size = 0;
+	return m_file ? Result::Successful : Result::Failure;
+}
+
+auto Journal::append(const PacketBuilder &record) -> Result {
+	if (!isOpen()) {
+		return Result::Failure;
+	}
+
+	write(static_cast<uint32_t>(record.getSize()));
+	write(HashUtilities::checksum(record.getBuffer(), record.getSize()));
+	m_file.write(reinterpret_cast<const char *>(record.getBuffer()), record.getSize());
+	m_file.flush();
+	m_size += sizeof(uint32_t) + sizeof(checksum_t) + record.getSize();
+	return m_file ? Result::Successful : Result::Failure;
+}
+
+auto Journal::isOpen() const -> bool {
+	return m_file.is_open() && m_file.good();
+}
+
+auto Journal::getSize() const -> uint64_t {
+	return m_size;
+}
+
+template <typename TValue>
+auto Journal::write(TValue value) -> void {
+	m_file.write(reinterpret_cast<const char *>(&value), sizeof(TValue));
+}
+
+}
\ No newline at end of file
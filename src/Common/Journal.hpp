@@ -0,0 +1,56 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Types.hpp"
+#include <fstream>
+
+namespace Vana {
+	class PacketBuilder;
+	class PacketReader;
+
+	// Journals are a 6 byte header ("VJNL" and a uint16_t version) followed by records in host byte order:
+	// uint32_t length, uint32_t checksum of the payload, then the payload
+	// Records are flushed as they're appended, one cut short by a crash fails its checksum and ends the replay there
+	class Journal {
+		NONCOPYABLE(Journal);
+		NO_DEFAULT_CONSTRUCTOR(Journal);
+	public:
+		explicit Journal(const string_t &filename);
+		~Journal();
+
+		// Hands every intact record already in the file to the handler, returns how many there were
+		auto replay(function_t<void(PacketReader &)> handler) -> size_t;
+		// Drops every record, the file is opened for appending afterwards
+		auto clear() -> Result;
+		auto append(const PacketBuilder &record) -> Result;
+		auto isOpen() const -> bool;
+		// Bytes appended since the last clear
+		auto getSize() const -> uint64_t;
+	private:
+		template <typename TValue>
+		auto write(TValue value) -> void;
+
+		uint64_t m_size = 0;
+		string_t m_filename;
+		std::ofstream m_file;
+	};
+
+	static const char JournalMagic[4] = {'V', 'J', 'N', 'L'};
+	static const uint16_t JournalVersion = 1;
+}
\ No newline at end of file
@@ -17,6 +17,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "MobDataProvider.hpp"
 #include "Algorithm.hpp"
+#include "DataSnapshot.hpp"
 #include "Database.hpp"
 #include "GameConstants.hpp"
 #include "InitializeCommon.hpp"
@@ -43,10 +44,9 @@ auto MobDataProvider::loadAttacks() -> void {
 	m_attacks.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("mob_attacks"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("mob_attacks"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		MobAttackInfo mobAttack;
 
 		mob_id_t mobId = row.get<mob_id_t>("mobid");
@@ -75,10 +75,9 @@ auto MobDataProvider::loadSkills() -> void {
 	m_skills.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("mob_skills"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("mob_skills"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		MobSkillInfo mobSkill;
 		mob_id_t mobId = row.get<mob_id_t>("mobid");
 		mobSkill.skillId = row.get<mob_skill_id_t>("skillid");
@@ -93,10 +92,9 @@ auto MobDataProvider::loadMobs() -> void {
 	m_mobInfo.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("mob_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("mob_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		auto mob = make_ref_ptr<MobInfo>();
 
 		mob_id_t mobId = row.get<mob_id_t>("mobid");
@@ -173,10 +171,9 @@ auto MobDataProvider::loadMobs() -> void {
 
 auto MobDataProvider::loadSummons() -> void {
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("mob_summons"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("mob_summons"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		mob_id_t mobId = row.get<mob_id_t>("mobid");
 		mob_id_t summonId = row.get<mob_id_t>("summonid");
 
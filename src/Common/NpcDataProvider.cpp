@@ -17,6 +17,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "NpcDataProvider.hpp"
 #include "Algorithm.hpp"
+#include "DataSnapshot.hpp"
 #include "Database.hpp"
 #include "GameConstants.hpp"
 #include "GameLogicUtilities.hpp"
@@ -31,10 +32,9 @@ auto NpcDataProvider::loadData() -> void {
 	std::cout << std::setw(Initializing::OutputWidth) << std::left << "Initializing NPCs... ";
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("npc_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("npc_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		NpcInfo npc;
 		npc_id_t id = row.get<npc_id_t>("npcid");
 		npc.storageCost = row.get<mesos_t>("storage_cost");
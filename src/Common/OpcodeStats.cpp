@@ -0,0 +1,219 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "OpcodeStats.hpp"
+#include "Common/FileUtilities.hpp"
+#include "Common/TimeUtilities.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+namespace Vana {
+
+OpcodeStats::Entry::Entry() {
+	calls = 0;
+	bytes = 0;
+	totalMicroseconds = 0;
+	maxMicroseconds = 0;
+	for (auto &bucket : buckets) {
+		bucket = 0;
+	}
+}
+
+OpcodeStats::OpcodeStats() :
+	m_handled{new std::atomic<Entry *>[OpcodeCount]()},
+	m_sent{new std::atomic<Entry *>[OpcodeCount]()},
+	m_resetTime{TimeUtilities::getNow()}
+{
+}
+
+OpcodeStats::~OpcodeStats() {
+	release(m_handled);
+	release(m_sent);
+}
+
+auto OpcodeStats::recordHandled(header_t opcode, size_t bytes, microseconds_t elapsed) -> void {
+	Entry &entry = getEntry(m_handled, opcode);
+	uint64_t micro = static_cast<uint64_t>(std::max<int64_t>(elapsed.count(), 0));
+
+	entry.calls.fetch_add(1, std::memory_order_relaxed);
+	entry.bytes.fetch_add(bytes, std::memory_order_relaxed);
+	entry.totalMicroseconds.fetch_add(micro, std::memory_order_relaxed);
+
+	uint64_t max = entry.maxMicroseconds.load(std::memory_order_relaxed);
+	while (micro > max && !entry.maxMicroseconds.compare_exchange_weak(max, micro, std::memory_order_relaxed));
+
+	// Bucket 0 holds anything under a microsecond, bucket N holds [2^(N-1), 2^N)
+	size_t bucket = 0;
+	while (micro != 0 && bucket < BucketCount - 1) {
+		micro >>= 1;
+		bucket++;
+	}
+	entry.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+auto OpcodeStats::recordSent(header_t opcode, size_t bytes) -> void {
+	Entry &entry = getEntry(m_sent, opcode);
+	entry.calls.fetch_add(1, std::memory_order_relaxed);
+	entry.bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+auto OpcodeStats::getHandled() const -> vector_t<Summary> {
+	return summarize(m_handled);
+}
+
+auto OpcodeStats::getSent() const -> vector_t<Summary> {
+	return summarize(m_sent);
+}
+
+auto OpcodeStats::getResetTime() const -> time_point_t {
+	owned_lock_t<mutex_t> l{m_resetMutex};
+	return m_resetTime;
+}
+
+auto OpcodeStats::reset() -> void {
+	// Counters recorded while this runs may land on either side of the reset, which is fine for statistics
+	reset(m_handled);
+	reset(m_sent);
+
+	owned_lock_t<mutex_t> l{m_resetMutex};
+	m_resetTime = TimeUtilities::getNow();
+}
+
+auto OpcodeStats::write(const string_t &filename, const opt_string_t &identifier) const -> bool {
+	FileUtilities::createParentDirectories(filename);
+
+	std::ofstream file{filename, std::ios_base::out | std::ios_base::trunc};
+	if (!file) {
+		return false;
+	}
+
+	auto handled = getHandled();
+	auto sent = getSent();
+	std::sort(std::begin(handled), std::end(handled), [](const Summary &a, const Summary &b) { return a.totalTime > b.totalTime; });
+	std::sort(std::begin(sent), std::end(sent), [](const Summary &a, const Summary &b) { return a.bytes > b.bytes; });
+
+	auto elapsed = TimeUtilities::getDistanceInSeconds(TimeUtilities::getNow(), getResetTime());
+	if (identifier.is_initialized()) {
+		file << identifier.get() << std::endl;
+	}
+	file << "Collected over " << elapsed.count() << " seconds" << std::endl;
+
+	file << std::endl << "Handled" << std::endl;
+	file << std::setw(8) << "opcode" << std::setw(12) << "calls" << std::setw(14) << "bytes"
+		<< std::setw(14) << "total ms" << std::setw(10) << "avg us" << std::setw(10) << "p99 us" << std::setw(10) << "max us" << std::endl;
+	for (const auto &summary : handled) {
+		file << "  0x" << std::hex << std::setw(4) << std::setfill('0') << summary.opcode << std::dec << std::setfill(' ')
+			<< std::setw(12) << summary.calls
+			<< std::setw(14) << summary.bytes
+			<< std::setw(14) << duration_cast<milliseconds_t>(summary.totalTime).count()
+			<< std::setw(10) << summary.totalTime.count() / static_cast<int64_t>(summary.calls)
+			<< std::setw(10) << summary.p99Time.count()
+			<< std::setw(10) << summary.maxTime.count() << std::endl;
+	}
+
+	file << std::endl << "Sent" << std::endl;
+	file << std::setw(8) << "opcode" << std::setw(12) << "packets" << std::setw(14) << "bytes" << std::endl;
+	for (const auto &summary : sent) {
+		file << "  0x" << std::hex << std::setw(4) << std::setfill('0') << summary.opcode << std::dec << std::setfill(' ')
+			<< std::setw(12) << summary.calls
+			<< std::setw(14) << summary.bytes << std::endl;
+	}
+
+	return true;
+}
+
+auto OpcodeStats::getEntry(const entries_t &entries, header_t opcode) -> Entry & {
+	std::atomic<Entry *> &slot = entries[opcode];
+	Entry *entry = slot.load(std::memory_order_acquire);
+	if (entry != nullptr) {
+		return *entry;
+	}
+
+	Entry *created = new Entry{};
+	if (slot.compare_exchange_strong(entry, created, std::memory_order_acq_rel)) {
+		return *created;
+	}
+
+	// Another thread got there first
+	delete created;
+	return *entry;
+}
+
+auto OpcodeStats::summarize(const entries_t &entries) -> vector_t<Summary> {
+	vector_t<Summary> ret;
+	for (size_t opcode = 0; opcode < OpcodeCount; ++opcode) {
+		Entry *entry = entries[opcode].load(std::memory_order_acquire);
+		if (entry == nullptr) {
+			continue;
+		}
+
+		Summary summary;
+		summary.opcode = static_cast<header_t>(opcode);
+		summary.calls = entry->calls.load(std::memory_order_relaxed);
+		if (summary.calls == 0) {
+			continue;
+		}
+
+		summary.bytes = entry->bytes.load(std::memory_order_relaxed);
+		summary.totalTime = microseconds_t{static_cast<int64_t>(entry->totalMicroseconds.load(std::memory_order_relaxed))};
+		summary.maxTime = microseconds_t{static_cast<int64_t>(entry->maxMicroseconds.load(std::memory_order_relaxed))};
+
+		uint64_t histogramTotal = 0;
+		for (const auto &bucket : entry->buckets) {
+			histogramTotal += bucket.load(std::memory_order_relaxed);
+		}
+
+		uint64_t threshold = histogramTotal - histogramTotal / 100;
+		uint64_t seen = 0;
+		for (size_t bucket = 0; bucket < BucketCount; ++bucket) {
+			seen += entry->buckets[bucket].load(std::memory_order_relaxed);
+			if (seen >= threshold) {
+				summary.p99Time = std::min(microseconds_t{static_cast<int64_t>(1) << bucket}, summary.maxTime);
+				break;
+			}
+		}
+
+		ret.push_back(summary);
+	}
+	return ret;
+}
+
+auto OpcodeStats::reset(const entries_t &entries) -> void {
+	for (size_t opcode = 0; opcode < OpcodeCount; ++opcode) {
+		Entry *entry = entries[opcode].load(std::memory_order_acquire);
+		if (entry == nullptr) {
+			continue;
+		}
+
+		entry->calls = 0;
+		entry->bytes = 0;
+		entry->totalMicroseconds = 0;
+		entry->maxMicroseconds = 0;
+		for (auto &bucket : entry->buckets) {
+			bucket = 0;
+		}
+	}
+}
+
+auto OpcodeStats::release(entries_t &entries) -> void {
+	for (size_t opcode = 0; opcode < OpcodeCount; ++opcode) {
+		delete entries[opcode].load(std::memory_order_relaxed);
+	}
+}
+
+}
\ No newline at end of file
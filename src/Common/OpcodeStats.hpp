@@ -0,0 +1,75 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Types.hpp"
+#include <atomic>
+
+namespace Vana {
+	// Always-on per-opcode counters for handled (inbound) and sent (outbound) packets
+	// Recording is lock-free, each opcode's counters are allocated the first time it's seen
+	class OpcodeStats {
+		NONCOPYABLE(OpcodeStats);
+	public:
+		struct Summary {
+			header_t opcode = 0;
+			uint64_t calls = 0;
+			uint64_t bytes = 0;
+			microseconds_t totalTime = microseconds_t{0};
+			microseconds_t maxTime = microseconds_t{0};
+			// Estimated from a power-of-two histogram, so it's an upper bound
+			microseconds_t p99Time = microseconds_t{0};
+		};
+
+		OpcodeStats();
+		~OpcodeStats();
+
+		auto recordHandled(header_t opcode, size_t bytes, microseconds_t elapsed) -> void;
+		auto recordSent(header_t opcode, size_t bytes) -> void;
+		auto getHandled() const -> vector_t<Summary>;
+		auto getSent() const -> vector_t<Summary>;
+		auto getResetTime() const -> time_point_t;
+		auto reset() -> void;
+		auto write(const string_t &filename, const opt_string_t &identifier) const -> bool;
+	private:
+		static const size_t OpcodeCount = 65536;
+		static const size_t BucketCount = 24;
+
+		struct Entry {
+			Entry();
+
+			std::atomic<uint64_t> calls;
+			std::atomic<uint64_t> bytes;
+			std::atomic<uint64_t> totalMicroseconds;
+			std::atomic<uint64_t> maxMicroseconds;
+			std::atomic<uint64_t> buckets[BucketCount];
+		};
+
+		using entries_t = owned_ptr_t<std::atomic<Entry *>[]>;
+
+		static auto getEntry(const entries_t &entries, header_t opcode) -> Entry &;
+		static auto summarize(const entries_t &entries) -> vector_t<Summary>;
+		static auto reset(const entries_t &entries) -> void;
+		static auto release(entries_t &entries) -> void;
+
+		entries_t m_handled;
+		entries_t m_sent;
+		mutable mutex_t m_resetMutex;
+		time_point_t m_resetTime;
+	};
+}
\ No newline at end of file
@@ -26,9 +26,21 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
 namespace Vana {
 
+PacketBuilder::Storage::Storage(size_t capacity, size_t front) :
+	bytes{new unsigned char[capacity]},
+	capacity{capacity},
+	front{front}
+{
+}
+
 PacketBuilder::PacketBuilder() :
-	m_packet{new unsigned char[bufferLen]},
-	m_packetCapacity{bufferLen}
+	PacketBuilder{bufferLen}
+{
+}
+
+PacketBuilder::PacketBuilder(size_t reserved) :
+	m_start{headroomLen},
+	m_storage{make_ref_ptr<Storage>(headroomLen + reserved, size_t{headroomLen})}
 {
 }
 
@@ -88,18 +100,54 @@ auto PacketBuilder::addBuffer(const PacketReader &reader) -> PacketBuilder & {
 	return addBuffer(reader.getBuffer(), reader.getBufferLength());
 }
 
+auto PacketBuilder::prependBuffer(const unsigned char *bytes, size_t len) -> PacketBuilder & {
+	size_t front = m_start;
+	if (m_start < len || !m_storage->front.compare_exchange_strong(front, m_start - len)) {
+		// Either the headroom is too small or another copy of this packet already claimed it
+		// Either way, this builder moves to storage of its own with fresh headroom, which nothing else can see yet
+		size_t start = headroomLen + len;
+		size_t capacity = start + (m_pos > bufferLen ? m_pos : bufferLen);
+		auto storage = make_ref_ptr<Storage>(capacity, headroomLen);
+		memcpy(storage->bytes.get() + start, getBuffer(), m_pos);
+		m_storage = storage;
+		m_start = start;
+	}
+
+	m_start -= len;
+	memcpy(m_storage->bytes.get() + m_start, bytes, len);
+	m_pos += len;
+	return *this;
+}
+
+auto PacketBuilder::prependBuffer(const PacketBuilder &builder) -> PacketBuilder & {
+	return prependBuffer(builder.getBuffer(), builder.getSize());
+}
+
 auto PacketBuilder::getBuffer(size_t pos, size_t len) -> unsigned char * {
-	if (m_packetCapacity < pos + len) {
+	size_t end = m_start + pos + len;
+	if (m_storage->capacity < end) {
 		// Buffer is not large enough
-		while (m_packetCapacity < pos + len) {
-			m_packetCapacity *= 2; // Double the capacity each time the buffer is full
+		size_t capacity = m_storage->capacity;
+		while (capacity < end) {
+			capacity *= 2; // Double the capacity each time the buffer is full
+		}
+		auto storage = make_ref_ptr<Storage>(capacity, m_start);
+		memcpy(storage->bytes.get() + m_start, m_storage->bytes.get() + m_start, m_pos);
+		m_storage = storage;
+
+	#ifdef DEBUG
+		// Growing once is expected for odd packets, growing again means the packet should reserve its size
+		if (++m_reallocations > 1) {
+			std::cout << "PacketBuilder reallocated " << m_reallocations << " times, needs " << (pos + len) << " bytes";
+			if (m_pos >= sizeof(header_t)) {
+				std::cout << " for 0x" << std::hex << std::setw(4) << std::setfill('0') << *reinterpret_cast<const header_t *>(getBuffer()) << std::dec << std::setfill(' ');
+			}
+			std::cout << std::endl;
 		}
-		unsigned char *newBuffer = new unsigned char[m_packetCapacity];
-		memcpy(newBuffer, m_packet.get(), pos);
-		m_packet.reset(newBuffer);
+	#endif
 	}
 
-	return m_packet.get() + pos;
+	return m_storage->bytes.get() + m_start + pos;
 }
 
 auto PacketBuilder::toString() const -> string_t {
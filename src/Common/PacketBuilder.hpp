@@ -18,8 +18,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #pragma once
 
 #include "Common/IPacket.hpp"
-#include "Common/shared_array.hpp"
 #include "Common/Types.hpp"
+#include <atomic>
 #include <cstring>
 #include <iostream>
 #include <limits>
@@ -39,6 +39,8 @@ namespace Vana {
 	class PacketBuilder {
 	public:
 		PacketBuilder();
+		// Reserves room for the whole packet up front, see PacketSize for the fixed-layout pieces
+		explicit PacketBuilder(size_t reserved);
 
 		template <typename TValue>
 		auto add(const TValue &value) -> PacketBuilder &;
@@ -61,12 +63,27 @@ namespace Vana {
 		auto addBuffer(const unsigned char *bytes, size_t len) -> PacketBuilder &;
 		auto addBuffer(const PacketBuilder &builder) -> PacketBuilder &;
 		auto addBuffer(const PacketReader &reader) -> PacketBuilder &;
+		// Puts the bytes in front of everything added so far, in the reserved headroom when it's free so the payload doesn't move
+		auto prependBuffer(const unsigned char *bytes, size_t len) -> PacketBuilder &;
+		auto prependBuffer(const PacketBuilder &builder) -> PacketBuilder &;
 
 		auto getBuffer() const -> const unsigned char *;
 		auto getSize() const -> size_t;
 		auto toString() const -> string_t;
 	private:
 		static const size_t bufferLen = 100; // Initial buffer length
+		static const size_t headroomLen = 32; // Room for routing headers in front of the packet
+
+		struct Storage {
+			Storage(size_t capacity, size_t front);
+
+			owned_ptr_t<unsigned char[]> bytes;
+			size_t capacity = 0;
+			// Copies of a builder share storage and may be prepended to from different threads, this is the lowest offset any of them has prepended at
+			// The headroom below it is unused, a builder that starts there claims it by moving this down (compare-exchange) before writing into it
+			std::atomic<size_t> front;
+		};
+
 		friend auto operator <<(std::ostream &out, const PacketBuilder &builder) -> std::ostream &;
 
 		auto getBuffer(size_t pos, size_t len) -> unsigned char *;
@@ -117,9 +134,12 @@ namespace Vana {
 		template <typename TElement>
 		auto addSizedImpl(const vector_t<TElement> &val, size_t size) -> void;
 
+		size_t m_start = 0;
 		size_t m_pos = 0;
-		size_t m_packetCapacity = 0;
-		MiscUtilities::shared_array<unsigned char> m_packet;
+		ref_ptr_t<Storage> m_storage;
+	#ifdef DEBUG
+		size_t m_reallocations = 0;
+	#endif
 	};
 
 	template <typename TValue>
@@ -265,9 +285,10 @@ namespace Vana {
 		if (size < slen) {
 			throw std::invalid_argument{"addString used with a length shorter than string size"};
 		}
-		strncpy(reinterpret_cast<char *>(getBuffer(m_pos, size)), value.c_str(), slen);
+		unsigned char *buffer = getBuffer(m_pos, size);
+		strncpy(reinterpret_cast<char *>(buffer), value.c_str(), slen);
 		for (size_t i = slen; i < size; i++) {
-			m_packet[m_pos + i] = 0;
+			buffer[i] = 0;
 		}
 		m_pos += size;
 	}
@@ -281,7 +302,7 @@ namespace Vana {
 
 	inline
 	auto PacketBuilder::getBuffer() const -> const unsigned char * {
-		return m_packet.get();
+		return m_storage->bytes.get() + m_start;
 	}
 
 	inline
@@ -0,0 +1,127 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "PacketCapture.hpp"
+#include "Common/FileUtilities.hpp"
+#include <cstring>
+
+namespace Vana {
+
+PacketCaptureWriter::PacketCaptureWriter(const string_t &filename) :
+	m_start{std::chrono::steady_clock::now()}
+{
+	FileUtilities::createParentDirectories(filename);
+	m_file.open(filename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+	if (m_file) {
+		m_file.write(CaptureMagic, sizeof(CaptureMagic));
+		write(CaptureVersion);
+	}
+}
+
+PacketCaptureWriter::~PacketCaptureWriter() {
+	m_file.flush();
+}
+
+auto PacketCaptureWriter::isOpen() const -> bool {
+	return m_file.is_open() && m_file.good();
+}
+
+auto PacketCaptureWriter::recordConnect(uint32_t session, const Ip &ip) -> void {
+	owned_lock_t<mutex_t> l{m_mutex};
+	writeRecordHeader(CaptureRecordType::Connect, session);
+	write(ip.asIpv4());
+}
+
+auto PacketCaptureWriter::recordPacket(uint32_t session, const unsigned char *buf, size_t length) -> void {
+	owned_lock_t<mutex_t> l{m_mutex};
+	writeRecordHeader(CaptureRecordType::Packet, session);
+	write(static_cast<uint16_t>(length));
+	m_file.write(reinterpret_cast<const char *>(buf), length);
+}
+
+auto PacketCaptureWriter::recordDisconnect(uint32_t session) -> void {
+	owned_lock_t<mutex_t> l{m_mutex};
+	writeRecordHeader(CaptureRecordType::Disconnect, session);
+	// Sessions come and go rarely enough that this keeps the file usable if the server dies
+	m_file.flush();
+}
+
+auto PacketCaptureWriter::writeRecordHeader(CaptureRecordType type, uint32_t session) -> void {
+	auto elapsed = duration_cast<microseconds_t>(std::chrono::steady_clock::now() - m_start);
+	write(static_cast<uint8_t>(type));
+	write(session);
+	write(static_cast<uint64_t>(elapsed.count()));
+}
+
+template <typename TValue>
+auto PacketCaptureWriter::write(TValue value) -> void {
+	m_file.write(reinterpret_cast<const char *>(&value), sizeof(TValue));
+}
+
+PacketCaptureReader::PacketCaptureReader(const string_t &filename) :
+	m_file{filename, std::ios_base::in | std::ios_base::binary}
+{
+	char magic[sizeof(CaptureMagic)];
+	uint16_t version = 0;
+	if (m_file.read(magic, sizeof(magic)) && read(version)) {
+		m_valid = memcmp(magic, CaptureMagic, sizeof(magic)) == 0 && version == CaptureVersion;
+	}
+}
+
+auto PacketCaptureReader::isValid() const -> bool {
+	return m_valid;
+}
+
+auto PacketCaptureReader::next(CaptureRecord &record) -> bool {
+	if (!m_valid) {
+		return false;
+	}
+
+	uint8_t type = 0;
+	uint64_t timestamp = 0;
+	if (!read(type) || !read(record.session) || !read(timestamp)) {
+		return false;
+	}
+
+	record.type = static_cast<CaptureRecordType>(type);
+	record.timestamp = microseconds_t{static_cast<int64_t>(timestamp)};
+	switch (record.type) {
+		case CaptureRecordType::Connect:
+			return read(record.ip);
+		case CaptureRecordType::Packet: {
+			uint16_t length = 0;
+			if (!read(length)) {
+				return false;
+			}
+			record.packet.resize(length);
+			return static_cast<bool>(m_file.read(reinterpret_cast<char *>(record.packet.data()), length));
+		}
+		case CaptureRecordType::Disconnect:
+			return true;
+	}
+
+	// Unknown record type, the rest of the file can't be trusted
+	m_valid = false;
+	return false;
+}
+
+template <typename TValue>
+auto PacketCaptureReader::read(TValue &value) -> bool {
+	return static_cast<bool>(m_file.read(reinterpret_cast<char *>(&value), sizeof(TValue)));
+}
+
+}
\ No newline at end of file
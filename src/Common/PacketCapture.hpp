@@ -0,0 +1,84 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Ip.hpp"
+#include "Common/Types.hpp"
+#include <chrono>
+#include <fstream>
+
+namespace Vana {
+	// Captures are a 6 byte header ("VCAP" and a uint16_t version) followed by records in host byte order:
+	// uint8_t type, uint32_t session, uint64_t microseconds since the capture started, then
+	// Connect: uint32_t IPv4 address
+	// Packet: uint16_t length and the decrypted packet, opcode included
+	// Disconnect: nothing
+	enum class CaptureRecordType : uint8_t {
+		Connect,
+		Packet,
+		Disconnect,
+	};
+
+	struct CaptureRecord {
+		CaptureRecordType type = CaptureRecordType::Packet;
+		uint32_t session = 0;
+		microseconds_t timestamp = microseconds_t{0};
+		uint32_t ip = 0;
+		vector_t<unsigned char> packet;
+	};
+
+	class PacketCaptureWriter {
+		NONCOPYABLE(PacketCaptureWriter);
+		NO_DEFAULT_CONSTRUCTOR(PacketCaptureWriter);
+	public:
+		explicit PacketCaptureWriter(const string_t &filename);
+		~PacketCaptureWriter();
+
+		auto isOpen() const -> bool;
+		auto recordConnect(uint32_t session, const Ip &ip) -> void;
+		auto recordPacket(uint32_t session, const unsigned char *buf, size_t length) -> void;
+		auto recordDisconnect(uint32_t session) -> void;
+	private:
+		auto writeRecordHeader(CaptureRecordType type, uint32_t session) -> void;
+		template <typename TValue>
+		auto write(TValue value) -> void;
+
+		mutex_t m_mutex;
+		std::ofstream m_file;
+		std::chrono::steady_clock::time_point m_start;
+	};
+
+	class PacketCaptureReader {
+		NONCOPYABLE(PacketCaptureReader);
+		NO_DEFAULT_CONSTRUCTOR(PacketCaptureReader);
+	public:
+		explicit PacketCaptureReader(const string_t &filename);
+
+		auto isValid() const -> bool;
+		auto next(CaptureRecord &record) -> bool;
+	private:
+		template <typename TValue>
+		auto read(TValue &value) -> bool;
+
+		bool m_valid = false;
+		std::ifstream m_file;
+	};
+
+	static const char CaptureMagic[4] = {'V', 'C', 'A', 'P'};
+	static const uint16_t CaptureVersion = 1;
+}
\ No newline at end of file
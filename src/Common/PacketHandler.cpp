@@ -40,6 +40,13 @@ auto PacketHandler::send(const PacketBuilder &builder) -> void {
 	m_session->send(builder);
 }
 
+auto PacketHandler::send(const BroadcastPacket &packet) -> void {
+	if (m_disconnected) {
+		return;
+	}
+	m_session->send(packet);
+}
+
 auto PacketHandler::getLatency() const -> milliseconds_t {
 	if (m_disconnected) {
 		return milliseconds_t{0};
@@ -51,6 +58,10 @@ auto PacketHandler::handle(PacketReader &reader) -> Result {
 	return Result::Successful;
 }
 
+auto PacketHandler::getShard(header_t opcode) const -> int32_t {
+	return -1;
+}
+
 auto PacketHandler::onConnectBase(ref_ptr_t<Session> session) -> void {
 	m_session = session;
 	onConnect();
@@ -27,10 +27,13 @@ namespace Vana {
 		auto getIp() const -> optional_t<Ip>;
 		auto disconnect() -> void;
 		auto send(const PacketBuilder &builder) -> void;
+		auto send(const BroadcastPacket &packet) -> void;
 		auto getLatency() const -> milliseconds_t;
 	protected:
 		friend class Session;
 		virtual auto handle(PacketReader &reader) -> Result;
+		// Called off the handler strand, returns the shard whose strand may handle the opcode or -1 for the handler strand
+		virtual auto getShard(header_t opcode) const -> int32_t;
 		virtual auto onConnect() -> void;
 		virtual auto onDisconnect() -> void;
 		auto onConnectBase(ref_ptr_t<Session> session) -> void;
@@ -0,0 +1,161 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "PacketReplay.hpp"
+#include "Common/AbstractServer.hpp"
+#include "Common/ConnectionManager.hpp"
+#include "Common/EncryptedPacketTransformer.hpp"
+#include "Common/PacketCapture.hpp"
+#include "Common/Randomizer.hpp"
+#include "Common/SendBatch.hpp"
+#include <chrono>
+#include <thread>
+
+namespace Vana {
+
+PacketReplay::PacketReplay(
+	asio::io_service &service,
+	ConnectionManager &manager,
+	const ReplayConfig &config,
+	HandlerCreator handlerCreator,
+	packet_hook_t beforeHandle,
+	complete_func_t onComplete) :
+	m_config{config},
+	m_service{service},
+	m_manager{manager},
+	m_handlerCreator{handlerCreator},
+	m_beforeHandle{beforeHandle},
+	m_onComplete{onComplete}
+{
+}
+
+PacketReplay::~PacketReplay() {
+	stop();
+}
+
+auto PacketReplay::start() -> void {
+	m_running = true;
+	m_thread = make_owned_ptr<thread_t>([this] { this->run(); });
+}
+
+auto PacketReplay::stop() -> void {
+	m_running = false;
+	if (m_thread != nullptr && m_thread->joinable()) {
+		if (m_thread->get_id() == std::this_thread::get_id()) {
+			m_thread->detach();
+		}
+		else {
+			m_thread->join();
+		}
+	}
+}
+
+auto PacketReplay::run() -> void {
+	AbstractServer *server = m_manager.getServer();
+	PacketCaptureReader reader{m_config.file};
+	if (!reader.isValid()) {
+		server->log(LogType::Error, "Unable to replay " + m_config.file + ", it's missing or isn't a packet capture");
+		return;
+	}
+
+	server->log(LogType::Info, [&](out_stream_t &str) {
+		str << "Replaying " << m_config.file << (m_config.fast ? " as fast as possible" : " at captured speed");
+	});
+
+	hash_map_t<uint32_t, ref_ptr_t<Session>> sessions;
+	uint64_t packets = 0;
+	uint64_t sessionCount = 0;
+	microseconds_t capturedDuration{0};
+	auto start = std::chrono::steady_clock::now();
+
+	CaptureRecord record;
+	while (m_running && reader.next(record)) {
+		capturedDuration = record.timestamp;
+		if (m_config.fast) {
+			// Keep the handler strand fed without queueing the whole capture in memory
+			waitForHandlers(MaxOutstandingPackets);
+		}
+		else {
+			std::this_thread::sleep_until(start + record.timestamp);
+		}
+
+		switch (record.type) {
+			case CaptureRecordType::Connect: {
+				auto session = make_ref_ptr<Session>(m_service, m_manager, m_handlerCreator());
+				// Outbound packets are still encrypted so the send path costs what it does live
+				session->startReplay(Ip{record.ip}, make_ref_ptr<EncryptedPacketTransformer>(Randomizer::rand<iv_t>(), Randomizer::rand<iv_t>()));
+				sessions[record.session] = session;
+				sessionCount++;
+				break;
+			}
+			case CaptureRecordType::Packet: {
+				auto kvp = sessions.find(record.session);
+				if (kvp == std::end(sessions)) {
+					break;
+				}
+
+				auto session = kvp->second;
+				auto packet = make_ref_ptr<vector_t<unsigned char>>(std::move(record.packet));
+				packets++;
+				m_outstanding++;
+				m_manager.postHandler([this, session, packet] {
+					if (session->m_isConnected) {
+						SendBatch batch;
+						PacketReader reader{packet->data(), packet->size()};
+						if (m_beforeHandle != nullptr) {
+							m_beforeHandle(session->getIp(), reader);
+						}
+						session->baseHandleRequest(reader);
+					}
+					m_outstanding--;
+				});
+				break;
+			}
+			case CaptureRecordType::Disconnect: {
+				auto kvp = sessions.find(record.session);
+				if (kvp != std::end(sessions)) {
+					kvp->second->disconnect();
+					sessions.erase(kvp);
+				}
+				break;
+			}
+		}
+	}
+
+	waitForHandlers(0);
+	for (auto &kvp : sessions) {
+		kvp.second->disconnect();
+	}
+
+	auto elapsed = duration_cast<milliseconds_t>(std::chrono::steady_clock::now() - start);
+	server->log(LogType::Info, [&](out_stream_t &str) {
+		str << "Replayed " << packets << " packets from " << sessionCount << " sessions in " << elapsed.count() << "ms"
+			<< " (captured over " << duration_cast<milliseconds_t>(capturedDuration).count() << "ms)";
+	});
+
+	if (m_running && m_onComplete != nullptr) {
+		m_onComplete();
+	}
+}
+
+auto PacketReplay::waitForHandlers(int32_t maxOutstanding) -> void {
+	while (m_outstanding > maxOutstanding && m_running) {
+		std::this_thread::sleep_for(milliseconds_t{1});
+	}
+}
+
+}
\ No newline at end of file
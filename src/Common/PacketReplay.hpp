@@ -0,0 +1,74 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Ip.hpp"
+#include "Common/PacketReader.hpp"
+#include "Common/Session.hpp"
+#include "Common/Types.hpp"
+#include <asio.hpp>
+#include <atomic>
+#include <string>
+
+namespace Vana {
+	class ConnectionManager;
+
+	struct ReplayConfig {
+		string_t file;
+		// Ignore the captured timing and hand packets over as fast as the handlers take them
+		bool fast = false;
+	};
+
+	// Feeds a capture written by PacketCaptureWriter back into the handlers through socketless sessions
+	// Runs on its own thread, packets are handled on the handler strand just like live traffic
+	class PacketReplay {
+		NONCOPYABLE(PacketReplay);
+		NO_DEFAULT_CONSTRUCTOR(PacketReplay);
+	public:
+		// Called on the handler strand right before a replayed packet is handled, this is where missing servers can be stubbed
+		using packet_hook_t = function_t<void(const Ip &, PacketReader)>;
+		using complete_func_t = function_t<void()>;
+
+		PacketReplay(
+			asio::io_service &service,
+			ConnectionManager &manager,
+			const ReplayConfig &config,
+			HandlerCreator handlerCreator,
+			packet_hook_t beforeHandle,
+			complete_func_t onComplete);
+		~PacketReplay();
+
+		auto start() -> void;
+		auto stop() -> void;
+	private:
+		static const int32_t MaxOutstandingPackets = 4096;
+
+		auto run() -> void;
+		auto waitForHandlers(int32_t maxOutstanding) -> void;
+
+		std::atomic_bool m_running{false};
+		std::atomic<int32_t> m_outstanding{0};
+		ReplayConfig m_config;
+		asio::io_service &m_service;
+		ConnectionManager &m_manager;
+		HandlerCreator m_handlerCreator;
+		packet_hook_t m_beforeHandle;
+		complete_func_t m_onComplete;
+		owned_ptr_t<thread_t> m_thread;
+	};
+}
\ No newline at end of file
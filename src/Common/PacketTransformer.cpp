@@ -57,6 +57,18 @@ auto PacketTransformer::decryptPacket(unsigned char *packetData, int32_t realPac
 	// Intentionally blank
 }
 
+auto PacketTransformer::usesCustomEncryption() const -> bool {
+	return false;
+}
+
+auto PacketTransformer::encryptPreparedPacket(unsigned char *packetData, int32_t realPacketSize, uint16_t headerSize) -> void {
+	// Intentionally blank
+}
+
+auto PacketTransformer::decryptPreparedPacket(unsigned char *packetData, int32_t realPacketSize, uint16_t headerSize) -> void {
+	// Intentionally blank
+}
+
 auto PacketTransformer::getVersionAndSize(unsigned char *header, uint16_t &version, uint16_t &size) -> void {
 	version = *reinterpret_cast<uint16_t *>(header);
 	size = *reinterpret_cast<uint16_t *>(header + sizeof(uint16_t));
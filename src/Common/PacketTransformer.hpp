@@ -27,6 +27,11 @@ namespace Vana {
 		virtual auto setPacketHeader(unsigned char *header, uint16_t realPacketSize) -> void;
 		virtual auto encryptPacket(unsigned char *packetData, int32_t realPacketSize, uint16_t headerSize) -> void;
 		virtual auto decryptPacket(unsigned char *packetData, int32_t realPacketSize, uint16_t headerSize) -> void;
+		// The IV independent custom layer can be applied separately, once per broadcast or to many packets at a time with CustomCipher
+		// Prepared packets have that layer applied, these functions only handle the per-session part
+		virtual auto usesCustomEncryption() const -> bool;
+		virtual auto encryptPreparedPacket(unsigned char *packetData, int32_t realPacketSize, uint16_t headerSize) -> void;
+		virtual auto decryptPreparedPacket(unsigned char *packetData, int32_t realPacketSize, uint16_t headerSize) -> void;
 	private:
 		auto getVersionAndSize(unsigned char *header, uint16_t &version, uint16_t &size) -> void;
 	};
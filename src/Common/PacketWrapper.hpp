@@ -25,9 +25,11 @@ namespace Vana {
 	namespace Packets {
 		inline
 		auto prepend(const PacketBuilder &builder, function_t<void(PacketBuilder &)> wrapFunction) -> PacketBuilder {
-			PacketBuilder packet;
-			wrapFunction(packet);
-			packet.addBuffer(builder);
+			PacketBuilder header;
+			wrapFunction(header);
+			// The header goes into the headroom of the packet, the payload itself stays where it is
+			PacketBuilder packet{builder};
+			packet.prependBuffer(header);
 			return packet;
 		}
 
@@ -62,6 +62,11 @@ namespace Vana {
 		}
 	};
 
+	template <>
+	struct PacketSize<Point> {
+		static constexpr size_t value = packetSize<coord_t, coord_t>();
+	};
+
 	inline
 	auto operator <<(std::ostream &out, const Point &pos) -> std::ostream & {
 		return out << "{" << pos.x << ", " << pos.y << "}";
@@ -17,6 +17,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "QuestDataProvider.hpp"
 #include "Algorithm.hpp"
+#include "DataSnapshot.hpp"
 #include "Database.hpp"
 #include "GameLogicUtilities.hpp"
 #include "InitializeCommon.hpp"
@@ -43,10 +44,9 @@ auto QuestDataProvider::loadQuestData() -> void {
 	m_quests.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("quest_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("quest_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		Quest quest;
 		quest_id_t questId = row.get<quest_id_t>("questid");
 
@@ -62,10 +62,9 @@ auto QuestDataProvider::loadRequests() -> void {
 	// Process the state when you add quest requests
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("quest_requests"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("quest_requests"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		quest_id_t questId = row.get<quest_id_t>("questid");
 		auto &quest = m_quests[questId];
 		QuestRequestInfo questRequest;
@@ -97,10 +96,9 @@ auto QuestDataProvider::loadRequests() -> void {
 
 auto QuestDataProvider::loadRequiredJobs() -> void {
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("quest_required_jobs"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("quest_required_jobs"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		quest_id_t questId = row.get<quest_id_t>("questid");
 		auto &quest = m_quests[questId];
 		QuestRequestInfo request;
@@ -112,10 +110,9 @@ auto QuestDataProvider::loadRequiredJobs() -> void {
 
 auto QuestDataProvider::loadRewards() -> void {
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("quest_rewards"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("quest_rewards"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		quest_id_t questId = row.get<quest_id_t>("questid");
 		Quest &quest = m_quests[questId];
 		QuestRewardInfo reward;
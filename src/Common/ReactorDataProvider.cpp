@@ -16,6 +16,7 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "ReactorDataProvider.hpp"
+#include "DataSnapshot.hpp"
 #include "Database.hpp"
 #include "InitializeCommon.hpp"
 #include "StringUtilities.hpp"
@@ -39,10 +40,9 @@ auto ReactorDataProvider::loadReactors() -> void {
 	m_reactorInfo.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("reactor_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("reactor_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		ReactorInfo reactor;
 		reactor_id_t id = row.get<reactor_id_t>("reactorid");
 		reactor.maxStates = row.get<int8_t>("max_states");
@@ -59,10 +59,9 @@ auto ReactorDataProvider::loadReactors() -> void {
 
 auto ReactorDataProvider::loadStates() -> void {
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("reactor_events") << " ORDER BY reactorId, state ASC");
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("reactor_events") + " ORDER BY reactorId, state ASC");
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		ReactorStateInfo state;
 		reactor_id_t id = row.get<reactor_id_t>("reactorid");
 		int8_t stateId = row.get<int8_t>("state");
@@ -91,10 +90,9 @@ auto ReactorDataProvider::loadStates() -> void {
 
 auto ReactorDataProvider::loadTriggerSkills() -> void {
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("reactor_event_trigger_skills"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("reactor_event_trigger_skills"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		reactor_id_t id = row.get<reactor_id_t>("reactorid");
 		int8_t state = row.get<int8_t>("state");
 		skill_id_t skillId = row.get<skill_id_t>("skillid");
@@ -0,0 +1,80 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Types.hpp"
+#include <map>
+#include <vector>
+
+namespace Vana {
+	// Remembers the rows a component last read from or wrote to the database
+	// Saves compare the current rows against it so only new, changed and removed rows are written
+	template <typename TKey, typename TRow>
+	class RowTracker {
+	public:
+		using rows_t = ord_map_t<TKey, TRow>;
+
+		// Until the first commit nothing is known about what's stored, the caller has to rewrite every row
+		auto isTracking() const -> bool { return m_tracking; }
+		// Keys that are new or whose row differs from the saved one
+		auto getChanged(const rows_t &rows) const -> vector_t<TKey>;
+		// Keys that were saved but aren't there anymore
+		auto getRemoved(const rows_t &rows) const -> vector_t<TKey>;
+		// Only call this after the rows are written, a save that throws keeps the old rows so the next one writes the same changes again
+		auto commit(rows_t rows) -> void;
+		auto clear() -> void;
+	private:
+		bool m_tracking = false;
+		rows_t m_saved;
+	};
+
+	template <typename TKey, typename TRow>
+	auto RowTracker<TKey, TRow>::getChanged(const rows_t &rows) const -> vector_t<TKey> {
+		vector_t<TKey> changed;
+		for (const auto &kvp : rows) {
+			auto iter = m_saved.find(kvp.first);
+			if (iter == std::end(m_saved) || !(iter->second == kvp.second)) {
+				changed.push_back(kvp.first);
+			}
+		}
+		return changed;
+	}
+
+	template <typename TKey, typename TRow>
+	auto RowTracker<TKey, TRow>::getRemoved(const rows_t &rows) const -> vector_t<TKey> {
+		vector_t<TKey> removed;
+		for (const auto &kvp : m_saved) {
+			if (rows.find(kvp.first) == std::end(rows)) {
+				removed.push_back(kvp.first);
+			}
+		}
+		return removed;
+	}
+
+	template <typename TKey, typename TRow>
+	auto RowTracker<TKey, TRow>::commit(rows_t rows) -> void {
+		m_saved = std::move(rows);
+		m_tracking = true;
+	}
+
+	template <typename TKey, typename TRow>
+	auto RowTracker<TKey, TRow>::clear() -> void {
+		m_saved.clear();
+		m_tracking = false;
+	}
+}
\ No newline at end of file
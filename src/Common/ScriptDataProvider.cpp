@@ -18,6 +18,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "ScriptDataProvider.hpp"
 #include "AbstractServer.hpp"
 #include "Algorithm.hpp"
+#include "DataSnapshot.hpp"
 #include "Database.hpp"
 #include "FileUtilities.hpp"
 #include "InitializeCommon.hpp"
@@ -40,10 +41,9 @@ auto ScriptDataProvider::loadData() -> void {
 	m_itemScripts.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("scripts"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("scripts"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		int32_t objectId = row.get<int32_t>("objectid");
 		string_t script = row.get<string_t>("script");
 		int8_t modifier = row.get<int8_t>("helper");
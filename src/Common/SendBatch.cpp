@@ -0,0 +1,51 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "SendBatch.hpp"
+#include "Common/Session.hpp"
+
+namespace Vana {
+
+thread_local SendBatch *SendBatch::s_current = nullptr;
+
+SendBatch::SendBatch() {
+	if (s_current == nullptr) {
+		s_current = this;
+		m_outermost = true;
+	}
+}
+
+SendBatch::~SendBatch() {
+	if (!m_outermost) {
+		return;
+	}
+
+	s_current = nullptr;
+	for (auto &session : m_sessions) {
+		session->flush();
+	}
+}
+
+auto SendBatch::current() -> SendBatch * {
+	return s_current;
+}
+
+auto SendBatch::add(ref_ptr_t<Session> session) -> void {
+	m_sessions.push_back(session);
+}
+
+}
\ No newline at end of file
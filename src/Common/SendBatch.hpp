@@ -0,0 +1,44 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Types.hpp"
+#include <memory>
+#include <vector>
+
+namespace Vana {
+	class Session;
+
+	// While a SendBatch is alive on a thread, packets sent from that thread are held by their sessions
+	// Each session then writes everything it was sent in a single write when the batch ends
+	// Nested batches fold into the outermost one
+	class SendBatch {
+		NONCOPYABLE(SendBatch);
+	public:
+		SendBatch();
+		~SendBatch();
+
+		static auto current() -> SendBatch *;
+		auto add(ref_ptr_t<Session> session) -> void;
+	private:
+		bool m_outermost = false;
+		vector_t<ref_ptr_t<Session>> m_sessions;
+
+		static thread_local SendBatch *s_current;
+	};
+}
\ No newline at end of file
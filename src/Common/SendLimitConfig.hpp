@@ -0,0 +1,64 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/ConfigFile.hpp"
+#include "Common/Types.hpp"
+
+namespace Vana {
+	// Outbound limits for a session, counted over everything queued that the socket hasn't accepted yet
+	// A limit of 0 disables it
+	struct SendLimitConfig {
+		// Above either soft limit, low priority packets to the session are dropped
+		size_t softBytes = 0;
+		size_t softPackets = 0;
+		// Above the hard limit, the session is disconnected
+		size_t hardBytes = 0;
+	};
+
+	template <>
+	struct LuaSerialize<SendLimitConfig> {
+		auto read(LuaEnvironment &config, const string_t &prefix) -> SendLimitConfig {
+			SendLimitConfig ret;
+
+			LuaVariant obj = config.get<LuaVariant>(prefix);
+			config.validateObject(LuaType::Table, obj, prefix);
+
+			auto map = obj.as<hash_map_t<LuaVariant, LuaVariant>>();
+			for (const auto &kvp : map) {
+				config.validateKey(LuaType::String, kvp.first, prefix);
+
+				string_t key = kvp.first.as<string_t>();
+				if (key == "soft_bytes") {
+					if (config.validateValue(LuaType::Number, kvp.second, key, prefix, true) == LuaType::Nil) continue;
+					ret.softBytes = kvp.second.as<uint32_t>();
+				}
+				else if (key == "soft_packets") {
+					if (config.validateValue(LuaType::Number, kvp.second, key, prefix, true) == LuaType::Nil) continue;
+					ret.softPackets = kvp.second.as<uint32_t>();
+				}
+				else if (key == "hard_bytes") {
+					if (config.validateValue(LuaType::Number, kvp.second, key, prefix, true) == LuaType::Nil) continue;
+					ret.hardBytes = kvp.second.as<uint32_t>();
+				}
+			}
+
+			return ret;
+		}
+	};
+}
\ No newline at end of file
@@ -17,16 +17,21 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "Session.hpp"
 #include "Common/AbstractServer.hpp"
+#include "Common/BroadcastPacket.hpp"
 #include "Common/CommonHeader.hpp"
 #include "Common/CommonPacket.hpp"
 #include "Common/ConnectionManager.hpp"
+#include "Common/CustomCipher.hpp"
 #include "Common/Decoder.hpp"
 #include "Common/ExitCodes.hpp"
 #include "Common/Logger.hpp"
+#include "Common/OpcodeStats.hpp"
+#include "Common/PacketCapture.hpp"
 #include "Common/PacketBuilder.hpp"
 #include "Common/PacketHandler.hpp"
 #include "Common/PacketReader.hpp"
 #include "Common/Randomizer.hpp"
+#include "Common/SendBatch.hpp"
 #include "Common/TimeUtilities.hpp"
 #include <functional>
 #include <iostream>
@@ -38,11 +43,18 @@ Session::Session(
 	Handler handler) :
 	m_manager{manager},
 	m_socket{service},
+	m_strand{service},
 	m_handler{handler},
-	m_ip{0}
+	m_ip{0},
+	m_id{manager.nextSessionId()},
+	m_receiveBuffer{manager.getReceiveBufferPool().acquire()}
 {
 }
 
+Session::~Session() {
+	m_manager.getReceiveBufferPool().release(std::move(m_receiveBuffer));
+}
+
 auto Session::getSocket() -> asio::ip::tcp::socket & {
 	return m_socket;
 }
@@ -51,10 +63,6 @@ auto Session::getCodec() -> PacketTransformer & {
 	return *m_codec;
 }
 
-auto Session::getBuffer() -> MiscUtilities::shared_array<unsigned char> & {
-	return m_buffer;
-}
-
 auto Session::getLatency() const -> milliseconds_t {
 	return m_latency;
 }
@@ -68,6 +76,21 @@ auto Session::setType(ConnectionType type) -> void {
 	m_type = type;
 }
 
+auto Session::getStats() const -> SessionStats {
+	SessionStats stats;
+	stats.packetsSent = m_packetsSent.load(std::memory_order_relaxed);
+	stats.bytesSent = m_bytesSent.load(std::memory_order_relaxed);
+	stats.writes = m_writes.load(std::memory_order_relaxed);
+	stats.packetsReceived = m_packetsReceived.load(std::memory_order_relaxed);
+	stats.bytesReceived = m_bytesReceived.load(std::memory_order_relaxed);
+	stats.reads = m_reads.load(std::memory_order_relaxed);
+	stats.packetsDropped = m_packetsDropped.load(std::memory_order_relaxed);
+	stats.queuedBytes = m_queuedBytes.load(std::memory_order_relaxed);
+	stats.queuedPackets = m_queuedPackets.load(std::memory_order_relaxed);
+	stats.peakQueuedBytes = m_peakQueuedBytes.load(std::memory_order_relaxed);
+	return stats;
+}
+
 auto Session::ping() -> void {
 	if (m_pingCount == m_maxPingCount) {
 		// We have a timeout now
@@ -80,7 +103,7 @@ auto Session::ping() -> void {
 	send(Packets::ping());
 }
 
-auto Session::start(const PingConfig &ping, ref_ptr_t<PacketTransformer> transformer) -> void {
+auto Session::start(const PingConfig &ping, const SendLimitConfig &sendLimits, ref_ptr_t<PacketTransformer> transformer) -> void {
 	// TODO FIXME support IPv6
 	auto &addr = m_socket.remote_endpoint().address();
 	if (addr.is_v4()) {
@@ -93,7 +116,11 @@ auto Session::start(const PingConfig &ping, ref_ptr_t<PacketTransformer> transfo
 	if (ping.enable) {
 		m_maxPingCount = ping.timeoutPingCount;
 		Timer::Timer::create(
-			[this](const time_point_t &now) { this->ping(); },
+			[this](const time_point_t &now) {
+				// Ping state is shared with the packet handlers, so it's only touched from the handler strand
+				auto self = shared_from_this();
+				m_manager.postHandler([self] { self->ping(); });
+			},
 			Timer::Id{TimerType::PingTimer},
 			getTimers(),
 			ping.initialDelay,
@@ -101,132 +128,397 @@ auto Session::start(const PingConfig &ping, ref_ptr_t<PacketTransformer> transfo
 	}
 
 	m_codec = transformer;
+	{
+		owned_lock_t<mutex_t> l{m_sendMutex};
+		m_sendLimits = sendLimits;
+	}
+	m_isConnected = true;
 
-	m_handler->onConnectBase(shared_from_this());
+	auto self = shared_from_this();
+	m_manager.dispatchHandler([self] {
+		if (auto capture = self->getCapture()) {
+			capture->recordConnect(self->m_id, self->m_ip);
+		}
+		self->m_handler->onConnectBase(self);
+		self->m_strand.post([self] { self->startRead(); });
+	});
+}
 
+auto Session::startReplay(const Ip &ip, ref_ptr_t<PacketTransformer> transformer) -> void {
+	m_ip = ip;
+	m_type = ConnectionType::EndUser;
+	m_replaying = true;
+	m_codec = transformer;
 	m_isConnected = true;
-	startReadHeader();
+	m_manager.start(shared_from_this());
+
+	auto self = shared_from_this();
+	m_manager.dispatchHandler([self] {
+		self->m_handler->onConnectBase(self);
+	});
+}
+
+auto Session::getCapture() -> PacketCaptureWriter * {
+	if (m_replaying || m_type != ConnectionType::EndUser) {
+		return nullptr;
+	}
+	return m_manager.getCapture();
 }
 
 auto Session::syncRead(size_t minimumBytes) -> pair_t<asio::error_code, PacketReader> {
 	asio::error_code error;
 
-	m_buffer.reset(new unsigned char[MaxBufferLen]);
-
 	size_t packetSize = asio::read(m_socket,
-		asio::buffer(m_buffer.get(), MaxBufferLen),
+		asio::buffer(m_receiveBuffer.get(), ReceiveBufferLen),
 		asio::transfer_at_least(minimumBytes),
 		error);
 
-	return std::make_pair(error, PacketReader{m_buffer.get(), packetSize});
+	return std::make_pair(error, PacketReader{m_receiveBuffer.get(), packetSize});
 }
 
 auto Session::disconnect() -> void {
-	if (!m_isConnected) return;
-	m_handler->onDisconnectBase();
-	m_manager.stop(shared_from_this());
-	m_isConnected = false;
-
-	asio::error_code ec;
-	m_socket.close(ec);
-	if (ec) {
-		m_manager.getServer()->log(LogType::Error, [&](out_stream_t &str) {
-			str << "FAILURE TO CLOSE SESSION (" << ec.value() << "): " << ec.message();
-		});
-	}
+	if (!m_isConnected.exchange(false)) return;
+
+	// Disconnection may be requested from any thread, but the handler must be notified on the handler strand and the socket closed on ours
+	auto self = shared_from_this();
+	m_manager.dispatchHandler([self] {
+		if (auto capture = self->getCapture()) {
+			capture->recordDisconnect(self->m_id);
+		}
+		self->m_handler->onDisconnectBase();
+		self->m_manager.stop(self);
+	});
+
+	m_strand.post([self] {
+		asio::error_code ec;
+		self->m_socket.close(ec);
+		if (ec) {
+			self->m_manager.getServer()->log(LogType::Error, [&](out_stream_t &str) {
+				str << "FAILURE TO CLOSE SESSION (" << ec.value() << "): " << ec.message();
+			});
+		}
+	});
 }
 
 auto Session::send(const PacketBuilder &builder, bool encrypt) -> void {
-	send(builder.getBuffer(), builder.getSize(), encrypt);
+	if (encrypt) {
+		send(builder.getBuffer(), static_cast<int32_t>(builder.getSize()), *reinterpret_cast<const header_t *>(builder.getBuffer()), Encryption::Full, PacketPriority::Normal);
+	}
+	else {
+		// Unencrypted packets are only ever the connect handshake, which has no opcode
+		send(builder.getBuffer(), static_cast<int32_t>(builder.getSize()), 0, Encryption::None, PacketPriority::Normal);
+	}
 }
 
-auto Session::send(const unsigned char *buf, int32_t len, bool encrypt) -> void {
-	owned_lock_t<mutex_t> l{m_sendMutex};
+auto Session::send(const BroadcastPacket &packet) -> void {
+	header_t opcode = *reinterpret_cast<const header_t *>(packet.getBuffer());
+	if (m_codec->usesCustomEncryption()) {
+		send(packet.getPreparedBuffer(), packet.getSize(), opcode, Encryption::Prepared, packet.getPriority());
+	}
+	else {
+		send(packet.getBuffer(), packet.getSize(), opcode, Encryption::Full, packet.getPriority());
+	}
+}
 
-	unsigned char *sendBuffer;
-	size_t realLength = len;
+auto Session::send(const unsigned char *buf, int32_t len, header_t opcode, Encryption encryption, PacketPriority priority) -> void {
+	bool scheduleFlush = false;
+	bool exceededLimit = false;
+	{
+		owned_lock_t<mutex_t> l{m_sendMutex};
+		if (m_sendLimitExceeded) {
+			return;
+		}
 
-	if (encrypt) {
-		realLength += HeaderLen;
-		sendBuffer = new unsigned char[realLength];
-		m_sendPacket.reset(sendBuffer);
+		size_t headerLen = encryption != Encryption::None ? HeaderLen : 0;
+		size_t frameLen = headerLen + len;
+		uint64_t queuedBytes = m_queuedBytes.load(std::memory_order_relaxed);
+		uint64_t queuedPackets = m_queuedPackets.load(std::memory_order_relaxed);
+
+		if (priority == PacketPriority::Low) {
+			bool overSoftLimit =
+				(m_sendLimits.softBytes != 0 && queuedBytes >= m_sendLimits.softBytes) ||
+				(m_sendLimits.softPackets != 0 && queuedPackets >= m_sendLimits.softPackets);
+
+			if (overSoftLimit) {
+				// The client isn't keeping up, losing a movement or emote update is better than falling further behind
+				m_packetsDropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+		}
+
+		if (m_sendLimits.hardBytes != 0 && queuedBytes + frameLen > m_sendLimits.hardBytes) {
+			m_sendLimitExceeded = true;
+			exceededLimit = true;
+		}
+		else {
+			size_t offset = m_pendingBytes.size();
+			m_pendingBytes.resize(offset + frameLen);
+			memcpy(m_pendingBytes.data() + offset + headerLen, buf, len);
+			m_pendingPackets.push_back(OutboundPacket{offset, len, encryption});
+			if (encryption != Encryption::None) {
+				m_manager.getOpcodeStats().recordSent(opcode, len);
+			}
+
+			queuedBytes = m_queuedBytes.fetch_add(frameLen, std::memory_order_relaxed) + frameLen;
+			m_queuedPackets.fetch_add(1, std::memory_order_relaxed);
+			if (queuedBytes > m_peakQueuedBytes.load(std::memory_order_relaxed)) {
+				m_peakQueuedBytes.store(queuedBytes, std::memory_order_relaxed);
+			}
+
+			if (!m_flushPending) {
+				m_flushPending = true;
+				scheduleFlush = true;
+			}
+		}
+	}
+
+	if (exceededLimit) {
+		m_manager.getServer()->log(LogType::Warning, [&](out_stream_t &str) {
+			str << "Disconnecting " << m_ip << " for exceeding the outbound limit of " << m_sendLimits.hardBytes << " bytes";
+		});
+		m_manager.recordSendLimitDisconnect();
+		disconnect();
+		return;
+	}
 
-		memcpy(sendBuffer + HeaderLen, buf, len);
-		m_codec->setPacketHeader(sendBuffer, static_cast<uint16_t>(len));
-		m_codec->encryptPacket(sendBuffer + HeaderLen, len, HeaderLen);
+	if (!scheduleFlush) {
+		return;
+	}
+
+	if (SendBatch *batch = SendBatch::current()) {
+		batch->add(shared_from_this());
 	}
 	else {
-		sendBuffer = new unsigned char[realLength];
-		m_sendPacket.reset(sendBuffer);
+		flush();
+	}
+}
 
-		memcpy(sendBuffer, buf, len);
+auto Session::flush() -> void {
+	auto self = shared_from_this();
+	m_strand.post([self] { self->startWrite(); });
+}
+
+auto Session::startWrite() -> void {
+	if (m_writeInProgress) {
+		// Anything queued in the meantime goes out when the current write completes
+		return;
 	}
 
-	asio::async_write(m_socket, asio::buffer(sendBuffer, realLength),
-		std::bind(&Session::handleWrite, shared_from_this(),
+	{
+		owned_lock_t<mutex_t> l{m_sendMutex};
+		m_flushPending = false;
+		std::swap(m_pendingBytes, m_writeBytes);
+		std::swap(m_pendingPackets, m_writePackets);
+	}
+
+	if (m_writePackets.empty()) {
+		return;
+	}
+
+	// The custom layer doesn't depend on the IV, so every packet that needs it goes through it in one batch
+	if (m_codec->usesCustomEncryption()) {
+		m_cipherBatch.clear();
+		for (auto &packet : m_writePackets) {
+			if (packet.encryption == Encryption::Full) {
+				m_cipherBatch.push_back(CustomCipher::Packet{m_writeBytes.data() + packet.offset + HeaderLen, packet.length});
+				packet.encryption = Encryption::Prepared;
+			}
+		}
+		CustomCipher::encryptBatch(m_cipherBatch);
+	}
+
+	// The codec's send IV changes with every packet, so encryption happens here in the order packets were sent
+	for (const auto &packet : m_writePackets) {
+		if (packet.encryption == Encryption::None) {
+			continue;
+		}
+
+		unsigned char *header = m_writeBytes.data() + packet.offset;
+		m_codec->setPacketHeader(header, static_cast<uint16_t>(packet.length));
+		if (packet.encryption == Encryption::Prepared) {
+			m_codec->encryptPreparedPacket(header + HeaderLen, packet.length, HeaderLen);
+		}
+		else {
+			m_codec->encryptPacket(header + HeaderLen, packet.length, HeaderLen);
+		}
+	}
+
+	m_writeInProgress = true;
+	if (m_replaying) {
+		handleWrite(asio::error_code{}, m_writeBytes.size());
+		return;
+	}
+
+	asio::async_write(m_socket, asio::buffer(m_writeBytes.data(), m_writeBytes.size()),
+		m_strand.wrap(std::bind(&Session::handleWrite, shared_from_this(),
 			std::placeholders::_1,
-			std::placeholders::_2));
+			std::placeholders::_2)));
 }
 
-auto Session::startReadHeader() -> void {
-	m_buffer.reset(new unsigned char[HeaderLen]);
+auto Session::startRead() -> void {
+	if (!m_isConnected) return;
 
-	asio::async_read(m_socket,
-		asio::buffer(m_buffer.get(), HeaderLen),
-		std::bind(&Session::handleReadHeader, shared_from_this(),
+	m_socket.async_read_some(
+		asio::buffer(m_receiveBuffer.get() + m_receiveEnd, ReceiveBufferLen - m_receiveEnd),
+		m_strand.wrap(std::bind(&Session::handleRead, shared_from_this(),
 			std::placeholders::_1,
-			std::placeholders::_2));
+			std::placeholders::_2)));
 }
 
 auto Session::handleWrite(const asio::error_code &error, size_t bytesTransferred) -> void {
-	owned_lock_t<mutex_t> l{m_sendMutex};
+	m_writeInProgress = false;
+	m_queuedBytes.fetch_sub(m_writeBytes.size(), std::memory_order_relaxed);
+	m_queuedPackets.fetch_sub(m_writePackets.size(), std::memory_order_relaxed);
+	m_packetsSent.fetch_add(m_writePackets.size(), std::memory_order_relaxed);
+	m_bytesSent.fetch_add(bytesTransferred, std::memory_order_relaxed);
+	m_writes.fetch_add(1, std::memory_order_relaxed);
+
+	m_writePackets.clear();
+	if (m_writeBytes.capacity() > MaxRetainedSendCapacity) {
+		vector_t<unsigned char>{}.swap(m_writeBytes);
+	}
+	else {
+		m_writeBytes.clear();
+	}
+
 	if (error) {
 		disconnect();
+		return;
 	}
+
+	startWrite();
 }
 
-auto Session::handleReadHeader(const asio::error_code &error, size_t bytesTransferred) -> void {
+auto Session::handleRead(const asio::error_code &error, size_t bytesTransferred) -> void {
 	if (error) {
 		disconnect();
 		return;
 	}
 
-	// TODO FIXME
-	// Figure out how to distinguish between client versions and server versions, can use this after
-	//if (m_codec.testPacket(m_buffer.get()) == ValidityResult::Invalid) {
-	//	// Hacking or trying to crash server
-	//	disconnect();
-	//	return;
-	//}
+	m_receiveEnd += bytesTransferred;
+	m_bytesReceived.fetch_add(bytesTransferred, std::memory_order_relaxed);
+	m_reads.fetch_add(1, std::memory_order_relaxed);
+
+	// Decrypt every complete frame in the buffer, each one shuffles the receive IV for the next
+	size_t pos = 0;
+	bool batchCustomLayer = m_codec->usesCustomEncryption();
+	m_receivedFrames.clear();
+	m_cipherBatch.clear();
+	while (m_receiveEnd - pos >= HeaderLen) {
+		unsigned char *header = m_receiveBuffer.get() + pos;
+
+		// TODO FIXME
+		// Figure out how to distinguish between client versions and server versions, can use this after
+		//if (m_codec->testPacket(header) == ValidityResult::Invalid) {
+		//	// Hacking or trying to crash server
+		//	disconnect();
+		//	return;
+		//}
+
+		size_t len = m_codec->getPacketLength(header);
+		if (len < 2) {
+			// Hacking or trying to crash server
+			disconnect();
+			return;
+		}
+
+		if (m_receiveEnd - pos - HeaderLen < len) {
+			// Partial frame, the rest is still in flight
+			break;
+		}
 
-	size_t len = m_codec->getPacketLength(m_buffer.get());
-	if (len < 2) {
-		// Hacking or trying to crash server
-		disconnect();
+		if (batchCustomLayer) {
+			m_codec->decryptPreparedPacket(header + HeaderLen, len, HeaderLen);
+			m_cipherBatch.push_back(CustomCipher::Packet{header + HeaderLen, static_cast<int32_t>(len)});
+		}
+		else {
+			m_codec->decryptPacket(header + HeaderLen, len, HeaderLen);
+		}
+		m_receivedFrames.emplace_back(pos + HeaderLen, len);
+		pos += HeaderLen + len;
+	}
+
+	CustomCipher::decryptBatch(m_cipherBatch);
+
+	m_receiveConsumed = pos;
+	if (m_receivedFrames.empty()) {
+		compactReceiveBuffer();
+		startRead();
 		return;
 	}
 
-	m_buffer.reset(new unsigned char[len]);
+	m_packetsReceived.fetch_add(m_receivedFrames.size(), std::memory_order_relaxed);
+
+	// The next read isn't issued until the handlers are done, so the frames can be handed over in place
+	auto self = shared_from_this();
+	int32_t shard = getShard();
+	if (shard >= 0) {
+		m_manager.postShard(shard, [self, shard] {
+			// The handler may have moved to another shard while the frames were waiting
+			if (self->getShard() != shard) {
+				self->m_manager.postHandler([self] { self->handleReceivedFrames(); });
+				return;
+			}
+			self->handleReceivedFrames();
+		});
+	}
+	else {
+		m_manager.postHandler([self] { self->handleReceivedFrames(); });
+	}
+}
 
-	asio::async_read(m_socket,
-		asio::buffer(m_buffer.get(), len),
-		std::bind(&Session::handleReadBody, shared_from_this(),
-			std::placeholders::_1,
-			std::placeholders::_2));
+auto Session::getShard() const -> int32_t {
+	if (m_manager.getShardCount() == 0) {
+		return -1;
+	}
+
+	// Every frame in the batch has to agree, otherwise they'd be handled out of order
+	int32_t shard = -1;
+	for (const auto &frame : m_receivedFrames) {
+		if (frame.second < sizeof(header_t)) {
+			return -1;
+		}
+
+		header_t opcode = PacketReader{m_receiveBuffer.get() + frame.first, frame.second}.peek<header_t>();
+		int32_t frameShard = m_handler->getShard(opcode);
+		if (frameShard < 0 || (shard >= 0 && frameShard != shard)) {
+			return -1;
+		}
+		shard = frameShard;
+	}
+	return shard;
 }
 
-auto Session::handleReadBody(const asio::error_code &error, size_t bytesTransferred) -> void {
-	if (error) {
-		disconnect();
-		return;
+auto Session::handleReceivedFrames() -> void {
+	auto self = shared_from_this();
+	SendBatch batch;
+	PacketCaptureWriter *capture = getCapture();
+	for (const auto &frame : m_receivedFrames) {
+		if (!m_isConnected) break;
+		if (capture != nullptr) {
+			capture->recordPacket(m_id, m_receiveBuffer.get() + frame.first, frame.second);
+		}
+		PacketReader packet{m_receiveBuffer.get() + frame.first, frame.second};
+		baseHandleRequest(packet);
 	}
 
-	m_codec->decryptPacket(m_buffer.get(), bytesTransferred, HeaderLen);
+	m_strand.post([self] {
+		self->compactReceiveBuffer();
+		self->startRead();
+	});
+}
 
-	PacketReader packet{m_buffer.get(), bytesTransferred};
-	baseHandleRequest(packet);
+auto Session::compactReceiveBuffer() -> void {
+	if (m_receiveConsumed == 0) {
+		return;
+	}
 
-	startReadHeader();
+	size_t remaining = m_receiveEnd - m_receiveConsumed;
+	if (remaining > 0) {
+		memmove(m_receiveBuffer.get(), m_receiveBuffer.get() + m_receiveConsumed, remaining);
+	}
+	m_receiveEnd = remaining;
+	m_receiveConsumed = 0;
 }
 
 auto Session::getIp() const -> const Ip & {
@@ -234,6 +526,8 @@ auto Session::getIp() const -> const Ip & {
 }
 
 auto Session::baseHandleRequest(PacketReader &reader) -> void {
+	// Everything the handler sends, to this session or any other, is written once it's done
+	SendBatch batch;
 	try {
 		switch (reader.peek<header_t>()) {
 			case SMSG_PING:
@@ -253,7 +547,13 @@ auto Session::baseHandleRequest(PacketReader &reader) -> void {
 				break;
 		}
 
-		if (m_handler->handle(reader) == Result::Failure) {
+		header_t opcode = reader.peek<header_t>();
+		size_t bytes = reader.getBufferLength();
+		time_point_t start = TimeUtilities::getNow();
+		Result result = m_handler->handle(reader);
+		m_manager.getOpcodeStats().recordHandled(opcode, bytes, duration_cast<microseconds_t>(TimeUtilities::getNow() - start));
+
+		if (result == Result::Failure) {
 			disconnect();
 		}
 	}
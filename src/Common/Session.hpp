@@ -19,22 +19,28 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
 #include "Common/Decoder.hpp"
 #include "Common/ConnectionType.hpp"
+#include "Common/CustomCipher.hpp"
 #include "Common/Ip.hpp"
+#include "Common/PacketPriority.hpp"
 #include "Common/PacketTransformer.hpp"
 #include "Common/PingConfig.hpp"
-#include "Common/shared_array.hpp"
+#include "Common/SendLimitConfig.hpp"
+#include "Common/SessionStats.hpp"
 #include "Common/TimerContainerHolder.hpp"
 #include "Common/Types.hpp"
 #include <asio.hpp>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <queue>
 #include <string>
 
 namespace Vana {
+	class BroadcastPacket;
 	class ConnectionManager;
 	class PacketBuilder;
 	class PacketHandler;
+	class PacketCaptureWriter;
 	class PacketReader;
 	class Session;
 
@@ -47,34 +53,65 @@ namespace Vana {
 			asio::io_service &service,
 			ConnectionManager &manager,
 			Handler handler);
+		~Session();
 
 		auto disconnect() -> void;
 		auto send(const PacketBuilder &builder, bool encrypt = true) -> void;
+		auto send(const BroadcastPacket &packet) -> void;
 		auto getIp() const -> const Ip &;
 		auto getLatency() const -> milliseconds_t;
 		auto getType() const -> ConnectionType;
 		auto setType(ConnectionType type) -> void;
+		auto getStats() const -> SessionStats;
 	private:
 		static const size_t HeaderLen = 4;
 		static const size_t MaxBufferLen = 65535;
+		static const size_t ReceiveBufferLen = HeaderLen + MaxBufferLen;
+		static const size_t MaxRetainedSendCapacity = 262144;
+
+		enum class Encryption : uint8_t {
+			None,
+			Full,
+			// The custom layer has already been applied, see BroadcastPacket
+			Prepared,
+		};
+
+		struct OutboundPacket {
+			size_t offset;
+			int32_t length;
+			Encryption encryption;
+		};
 
 		auto syncRead(size_t minimumBytes) -> pair_t<asio::error_code, PacketReader>;
-		auto startReadHeader() -> void;
+		auto startRead() -> void;
+		auto flush() -> void;
+		auto startWrite() -> void;
 		auto handleWrite(const asio::error_code &error, size_t bytesTransferred) -> void;
-		auto handleReadHeader(const asio::error_code &error, size_t bytesTransferred) -> void;
-		auto handleReadBody(const asio::error_code &error, size_t bytesTransferred) -> void;
+		auto handleRead(const asio::error_code &error, size_t bytesTransferred) -> void;
+		auto compactReceiveBuffer() -> void;
+		auto getShard() const -> int32_t;
+		auto handleReceivedFrames() -> void;
 		auto getSocket() -> asio::ip::tcp::socket &;
 		auto getCodec() -> PacketTransformer &;
-		auto getBuffer() -> MiscUtilities::shared_array<unsigned char> &;
-		auto start(const PingConfig &ping, ref_ptr_t<PacketTransformer> transformer) -> void;
-		auto send(const unsigned char *buf, int32_t len, bool encrypt = true) -> void;
+		auto start(const PingConfig &ping, const SendLimitConfig &sendLimits, ref_ptr_t<PacketTransformer> transformer) -> void;
+		auto startReplay(const Ip &ip, ref_ptr_t<PacketTransformer> transformer) -> void;
+		auto getCapture() -> PacketCaptureWriter *;
+		// The opcode is passed separately because a prepared buffer has already been through the custom cipher layer
+		auto send(const unsigned char *buf, int32_t len, header_t opcode, Encryption encryption, PacketPriority priority) -> void;
 		auto ping() -> void;
 		auto baseHandleRequest(PacketReader &reader) -> void;
 
 		friend class ConnectionManager;
 		friend class ConnectionListener;
+		friend class PacketReplay;
+		friend class SendBatch;
 
-		bool m_isConnected = false;
+		std::atomic_bool m_isConnected{false};
+		bool m_flushPending = false;
+		bool m_writeInProgress = false;
+		bool m_sendLimitExceeded = false;
+		// Replayed sessions have no socket, packets come from a capture and everything sent is encrypted and discarded
+		bool m_replaying = false;
 		ConnectionType m_type = ConnectionType::Unknown;
 		int8_t m_pingCount = 0;
 		int32_t m_maxPingCount = 0;
@@ -82,11 +119,36 @@ namespace Vana {
 		time_point_t m_lastPing;
 		Handler m_handler;
 		Ip m_ip;
+		uint32_t m_id = 0;
 		ConnectionManager &m_manager;
 		asio::ip::tcp::socket m_socket;
-		MiscUtilities::shared_array<unsigned char> m_buffer;
-		MiscUtilities::shared_array<unsigned char> m_sendPacket;
+		asio::io_service::strand m_strand;
+		// Owned by the session strand except while received frames are being handled
+		owned_ptr_t<unsigned char[]> m_receiveBuffer;
+		size_t m_receiveEnd = 0;
+		size_t m_receiveConsumed = 0;
+		vector_t<pair_t<size_t, size_t>> m_receivedFrames;
 		ref_ptr_t<PacketTransformer> m_codec;
+		SendLimitConfig m_sendLimits;
 		mutex_t m_sendMutex;
+		// Guarded by m_sendMutex, filled by send
+		vector_t<unsigned char> m_pendingBytes;
+		vector_t<OutboundPacket> m_pendingPackets;
+		// Owned by the session strand, the batch currently being written
+		vector_t<unsigned char> m_writeBytes;
+		vector_t<OutboundPacket> m_writePackets;
+		// Owned by the session strand, scratch space for batching the custom cipher layer
+		vector_t<CustomCipher::Packet> m_cipherBatch;
+		std::atomic<uint64_t> m_packetsSent{0};
+		std::atomic<uint64_t> m_bytesSent{0};
+		std::atomic<uint64_t> m_writes{0};
+		std::atomic<uint64_t> m_packetsReceived{0};
+		std::atomic<uint64_t> m_bytesReceived{0};
+		std::atomic<uint64_t> m_reads{0};
+		std::atomic<uint64_t> m_packetsDropped{0};
+		// Everything queued that the socket hasn't accepted yet, pending or in flight
+		std::atomic<uint64_t> m_queuedBytes{0};
+		std::atomic<uint64_t> m_queuedPackets{0};
+		std::atomic<uint64_t> m_peakQueuedBytes{0};
 	};
 }
\ No newline at end of file
@@ -0,0 +1,35 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Types.hpp"
+
+namespace Vana {
+	struct SessionStats {
+		uint64_t packetsSent = 0;
+		uint64_t bytesSent = 0;
+		uint64_t writes = 0;
+		uint64_t packetsReceived = 0;
+		uint64_t bytesReceived = 0;
+		uint64_t reads = 0;
+		uint64_t packetsDropped = 0;
+		uint64_t queuedBytes = 0;
+		uint64_t queuedPackets = 0;
+		uint64_t peakQueuedBytes = 0;
+	};
+}
\ No newline at end of file
@@ -18,6 +18,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "ShopDataProvider.hpp"
 #include "Algorithm.hpp"
 #include "CommonHeader.hpp"
+#include "DataSnapshot.hpp"
 #include "Database.hpp"
 #include "GameLogicUtilities.hpp"
 #include "InitializeCommon.hpp"
@@ -43,10 +44,9 @@ auto ShopDataProvider::loadShops() -> void {
 	m_shops.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("shop_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("shop_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		ShopInfo shop;
 		shop_id_t shopId = row.get<shop_id_t>("shopid");
 		shop.npc = row.get<npc_id_t>("npcid");
@@ -54,9 +54,9 @@ auto ShopDataProvider::loadShops() -> void {
 		m_shops[shopId] = shop;
 	}
 
-	rs = (sql.prepare << "SELECT * FROM " << db.makeTable("shop_items") << " ORDER BY shopid, sort DESC");
+	rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("shop_items") + " ORDER BY shopid, sort DESC");
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		ShopItemInfo item;
 		shop_id_t shopId = row.get<shop_id_t>("shopid");
 		item.itemId = row.get<item_id_t>("itemid");
@@ -69,10 +69,9 @@ auto ShopDataProvider::loadShops() -> void {
 
 auto ShopDataProvider::loadUserShops() -> void {
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("user_shop_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("user_shop_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		ShopInfo shop;
 		shop_id_t shopId = row.get<shop_id_t>("shopid");
 		shop.npc = row.get<npc_id_t>("npcid");
@@ -84,9 +83,9 @@ auto ShopDataProvider::loadUserShops() -> void {
 		m_shops[shopId] = shop;
 	}
 
-	rs = (sql.prepare << "SELECT * FROM " << db.makeTable("user_shop_items") << " ORDER BY shopid, sort DESC");
+	rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("user_shop_items") + " ORDER BY shopid, sort DESC");
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		ShopItemInfo item;
 		shop_id_t shopId = row.get<shop_id_t>("shopid");
 		item.itemId = row.get<item_id_t>("itemid");
@@ -101,10 +100,9 @@ auto ShopDataProvider::loadRechargeTiers() -> void {
 	m_rechargeCosts.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("shop_recharge_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("shop_recharge_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		int8_t rechargeTier = row.get<int8_t>("tierid");
 		item_id_t itemId = row.get<item_id_t>("itemid");
 		double price = row.get<double>("price");
@@ -17,6 +17,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "SkillDataProvider.hpp"
 #include "Algorithm.hpp"
+#include "DataSnapshot.hpp"
 #include "Database.hpp"
 #include "InitializeCommon.hpp"
 #include "SkillConstants.hpp"
@@ -44,10 +45,9 @@ auto SkillDataProvider::loadPlayerSkills() -> void {
 	m_skillMaxLevels.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("skill_player_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("skill_player_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		skill_id_t skillId = row.get<skill_id_t>("skillid");
 
 		m_skillLevels[skillId] = hash_map_t<skill_level_t, SkillLevelInfo>();
@@ -57,10 +57,9 @@ auto SkillDataProvider::loadPlayerSkills() -> void {
 
 auto SkillDataProvider::loadPlayerSkillLevels() -> void {
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("skill_player_level_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("skill_player_level_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		SkillLevelInfo level;
 		skill_id_t skillId = row.get<skill_id_t>("skillid");
 		skill_level_t skillLevel = row.get<skill_level_t>("skill_level");
@@ -113,10 +112,9 @@ auto SkillDataProvider::loadMobSkills() -> void {
 	m_mobSkills.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("skill_mob_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("skill_mob_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		MobSkillLevelInfo mobLevel;
 		mob_skill_id_t skillId = row.get<mob_skill_id_t>("skillid");
 		mob_skill_level_t level = row.get<mob_skill_level_t>("skill_level");
@@ -143,10 +141,9 @@ auto SkillDataProvider::loadMobSkills() -> void {
 
 auto SkillDataProvider::loadMobSummons() -> void {
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("skill_mob_summons"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("skill_mob_summons"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		mob_skill_level_t level = row.get<mob_skill_level_t>("level");
 		mob_id_t mobId = row.get<mob_id_t>("mobid");
 
@@ -158,10 +155,9 @@ auto SkillDataProvider::loadBanishData() -> void {
 	m_banishInfo.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("skill_mob_banish_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("skill_mob_banish_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		BanishFieldInfo banish;
 		mob_id_t mobId = row.get<mob_id_t>("mobid");
 
@@ -177,10 +173,9 @@ auto SkillDataProvider::loadMorphs() -> void {
 	m_morphInfo.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("morph_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("morph_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		MorphInfo morph;
 		morph_id_t morphId = row.get<morph_id_t>("morphid");
 
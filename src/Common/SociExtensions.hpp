@@ -21,7 +21,11 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "Common/Types.hpp"
 #include "Common/UnixTime.hpp"
 #include <soci.h>
+#include <atomic>
+#include <sstream>
 #include <string>
+#include <tuple>
+#include <vector>
 
 namespace soci {
 	using UnixTime = Vana::UnixTime;
@@ -327,4 +331,168 @@ namespace soci {
 			}
 		}
 	};
+}
+
+namespace Vana {
+	// Binds every element of a tuple as a positional parameter, the statement refers to the elements so they have to outlive it
+	template <size_t Index, size_t Count>
+	struct ParameterBinder {
+		template <typename TRow>
+		static auto bind(soci::statement &st, const TRow &row) -> void {
+			st.exchange(soci::use(std::get<Index>(row)));
+			ParameterBinder<Index + 1, Count>::bind(st, row);
+		}
+	};
+
+	template <size_t Count>
+	struct ParameterBinder<Count, Count> {
+		template <typename TRow>
+		static auto bind(soci::statement &st, const TRow &row) -> void {
+		}
+	};
+
+	// Lets a Database hold prepared statements of any type
+	class CachedStatement {
+	public:
+		virtual ~CachedStatement() = default;
+	};
+
+	// Prepared once, then executed as often as needed with new parameter values
+	// The parameters are bound by position, in the order their placeholders appear in the query
+	template <typename ... TParams>
+	class PreparedStatement : public CachedStatement {
+		NONCOPYABLE(PreparedStatement);
+		NO_DEFAULT_CONSTRUCTOR(PreparedStatement);
+	public:
+		PreparedStatement(soci::session &sql, const string_t &query, bool returnsRows, std::atomic<uint64_t> &executions);
+
+		// Returns whether there's a row to read, statements that don't return rows always return false
+		auto execute(const TParams & ... params) -> bool;
+		// Moves on to the next row of the result
+		auto fetch() -> bool;
+		auto getRow() const -> const soci::row & { return m_row; }
+	private:
+		std::atomic<uint64_t> &m_executions;
+		tuple_t<TParams...> m_params;
+		soci::row m_row;
+		soci::statement m_statement;
+	};
+
+	template <typename ... TParams>
+	PreparedStatement<TParams...>::PreparedStatement(soci::session &sql, const string_t &query, bool returnsRows, std::atomic<uint64_t> &executions) :
+		m_executions(executions),
+		m_statement{sql}
+	{
+		m_statement.alloc();
+		m_statement.prepare(query);
+		ParameterBinder<0, sizeof...(TParams)>::bind(m_statement, m_params);
+		if (returnsRows) {
+			m_statement.exchange(soci::into(m_row));
+		}
+		m_statement.define_and_bind();
+	}
+
+	template <typename ... TParams>
+	auto PreparedStatement<TParams...>::execute(const TParams & ... params) -> bool {
+		m_params = tuple_t<TParams...>{params...};
+		m_executions++;
+		return m_statement.execute(true);
+	}
+
+	template <typename ... TParams>
+	auto PreparedStatement<TParams...>::fetch() -> bool {
+		return m_statement.fetch();
+	}
+
+	// Writes rows in chunks with multi-row INSERT statements, a chunk costs one round trip instead of one per row
+	// The values are given in the order the columns are listed in the statement, optional_t values are written as NULL when empty
+	template <typename ... TColumns>
+	class BulkInsert {
+		NONCOPYABLE(BulkInsert);
+	public:
+		// The statement is everything that comes before VALUES, e.g. "INSERT INTO items (a, b)"
+		// The suffix goes after the rows, e.g. for ON DUPLICATE KEY UPDATE
+		BulkInsert(soci::session &sql, const string_t &statement, size_t rowsPerChunk = DefaultRowsPerChunk, const string_t &suffix = "");
+
+		// Full chunks are written right away
+		auto add(const TColumns & ... values) -> void;
+		// Writes the rows that don't fill a chunk, call it once everything has been added
+		auto flush() -> void;
+		auto getRowsWritten() const -> size_t { return m_rowsWritten; }
+		auto getStatements() const -> size_t { return m_statements; }
+
+		static const size_t DefaultRowsPerChunk = 100;
+	private:
+		using row_t = tuple_t<TColumns...>;
+
+		auto buildQuery(size_t rows) const -> string_t;
+
+		size_t m_rowsPerChunk = DefaultRowsPerChunk;
+		size_t m_rowsWritten = 0;
+		size_t m_statements = 0;
+		soci::session &m_sql;
+		string_t m_statement;
+		string_t m_suffix;
+		string_t m_chunkQuery;
+		vector_t<row_t> m_rows;
+	};
+
+	template <typename ... TColumns>
+	BulkInsert<TColumns...>::BulkInsert(soci::session &sql, const string_t &statement, size_t rowsPerChunk, const string_t &suffix) :
+		m_rowsPerChunk{rowsPerChunk > 0 ? rowsPerChunk : 1},
+		m_sql{sql},
+		m_statement{statement},
+		m_suffix{suffix}
+	{
+		m_rows.reserve(m_rowsPerChunk);
+	}
+
+	template <typename ... TColumns>
+	auto BulkInsert<TColumns...>::add(const TColumns & ... values) -> void {
+		m_rows.emplace_back(values...);
+		if (m_rows.size() >= m_rowsPerChunk) {
+			flush();
+		}
+	}
+
+	template <typename ... TColumns>
+	auto BulkInsert<TColumns...>::flush() -> void {
+		if (m_rows.size() == 0) {
+			return;
+		}
+
+		// Every full chunk has the same text, only a short final chunk needs its own
+		if (m_rows.size() == m_rowsPerChunk && m_chunkQuery.empty()) {
+			m_chunkQuery = buildQuery(m_rowsPerChunk);
+		}
+
+		soci::statement st{m_sql};
+		st.alloc();
+		st.prepare(m_rows.size() == m_rowsPerChunk ? m_chunkQuery : buildQuery(m_rows.size()));
+		for (const auto &row : m_rows) {
+			ParameterBinder<0, sizeof...(TColumns)>::bind(st, row);
+		}
+		st.define_and_bind();
+		st.execute(true);
+
+		m_rowsWritten += m_rows.size();
+		m_statements++;
+		m_rows.clear();
+	}
+
+	template <typename ... TColumns>
+	auto BulkInsert<TColumns...>::buildQuery(size_t rows) const -> string_t {
+		out_stream_t query;
+		query << m_statement << " VALUES ";
+		size_t parameter = 0;
+		for (size_t row = 0; row < rows; ++row) {
+			query << (row == 0 ? "(" : ", (");
+			for (size_t column = 0; column < sizeof...(TColumns); ++column) {
+				query << (column == 0 ? ":v" : ", :v") << parameter++;
+			}
+			query << ")";
+		}
+		query << m_suffix;
+		return query.str();
+	}
 }
\ No newline at end of file
@@ -17,6 +17,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "SqlLogger.hpp"
 #include "Common/Database.hpp"
+#include "Common/ThreadPool.hpp"
+#include <algorithm>
+#include <iterator>
 
 namespace Vana {
 
@@ -29,6 +32,9 @@ SqlLogger::SqlLogger(const string_t &filename, const string_t &format, const str
 
 SqlLogger::~SqlLogger() {
 	flush();
+	if (m_writer.valid()) {
+		m_writer.wait();
+	}
 }
 
 auto SqlLogger::log(LogType type, const opt_string_t &identifier, const string_t &message) -> void {
@@ -44,36 +50,65 @@ auto SqlLogger::log(LogType type, const opt_string_t &identifier, const string_t
 }
 
 auto SqlLogger::flush() -> void {
-	if (m_buffer.size() > 0) {
-		auto &db = Database::getCharDb();
-		auto &sql = db.getSession();
-		server_type_t serverType = static_cast<server_type_t>(getServerType());
-		int32_t logType = 0;
-		opt_string_t identifier;
-		// For GCC, GCC doesn't interpret operators very well
-		identifier = "";
-		string_t message = "";
-		UnixTime logTime;
-
-		soci::statement st = (sql.prepare
-			<< "INSERT INTO " << db.makeTable("logs") << " (log_time, origin, info_type, identifier, message) "
-			<< "VALUES (:time, :origin, :infoType, :identifier, :message)",
-			soci::use(logTime, "time"),
-			soci::use(serverType, "origin"),
-			soci::use(logType, "infoType"),
-			soci::use(identifier, "identifier"),
-			soci::use(message, "message"));
-
-		for (const auto &bufferedMessage : m_buffer) {
-			logType = static_cast<int32_t>(bufferedMessage.type);
-			logTime = bufferedMessage.time;
-			identifier = bufferedMessage.identifier;
-			message = bufferedMessage.message;
-			st.execute(true);
-		}
+	if (m_buffer.empty()) {
+		return;
+	}
 
+	{
+		owned_lock_t<mutex_t> l{m_pendingMutex};
+		std::move(std::begin(m_buffer), std::end(m_buffer), std::back_inserter(m_pending));
 		m_buffer.clear();
+		if (m_writing) {
+			// The running task picks these up before it finishes
+			return;
+		}
+		m_writing = true;
+	}
+
+	m_writer = ThreadPool::submit([this] { writePending(); }, TaskPriority::Low);
+}
+
+auto SqlLogger::writePending() -> void {
+	while (true) {
+		vector_t<LogMessage> messages;
+		{
+			owned_lock_t<mutex_t> l{m_pendingMutex};
+			if (m_pending.empty()) {
+				m_writing = false;
+				return;
+			}
+			messages.swap(m_pending);
+		}
+
+		try {
+			write(messages);
+		}
+		catch (...) {
+			// The next flush starts a new task for whatever is still pending
+			owned_lock_t<mutex_t> l{m_pendingMutex};
+			m_writing = false;
+			throw;
+		}
+	}
+}
+
+auto SqlLogger::write(const vector_t<LogMessage> &messages) -> void {
+	auto &db = Database::getCharDb();
+	server_type_t serverType = static_cast<server_type_t>(getServerType());
+
+	BulkInsert<UnixTime, server_type_t, int32_t, opt_string_t, string_t> bulk{
+		db.getSession(),
+		"INSERT INTO " + db.makeTable("logs") + " (log_time, origin, info_type, identifier, message)"};
+
+	for (const auto &bufferedMessage : messages) {
+		bulk.add(
+			UnixTime{bufferedMessage.time},
+			serverType,
+			static_cast<int32_t>(bufferedMessage.type),
+			bufferedMessage.identifier,
+			bufferedMessage.message);
 	}
+	bulk.flush();
 }
 
 }
\ No newline at end of file
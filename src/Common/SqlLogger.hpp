@@ -18,6 +18,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #pragma once
 
 #include "Common/Logger.hpp"
+#include <future>
 #include <string>
 #include <vector>
 
@@ -28,9 +29,17 @@ namespace Vana {
 		~SqlLogger();
 
 		auto log(LogType type, const opt_string_t &identifier, const string_t &message) -> void override;
+		// Hands the buffer to a background task, batches are still inserted one after another
 		auto flush() -> void;
 	private:
+		auto writePending() -> void;
+		auto write(const vector_t<LogMessage> &messages) -> void;
+
+		bool m_writing = false;
 		size_t m_bufferSize;
 		vector_t<LogMessage> m_buffer;
+		vector_t<LogMessage> m_pending;
+		mutex_t m_pendingMutex;
+		std::future<void> m_writer;
 	};
 }
\ No newline at end of file
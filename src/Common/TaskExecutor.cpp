@@ -0,0 +1,211 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "TaskExecutor.hpp"
+#include "Common/TimeUtilities.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace Vana {
+
+thread_local TaskExecutor *TaskExecutor::s_currentExecutor = nullptr;
+thread_local size_t TaskExecutor::s_currentWorker = 0;
+
+TaskExecutor::TaskExecutor(size_t capacity, size_t workerCount) :
+	m_capacity{capacity},
+	m_workerCount{workerCount}
+{
+}
+
+TaskExecutor::~TaskExecutor() {
+	drain();
+}
+
+auto TaskExecutor::start() -> void {
+	owned_lock_t<mutex_t> l{m_startMutex};
+	if (m_started || m_stopping) {
+		return;
+	}
+
+	size_t workerCount = m_workerCount > 0 ?
+		m_workerCount :
+		std::max<size_t>(2, thread_t::hardware_concurrency());
+	for (size_t i = 0; i < workerCount; ++i) {
+		m_workers.push_back(make_owned_ptr<Worker>());
+	}
+	for (size_t i = 0; i < workerCount; ++i) {
+		m_workers[i]->thread = make_owned_ptr<thread_t>([this, i] { this->run(i); });
+	}
+	m_started = true;
+}
+
+auto TaskExecutor::submit(function_t<void()> work, TaskPriority priority) -> void {
+	if (!enqueue(work, priority)) {
+		// Running it here slows the caller down instead of letting the backlog grow without bound
+		m_ranInline++;
+		Task task{work, TimeUtilities::getNow()};
+		execute(task);
+	}
+}
+
+auto TaskExecutor::trySubmit(function_t<void()> work, TaskPriority priority) -> bool {
+	return enqueue(work, priority);
+}
+
+auto TaskExecutor::enqueue(function_t<void()> &work, TaskPriority priority) -> bool {
+	m_submitted++;
+	if (!m_started) {
+		start();
+	}
+
+	if (m_stopping || m_queued.load() >= m_capacity) {
+		return false;
+	}
+
+	// Counted before it's visible so a worker can never take more than is counted
+	size_t queued = ++m_queued;
+	size_t peak = m_peakQueued.load();
+	while (queued > peak && !m_peakQueued.compare_exchange_weak(peak, queued));
+
+	size_t index = s_currentExecutor == this ?
+		s_currentWorker :
+		m_nextWorker++ % m_workers.size();
+
+	Worker &worker = *m_workers[index];
+	{
+		owned_lock_t<mutex_t> l{worker.mutex};
+		worker.queues[static_cast<size_t>(priority)].push_back(Task{std::move(work), TimeUtilities::getNow()});
+	}
+
+	{
+		owned_lock_t<mutex_t> l{m_sleepMutex};
+	}
+	m_wake.notify_one();
+	return true;
+}
+
+auto TaskExecutor::take(size_t index, Task &task) -> bool {
+	size_t workerCount = m_workers.size();
+	for (size_t priority = 0; priority < PriorityCount; ++priority) {
+		for (size_t offset = 0; offset < workerCount; ++offset) {
+			Worker &worker = *m_workers[(index + offset) % workerCount];
+			owned_lock_t<mutex_t> l{worker.mutex};
+			auto &queue = worker.queues[priority];
+			if (queue.empty()) {
+				continue;
+			}
+
+			task = std::move(queue.front());
+			queue.pop_front();
+			m_queued--;
+			if (offset != 0) {
+				m_stolen++;
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+auto TaskExecutor::run(size_t index) -> void {
+	s_currentExecutor = this;
+	s_currentWorker = index;
+
+	Task task;
+	while (true) {
+		if (take(index, task)) {
+			execute(task);
+			continue;
+		}
+
+		owned_lock_t<mutex_t> l{m_sleepMutex};
+		m_wake.wait(l, [this] { return m_queued.load() > 0 || m_stopping; });
+		if (m_stopping && m_queued.load() == 0) {
+			break;
+		}
+	}
+}
+
+auto TaskExecutor::execute(Task &task) -> void {
+	time_point_t start = TimeUtilities::getNow();
+	record(m_totalWait, m_maxWait, duration_cast<microseconds_t>(start - task.queuedAt));
+
+	try {
+		task.work();
+	}
+	catch (std::exception &e) {
+		std::cerr << "TASK ERROR: " << e.what() << std::endl;
+	}
+
+	record(m_totalRun, m_maxRun, duration_cast<microseconds_t>(TimeUtilities::getNow() - start));
+	task.work = nullptr;
+	m_completed++;
+}
+
+auto TaskExecutor::record(std::atomic<uint64_t> &total, std::atomic<uint64_t> &max, microseconds_t elapsed) -> void {
+	uint64_t value = static_cast<uint64_t>(std::max<int64_t>(elapsed.count(), 0));
+	total.fetch_add(value, std::memory_order_relaxed);
+	uint64_t current = max.load(std::memory_order_relaxed);
+	while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed));
+}
+
+auto TaskExecutor::drain() -> void {
+	{
+		owned_lock_t<mutex_t> l{m_startMutex};
+		if (m_stopping) {
+			return;
+		}
+		m_stopping = true;
+	}
+
+	{
+		owned_lock_t<mutex_t> l{m_sleepMutex};
+	}
+	m_wake.notify_all();
+
+	for (auto &worker : m_workers) {
+		if (worker->thread != nullptr && worker->thread->joinable()) {
+			worker->thread->join();
+		}
+	}
+
+	// Anything that was still being submitted while the workers stopped runs here
+	if (m_workers.size() > 0) {
+		Task task;
+		while (take(0, task)) {
+			execute(task);
+		}
+	}
+}
+
+auto TaskExecutor::getStats() const -> Stats {
+	Stats stats;
+	stats.workers = m_started ? m_workers.size() : 0;
+	stats.queued = m_queued.load();
+	stats.peakQueued = m_peakQueued.load();
+	stats.submitted = m_submitted.load();
+	stats.completed = m_completed.load();
+	stats.stolen = m_stolen.load();
+	stats.ranInline = m_ranInline.load();
+	stats.totalWait = microseconds_t{m_totalWait.load()};
+	stats.maxWait = microseconds_t{m_maxWait.load()};
+	stats.totalRun = microseconds_t{m_totalRun.load()};
+	stats.maxRun = microseconds_t{m_maxRun.load()};
+	return stats;
+}
+
+}
\ No newline at end of file
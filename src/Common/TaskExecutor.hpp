@@ -0,0 +1,111 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Types.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Vana {
+	enum class TaskPriority : uint8_t {
+		High,
+		Normal,
+		Low,
+	};
+
+	// Runs short-lived background tasks (DB work, rankings, etc.) on a fixed set of workers
+	// Each worker has its own queues and idle workers steal from busy ones, higher priorities are always taken first
+	// Tasks aren't ordered relative to each other, work that has to happen in order belongs in a single task
+	class TaskExecutor {
+		NONCOPYABLE(TaskExecutor);
+		NO_DEFAULT_CONSTRUCTOR(TaskExecutor);
+	public:
+		struct Stats {
+			size_t workers = 0;
+			size_t queued = 0;
+			size_t peakQueued = 0;
+			uint64_t submitted = 0;
+			uint64_t completed = 0;
+			uint64_t stolen = 0;
+			// Tasks that found the queues full or the executor drained and ran on the caller instead
+			uint64_t ranInline = 0;
+			microseconds_t totalWait = microseconds_t{0};
+			microseconds_t maxWait = microseconds_t{0};
+			microseconds_t totalRun = microseconds_t{0};
+			microseconds_t maxRun = microseconds_t{0};
+		};
+
+		// 0 workers uses one per hardware thread
+		TaskExecutor(size_t capacity, size_t workerCount = 0);
+		~TaskExecutor();
+
+		auto submit(function_t<void()> work, TaskPriority priority) -> void;
+		// Like submit, but a full or drained executor turns the task away instead of running it on the caller
+		auto trySubmit(function_t<void()> work, TaskPriority priority) -> bool;
+		// Runs everything that's queued and stops the workers, anything submitted afterwards runs on the caller
+		auto drain() -> void;
+		auto getStats() const -> Stats;
+	private:
+		static const size_t PriorityCount = 3;
+
+		struct Task {
+			function_t<void()> work;
+			time_point_t queuedAt;
+		};
+
+		struct Worker {
+			mutex_t mutex;
+			std::deque<Task> queues[PriorityCount];
+			owned_ptr_t<thread_t> thread;
+		};
+
+		auto start() -> void;
+		auto enqueue(function_t<void()> &work, TaskPriority priority) -> bool;
+		auto run(size_t index) -> void;
+		auto take(size_t index, Task &task) -> bool;
+		auto execute(Task &task) -> void;
+		auto record(std::atomic<uint64_t> &total, std::atomic<uint64_t> &max, microseconds_t elapsed) -> void;
+
+		const size_t m_capacity;
+		const size_t m_workerCount;
+		std::atomic_bool m_started{false};
+		std::atomic_bool m_stopping{false};
+		std::atomic<size_t> m_nextWorker{0};
+		std::atomic<size_t> m_queued{0};
+		std::atomic<size_t> m_peakQueued{0};
+		std::atomic<uint64_t> m_submitted{0};
+		std::atomic<uint64_t> m_completed{0};
+		std::atomic<uint64_t> m_stolen{0};
+		std::atomic<uint64_t> m_ranInline{0};
+		std::atomic<uint64_t> m_totalWait{0};
+		std::atomic<uint64_t> m_maxWait{0};
+		std::atomic<uint64_t> m_totalRun{0};
+		std::atomic<uint64_t> m_maxRun{0};
+		vector_t<owned_ptr_t<Worker>> m_workers;
+		mutex_t m_startMutex;
+		mutex_t m_sleepMutex;
+		std::condition_variable m_wake;
+
+		static thread_local TaskExecutor *s_currentExecutor;
+		static thread_local size_t s_currentWorker;
+	};
+}
\ No newline at end of file
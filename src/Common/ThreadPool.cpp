@@ -22,5 +22,6 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 namespace Vana {
 
 ThreadPool::_impl ThreadPool::s_pool{};
+TaskExecutor ThreadPool::s_tasks{ThreadPool::TaskCapacity};
 
 }
\ No newline at end of file
@@ -17,8 +17,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #pragma once
 
+#include "Common/TaskExecutor.hpp"
 #include "Common/Types.hpp"
 #include <atomic>
+#include <future>
 #include <thread>
 
 namespace Vana {
@@ -32,10 +34,28 @@ namespace Vana {
 			return s_pool.lease(work, preWaitHook, mutex);
 		}
 
+		// Runs func on one of the task workers, the future carries its result or exception
+		template <typename TFunc>
+		static auto submit(TFunc func, TaskPriority priority = TaskPriority::Normal) -> std::future<decltype(func())> {
+			using result_t = decltype(func());
+			auto task = make_ref_ptr<std::packaged_task<result_t()>>(std::move(func));
+			auto future = task->get_future();
+			s_tasks.submit([task] { (*task)(); }, priority);
+			return future;
+		}
+
+		static auto getTaskStats() -> TaskExecutor::Stats {
+			return s_tasks.getStats();
+		}
+
+		// Queued tasks finish before the leased threads are stopped
 		static auto wait() -> void {
+			s_tasks.drain();
 			s_pool.wait();
 		}
 	private:
+		static const size_t TaskCapacity = 8192;
+
 		struct ThreadPair {
 			ref_ptr_t<thread_t> thread;
 			function_t<void()> preWaitHook;
@@ -89,5 +109,6 @@ namespace Vana {
 		};
 
 		static _impl s_pool;
+		static TaskExecutor s_tasks;
 	};
 }
\ No newline at end of file
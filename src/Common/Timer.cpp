@@ -43,6 +43,12 @@ Timer::Timer(const timer_func_t func, const Id &id, ref_ptr_t<Container> contain
 	m_runAt = TimeUtilities::getNowWithTimeAdded(differenceFromNow);
 }
 
+Timer::~Timer() {
+	if (m_node != nullptr) {
+		TimerThread::getInstance().unregisterTimer(this);
+	}
+}
+
 auto Timer::removeFromContainer() const -> void {
 	if (ref_ptr_t<Container> container = m_container.lock()) {
 		container->removeTimer(m_id);
@@ -20,6 +20,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "Common/TimerId.hpp"
 #include "Common/TimerType.hpp"
 #include "Common/Types.hpp"
+#include <atomic>
 #include <ctime>
 #include <functional>
 #include <memory>
@@ -35,12 +36,15 @@ namespace Vana {
 
 		class Container;
 		class Thread;
+		class TimerWheel;
+		struct WheelNode;
 
 		class Timer {
 			NONCOPYABLE(Timer);
 			NO_DEFAULT_CONSTRUCTOR(Timer);
 		public:
 			Timer(const timer_func_t func, const Id &id, ref_ptr_t<Container> container, const duration_t &differenceFromNow, const duration_t &repeat);
+			~Timer();
 			static auto create(const timer_func_t func, const Id &id, ref_ptr_t<Container> container, const duration_t &differenceFromNow, const duration_t &repeat = seconds_t{0}) -> void;
 
 			auto getTimeLeft() const -> duration_t;
@@ -48,12 +52,16 @@ namespace Vana {
 			auto reset(const time_point_t &now) -> time_point_t;
 			auto removeFromContainer() const -> void;
 		private:
+			friend class TimerWheel;
+
 			Id m_id;
 			view_ptr_t<Container> m_container;
 			time_point_t m_runAt;
 			bool m_repeat;
 			duration_t m_repeatTime;
 			timer_func_t m_function;
+			// Set while the timer is queued in a TimerWheel so it can be unlinked as soon as the timer goes away
+			std::atomic<WheelNode *> m_node{nullptr};
 		};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,62 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "TimerHeap.hpp"
+#include "Common/Timer.hpp"
+#include "Common/TimeUtilities.hpp"
+
+namespace Vana {
+namespace Timer {
+
+auto TimerHeap::add(ref_ptr_t<Timer> timer, time_point_t runAt) -> void {
+	m_timers.emplace(runAt, timer);
+}
+
+auto TimerHeap::remove(Timer *timer) -> void {
+	// Nothing to do, the expired entry is popped when it comes up
+}
+
+auto TimerHeap::popDue(const time_point_t &now) -> ref_ptr_t<Timer> {
+	while (m_timers.size() > 0 && m_timers.top().first <= now) {
+		ref_ptr_t<Timer> timer = m_timers.top().second.lock();
+		m_timers.pop();
+		if (timer != nullptr) {
+			return timer;
+		}
+	}
+	return nullptr;
+}
+
+auto TimerHeap::getNextRunTime(const time_point_t &now) const -> time_point_t {
+	if (m_timers.size() > 0) {
+		return m_timers.top().first;
+	}
+
+	return TimeUtilities::getNowWithTimeAdded(milliseconds_t{1000000000});
+}
+
+auto TimerHeap::drain(vector_t<pair_t<time_point_t, ref_ptr_t<Timer>>> &timers) -> void {
+	while (m_timers.size() > 0) {
+		if (ref_ptr_t<Timer> timer = m_timers.top().second.lock()) {
+			timers.emplace_back(m_timers.top().first, timer);
+		}
+		m_timers.pop();
+	}
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/TimerQueue.hpp"
+#include "Common/Types.hpp"
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace Vana {
+	namespace Timer {
+		// Binary heap ordered by run time
+		// Cancelled timers aren't looked for, they're dropped once they reach the top
+		class TimerHeap : public TimerQueue {
+		public:
+			auto add(ref_ptr_t<Timer> timer, time_point_t runAt) -> void override;
+			auto remove(Timer *timer) -> void override;
+			auto popDue(const time_point_t &now) -> ref_ptr_t<Timer> override;
+			auto getNextRunTime(const time_point_t &now) const -> time_point_t override;
+			auto drain(vector_t<pair_t<time_point_t, ref_ptr_t<Timer>>> &timers) -> void override;
+		private:
+			using timer_pair_t = pair_t<time_point_t, view_ptr_t<Timer>>;
+
+			struct FindClosestTimer {
+				auto operator()(const timer_pair_t &t1, const timer_pair_t &t2) const -> bool {
+					return t1.first > t2.first;
+				}
+			};
+
+			std::priority_queue<timer_pair_t, vector_t<timer_pair_t>, FindClosestTimer> m_timers;
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Types.hpp"
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace Vana {
+	namespace Timer {
+		class Timer;
+
+		// Holds the timers TimerThread is waiting on, every call is made with the TimerThread lock held
+		class TimerQueue {
+		public:
+			virtual ~TimerQueue() = default;
+
+			virtual auto add(ref_ptr_t<Timer> timer, time_point_t runAt) -> void = 0;
+			// Called by the Timer destructor when the timer is still queued
+			virtual auto remove(Timer *timer) -> void = 0;
+			// Hands out the timers due by now one at a time, nullptr means there's nothing left to run
+			virtual auto popDue(const time_point_t &now) -> ref_ptr_t<Timer> = 0;
+			virtual auto getNextRunTime(const time_point_t &now) const -> time_point_t = 0;
+			// Empties the queue so the live timers can be moved to another queue
+			virtual auto drain(vector_t<pair_t<time_point_t, ref_ptr_t<Timer>>> &timers) -> void = 0;
+		};
+	}
+}
\ No newline at end of file
@@ -16,9 +16,12 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "TimerThread.hpp"
+#include "Common/SendBatch.hpp"
 #include "Common/ThreadPool.hpp"
 #include "Common/Timer.hpp"
 #include "Common/TimerContainer.hpp"
+#include "Common/TimerHeap.hpp"
+#include "Common/TimerWheel.hpp"
 #include "Common/TimeUtilities.hpp"
 #include <chrono>
 #include <functional>
@@ -28,35 +31,39 @@ namespace Timer {
 
 TimerThread::TimerThread()
 {
+	m_timers = make_owned_ptr<TimerHeap>();
 	m_container = make_ref_ptr<Container>();
 	m_thread = ThreadPool::lease(
 		[this](owned_lock_t<recursive_mutex_t> &lock) {
-			time_point_t waitTime = getWaitTime();
 			time_point_t now = TimeUtilities::getNow();
 
-			while (waitTime <= now && m_timers.size() > 0) {
-				timer_pair_t top = m_timers.top();
-
-				if (ref_ptr_t<Timer> timer = top.second.lock()) {
-					m_timers.pop();
-
-					if (timer->run(now) == RunResult::Reset) {
-						m_timers.emplace(timer->reset(now), timer);
-					}
-					else {
-						timer->removeFromContainer();
-					}
+			if (m_dispatcher != nullptr) {
+				// Only weak references are handed over, a timer that's removed before the batch runs is skipped
+				vector_t<view_ptr_t<Timer>> due;
+				while (ref_ptr_t<Timer> timer = m_timers->popDue(now)) {
+					due.push_back(timer);
+				}
 
-					waitTime = getWaitTime();
+				if (due.size() > 0) {
+					m_dispatcher([this, due, now] {
+						SendBatch batch;
+						for (const auto &weakTimer : due) {
+							if (ref_ptr_t<Timer> timer = weakTimer.lock()) {
+								runTimer(timer, now);
+							}
+						}
+					});
 				}
-				else {
-					// Expired timer
-					m_timers.pop();
-					continue;
+			}
+			else {
+				// Packets sent by every timer due this tick are written together
+				SendBatch batch;
+				while (ref_ptr_t<Timer> timer = m_timers->popDue(now)) {
+					runTimer(timer, now);
 				}
 			}
 
-			m_mainLoopCondition.wait_until(lock, waitTime);
+			m_mainLoopCondition.wait_until(lock, m_timers->getNextRunTime(now));
 		},
 		[this] {
 			m_mainLoopCondition.notify_one();
@@ -66,6 +73,8 @@ TimerThread::TimerThread()
 
 TimerThread::~TimerThread() {
 	m_thread.reset();
+	// The wheel lets go of the timers first so the ones that outlive it don't come back here
+	m_timers.reset();
 }
 
 auto TimerThread::getTimerContainer() const -> ref_ptr_t<Container> {
@@ -74,16 +83,51 @@ auto TimerThread::getTimerContainer() const -> ref_ptr_t<Container> {
 
 auto TimerThread::registerTimer(ref_ptr_t<Timer> timer, time_point_t runAt) -> void {
 	owned_lock_t<recursive_mutex_t> l{m_timersMutex};
-	m_timers.emplace(runAt, timer);
+	m_timers->add(timer, runAt);
 	m_mainLoopCondition.notify_one();
 }
 
-auto TimerThread::getWaitTime() const -> time_point_t {
-	if (m_timers.size() > 0) {
-		return m_timers.top().first;
+auto TimerThread::runTimer(ref_ptr_t<Timer> timer, const time_point_t &now) -> void {
+	if (timer->run(now) == RunResult::Reset) {
+		registerTimer(timer, timer->reset(now));
+	}
+	else {
+		timer->removeFromContainer();
 	}
+}
 
-	return TimeUtilities::getNowWithTimeAdded(milliseconds_t{1000000000});
+auto TimerThread::unregisterTimer(Timer *timer) -> void {
+	owned_lock_t<recursive_mutex_t> l{m_timersMutex};
+	if (m_timers != nullptr) {
+		m_timers->remove(timer);
+	}
+}
+
+auto TimerThread::useTimerWheel(bool useWheel) -> void {
+	owned_lock_t<recursive_mutex_t> l{m_timersMutex};
+	if (useWheel == m_usingWheel) {
+		return;
+	}
+
+	vector_t<pair_t<time_point_t, ref_ptr_t<Timer>>> timers;
+	m_timers->drain(timers);
+	if (useWheel) {
+		m_timers = make_owned_ptr<TimerWheel>();
+	}
+	else {
+		m_timers = make_owned_ptr<TimerHeap>();
+	}
+	m_usingWheel = useWheel;
+
+	for (const auto &timer : timers) {
+		m_timers->add(timer.second, timer.first);
+	}
+	m_mainLoopCondition.notify_one();
+}
+
+auto TimerThread::setDispatcher(dispatcher_t dispatcher) -> void {
+	owned_lock_t<recursive_mutex_t> l{m_timersMutex};
+	m_dispatcher = dispatcher;
 }
 
 }
@@ -17,13 +17,13 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #pragma once
 
+#include "Common/TimerQueue.hpp"
 #include "Common/Types.hpp"
 #include <atomic>
 #include <condition_variable>
 #include <map>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -33,24 +33,27 @@ namespace Vana {
 		class Container;
 		class Timer;
 
+		// Hands timer callbacks to whatever should run them, e.g. a strand
+		using dispatcher_t = function_t<void(function_t<void()>)>;
+
 		class TimerThread {
 			SINGLETON(TimerThread);
 		public:
 			~TimerThread();
 			auto getTimerContainer() const -> ref_ptr_t<Container>;
 			auto registerTimer(ref_ptr_t<Timer> timer, time_point_t runAt) -> void;
+			auto unregisterTimer(Timer *timer) -> void;
+			// Switches between the timing wheel and the priority queue, timers already waiting are moved over
+			auto useTimerWheel(bool useWheel) -> void;
+			// With a dispatcher the thread only keeps time, every batch of due timers is passed to the dispatcher to run
+			// Without one the callbacks run on the timer thread itself
+			auto setDispatcher(dispatcher_t dispatcher) -> void;
 		private:
-			auto getWaitTime() const -> time_point_t;
-
-			using timer_pair_t = pair_t<time_point_t, view_ptr_t<Timer>>;
-
-			struct FindClosestTimer {
-				auto operator()(const timer_pair_t &t1, const timer_pair_t &t2) const -> bool {
-					return t1.first > t2.first;
-				}
-			};
+			auto runTimer(ref_ptr_t<Timer> timer, const time_point_t &now) -> void;
 
-			std::priority_queue<timer_pair_t, vector_t<timer_pair_t>, FindClosestTimer> m_timers;
+			bool m_usingWheel = false;
+			dispatcher_t m_dispatcher;
+			owned_ptr_t<TimerQueue> m_timers;
 			std::condition_variable_any m_mainLoopCondition;
 			recursive_mutex_t m_timersMutex;
 			ref_ptr_t<thread_t> m_thread;
@@ -42,5 +42,8 @@ namespace Vana {
 		TradeTimer,
 		WeatherTimer,
 		FinalizeTimer,
+		StatsTimer,
+		SaveTimer,
+		FlushTimer,
 	};
 }
\ No newline at end of file
@@ -0,0 +1,274 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "TimerWheel.hpp"
+#include "Common/Timer.hpp"
+#include "Common/TimeUtilities.hpp"
+#include <algorithm>
+
+namespace Vana {
+namespace Timer {
+
+TimerWheel::TimerWheel() :
+	m_tickLength{duration_cast<duration_t>(milliseconds_t{10})},
+	m_start{TimeUtilities::getNow()}
+{
+	m_firstLevel.fill(nullptr);
+	for (auto &level : m_levels) {
+		level.fill(nullptr);
+	}
+}
+
+TimerWheel::~TimerWheel() {
+	// Timers can outlive the wheel, they must not try to unlink themselves from it afterwards
+	forEachNode([](WheelNode *node) {
+		node->owner->m_node = nullptr;
+	});
+}
+
+template <typename TFunc>
+auto TimerWheel::forEachNode(TFunc func) -> void {
+	auto walk = [&func](WheelNode *node) {
+		while (node != nullptr) {
+			WheelNode *next = node->next;
+			func(node);
+			node = next;
+		}
+	};
+
+	walk(m_due);
+	for (WheelNode *head : m_firstLevel) {
+		walk(head);
+	}
+	for (const auto &level : m_levels) {
+		for (WheelNode *head : level) {
+			walk(head);
+		}
+	}
+}
+
+auto TimerWheel::add(ref_ptr_t<Timer> timer, time_point_t runAt) -> void {
+	if (timer->m_node != nullptr) {
+		remove(timer.get());
+	}
+
+	if (m_count == 0) {
+		// Nothing is waiting, so skip straight to the present instead of turning through the idle ticks
+		m_currentTick = std::max(m_currentTick, tickOf(TimeUtilities::getNow()));
+	}
+
+	WheelNode *node = acquireNode();
+	node->timer = timer;
+	node->owner = timer.get();
+	node->runAt = runAt;
+	node->tick = tickOf(runAt);
+	if (timeOf(node->tick) < runAt) {
+		// Never run early
+		node->tick++;
+	}
+
+	timer->m_node = node;
+	link(node);
+	m_count++;
+}
+
+auto TimerWheel::remove(Timer *timer) -> void {
+	WheelNode *node = timer->m_node;
+	if (node == nullptr) {
+		return;
+	}
+
+	if (node->prev != nullptr) {
+		unlink(node);
+		m_count--;
+	}
+	timer->m_node = nullptr;
+	releaseNode(node);
+}
+
+auto TimerWheel::popDue(const time_point_t &now) -> ref_ptr_t<Timer> {
+	uint64_t nowTick = tickOf(now);
+	for (advance(nowTick); m_due != nullptr; advance(nowTick)) {
+		WheelNode *node = m_due;
+		unlink(node);
+		m_count--;
+
+		// A timer that can't be locked is in its destructor, it isn't waiting on the node anymore once it's cleared here
+		ref_ptr_t<Timer> timer = node->timer.lock();
+		node->owner->m_node = nullptr;
+		releaseNode(node);
+		if (timer != nullptr) {
+			return timer;
+		}
+	}
+	return nullptr;
+}
+
+auto TimerWheel::getNextRunTime(const time_point_t &now) const -> time_point_t {
+	if (m_due != nullptr) {
+		return now;
+	}
+	if (m_count == 0) {
+		return TimeUtilities::getNowWithTimeAdded(milliseconds_t{1000000000});
+	}
+
+	// Wake up for the next occupied slot on the first level or for the next cascade, whichever comes first
+	const uint64_t mask = firstLevelSlots - 1;
+	uint64_t tick = m_currentTick;
+	while ((tick & mask) != 0 && m_firstLevel[tick & mask] == nullptr) {
+		tick++;
+	}
+	return timeOf(tick);
+}
+
+auto TimerWheel::drain(vector_t<pair_t<time_point_t, ref_ptr_t<Timer>>> &timers) -> void {
+	forEachNode([&](WheelNode *node) {
+		if (ref_ptr_t<Timer> timer = node->timer.lock()) {
+			timers.emplace_back(node->runAt, timer);
+		}
+		node->owner->m_node = nullptr;
+		unlink(node);
+		releaseNode(node);
+	});
+	m_count = 0;
+}
+
+auto TimerWheel::tickOf(const time_point_t &time) const -> uint64_t {
+	if (time <= m_start) {
+		return 0;
+	}
+	return static_cast<uint64_t>((time - m_start) / m_tickLength);
+}
+
+auto TimerWheel::timeOf(uint64_t tick) const -> time_point_t {
+	return m_start + m_tickLength * static_cast<duration_t::rep>(tick);
+}
+
+auto TimerWheel::link(WheelNode *node) -> void {
+	WheelNode **head = nullptr;
+	if (node->tick < m_currentTick) {
+		head = &m_due;
+	}
+	else if (node->tick - m_currentTick < firstLevelSlots) {
+		head = &m_firstLevel[node->tick & (firstLevelSlots - 1)];
+	}
+	else {
+		uint64_t delta = node->tick - m_currentTick;
+		uint64_t tick = node->tick;
+		size_t level = 0;
+		size_t shift = firstLevelBits;
+		while (level < levelCount - 1 && delta >= (uint64_t{1} << (shift + levelBits))) {
+			level++;
+			shift += levelBits;
+		}
+		if (delta >= (uint64_t{1} << (shift + levelBits))) {
+			// Further out than the wheel reaches, park it in the furthest slot and let the cascades bring it around again
+			tick = m_currentTick + (uint64_t{1} << (shift + levelBits)) - 1;
+		}
+		head = &m_levels[level][(tick >> shift) & (levelSlots - 1)];
+	}
+
+	node->next = *head;
+	if (node->next != nullptr) {
+		node->next->prev = &node->next;
+	}
+	node->prev = head;
+	*head = node;
+}
+
+auto TimerWheel::unlink(WheelNode *node) -> void {
+	if (node->prev == nullptr) {
+		return;
+	}
+
+	*node->prev = node->next;
+	if (node->next != nullptr) {
+		node->next->prev = node->prev;
+	}
+	node->next = nullptr;
+	node->prev = nullptr;
+}
+
+auto TimerWheel::cascade(size_t level, size_t slot) -> void {
+	WheelNode *node = m_levels[level][slot];
+	m_levels[level][slot] = nullptr;
+	while (node != nullptr) {
+		WheelNode *next = node->next;
+		node->next = nullptr;
+		node->prev = nullptr;
+		link(node);
+		node = next;
+	}
+}
+
+auto TimerWheel::advance(uint64_t toTick) -> void {
+	while (m_due == nullptr && m_currentTick <= toTick) {
+		if (m_count == 0) {
+			m_currentTick = toTick + 1;
+			return;
+		}
+
+		size_t slot = m_currentTick & (firstLevelSlots - 1);
+		if (slot == 0) {
+			// The first level came around, pull the next slot of each level down as far as it has wrapped
+			size_t shift = firstLevelBits;
+			for (size_t level = 0; level < levelCount; level++) {
+				size_t levelSlot = (m_currentTick >> shift) & (levelSlots - 1);
+				cascade(level, levelSlot);
+				if (levelSlot != 0) {
+					break;
+				}
+				shift += levelBits;
+			}
+		}
+
+		WheelNode *head = m_firstLevel[slot];
+		if (head != nullptr) {
+			m_firstLevel[slot] = nullptr;
+			head->prev = &m_due;
+			m_due = head;
+		}
+		m_currentTick++;
+	}
+}
+
+auto TimerWheel::acquireNode() -> WheelNode * {
+	if (m_freeNodes == nullptr) {
+		owned_ptr_t<WheelNode[]> chunk{new WheelNode[nodesPerChunk]};
+		for (size_t i = 0; i < nodesPerChunk; i++) {
+			chunk[i].next = m_freeNodes;
+			m_freeNodes = &chunk[i];
+		}
+		m_chunks.push_back(std::move(chunk));
+	}
+
+	WheelNode *node = m_freeNodes;
+	m_freeNodes = node->next;
+	node->next = nullptr;
+	return node;
+}
+
+auto TimerWheel::releaseNode(WheelNode *node) -> void {
+	node->timer.reset();
+	node->owner = nullptr;
+	node->prev = nullptr;
+	node->next = m_freeNodes;
+	m_freeNodes = node;
+}
+
+}
+}
\ No newline at end of file
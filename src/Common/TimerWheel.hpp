@@ -0,0 +1,85 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/TimerQueue.hpp"
+#include "Common/Types.hpp"
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace Vana {
+	namespace Timer {
+		// Entry for one queued timer, the timer keeps a pointer to it so it can be unlinked directly
+		struct WheelNode {
+			view_ptr_t<Timer> timer;
+			// Still valid while the timer is being destroyed, unlike timer
+			Timer *owner = nullptr;
+			time_point_t runAt;
+			uint64_t tick = 0;
+			WheelNode *next = nullptr;
+			// Points at whatever points at this node, nullptr when the node isn't in a list
+			WheelNode **prev = nullptr;
+		};
+
+		// Hierarchical timing wheel, insert and cancel are constant time
+		// The first level holds the next 256 ticks one slot each, every level after that covers 64 times the span of the one before
+		// Slots of the upper levels are spread over the lower levels as the wheel turns
+		class TimerWheel : public TimerQueue {
+			NONCOPYABLE(TimerWheel);
+		public:
+			TimerWheel();
+			~TimerWheel();
+
+			auto add(ref_ptr_t<Timer> timer, time_point_t runAt) -> void override;
+			auto remove(Timer *timer) -> void override;
+			auto popDue(const time_point_t &now) -> ref_ptr_t<Timer> override;
+			auto getNextRunTime(const time_point_t &now) const -> time_point_t override;
+			auto drain(vector_t<pair_t<time_point_t, ref_ptr_t<Timer>>> &timers) -> void override;
+		private:
+			static const size_t firstLevelBits = 8;
+			static const size_t levelBits = 6;
+			static const size_t levelCount = 4;
+			static const size_t firstLevelSlots = 1 << firstLevelBits;
+			static const size_t levelSlots = 1 << levelBits;
+			static const size_t nodesPerChunk = 1024;
+
+			auto tickOf(const time_point_t &time) const -> uint64_t;
+			auto timeOf(uint64_t tick) const -> time_point_t;
+			auto link(WheelNode *node) -> void;
+			auto unlink(WheelNode *node) -> void;
+			auto cascade(size_t level, size_t slot) -> void;
+			auto advance(uint64_t toTick) -> void;
+			auto acquireNode() -> WheelNode *;
+			auto releaseNode(WheelNode *node) -> void;
+			template <typename TFunc>
+			auto forEachNode(TFunc func) -> void;
+
+			uint64_t m_currentTick = 0;
+			size_t m_count = 0;
+			duration_t m_tickLength;
+			time_point_t m_start;
+			WheelNode *m_due = nullptr;
+			array_t<WheelNode *, firstLevelSlots> m_firstLevel;
+			array_t<array_t<WheelNode *, levelSlots>, levelCount> m_levels;
+			WheelNode *m_freeNodes = nullptr;
+			vector_t<owned_ptr_t<WheelNode[]>> m_chunks;
+		};
+	}
+}
\ No newline at end of file
@@ -17,6 +17,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "ValidCharDataProvider.hpp"
 #include "Algorithm.hpp"
+#include "DataSnapshot.hpp"
 #include "Database.hpp"
 #include "GameConstants.hpp"
 #include "GameLogicUtilities.hpp"
@@ -41,10 +42,9 @@ auto ValidCharDataProvider::loadForbiddenNames() -> void {
 	m_forbiddenNames.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("character_forbidden_names"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("character_forbidden_names"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		m_forbiddenNames.push_back(row.get<string_t>("forbidden_name"));
 	}
 }
@@ -54,10 +54,9 @@ auto ValidCharDataProvider::loadCreationItems() -> void {
 	m_cygnus.clear();
 
 	auto &db = Database::getDataDb();
-	auto &sql = db.getSession();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.makeTable("character_creation_data"));
+	auto rs = DataSnapshot::getInstance().select(db, "SELECT * FROM " + db.makeTable("character_creation_data"));
 
-	for (const auto &row : rs) {
+	for (const auto &row : *rs) {
 		gender_id_t genderId = GameLogicUtilities::getGenderId(row.get<string_t>("gender"));
 		int32_t objectId = row.get<int32_t>("objectid");
 		int8_t classId = -1;
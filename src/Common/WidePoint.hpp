@@ -58,6 +58,11 @@ namespace Vana {
 		}
 	};
 
+	template <>
+	struct PacketSize<WidePoint> {
+		static constexpr size_t value = packetSize<int32_t, int32_t>();
+	};
+
 	inline
 	auto operator <<(std::ostream &out, const WidePoint &pos) -> std::ostream & {
 		return out << "{" << pos.x << ", " << pos.y << "}";
@@ -0,0 +1,402 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "Bot.hpp"
+#include "Common/CommonHeader.hpp"
+#include "Common/PacketBuilder.hpp"
+#include "Common/PacketReader.hpp"
+#include "ChannelServer/SmsgHeader.hpp"
+#include "LoadGenerator/BotConnection.hpp"
+#include "LoadGenerator/BotPacket.hpp"
+#include "LoadGenerator/LoadGeneratorConfig.hpp"
+#include "LoadGenerator/LoadStats.hpp"
+#include "LoginServer/PlayerStatus.hpp"
+#include "LoginServer/SmsgHeader.hpp"
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
+namespace Vana {
+namespace LoadGenerator {
+
+Bot::Bot(asio::io_service &service, const LoadGeneratorConfig &config, LoadStats &stats, int32_t index) :
+	m_index{index},
+	m_random{std::random_device{}()},
+	m_config{config},
+	m_stats{stats},
+	m_service{service},
+	m_strand{service},
+	m_timer{service}
+{
+}
+
+auto Bot::start() -> void {
+	auto self = shared_from_this();
+	m_strand.post([self] { self->connectLogin(); });
+}
+
+auto Bot::stop() -> void {
+	auto self = shared_from_this();
+	m_strand.post([self] {
+		if (self->m_state == State::InGame) {
+			self->m_stats.leftGame();
+		}
+
+		self->m_state = State::Stopped;
+		asio::error_code ignored;
+		self->m_timer.cancel(ignored);
+		if (self->m_connection != nullptr) {
+			self->m_connection->close();
+		}
+	});
+}
+
+auto Bot::connect(const Ip &destination, port_t port, void (Bot::*onReady)(), void (Bot::*onPacket)(PacketReader &)) -> void {
+	// The connection only holds on to the bot weakly, otherwise they'd keep each other alive
+	view_ptr_t<Bot> bot = shared_from_this();
+	m_connection = make_ref_ptr<BotConnection>(m_service, m_strand, m_stats);
+	m_connection->connect(destination, port,
+		[bot, onReady] {
+			if (auto self = bot.lock()) {
+				((*self).*onReady)();
+			}
+		},
+		[bot, onPacket](PacketReader &reader) {
+			if (auto self = bot.lock()) {
+				((*self).*onPacket)(reader);
+			}
+		},
+		[bot](const string_t &reason) {
+			if (auto self = bot.lock()) {
+				self->fail(reason);
+			}
+		});
+}
+
+auto Bot::fail(const string_t &reason) -> void {
+	if (m_state == State::Stopped) {
+		return;
+	}
+
+	if (m_state == State::InGame) {
+		m_stats.leftGame();
+		m_stats.disconnected();
+	}
+	else {
+		m_stats.loginFailed();
+	}
+
+	std::cerr << "Bot " << m_config.accountPrefix << (m_config.accountStart + m_index) << ": " << reason << std::endl;
+
+	m_state = State::Stopped;
+	asio::error_code ignored;
+	m_timer.cancel(ignored);
+	if (m_connection != nullptr) {
+		m_connection->close();
+	}
+}
+
+auto Bot::send(const PacketBuilder &builder) -> void {
+	m_connection->send(builder);
+}
+
+auto Bot::connectLogin() -> void {
+	if (m_state != State::Idle) {
+		return;
+	}
+
+	m_state = State::LoggingIn;
+	m_loginStart = clock_t::now();
+	m_stats.loginStarted();
+	connect(m_config.loginIp, m_config.loginPort, &Bot::handleLoginReady, &Bot::handleLoginPacket);
+}
+
+auto Bot::handleLoginReady() -> void {
+	string_t username = m_config.accountPrefix + std::to_string(m_config.accountStart + m_index);
+	send(Packets::authenticate(username, m_config.password));
+}
+
+auto Bot::handleLoginPacket(PacketReader &reader) -> void {
+	switch (reader.get<header_t>()) {
+		case SMSG_PING: send(Packets::pong()); break;
+		case SMSG_AUTHENTICATION: handleAuthentication(reader); break;
+		case SMSG_PIN: handleLoginProcess(reader); break;
+		case SMSG_PLAYER_LIST: handlePlayerList(reader); break;
+		case SMSG_CHANNEL_CONNECT: handleChannelConnect(reader); break;
+	}
+}
+
+auto Bot::handleAuthentication(PacketReader &reader) -> void {
+	int16_t result = reader.get<int16_t>();
+	if (result != 0) {
+		fail("login rejected with error " + std::to_string(result));
+		return;
+	}
+
+	reader.unk<int32_t>();
+	reader.skip<account_id_t>();
+	if (reader.get<int8_t>() == LoginServer::PlayerStatus::SetGender) {
+		fail("account has no gender set");
+		return;
+	}
+
+	send(Packets::requestLogin());
+}
+
+auto Bot::handleLoginProcess(PacketReader &reader) -> void {
+	int8_t status = reader.get<int8_t>();
+	if (status == LoginServer::PlayerStatus::LoggedIn) {
+		m_state = State::SelectingCharacter;
+		send(Packets::playerList(m_config.world, m_config.channel));
+	}
+	else if (status == LoginServer::PlayerStatus::CheckPin && !m_config.pin.empty()) {
+		send(Packets::checkPin(m_config.pin));
+	}
+	else {
+		fail("PIN step failed with status " + std::to_string(status));
+	}
+}
+
+auto Bot::handlePlayerList(PacketReader &reader) -> void {
+	reader.unk<int8_t>();
+	if (reader.get<uint8_t>() == 0) {
+		fail("account has no characters in the world");
+		return;
+	}
+
+	// Every character entry starts with the ID, the rest of the list isn't needed
+	m_playerId = reader.get<player_id_t>();
+	m_state = State::Migrating;
+	send(Packets::channelConnect(m_playerId));
+}
+
+auto Bot::handleChannelConnect(PacketReader &reader) -> void {
+	reader.unk<int16_t>();
+	uint32_t ip = ntohl(reader.get<uint32_t>());
+	port_t port = reader.get<port_t>();
+	if (port == static_cast<port_t>(-1)) {
+		fail("channel is offline");
+		return;
+	}
+
+	m_channelIp = ip == 0 ? m_config.loginIp : Ip{ip};
+	m_channelPort = port;
+	m_connection->close();
+
+	// The WorldServer has to tell the channel about the connecting player before the channel accepts the load
+	auto self = shared_from_this();
+	m_timer.expires_from_now(m_config.migrateDelay);
+	m_timer.async_wait(m_strand.wrap([self](const asio::error_code &error) {
+		if (!error) {
+			self->connectChannel();
+		}
+	}));
+}
+
+auto Bot::connectChannel() -> void {
+	if (m_state != State::Migrating) {
+		return;
+	}
+
+	m_state = State::LoadingPlayer;
+	connect(m_channelIp, m_channelPort, &Bot::handleChannelReady, &Bot::handleChannelPacket);
+}
+
+auto Bot::handleChannelReady() -> void {
+	send(Packets::playerLoad(m_playerId));
+}
+
+auto Bot::handleChannelPacket(PacketReader &reader) -> void {
+	switch (reader.get<header_t>()) {
+		case SMSG_PING: send(Packets::pong()); break;
+		case SMSG_CHANGE_MAP: handleChangeMap(reader); break;
+		case SMSG_MOB_SHOW: addMob(reader.get<map_object_t>()); break;
+		case SMSG_MOB_CONTROL: {
+			bool controlled = reader.get<int8_t>() != 0;
+			map_object_t mapMobId = reader.get<map_object_t>();
+			if (controlled) {
+				addMob(mapMobId);
+			}
+			break;
+		}
+		case SMSG_MOB_DEATH: removeMob(reader.get<map_object_t>()); break;
+		case SMSG_DROP_ITEM: handleShowDrop(reader); break;
+		case SMSG_DROP_PICKUP:
+			reader.unk<int8_t>();
+			m_drops.erase(reader.get<map_object_t>());
+			break;
+		case SMSG_PLAYER_CHAT: handleChat(reader); break;
+	}
+}
+
+auto Bot::handleChangeMap(PacketReader &reader) -> void {
+	reader.skip<int32_t>(); // Channel
+	m_portalCount = reader.get<portal_count_t>();
+
+	// Nothing from the old map carries over, the position gets picked up again from the first movement
+	m_mobs.clear();
+	m_drops.clear();
+	m_pos = Point{};
+	m_chatPending = false;
+
+	if (m_state == State::LoadingPlayer) {
+		m_state = State::InGame;
+		m_stats.enteredGame(duration_cast<milliseconds_t>(clock_t::now() - m_loginStart));
+		scheduleAction();
+	}
+}
+
+auto Bot::handleShowDrop(PacketReader &reader) -> void {
+	reader.unk<int8_t>(); // Drop animation
+	map_object_t dropId = reader.get<map_object_t>();
+	reader.skip<bool>(); // Mesos
+	reader.skip<int32_t>(); // Item ID or amount
+	reader.skip<int32_t>(); // Owner
+	reader.skip<int8_t>(); // Owner type
+	m_drops[dropId] = reader.get<Point>();
+}
+
+auto Bot::handleChat(PacketReader &reader) -> void {
+	if (!m_chatPending || reader.get<player_id_t>() != m_playerId) {
+		return;
+	}
+
+	reader.skip<bool>(); // GM
+	if (reader.get<chat_t>() == m_pendingChat) {
+		// The echo of our own chat went through the channel's handler queue and back, the closest thing to tick latency a client can see
+		m_chatPending = false;
+		m_stats.recordChatLatency(duration_cast<microseconds_t>(clock_t::now() - m_chatSent));
+	}
+}
+
+auto Bot::addMob(map_object_t mapMobId) -> void {
+	if (std::find(std::begin(m_mobs), std::end(m_mobs), mapMobId) == std::end(m_mobs)) {
+		m_mobs.push_back(mapMobId);
+	}
+}
+
+auto Bot::removeMob(map_object_t mapMobId) -> void {
+	m_mobs.erase(std::remove(std::begin(m_mobs), std::end(m_mobs), mapMobId), std::end(m_mobs));
+}
+
+auto Bot::scheduleAction() -> void {
+	// Spread the actions out so thousands of bots started together don't all act on the same tick
+	int32_t interval = static_cast<int32_t>(m_config.behaviour.actionInterval.count());
+	int32_t jitter = interval / 4;
+	auto self = shared_from_this();
+	m_timer.expires_from_now(milliseconds_t{roll(interval + jitter, std::max(interval - jitter, 1))});
+	m_timer.async_wait(m_strand.wrap([self](const asio::error_code &error) {
+		if (!error) {
+			self->performAction();
+		}
+	}));
+}
+
+auto Bot::performAction() -> void {
+	if (m_state != State::InGame) {
+		return;
+	}
+
+	const BotBehaviourConfig &behaviour = m_config.behaviour;
+	int32_t total = behaviour.moveWeight + behaviour.attackWeight + behaviour.lootWeight + behaviour.chatWeight + behaviour.changeMapWeight;
+	int32_t pick = total > 0 ? roll(total - 1) : 0;
+
+	if ((pick -= behaviour.attackWeight) < 0) attack();
+	else if ((pick -= behaviour.lootWeight) < 0) loot();
+	else if ((pick -= behaviour.chatWeight) < 0) chat();
+	else if ((pick -= behaviour.changeMapWeight) < 0) changeMap();
+	else move();
+
+	m_stats.actionPerformed();
+	scheduleAction();
+}
+
+auto Bot::move() -> void {
+	coord_t range = m_config.behaviour.moveRange;
+	m_pos = m_pos.moveX(static_cast<coord_t>(roll(range, -range)));
+	send(Packets::move(m_portalCount, m_pos));
+}
+
+auto Bot::attack() -> void {
+	if (m_mobs.empty()) {
+		move();
+		return;
+	}
+
+	map_object_t mapMobId = m_mobs[roll(static_cast<int32_t>(m_mobs.size()) - 1)];
+	send(Packets::meleeAttack(m_portalCount, mapMobId, m_config.behaviour.damage, m_pos, getTicks()));
+}
+
+auto Bot::loot() -> void {
+	if (m_drops.empty()) {
+		move();
+		return;
+	}
+
+	auto drop = std::begin(m_drops);
+	std::advance(drop, roll(static_cast<int32_t>(m_drops.size()) - 1));
+	map_object_t dropId = drop->first;
+	m_pos = drop->second;
+	// Forget the drop right away, if someone else owns it the server won't say so and the bot would keep trying
+	m_drops.erase(drop);
+
+	// The server only allows looting from close by
+	send(Packets::move(m_portalCount, m_pos));
+	send(Packets::loot(dropId, m_pos, getTicks()));
+}
+
+auto Bot::chat() -> void {
+	const auto &messages = m_config.behaviour.chatMessages;
+	if (messages.empty()) {
+		move();
+		return;
+	}
+
+	const chat_t &message = messages[roll(static_cast<int32_t>(messages.size()) - 1)];
+	// Chat is low priority on the server and can be dropped under load, so a lost echo doesn't stall the measurement forever
+	if (!m_chatPending || clock_t::now() - m_chatSent > seconds_t{10}) {
+		m_chatPending = true;
+		m_pendingChat = message;
+		m_chatSent = clock_t::now();
+	}
+
+	send(Packets::chat(message));
+}
+
+auto Bot::changeMap() -> void {
+	const auto &maps = m_config.behaviour.maps;
+	if (maps.empty()) {
+		move();
+		return;
+	}
+
+	// There's no portal data on this side, so bots warp with the GM command instead
+	map_id_t mapId = maps[roll(static_cast<int32_t>(maps.size()) - 1)];
+	send(Packets::chat("!map " + std::to_string(mapId)));
+}
+
+auto Bot::roll(int32_t max, int32_t min) -> int32_t {
+	std::uniform_int_distribution<int32_t> distribution{min, max};
+	return distribution(m_random);
+}
+
+auto Bot::getTicks() const -> tick_count_t {
+	return static_cast<tick_count_t>(duration_cast<milliseconds_t>(clock_t::now().time_since_epoch()).count());
+}
+
+}
+}
\ No newline at end of file
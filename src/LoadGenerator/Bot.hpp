@@ -0,0 +1,116 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Ip.hpp"
+#include "Common/Point.hpp"
+#include "Common/Types.hpp"
+#include <asio.hpp>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Vana {
+	class PacketBuilder;
+	class PacketReader;
+
+	namespace LoadGenerator {
+		class BotConnection;
+		class LoadStats;
+		struct LoadGeneratorConfig;
+
+		// A scripted player, logs in through the LoginServer, migrates to the channel and then plays until stopped
+		// Everything a bot does happens on its own strand, so bots never contend with each other
+		class Bot : public enable_shared<Bot> {
+			NONCOPYABLE(Bot);
+			NO_DEFAULT_CONSTRUCTOR(Bot);
+		public:
+			Bot(asio::io_service &service, const LoadGeneratorConfig &config, LoadStats &stats, int32_t index);
+
+			auto start() -> void;
+			auto stop() -> void;
+		private:
+			using clock_t = std::chrono::steady_clock;
+
+			enum class State : uint8_t {
+				Idle,
+				LoggingIn,
+				SelectingCharacter,
+				Migrating,
+				LoadingPlayer,
+				InGame,
+				Stopped,
+			};
+
+			auto connect(const Ip &destination, port_t port, void (Bot::*onReady)(), void (Bot::*onPacket)(PacketReader &)) -> void;
+			auto fail(const string_t &reason) -> void;
+			auto send(const PacketBuilder &builder) -> void;
+
+			auto connectLogin() -> void;
+			auto handleLoginReady() -> void;
+			auto handleLoginPacket(PacketReader &reader) -> void;
+			auto handleAuthentication(PacketReader &reader) -> void;
+			auto handleLoginProcess(PacketReader &reader) -> void;
+			auto handlePlayerList(PacketReader &reader) -> void;
+			auto handleChannelConnect(PacketReader &reader) -> void;
+
+			auto connectChannel() -> void;
+			auto handleChannelReady() -> void;
+			auto handleChannelPacket(PacketReader &reader) -> void;
+			auto handleChangeMap(PacketReader &reader) -> void;
+			auto handleShowDrop(PacketReader &reader) -> void;
+			auto handleChat(PacketReader &reader) -> void;
+			auto addMob(map_object_t mapMobId) -> void;
+			auto removeMob(map_object_t mapMobId) -> void;
+
+			auto scheduleAction() -> void;
+			auto performAction() -> void;
+			auto move() -> void;
+			auto attack() -> void;
+			auto loot() -> void;
+			auto chat() -> void;
+			auto changeMap() -> void;
+			auto roll(int32_t max, int32_t min = 0) -> int32_t;
+			auto getTicks() const -> tick_count_t;
+
+			State m_state = State::Idle;
+			int32_t m_index = 0;
+			player_id_t m_playerId = 0;
+			portal_count_t m_portalCount = 0;
+			port_t m_channelPort = 0;
+			bool m_chatPending = false;
+			Ip m_channelIp{0};
+			Point m_pos;
+			chat_t m_pendingChat;
+			clock_t::time_point m_loginStart;
+			clock_t::time_point m_chatSent;
+			vector_t<map_object_t> m_mobs;
+			hash_map_t<map_object_t, Point> m_drops;
+			std::mt19937 m_random;
+			const LoadGeneratorConfig &m_config;
+			LoadStats &m_stats;
+			asio::io_service &m_service;
+			asio::io_service::strand m_strand;
+			asio::steady_timer m_timer;
+			ref_ptr_t<BotConnection> m_connection;
+		};
+	}
+}
\ No newline at end of file
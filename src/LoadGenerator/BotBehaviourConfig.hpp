@@ -0,0 +1,109 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/ConfigFile.hpp"
+#include "Common/Types.hpp"
+#include <string>
+#include <vector>
+
+namespace Vana {
+	namespace LoadGenerator {
+		struct BotBehaviourConfig {
+			milliseconds_t actionInterval = milliseconds_t{1000};
+			int32_t moveWeight = 50;
+			int32_t attackWeight = 25;
+			int32_t lootWeight = 15;
+			int32_t chatWeight = 8;
+			int32_t changeMapWeight = 2;
+			coord_t moveRange = 150;
+			damage_t damage = 1;
+			vector_t<map_id_t> maps;
+			vector_t<chat_t> chatMessages;
+		};
+	}
+
+	template <>
+	struct LuaSerialize<LoadGenerator::BotBehaviourConfig> {
+		auto read(LuaEnvironment &config, const string_t &prefix) -> LoadGenerator::BotBehaviourConfig {
+			LoadGenerator::BotBehaviourConfig ret;
+
+			LuaVariant obj = config.get<LuaVariant>(prefix);
+			config.validateObject(LuaType::Table, obj, prefix);
+
+			auto map = obj.as<hash_map_t<LuaVariant, LuaVariant>>();
+			for (const auto &kvp : map) {
+				config.validateKey(LuaType::String, kvp.first, prefix);
+
+				string_t key = kvp.first.as<string_t>();
+				if (key == "action_interval") {
+					if (config.validateValue(LuaType::Number, kvp.second, key, prefix, true) == LuaType::Nil) continue;
+					ret.actionInterval = milliseconds_t{kvp.second.as<int32_t>()};
+				}
+				else if (key == "move") {
+					if (config.validateValue(LuaType::Number, kvp.second, key, prefix, true) == LuaType::Nil) continue;
+					ret.moveWeight = kvp.second.as<int32_t>();
+				}
+				else if (key == "attack") {
+					if (config.validateValue(LuaType::Number, kvp.second, key, prefix, true) == LuaType::Nil) continue;
+					ret.attackWeight = kvp.second.as<int32_t>();
+				}
+				else if (key == "loot") {
+					if (config.validateValue(LuaType::Number, kvp.second, key, prefix, true) == LuaType::Nil) continue;
+					ret.lootWeight = kvp.second.as<int32_t>();
+				}
+				else if (key == "chat") {
+					if (config.validateValue(LuaType::Number, kvp.second, key, prefix, true) == LuaType::Nil) continue;
+					ret.chatWeight = kvp.second.as<int32_t>();
+				}
+				else if (key == "change_map") {
+					if (config.validateValue(LuaType::Number, kvp.second, key, prefix, true) == LuaType::Nil) continue;
+					ret.changeMapWeight = kvp.second.as<int32_t>();
+				}
+				else if (key == "move_range") {
+					if (config.validateValue(LuaType::Number, kvp.second, key, prefix, true) == LuaType::Nil) continue;
+					ret.moveRange = kvp.second.as<coord_t>();
+				}
+				else if (key == "damage") {
+					if (config.validateValue(LuaType::Number, kvp.second, key, prefix, true) == LuaType::Nil) continue;
+					ret.damage = kvp.second.as<damage_t>();
+				}
+				else if (key == "maps") {
+					if (config.validateValue(LuaType::Table, kvp.second, key, prefix, true) == LuaType::Nil) continue;
+					auto maps = kvp.second.as<vector_t<LuaVariant>>();
+					for (const auto &map : maps) {
+						config.validateValue(LuaType::Number, map, key, prefix);
+					}
+
+					ret.maps = kvp.second.as<vector_t<map_id_t>>();
+				}
+				else if (key == "chat_messages") {
+					if (config.validateValue(LuaType::Table, kvp.second, key, prefix, true) == LuaType::Nil) continue;
+					auto messages = kvp.second.as<vector_t<LuaVariant>>();
+					for (const auto &message : messages) {
+						config.validateValue(LuaType::String, message, key, prefix);
+					}
+
+					ret.chatMessages = kvp.second.as<vector_t<chat_t>>();
+				}
+			}
+
+			return ret;
+		}
+	};
+}
\ No newline at end of file
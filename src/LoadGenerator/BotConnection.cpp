@@ -0,0 +1,251 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "BotConnection.hpp"
+#include "Common/EncryptedPacketTransformer.hpp"
+#include "Common/MapleVersion.hpp"
+#include "Common/PacketBuilder.hpp"
+#include "Common/PacketReader.hpp"
+#include "LoadGenerator/LoadStats.hpp"
+#include <cstring>
+#include <functional>
+
+namespace Vana {
+namespace LoadGenerator {
+
+BotConnection::BotConnection(asio::io_service &service, asio::io_service::strand &strand, LoadStats &stats) :
+	m_strand{strand},
+	m_socket{service},
+	m_stats{stats}
+{
+}
+
+auto BotConnection::connect(const Ip &destination, port_t port, ready_func_t onReady, packet_func_t onPacket, disconnect_func_t onDisconnect) -> void {
+	if (destination.getType() != Ip::Type::Ipv4) {
+		throw NotImplementedException{"IPv6 unsupported"};
+	}
+
+	m_onReady = onReady;
+	m_onPacket = onPacket;
+	m_onDisconnect = onDisconnect;
+
+	asio::ip::tcp::endpoint endpoint{asio::ip::address_v4{destination.asIpv4()}, port};
+	m_socket.async_connect(endpoint,
+		m_strand.wrap(std::bind(&BotConnection::handleConnect, shared_from_this(),
+			std::placeholders::_1)));
+}
+
+auto BotConnection::send(const PacketBuilder &builder) -> void {
+	if (m_closed || m_codec == nullptr) {
+		return;
+	}
+
+	// The send IV shuffles with every packet, so packets are encrypted in the order they're sent and written out together
+	size_t len = builder.getSize();
+	size_t offset = m_pendingBytes.size();
+	m_pendingBytes.resize(offset + HeaderLen + len);
+	unsigned char *header = m_pendingBytes.data() + offset;
+	memcpy(header + HeaderLen, builder.getBuffer(), len);
+	m_codec->setPacketHeader(header, static_cast<uint16_t>(len));
+	m_codec->encryptPacket(header + HeaderLen, static_cast<int32_t>(len), HeaderLen);
+	m_stats.packetSent(HeaderLen + len);
+
+	if (!m_writeInProgress) {
+		startWrite();
+	}
+}
+
+auto BotConnection::close() -> void {
+	if (m_closed) {
+		return;
+	}
+
+	m_closed = true;
+	asio::error_code ignored;
+	m_socket.shutdown(asio::ip::tcp::socket::shutdown_both, ignored);
+	m_socket.close(ignored);
+}
+
+auto BotConnection::isOpen() const -> bool {
+	return !m_closed && m_codec != nullptr;
+}
+
+auto BotConnection::fail(const string_t &reason) -> void {
+	if (m_closed) {
+		return;
+	}
+
+	close();
+	if (m_onDisconnect) {
+		m_onDisconnect(reason);
+	}
+}
+
+auto BotConnection::handleConnect(const asio::error_code &error) -> void {
+	if (m_closed) {
+		return;
+	}
+
+	if (error) {
+		fail("connect failed: " + error.message());
+		return;
+	}
+
+	asio::error_code ignored;
+	m_socket.set_option(asio::ip::tcp::no_delay{true}, ignored);
+	m_receiveBuffer.resize(ReceiveBufferLen);
+	startRead();
+}
+
+auto BotConnection::startRead() -> void {
+	m_socket.async_read_some(
+		asio::buffer(m_receiveBuffer.data() + m_receiveEnd, ReceiveBufferLen - m_receiveEnd),
+		m_strand.wrap(std::bind(&BotConnection::handleRead, shared_from_this(),
+			std::placeholders::_1,
+			std::placeholders::_2)));
+}
+
+auto BotConnection::handleRead(const asio::error_code &error, size_t bytesTransferred) -> void {
+	if (m_closed) {
+		return;
+	}
+
+	if (error) {
+		fail(error == asio::error::eof ? "closed by the server" : error.message());
+		return;
+	}
+
+	m_receiveEnd += bytesTransferred;
+	unsigned char *buffer = m_receiveBuffer.data();
+	size_t pos = 0;
+
+	if (m_codec == nullptr) {
+		// The IV packet is the only unencrypted one, it only has a plain length in front of it
+		if (m_receiveEnd < HandshakeHeaderLen) {
+			startRead();
+			return;
+		}
+
+		size_t len = *reinterpret_cast<header_t *>(buffer);
+		if (m_receiveEnd - HandshakeHeaderLen < len) {
+			startRead();
+			return;
+		}
+
+		if (!handleHandshake(buffer + HandshakeHeaderLen, len)) {
+			return;
+		}
+
+		pos = HandshakeHeaderLen + len;
+		m_onReady();
+		if (m_closed) {
+			return;
+		}
+	}
+
+	while (m_receiveEnd - pos >= HeaderLen) {
+		unsigned char *header = buffer + pos;
+		size_t len = m_codec->getPacketLength(header);
+		if (len < sizeof(header_t)) {
+			fail("malformed packet header");
+			return;
+		}
+
+		if (m_receiveEnd - pos - HeaderLen < len) {
+			// Partial frame, the rest is still in flight
+			break;
+		}
+
+		m_codec->decryptPacket(header + HeaderLen, static_cast<int32_t>(len), HeaderLen);
+		m_stats.packetReceived(HeaderLen + len);
+		pos += HeaderLen + len;
+
+		try {
+			PacketReader reader{header + HeaderLen, len};
+			m_onPacket(reader);
+		}
+		catch (PacketContentException &e) {
+			fail(string_t{"malformed packet: "} + e.what());
+			return;
+		}
+
+		if (m_closed) {
+			return;
+		}
+	}
+
+	if (pos > 0) {
+		memmove(buffer, buffer + pos, m_receiveEnd - pos);
+		m_receiveEnd -= pos;
+	}
+
+	startRead();
+}
+
+auto BotConnection::handleHandshake(unsigned char *buffer, size_t length) -> bool {
+	try {
+		PacketReader reader{buffer, length};
+		version_t version = reader.get<version_t>();
+		reader.skip<string_t>(); // Subversion, which differs between the login and channel servers
+		iv_t sendIv = reader.get<iv_t>();
+		iv_t recvIv = reader.get<iv_t>();
+		game_locale_t locale = reader.get<game_locale_t>();
+
+		if (version != MapleVersion::Version || locale != MapleVersion::Locale) {
+			fail("server version mismatch");
+			return false;
+		}
+
+		m_codec = make_owned_ptr<EncryptedPacketTransformer>(recvIv, sendIv);
+	}
+	catch (PacketContentException &) {
+		fail("malformed IV packet");
+		return false;
+	}
+
+	return true;
+}
+
+auto BotConnection::startWrite() -> void {
+	m_writeBytes.clear();
+	std::swap(m_pendingBytes, m_writeBytes);
+	m_writeInProgress = true;
+
+	asio::async_write(m_socket, asio::buffer(m_writeBytes.data(), m_writeBytes.size()),
+		m_strand.wrap(std::bind(&BotConnection::handleWrite, shared_from_this(),
+			std::placeholders::_1,
+			std::placeholders::_2)));
+}
+
+auto BotConnection::handleWrite(const asio::error_code &error, size_t bytesTransferred) -> void {
+	m_writeInProgress = false;
+	if (m_closed) {
+		return;
+	}
+
+	if (error) {
+		fail(error.message());
+		return;
+	}
+
+	if (!m_pendingBytes.empty()) {
+		startWrite();
+	}
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Ip.hpp"
+#include "Common/PacketTransformer.hpp"
+#include "Common/Types.hpp"
+#include <asio.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Vana {
+	class PacketBuilder;
+	class PacketReader;
+
+	namespace LoadGenerator {
+		class LoadStats;
+
+		// The client side of a single connection, does the IV handshake and the per-packet encryption the way the game client does
+		// Everything, including the callbacks, runs on the strand of the bot that owns the connection
+		class BotConnection : public enable_shared<BotConnection> {
+			NONCOPYABLE(BotConnection);
+			NO_DEFAULT_CONSTRUCTOR(BotConnection);
+		public:
+			using ready_func_t = function_t<void()>;
+			using packet_func_t = function_t<void(PacketReader &)>;
+			using disconnect_func_t = function_t<void(const string_t &)>;
+
+			BotConnection(asio::io_service &service, asio::io_service::strand &strand, LoadStats &stats);
+
+			auto connect(const Ip &destination, port_t port, ready_func_t onReady, packet_func_t onPacket, disconnect_func_t onDisconnect) -> void;
+			auto send(const PacketBuilder &builder) -> void;
+			auto close() -> void;
+			auto isOpen() const -> bool;
+		private:
+			static const size_t HandshakeHeaderLen = 2;
+			static const size_t HeaderLen = 4;
+			static const size_t MaxBufferLen = 65535;
+			static const size_t ReceiveBufferLen = HeaderLen + MaxBufferLen;
+
+			auto handleConnect(const asio::error_code &error) -> void;
+			auto startRead() -> void;
+			auto handleRead(const asio::error_code &error, size_t bytesTransferred) -> void;
+			auto handleHandshake(unsigned char *buffer, size_t length) -> bool;
+			auto startWrite() -> void;
+			auto handleWrite(const asio::error_code &error, size_t bytesTransferred) -> void;
+			auto fail(const string_t &reason) -> void;
+
+			bool m_closed = false;
+			bool m_writeInProgress = false;
+			size_t m_receiveEnd = 0;
+			asio::io_service::strand &m_strand;
+			asio::ip::tcp::socket m_socket;
+			LoadStats &m_stats;
+			owned_ptr_t<PacketTransformer> m_codec;
+			ready_func_t m_onReady;
+			packet_func_t m_onPacket;
+			disconnect_func_t m_onDisconnect;
+			vector_t<unsigned char> m_receiveBuffer;
+			vector_t<unsigned char> m_pendingBytes;
+			vector_t<unsigned char> m_writeBytes;
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "BotPacket.hpp"
+#include "Common/CommonHeader.hpp"
+#include "ChannelServer/CmsgHeader.hpp"
+#include "LoginServer/CmsgHeader.hpp"
+
+namespace Vana {
+namespace LoadGenerator {
+namespace Packets {
+
+PACKET_IMPL(pong) {
+	PacketBuilder builder;
+	builder.add<header_t>(CMSG_PONG);
+	return builder;
+}
+
+PACKET_IMPL(authenticate, const string_t &username, const string_t &password) {
+	PacketBuilder builder;
+	builder
+		.add<header_t>(CMSG_AUTHENTICATION)
+		.add<string_t>(username)
+		.add<string_t>(password);
+	return builder;
+}
+
+PACKET_IMPL(requestLogin) {
+	PacketBuilder builder;
+	builder
+		.add<header_t>(CMSG_PIN)
+		.unk<int8_t>(1)
+		.unk<int8_t>(1);
+	return builder;
+}
+
+PACKET_IMPL(checkPin, const string_t &pin) {
+	PacketBuilder builder;
+	builder
+		.add<header_t>(CMSG_PIN)
+		.add<int8_t>(1) // Entering the PIN
+		.unk<uint8_t>()
+		.unk<uint32_t>()
+		.add<string_t>(pin);
+	return builder;
+}
+
+PACKET_IMPL(playerList, world_id_t worldId, channel_id_t channelId) {
+	PacketBuilder builder;
+	builder
+		.add<header_t>(CMSG_PLAYER_LIST)
+		.add<world_id_t>(worldId)
+		.add<channel_id_t>(channelId);
+	return builder;
+}
+
+PACKET_IMPL(channelConnect, player_id_t playerId) {
+	PacketBuilder builder;
+	builder
+		.add<header_t>(CMSG_CHANNEL_CONNECT)
+		.add<player_id_t>(playerId);
+	return builder;
+}
+
+PACKET_IMPL(playerLoad, player_id_t playerId) {
+	PacketBuilder builder;
+	builder
+		.add<header_t>(CMSG_PLAYER_LOAD)
+		.add<player_id_t>(playerId);
+	return builder;
+}
+
+PACKET_IMPL(move, portal_count_t portalCount, const Point &pos) {
+	PacketBuilder builder;
+	builder
+		.add<header_t>(CMSG_PLAYER_MOVE)
+		.add<portal_count_t>(portalCount)
+		.unk<int64_t>() // The server skips to the movement data at a fixed offset
+		.add<uint8_t>(1) // Movement count
+		.add<int8_t>(0) // Normal movement
+		.add<Point>(pos)
+		.unk<uint32_t>() // Velocity
+		.add<foothold_id_t>(1) // Anything but 0, otherwise the server treats the player as falling
+		.add<int8_t>(0) // Stance
+		.unk<uint16_t>(); // Duration
+	return builder;
+}
+
+PACKET_IMPL(meleeAttack, portal_count_t portalCount, map_object_t mapMobId, damage_t damage, const Point &pos, tick_count_t ticks) {
+	PacketBuilder builder;
+	builder
+		.add<header_t>(CMSG_ATTACK_MELEE)
+		.add<portal_count_t>(portalCount)
+		.add<uint8_t>(0x11) // One target, one hit
+		.add<skill_id_t>(0) // Regular attack
+		.unk<checksum_t>()
+		.unk<checksum_t>()
+		.add<uint8_t>(0) // Display
+		.add<uint8_t>(0) // Animation
+		.add<uint8_t>(0) // Weapon class
+		.add<uint8_t>(4) // Weapon speed
+		.add<tick_count_t>(ticks)
+		.add<map_object_t>(mapMobId)
+		.unk<uint32_t>()
+		.add<Point>(pos) // Mob position
+		.add<Point>(pos) // Damage position
+		.add<uint16_t>(0) // Distance
+		.add<damage_t>(damage)
+		.unk<checksum_t>()
+		.add<Point>(pos);
+	return builder;
+}
+
+PACKET_IMPL(chat, const chat_t &message) {
+	PacketBuilder builder;
+	builder
+		.add<header_t>(CMSG_PLAYER_CHAT)
+		.add<chat_t>(message)
+		.add<bool>(false); // Bubble only
+	return builder;
+}
+
+PACKET_IMPL(loot, map_object_t dropId, const Point &pos, tick_count_t ticks) {
+	PacketBuilder builder;
+	builder
+		.add<header_t>(CMSG_ITEM_LOOT)
+		.unk<uint8_t>()
+		.add<tick_count_t>(ticks)
+		.add<Point>(pos)
+		.add<map_object_t>(dropId);
+	return builder;
+}
+
+}
+}
+}
\ No newline at end of file
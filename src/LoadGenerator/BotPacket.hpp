@@ -0,0 +1,41 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/PacketBuilder.hpp"
+#include "Common/Point.hpp"
+#include "Common/Types.hpp"
+#include <string>
+
+namespace Vana {
+	namespace LoadGenerator {
+		namespace Packets {
+			PACKET(pong);
+			PACKET(authenticate, const string_t &username, const string_t &password);
+			PACKET(requestLogin);
+			PACKET(checkPin, const string_t &pin);
+			PACKET(playerList, world_id_t worldId, channel_id_t channelId);
+			PACKET(channelConnect, player_id_t playerId);
+			PACKET(playerLoad, player_id_t playerId);
+			PACKET(move, portal_count_t portalCount, const Point &pos);
+			PACKET(meleeAttack, portal_count_t portalCount, map_object_t mapMobId, damage_t damage, const Point &pos, tick_count_t ticks);
+			PACKET(chat, const chat_t &message);
+			PACKET(loot, map_object_t dropId, const Point &pos, tick_count_t ticks);
+		}
+	}
+}
\ No newline at end of file
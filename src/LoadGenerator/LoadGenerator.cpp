@@ -0,0 +1,153 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "LoadGenerator.hpp"
+#include "Common/ConfigFile.hpp"
+#include "LoadGenerator/Bot.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace Vana {
+namespace LoadGenerator {
+
+// Bots are started in small groups this often, so the ramp rate is smooth rather than a burst every second
+const milliseconds_t RampInterval = milliseconds_t{100};
+
+LoadGenerator::LoadGenerator(asio::io_service &service, const LoadGeneratorConfig &config) :
+	m_config{config},
+	m_service{service},
+	m_strand{service},
+	m_rampTimer{service},
+	m_reportTimer{service},
+	m_durationTimer{service}
+{
+}
+
+auto LoadGenerator::loadConfig() -> LoadGeneratorConfig {
+	auto config = ConfigFile::getLoadGeneratorConfig();
+	config->run();
+
+	LoadGeneratorConfig ret;
+	ret.loginIp = Ip{Ip::stringToIpv4(config->get<string_t>("login_ip"))};
+	ret.loginPort = config->get<port_t>("login_port");
+	ret.accountPrefix = config->get<string_t>("account_prefix");
+	ret.accountStart = config->get<int32_t>("account_start");
+	ret.password = config->get<string_t>("password");
+	ret.pin = config->get<string_t>("pin");
+	ret.world = config->get<world_id_t>("world");
+	ret.channel = config->get<channel_id_t>("channel");
+	ret.botCount = config->get<int32_t>("bot_count");
+	ret.rampRate = std::max(config->get<int32_t>("ramp_rate"), 1);
+	ret.threads = config->get<int32_t>("threads");
+	ret.duration = seconds_t{config->get<int32_t>("duration")};
+	ret.reportInterval = seconds_t{std::max(config->get<int32_t>("report_interval"), 1)};
+	ret.migrateDelay = milliseconds_t{config->get<int32_t>("migrate_delay")};
+	ret.behaviour = config->get<BotBehaviourConfig>("behaviour");
+	return ret;
+}
+
+auto LoadGenerator::start(function_t<void()> onStopped) -> void {
+	m_onStopped = onStopped;
+	std::cout << "Starting " << m_config.botCount << " bots against " << m_config.loginIp << ":" << m_config.loginPort
+		<< " at " << m_config.rampRate << " per second" << std::endl;
+
+	m_startTime = std::chrono::steady_clock::now();
+	m_bots.reserve(m_config.botCount);
+	m_strand.post([this] {
+		spawnBots();
+		scheduleReport();
+
+		if (m_config.duration.count() > 0) {
+			m_durationTimer.expires_from_now(m_config.duration);
+			m_durationTimer.async_wait(m_strand.wrap([this](const asio::error_code &error) {
+				if (!error) {
+					std::cout << "Run finished after " << m_config.duration.count() << " seconds" << std::endl;
+					stop();
+				}
+			}));
+		}
+	});
+}
+
+auto LoadGenerator::stop() -> void {
+	m_strand.dispatch([this] {
+		if (m_stopped) {
+			return;
+		}
+
+		m_stopped = true;
+		asio::error_code ignored;
+		m_rampTimer.cancel(ignored);
+		m_reportTimer.cancel(ignored);
+		m_durationTimer.cancel(ignored);
+
+		report();
+		for (auto &bot : m_bots) {
+			bot->stop();
+		}
+
+		if (m_onStopped) {
+			m_onStopped();
+		}
+	});
+}
+
+auto LoadGenerator::spawnBots() -> void {
+	if (m_stopped) {
+		return;
+	}
+
+	auto elapsed = duration_cast<milliseconds_t>(std::chrono::steady_clock::now() - m_startTime);
+	int64_t due = static_cast<int64_t>(m_config.rampRate) * (elapsed.count() + RampInterval.count()) / 1000;
+	int32_t target = static_cast<int32_t>(std::min<int64_t>(due, m_config.botCount));
+
+	for (int32_t i = static_cast<int32_t>(m_bots.size()); i < target; ++i) {
+		auto bot = make_ref_ptr<Bot>(m_service, m_config, m_stats, i);
+		m_bots.push_back(bot);
+		bot->start();
+	}
+
+	if (static_cast<int32_t>(m_bots.size()) < m_config.botCount) {
+		m_rampTimer.expires_from_now(RampInterval);
+		m_rampTimer.async_wait(m_strand.wrap([this](const asio::error_code &error) {
+			if (!error) {
+				spawnBots();
+			}
+		}));
+	}
+}
+
+auto LoadGenerator::scheduleReport() -> void {
+	m_reportTimer.expires_from_now(m_config.reportInterval);
+	m_reportTimer.async_wait(m_strand.wrap([this](const asio::error_code &error) {
+		if (!error) {
+			report();
+			scheduleReport();
+		}
+	}));
+}
+
+auto LoadGenerator::report() -> void {
+	out_stream_t str;
+	auto elapsed = duration_cast<seconds_t>(std::chrono::steady_clock::now() - m_startTime);
+	str << "[" << elapsed.count() << "s] Bots: " << m_bots.size() << "/" << m_config.botCount << " | ";
+	m_stats.report(str);
+	std::cout << str.str() << std::endl;
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Types.hpp"
+#include "LoadGenerator/LoadGeneratorConfig.hpp"
+#include "LoadGenerator/LoadStats.hpp"
+#include <asio.hpp>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace Vana {
+	namespace LoadGenerator {
+		class Bot;
+
+		// Ramps the bots up to the configured count, reports on them periodically and stops them all at the end of the run
+		class LoadGenerator {
+			NONCOPYABLE(LoadGenerator);
+			NO_DEFAULT_CONSTRUCTOR(LoadGenerator);
+		public:
+			LoadGenerator(asio::io_service &service, const LoadGeneratorConfig &config);
+
+			static auto loadConfig() -> LoadGeneratorConfig;
+
+			auto start(function_t<void()> onStopped) -> void;
+			auto stop() -> void;
+		private:
+			auto spawnBots() -> void;
+			auto scheduleReport() -> void;
+			auto report() -> void;
+
+			bool m_stopped = false;
+			std::chrono::steady_clock::time_point m_startTime;
+			LoadGeneratorConfig m_config;
+			LoadStats m_stats;
+			function_t<void()> m_onStopped;
+			asio::io_service &m_service;
+			asio::io_service::strand m_strand;
+			asio::steady_timer m_rampTimer;
+			asio::steady_timer m_reportTimer;
+			asio::steady_timer m_durationTimer;
+			vector_t<ref_ptr_t<Bot>> m_bots;
+		};
+	}
+}
\ No newline at end of file
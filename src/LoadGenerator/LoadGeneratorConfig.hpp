@@ -0,0 +1,45 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Ip.hpp"
+#include "Common/Types.hpp"
+#include "LoadGenerator/BotBehaviourConfig.hpp"
+#include <string>
+
+namespace Vana {
+	namespace LoadGenerator {
+		struct LoadGeneratorConfig {
+			Ip loginIp{0};
+			port_t loginPort = 8484;
+			string_t accountPrefix;
+			int32_t accountStart = 1;
+			string_t password;
+			string_t pin;
+			world_id_t world = 0;
+			channel_id_t channel = 0;
+			int32_t botCount = 1;
+			int32_t rampRate = 10;
+			int32_t threads = 0;
+			seconds_t duration = seconds_t{0};
+			seconds_t reportInterval = seconds_t{10};
+			milliseconds_t migrateDelay = milliseconds_t{500};
+			BotBehaviourConfig behaviour;
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "LoadStats.hpp"
+#include <iomanip>
+
+namespace Vana {
+namespace LoadGenerator {
+
+auto LoadStats::loginStarted() -> void {
+	m_loginsStarted.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto LoadStats::loginFailed() -> void {
+	m_loginFailures.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto LoadStats::enteredGame(milliseconds_t loginTime) -> void {
+	uint64_t inGame = m_inGame.fetch_add(1, std::memory_order_relaxed) + 1;
+	uint64_t peak = m_peakInGame.load(std::memory_order_relaxed);
+	while (inGame > peak && !m_peakInGame.compare_exchange_weak(peak, inGame, std::memory_order_relaxed));
+
+	m_loginCount.fetch_add(1, std::memory_order_relaxed);
+	m_loginMilliseconds.fetch_add(static_cast<uint64_t>(loginTime.count()), std::memory_order_relaxed);
+}
+
+auto LoadStats::leftGame() -> void {
+	m_inGame.fetch_sub(1, std::memory_order_relaxed);
+}
+
+auto LoadStats::disconnected() -> void {
+	m_disconnects.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto LoadStats::packetSent(size_t bytes) -> void {
+	m_packetsSent.fetch_add(1, std::memory_order_relaxed);
+	m_bytesSent.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+auto LoadStats::packetReceived(size_t bytes) -> void {
+	m_packetsReceived.fetch_add(1, std::memory_order_relaxed);
+	m_bytesReceived.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+auto LoadStats::actionPerformed() -> void {
+	m_actions.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto LoadStats::recordChatLatency(microseconds_t latency) -> void {
+	uint64_t value = static_cast<uint64_t>(latency.count());
+	m_chatCount.fetch_add(1, std::memory_order_relaxed);
+	m_chatMicroseconds.fetch_add(value, std::memory_order_relaxed);
+
+	uint64_t max = m_chatMaxMicroseconds.load(std::memory_order_relaxed);
+	while (value > max && !m_chatMaxMicroseconds.compare_exchange_weak(max, value, std::memory_order_relaxed));
+}
+
+auto LoadStats::report(out_stream_t &str) -> void {
+	uint64_t logins = m_loginCount.load(std::memory_order_relaxed);
+	uint64_t loginMilliseconds = m_loginMilliseconds.load(std::memory_order_relaxed);
+	uint64_t chats = m_chatCount.exchange(0, std::memory_order_relaxed);
+	uint64_t chatMicroseconds = m_chatMicroseconds.exchange(0, std::memory_order_relaxed);
+	uint64_t chatMax = m_chatMaxMicroseconds.exchange(0, std::memory_order_relaxed);
+
+	str << std::fixed << std::setprecision(1)
+		<< "In game: " << m_inGame.load(std::memory_order_relaxed)
+		<< " (peak " << m_peakInGame.load(std::memory_order_relaxed) << ")"
+		<< " | Logins: " << logins << "/" << m_loginsStarted.load(std::memory_order_relaxed)
+		<< ", " << m_loginFailures.load(std::memory_order_relaxed) << " failed"
+		<< ", avg " << (logins == 0 ? 0 : loginMilliseconds / logins) << "ms"
+		<< " | Disconnects: " << m_disconnects.load(std::memory_order_relaxed)
+		<< " | Sent: " << m_packetsSent.load(std::memory_order_relaxed) << " packets, " << (m_bytesSent.load(std::memory_order_relaxed) / 1024) << " KB"
+		<< " | Received: " << m_packetsReceived.load(std::memory_order_relaxed) << " packets, " << (m_bytesReceived.load(std::memory_order_relaxed) / 1024) << " KB"
+		<< " | Actions: " << m_actions.load(std::memory_order_relaxed)
+		<< " | Chat round trip: ";
+
+	if (chats == 0) {
+		str << "n/a";
+	}
+	else {
+		str << (static_cast<double>(chatMicroseconds) / chats / 1000.0) << "ms avg, "
+			<< (static_cast<double>(chatMax) / 1000.0) << "ms max over " << chats;
+	}
+}
+
+}
+}
\ No newline at end of file
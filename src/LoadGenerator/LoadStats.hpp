@@ -0,0 +1,57 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "Common/Types.hpp"
+#include <atomic>
+
+namespace Vana {
+	namespace LoadGenerator {
+		// Shared by every bot, so everything here is updated without a lock
+		// The latency figures cover the current report interval, the rest are running totals
+		class LoadStats {
+		public:
+			auto loginStarted() -> void;
+			auto loginFailed() -> void;
+			auto enteredGame(milliseconds_t loginTime) -> void;
+			auto leftGame() -> void;
+			auto disconnected() -> void;
+			auto packetSent(size_t bytes) -> void;
+			auto packetReceived(size_t bytes) -> void;
+			auto actionPerformed() -> void;
+			auto recordChatLatency(microseconds_t latency) -> void;
+			auto report(out_stream_t &str) -> void;
+		private:
+			std::atomic<uint64_t> m_loginsStarted{0};
+			std::atomic<uint64_t> m_loginFailures{0};
+			std::atomic<uint64_t> m_inGame{0};
+			std::atomic<uint64_t> m_peakInGame{0};
+			std::atomic<uint64_t> m_disconnects{0};
+			std::atomic<uint64_t> m_packetsSent{0};
+			std::atomic<uint64_t> m_bytesSent{0};
+			std::atomic<uint64_t> m_packetsReceived{0};
+			std::atomic<uint64_t> m_bytesReceived{0};
+			std::atomic<uint64_t> m_actions{0};
+			std::atomic<uint64_t> m_loginCount{0};
+			std::atomic<uint64_t> m_loginMilliseconds{0};
+			std::atomic<uint64_t> m_chatCount{0};
+			std::atomic<uint64_t> m_chatMicroseconds{0};
+			std::atomic<uint64_t> m_chatMaxMicroseconds{0};
+		};
+	}
+}
\ No newline at end of file
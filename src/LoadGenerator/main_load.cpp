@@ -0,0 +1,76 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "Common/ConfigFile.hpp"
+#include "Common/ExitCodes.hpp"
+#include "LoadGenerator/LoadGenerator.hpp"
+#include <asio.hpp>
+#include <botan/botan.h>
+#include <algorithm>
+#include <csignal>
+#include <exception>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+auto main() -> Vana::exit_code_t {
+	using Vana::LoadGenerator::LoadGenerator;
+
+	Botan::LibraryInitializer init{"thread_safe=true"};
+	asio::io_service service;
+	asio::signal_set signals{service, SIGINT};
+
+	try {
+		auto config = LoadGenerator::loadConfig();
+		LoadGenerator generator{service, config};
+
+		signals.async_wait([&generator](const asio::error_code &error, int signal) {
+			if (!error) {
+				generator.stop();
+			}
+		});
+
+		// Once every bot is stopped, nothing else is keeping the io_service running
+		generator.start([&signals] {
+			asio::error_code ignored;
+			signals.cancel(ignored);
+		});
+
+		int32_t threadCount = config.threads > 0 ?
+			config.threads :
+			std::max(static_cast<int32_t>(std::thread::hardware_concurrency()), 1);
+
+		Vana::vector_t<Vana::thread_t> threads;
+		for (int32_t i = 1; i < threadCount; ++i) {
+			threads.emplace_back([&service] { service.run(); });
+		}
+
+		service.run();
+		for (auto &thread : threads) {
+			thread.join();
+		}
+	}
+	catch (Vana::ConfigException &) {
+		return Vana::ExitCodes::ConfigError;
+	}
+	catch (std::exception &e) {
+		std::cerr << "PROGRAM ERROR: " << e.what() << std::endl;
+		return Vana::ExitCodes::ProgramException;
+	}
+
+	return Vana::ExitCodes::Ok;
+}
\ No newline at end of file
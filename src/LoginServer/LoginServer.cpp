@@ -53,7 +53,8 @@ auto LoginServer::listen() -> void {
 			ConnectionType::EndUser,
 			MapleVersion::LoginSubversion,
 			m_port,
-			Ip::Type::Ipv4
+			Ip::Type::Ipv4,
+			config.clientSendLimits
 		},
 		[&] { return make_ref_ptr<User>(); }
 	);
@@ -23,6 +23,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "Common/JobConstants.hpp"
 #include "Common/StopWatch.hpp"
 #include "Common/StringUtilities.hpp"
+#include "Common/ThreadPool.hpp"
 #include "Common/Timer.hpp"
 #include "Common/TimerThread.hpp"
 #include "Common/TimeUtilities.hpp"
@@ -34,7 +35,6 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include <iomanip>
 #include <iostream>
 #include <memory>
-#include <thread>
 
 namespace Vana {
 namespace LoginServer {
@@ -50,9 +50,7 @@ auto RankingCalculator::setTimer() -> void {
 
 auto RankingCalculator::runThread() -> void {
 	// Ranking on larger servers may take a long time and we don't want that to be blocking
-	// The thread_t object will be deleted immediately, but the thread will continue to run
-	auto p = make_owned_ptr<thread_t>([] { RankingCalculator::all(); });
-	p->detach();
+	ThreadPool::submit([] { RankingCalculator::all(); }, TaskPriority::Low);
 }
 
 auto RankingCalculator::all() -> void {
@@ -110,50 +108,57 @@ auto RankingCalculator::all() -> void {
 		job(v);
 		fame(v);
 
-		player_id_t charId = 0;
-		opt_int32_t oFame = 0;
-		int32_t cFame = 0;
-		opt_int32_t oWorld = 0;
-		int32_t cWorld = 0;
-		opt_int32_t oJob = 0;
-		int32_t cJob = 0;
-		opt_int32_t oOverall = 0;
-		int32_t cOverall = 0;
-
-		soci::statement st = (sql.prepare
-			<< "UPDATE " << db.makeTable("characters") << " "
-			<< "SET "
-			<< "	fame_opos = :ofame,"
-			<< "	fame_cpos = :cfame,"
-			<< "	world_opos = :oworld,"
-			<< "	world_cpos = :cworld,"
-			<< "	job_opos = :ojob,"
-			<< "	job_cpos = :cjob,"
-			<< "	overall_opos = :ooverall,"
-			<< "	overall_cpos = :coverall "
-			<< "	WHERE character_id = :char",
-			soci::use(charId, "char"),
-			soci::use(oFame, "ofame"),
-			soci::use(cFame, "cfame"),
-			soci::use(oWorld, "oworld"),
-			soci::use(cWorld, "cworld"),
-			soci::use(oJob, "ojob"),
-			soci::use(cJob, "cjob"),
-			soci::use(oOverall, "ooverall"),
-			soci::use(cOverall, "coverall"));
+		// The new positions go into a temporary table in chunks and are applied with a single joined UPDATE
+		// instead of an UPDATE per character
+		string_t rankTable = db.makeTable("rank_updates");
+		sql.once
+			<< "CREATE TEMPORARY TABLE IF NOT EXISTS " << rankTable << " ("
+			<< "	character_id int(11) NOT NULL,"
+			<< "	fame_opos int(11) unsigned NULL,"
+			<< "	fame_cpos int(11) unsigned NULL,"
+			<< "	world_opos int(11) unsigned NULL,"
+			<< "	world_cpos int(11) unsigned NULL,"
+			<< "	job_opos int(11) unsigned NULL,"
+			<< "	job_cpos int(11) unsigned NULL,"
+			<< "	overall_opos int(11) unsigned NULL,"
+			<< "	overall_cpos int(11) unsigned NULL,"
+			<< "	PRIMARY KEY (character_id)"
+			<< ")";
+		sql.once << "DELETE FROM " << rankTable;
+
+		BulkInsert<player_id_t, opt_int32_t, int32_t, opt_int32_t, int32_t, opt_int32_t, int32_t, opt_int32_t, int32_t> bulk{
+			sql,
+			"INSERT INTO " + rankTable + " (character_id, fame_opos, fame_cpos, world_opos, world_cpos, job_opos, job_cpos, overall_opos, overall_cpos)",
+			500};
 
 		for (const auto &p : v) {
-			charId = p.charId;
-			oFame = p.fame.oldRank;
-			cFame = p.fame.newRank.get();
-			oWorld = p.world.oldRank;
-			cWorld = p.world.newRank.get();
-			oJob = p.job.oldRank;
-			cJob = p.job.newRank.get();
-			oOverall = p.overall.oldRank;
-			cOverall = p.overall.newRank.get();
-			st.execute(true);
+			bulk.add(
+				p.charId,
+				p.fame.oldRank,
+				p.fame.newRank.get(),
+				p.world.oldRank,
+				p.world.newRank.get(),
+				p.job.oldRank,
+				p.job.newRank.get(),
+				p.overall.oldRank,
+				p.overall.newRank.get());
 		}
+		bulk.flush();
+
+		sql.once
+			<< "UPDATE " << db.makeTable("characters") << " c "
+			<< "INNER JOIN " << rankTable << " r ON r.character_id = c.character_id "
+			<< "SET "
+			<< "	c.fame_opos = r.fame_opos,"
+			<< "	c.fame_cpos = r.fame_cpos,"
+			<< "	c.world_opos = r.world_opos,"
+			<< "	c.world_cpos = r.world_cpos,"
+			<< "	c.job_opos = r.job_opos,"
+			<< "	c.job_cpos = r.job_cpos,"
+			<< "	c.overall_opos = r.overall_opos,"
+			<< "	c.overall_cpos = r.overall_cpos";
+
+		sql.once << "DROP TEMPORARY TABLE " << rankTable;
 	}
 
 	LoginServer::getInstance().log(LogType::Info, [&](out_stream_t &str) {
@@ -169,6 +169,10 @@ auto WorldServer::getLogPrefix() const -> string_t {
 	return "world";
 }
 
+auto WorldServer::makeFileIdentifier() const -> string_t {
+	return "world_" + StringUtilities::lexical_cast<string_t>(static_cast<int32_t>(m_worldId));
+}
+
 auto WorldServer::isConnected() const -> bool {
 	return m_worldId != -1;
 }
@@ -57,6 +57,7 @@ namespace Vana {
 			auto loadData() -> Result override;
 			auto makeLogIdentifier() const -> opt_string_t override;
 			auto getLogPrefix() const -> string_t override;
+			auto makeFileIdentifier() const -> string_t override;
 		private:
 			world_id_t m_worldId = -1;
 			port_t m_port = 0;